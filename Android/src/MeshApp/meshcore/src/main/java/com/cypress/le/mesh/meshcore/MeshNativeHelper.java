@@ -23,8 +23,6 @@
 */
 package com.cypress.le.mesh.meshcore;
 
-import android.os.Handler;
-import android.os.Message;
 import android.os.SystemClock;
 import android.util.Log;
 
@@ -95,24 +93,6 @@ public class MeshNativeHelper {
         mCallback.onDatabaseChangedCallback(meshName);
     }
 
-    private static  Handler mTimerHandler = new Handler() {
-        @Override
-        public void handleMessage(Message msg) {
-            timerCallback(msg.what);
-        }
-    };
-
-    static void startTimercb(final int timerId,  final int timeout)  {
-            Message msg = new Message();
-            msg.what = timerId;
-            msg.arg1 = timeout;
-            mTimerHandler.sendMessageDelayed(msg,timeout);
-    }
-
-    static void stopTimercb(int timerId) {
-        mTimerHandler.removeMessages(timerId);
-    }
-
     static void Sleep(int ms) {
         try {
             Thread.sleep(ms);
@@ -422,9 +402,6 @@ public class MeshNativeHelper {
     public static native void meshClientAdvertReport(byte[] bdaddr, byte addrType, byte rssi, byte[] advData, int advLen);
     public static native byte meshConnectComponent(String componentName, byte useProxy, byte scanDuration);
 
-    //MESH TIMER APIS
-    public static native void timerCallback(long l);
-
     //IMPORT EXPORT
     public static native String meshClientNetworkImport(String provisionerName, String jsonString);
     public static native String meshClientNetworkExport(String meshName);
@@ -447,6 +424,8 @@ public class MeshNativeHelper {
     public static native int meshClientSensorGet(String componentName, int propertyId);
 
     public static native int meshClientNetworkConnectionChanged(int connId);
+    public static native int meshClientSetTraceLevels(String spec);
+    public static native String meshClientGetTraceLevels();
 
     static void meshClientProvisionCompletedCb(byte isSuccess, byte[] uuid) {
         mCallback.meshClientProvisionCompletedCb(isSuccess, uuid);
@@ -56,6 +56,12 @@ MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/trace.c)
 #MY_CPP_LIST := $(wildcard $(LOCAL_PATH)/*.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_app.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/mesh_main.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/mesh_trace.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/hex_dump.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/log_ring.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/timer_stats.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/timer_thread.c)
+MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/mesh_libs/timer_wheel.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/../../../../../../../../../dev-kit/libraries/btsdk-mesh/mesh_client_lib/meshdb.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/../../../../../../../../../dev-kit/libraries/btsdk-mesh/mesh_client_lib/wiced_bt_mesh_db.c)
 MY_CPP_LIST += $(wildcard $(LOCAL_PATH)/../../../../../../../../../dev-kit/libraries/btsdk-mesh/mesh_client_lib/wiced_mesh_client.c)
@@ -41,6 +41,7 @@
 
 #include "wiced.h"
 #include "mesh_main.h"
+#include "hex_dump.h"
 #include <wiced_bt_mesh_cfg.h>
 #include <wiced_bt_mesh_models.h>
 #include <wiced_bt_mesh_provision.h>
@@ -62,17 +63,18 @@ static void mesh_provision_message_handler(uint16_t event, wiced_bt_mesh_event_t
 static void mesh_config_message_handler(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
 static void mesh_control_message_handler(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
 static void mesh_sensor_message_handler(uint8_t element_idx, uint16_t addr, uint16_t event, void *p_data);
-static void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh_core_state_t *p_state);
 extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
 extern void mesh_sensor_process_event(uint16_t addr, uint16_t event, void *p_data);
 
 extern void proxy_gatt_send_cb(uint32_t conn_id, uint32_t ref_data, const uint8_t *packet, uint32_t packet_len);
+#ifndef MESH_NVRAM_FILE
 static uint32_t mesh_nvram_access(wiced_bool_t write, int inx, uint8_t* value, uint16_t len, wiced_result_t *p_result);
+#endif
 typedef wiced_bool_t (*wiced_model_message_handler_t)(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
 static wiced_bt_mesh_core_received_msg_handler_t get_msg_handler_callback(uint16_t company_id, uint16_t opcode, uint16_t *p_model_id, wiced_bool_t *p_dont_save_rpl);
 static void mesh_start_stop_scan_callback(wiced_bool_t start, wiced_bool_t is_active);
 wiced_bool_t vendor_data_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
-extern void meshClientVendorSpecificDataStatus(const char *device_name, uint16_t company_id, uint16_t model_id, uint8_t opcode,uint_8t ttl,uint8_t *p_data, uint16_t data_len);
+extern void meshClientVendorSpecificDataStatus(uint16_t src, uint16_t company_id, uint16_t model_id, uint8_t opcode, uint8_t ttl, uint8_t *p_data, uint16_t data_len);
 extern void mesh_native_lib_read_dfu_meta_data(uint8_t *p_fw_id, uint32_t *p_fw_id_len, uint8_t *p_validation_data, uint32_t *p_validation_data_len);
 
 
@@ -251,7 +253,12 @@ void mesh_application_init(void)
         init.callback = get_msg_handler_callback;
         init.scan_callback = mesh_start_stop_scan_callback;
         init.proxy_send_callback = proxy_gatt_send_cb;
+#ifdef MESH_NVRAM_FILE
+        // the Linux daemon keeps each NVRAM index in a file, see mesh_nvram_init
+        init.nvram_access_callback = mesh_nvram_file_access;
+#else
         init.nvram_access_callback = mesh_nvram_access;
+#endif
         init.state_changed_cb = mesh_core_state_changed;
         wiced_bt_mesh_core_init(&init);
         wiced_bt_mesh_remote_provisioning_server_init();
@@ -405,6 +412,7 @@ uint32_t mesh_app_on_received_provision_gatt_pkt(uint8_t *p_data, uint32_t lengt
     return 0;
 }
 
+#ifndef MESH_NVRAM_FILE
 static uint16_t write_reg(char name[80], uint8_t *value, uint16_t len, uint32_t *pInt) {
     return len;
 }
@@ -428,6 +436,7 @@ static uint32_t mesh_nvram_access(wiced_bool_t write, int inx, uint8_t* value, u
         *p_result = WICED_BT_SUCCESS;
     return len;
 }
+#endif
 
 wiced_bool_t wiced_bt_get_upgrade_fw_info(uint16_t *company_id, uint8_t *fw_id_len, uint8_t *fw_id)
 {
@@ -456,7 +465,7 @@ int32_t ota_fw_upgrade_calculate_checksum(int32_t offset, int32_t length)
 
 wiced_bool_t vendor_data_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
 {
-    char buf[100] = { 0 };
+    char buf[100];
 
     // 0xffff model_id means request to check if that opcode belongs to that model
     if (p_event->model_id == 0xffff)
@@ -474,8 +483,7 @@ wiced_bool_t vendor_data_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data
 
     WICED_BT_TRACE("Vendor Data Opcode:%d\n", p_event->opcode);
 
-    for (int i = 0; i < data_len && i < 33; i++)
-        sprintf(&buf[strlen(buf)], "%02x", p_data[i]);
+    hex_dump_format(buf, sizeof(buf), p_data, (data_len < 33) ? data_len : 33, 0);
 
     WICED_BT_TRACE("%s\n", buf);
 
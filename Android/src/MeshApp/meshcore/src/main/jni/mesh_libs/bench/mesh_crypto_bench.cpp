@@ -0,0 +1,565 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+*
+* Known answer tests and microbenchmarks for mesh_libs on a Linux host.
+*
+* The known answer tests cover AES-128 (FIPS-197), AES-CMAC (RFC 4493),
+* the Bluetooth Mesh key derivation functions s1, k1, k2, k3 and k4 and a
+* network PDU encrypted with CCM (Mesh Profile sample data), and P-256 key
+* generation and DHKey (Bluetooth Core LE Secure Connections sample data).
+* s1 and k1-k4 are built here from AES_CMAC as the Mesh Profile defines them;
+* the mesh core library has its own copies.
+*
+* Each benchmark reports ns per operation, operations per second and, on
+* x86, TSC cycles per byte (or per operation for the P-256 routines). A
+* benchmark slower than its threshold fails the run, so a change that loses
+* a fast path is caught (AES instructions, 64-bit limbs, the generator
+* comb). The thresholds are about three times the times on a 2.1 GHz x86_64
+* host; scale them with -x for slower hosts.
+*
+* mesh_crypto_bench.sh builds this file against each of the Android, iOS
+* and Windows copies of mesh_libs and runs it.
+*
+* Usage: mesh_crypto_bench [-k] [-n] [-x factor]
+*   -k  known answer tests only
+*   -n  report timings without failing on the thresholds
+*   -x  multiply every threshold by factor
+*
+* Exit status: 0 all good, 1 a known answer test failed, 2 a threshold was
+* exceeded.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bt_target.h"
+#include "aes.h"
+#include "aes_cmac.h"
+#include "ccm.h"
+#include "p_256_multprecision.h"
+#include "p_256_ecc_pp.h"
+
+// The Windows copy of ccm.cpp has no single-pass mesh CCM
+#if defined(CCM_MESH_IV_LEN) && !defined(BENCH_NO_CCM_MESH)
+#define BENCH_CCM_MESH
+#endif
+
+#define BENCH_MAX_MSG   384
+
+static int bench_hex(uint8_t *b, const char *s)
+{
+    int n = 0;
+    unsigned int v;
+
+    while(s[0] && s[1] && sscanf(s, "%2x", &v) == 1)
+    {
+        b[n++] = (uint8_t)v;
+        s += 2;
+    }
+    return n;
+}
+
+// Big endian hex to little endian DWORDs as used by the P-256 code
+static void bench_hex_mp(DWORD *a, const char *s)
+{
+    uint8_t b[32];
+    int i;
+
+    bench_hex(b, s);
+    for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+        a[i] = ((DWORD)b[31-4*i]) | ((DWORD)b[30-4*i] << 8) | ((DWORD)b[29-4*i] << 16) | ((DWORD)b[28-4*i] << 24);
+}
+
+static int bench_check(const char *name, const uint8_t *out, const char *expect, int len)
+{
+    uint8_t b[64];
+    int ok = (bench_hex(b, expect) == len) && !memcmp(out, b, len);
+
+    printf("%-36s %s\n", name, ok ? "pass" : "FAIL");
+    return ok;
+}
+
+/******************************************************************************
+* Bluetooth Mesh key derivation (Mesh Profile 3.8.2)
+******************************************************************************/
+
+static void mesh_s1(uint8_t *salt, const char *m)
+{
+    uint8_t zero[16];
+
+    memset(zero, 0, sizeof(zero));
+    AES_CMAC(zero, (unsigned char *)m, (int)strlen(m), salt);
+}
+
+static void mesh_k1(uint8_t *out, uint8_t *n, int n_len, uint8_t *salt, uint8_t *p, int p_len)
+{
+    uint8_t t[16];
+
+    AES_CMAC(salt, n, n_len, t);
+    AES_CMAC(t, p, p_len, out);
+}
+
+static void mesh_k2(uint8_t *nid, uint8_t *enc_key, uint8_t *privacy_key, uint8_t *n, uint8_t *p, int p_len)
+{
+    uint8_t salt[16], t[16], buf[16 + 16 + 1];
+    int len;
+
+    mesh_s1(salt, "smk2");
+    AES_CMAC(salt, n, 16, t);
+
+    // T1 = CMAC_T(P || 0x01), Tn = CMAC_T(Tn-1 || P || n)
+    memcpy(buf, p, p_len);
+    buf[p_len] = 0x01;
+    AES_CMAC(t, buf, p_len + 1, buf);
+    *nid = buf[15] & 0x7F;
+
+    memmove(buf + 16, p, p_len);
+    len = 16 + p_len;
+    buf[len] = 0x02;
+    AES_CMAC(t, buf, len + 1, enc_key);
+
+    memcpy(buf, enc_key, 16);
+    buf[len] = 0x03;
+    AES_CMAC(t, buf, len + 1, privacy_key);
+}
+
+static void mesh_k3(uint8_t *out, uint8_t *n)
+{
+    uint8_t salt[16], t[16], id64[5] = { 'i', 'd', '6', '4', 0x01 };
+
+    mesh_s1(salt, "smk3");
+    AES_CMAC(salt, n, 16, t);
+    AES_CMAC(t, id64, sizeof(id64), t);
+    memcpy(out, t + 8, 8);
+}
+
+static uint8_t mesh_k4(uint8_t *n)
+{
+    uint8_t salt[16], t[16], id6[4] = { 'i', 'd', '6', 0x01 };
+
+    mesh_s1(salt, "smk4");
+    AES_CMAC(salt, n, 16, t);
+    AES_CMAC(t, id6, sizeof(id6), t);
+    return t[15] & 0x3F;
+}
+
+/******************************************************************************
+* Known answer tests
+******************************************************************************/
+
+static int kat_aes(void)
+{
+    uint8_t key[16], in[16], out[16], msg[64];
+    aes_context ctx[1];
+    aes_cmac_ctx cmac[1];
+    int ok;
+
+    bench_hex(key, "000102030405060708090a0b0c0d0e0f");
+    bench_hex(in, "00112233445566778899aabbccddeeff");
+    aes_set_key(key, 16, ctx);
+    aes_encrypt(in, out, ctx);
+    ok = bench_check("AES-128 FIPS-197 C.1", out, "69c4e0d86a7b0430d8cdb78070b4c55a", 16);
+
+    bench_hex(key, "2b7e151628aed2a6abf7158809cf4f3c");
+    bench_hex(msg, "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                   "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+    AES_CMAC(key, msg, 0, out);
+    ok &= bench_check("AES-CMAC RFC 4493 example 1", out, "bb1d6929e95937287fa37d129b756746", 16);
+    AES_CMAC(key, msg, 16, out);
+    ok &= bench_check("AES-CMAC RFC 4493 example 2", out, "070a16b46b4d4144f79bdd9dd04a287c", 16);
+    AES_CMAC(key, msg, 40, out);
+    ok &= bench_check("AES-CMAC RFC 4493 example 3", out, "dfa66747de9ae63030ca32611497c827", 16);
+    aes_cmac_ctx_init(cmac, key);
+    aes_cmac_ctx_mac(cmac, msg, 64, out);
+    ok &= bench_check("AES-CMAC RFC 4493 example 4 (keyed)", out, "51f0bebf7e3b9d92fc49741779363cfe", 16);
+    return ok;
+}
+
+static int kat_mesh_keys(void)
+{
+    uint8_t n[16], salt[16], p[16], out[16], enc_key[16], privacy_key[16], nid;
+    int ok, p_len;
+
+    mesh_s1(out, "test");
+    ok = bench_check("Mesh s1", out, "b73cefbd641ef2ea598c2b6efb62f79c", 16);
+
+    bench_hex(n, "3216d1509884b533248541792b877f98");
+    bench_hex(salt, "2ba14ffa0df84a2831938d57d276cab4");
+    bench_hex(p, "5a09d60797eeb4478aada59db3352a0d");
+    mesh_k1(out, n, 16, salt, p, 16);
+    ok &= bench_check("Mesh k1", out, "f6ed15a8934afbe7d83e8dcb57fcf5d7", 16);
+
+    bench_hex(n, "f7a2a44f8e8a8029064f173ddc1e2b00");
+    p[0] = 0x00;
+    mesh_k2(&nid, enc_key, privacy_key, n, p, 1);
+    ok &= bench_check("Mesh k2 master NID", &nid, "7f", 1);
+    ok &= bench_check("Mesh k2 master EncryptionKey", enc_key, "9f589181a0f50de73c8070c7a6d27f46", 16);
+    ok &= bench_check("Mesh k2 master PrivacyKey", privacy_key, "4c715bd4a64b938f99b453351653124f", 16);
+
+    p_len = bench_hex(p, "010203040506070809");
+    mesh_k2(&nid, enc_key, privacy_key, n, p, p_len);
+    ok &= bench_check("Mesh k2 friendship NID", &nid, "73", 1);
+    ok &= bench_check("Mesh k2 friendship EncryptionKey", enc_key, "11efec0642774992510fb5929646df49", 16);
+    ok &= bench_check("Mesh k2 friendship PrivacyKey", privacy_key, "d4d7cc0dfa772d836a8df9df5510d7a7", 16);
+
+    mesh_k3(out, n);
+    ok &= bench_check("Mesh k3", out, "ff046958233db014", 8);
+
+    bench_hex(n, "3216d1509884b533248541792b877f98");
+    nid = mesh_k4(n);
+    ok &= bench_check("Mesh k4", &nid, "38", 1);
+
+    // sample data 8.2: NetKey and AppKey
+    bench_hex(n, "7dd7364cd842ad18c17c2b820c84c3d6");
+    p[0] = 0x00;
+    mesh_k2(&nid, enc_key, privacy_key, n, p, 1);
+    ok &= bench_check("Mesh sample NetKey NID", &nid, "68", 1);
+    ok &= bench_check("Mesh sample NetKey EncryptionKey", enc_key, "0953fa93e7caac9638f58820220a398e", 16);
+    ok &= bench_check("Mesh sample NetKey PrivacyKey", privacy_key, "8b84eedec100067d670971dd2aa700cf", 16);
+    mesh_k3(out, n);
+    ok &= bench_check("Mesh sample Network ID", out, "3ecaff672f673370", 8);
+
+    bench_hex(n, "63964771734fbd76e3b40519d1d94a48");
+    nid = mesh_k4(n);
+    ok &= bench_check("Mesh sample AppKey AID", &nid, "26", 1);
+    return ok;
+}
+
+static int kat_ccm(void)
+{
+    uint8_t key[16], iv[13], msg[32], tag[8];
+    ccm_ctx ctx[1];
+    int ok, len;
+
+    // Mesh Profile sample data message #1: network layer encryption of
+    // DST || TransportPDU with a 64-bit NetMIC
+    bench_hex(key, "0953fa93e7caac9638f58820220a398e");
+    bench_hex(iv, "00800000011201000012345678");
+    len = bench_hex(msg, "fffd034b50057e400000010000");
+    ccm_init_and_key(key, 16, ctx);
+
+    ok = ccm_encrypt_message(iv, 13, NULL, 0, msg, len, tag, 8, ctx) == RETURN_GOOD;
+    ok &= bench_check("CCM mesh message #1", msg, "b5e5bfdacbaf6cb7fb6bff871f", len);
+    ok &= bench_check("CCM mesh message #1 NetMIC", tag, "035444ce83a670df", 8);
+    ok &= ccm_decrypt_message(iv, 13, NULL, 0, msg, len, tag, 8, ctx) == RETURN_GOOD;
+    ok &= bench_check("CCM mesh message #1 decrypt", msg, "fffd034b50057e400000010000", len);
+
+#ifdef BENCH_CCM_MESH
+    ok &= ccm_mesh_encrypt_message(iv, NULL, 0, msg, len, tag, 8, ctx) == RETURN_GOOD;
+    ok &= bench_check("CCM mesh message #1 (single pass)", msg, "b5e5bfdacbaf6cb7fb6bff871f", len);
+    tag[7] ^= 1;
+    ok &= ccm_mesh_decrypt_message(iv, NULL, 0, msg, len, tag, 8, ctx) != RETURN_GOOD;
+    printf("%-36s %s\n", "CCM mesh bad NetMIC rejected", ok ? "pass" : "FAIL");
+#endif
+    ccm_end(ctx);
+    return ok;
+}
+
+static const char priv_a[] = "3f49f6d4a3c55f3874c9b3e3d2103f504aff607beb40b7995899b8a6cd3c1abd";
+static const char priv_b[] = "55188b3d32f6bb9a900afcfbeed4e72a59cb9ac2f19d7cfb6b4fdd49f47fc5fd";
+static const char pub_b_x[] = "1ea1f0f01faf1d9609592284f19e4c0047b58afd8615a69f559077b22faaa190";
+static const char pub_b_y[] = "4c55f33e429dad377356703a9ab85160472d1130e28e36765f89aff915b1214a";
+
+static int kat_p256_point(const char *name, Point *p, const char *k, const char *x, const char *y)
+{
+    DWORD n[KEY_LENGTH_DWORDS_P256], e[KEY_LENGTH_DWORDS_P256];
+    Point q;
+    int ok;
+
+    bench_hex_mp(n, k);
+    ECC_PM_B_NAF(&q, p, n, KEY_LENGTH_DWORDS_P256);
+    bench_hex_mp(e, x);
+    ok = !MP_CMP(q.x, e, KEY_LENGTH_DWORDS_P256);
+    if(y)
+    {
+        bench_hex_mp(e, y);
+        ok &= !MP_CMP(q.y, e, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("%-36s %s\n", name, ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static int kat_p256(void)
+{
+    Point g, pub_b;
+    int ok;
+
+    memcpy(&g, &curve_p256.G, sizeof(Point));
+    ok = kat_p256_point("P-256 LE SC public key A", &g, priv_a,
+                        "20b003d2f297be2c5e2c83a7e9f9a5b9eff49111acf4fddbcc0301480e359de6",
+                        "dc809c49652aeb6d63329abf5a52155c766345c28fed3024741c8ed01589d28b");
+    ok &= kat_p256_point("P-256 LE SC public key B", &g, priv_b, pub_b_x, pub_b_y);
+
+    bench_hex_mp(pub_b.x, pub_b_x);
+    bench_hex_mp(pub_b.y, pub_b_y);
+    ok &= kat_p256_point("P-256 LE SC DHKey", &pub_b, priv_a,
+                         "ec0234a357c8ad05341010a60a397d9b99796b13b4f866f1868d34f373bfa698", NULL);
+    return ok;
+}
+
+/******************************************************************************
+* Benchmarks
+******************************************************************************/
+
+typedef struct
+{
+    uint8_t         key[16];
+    uint8_t         iv[13];
+    uint8_t         buf[BENCH_MAX_MSG];
+    uint8_t         tag[16];
+    aes_context     aes[1];
+    aes_cmac_ctx    cmac[1];
+    ccm_ctx         ccm[1];
+    DWORD           a[KEY_LENGTH_DWORDS_P256], b[KEY_LENGTH_DWORDS_P256];
+    DWORD           c[2*KEY_LENGTH_DWORDS_P256];
+    Point           p, q;
+} bench_state;
+
+static void b_aes_set_key(bench_state *st, int len)
+{
+    aes_set_key(st->key, 16, st->aes);
+}
+
+static void b_aes_encrypt(bench_state *st, int len)
+{
+    aes_encrypt(st->buf, st->buf, st->aes);
+}
+
+static void b_aes_cmac(bench_state *st, int len)
+{
+    AES_CMAC(st->key, st->buf, len, st->tag);
+}
+
+static void b_aes_cmac_ctx(bench_state *st, int len)
+{
+    aes_cmac_ctx_mac(st->cmac, st->buf, len, st->tag);
+}
+
+static void b_ccm_encrypt(bench_state *st, int len)
+{
+    ccm_encrypt_message(st->iv, 13, NULL, 0, st->buf, len, st->tag, len > 32 ? 8 : 4, st->ccm);
+}
+
+#ifdef BENCH_CCM_MESH
+static void b_ccm_mesh_encrypt(bench_state *st, int len)
+{
+    ccm_mesh_encrypt_message(st->iv, NULL, 0, st->buf, len, st->tag, len > 32 ? 8 : 4, st->ccm);
+}
+#endif
+
+static void b_mp_mult(bench_state *st, int len)
+{
+    MP_Mult(st->c, st->a, st->b, KEY_LENGTH_DWORDS_P256);
+}
+
+static void b_mp_mult_mod(bench_state *st, int len)
+{
+    MP_MersennsMultMod(st->a, st->a, st->b, KEY_LENGTH_DWORDS_P256);
+}
+
+static void b_mp_inv_mod(bench_state *st, int len)
+{
+    MP_Copy(st->c, st->a, KEY_LENGTH_DWORDS_P256);
+    MP_InvMod(st->a, st->c, KEY_LENGTH_DWORDS_P256);
+}
+
+static void b_ecc_keygen(bench_state *st, int len)
+{
+    MP_Copy(st->c, st->b, KEY_LENGTH_DWORDS_P256);
+    ECC_PM_B_NAF(&st->q, &curve_p256.G, st->c, KEY_LENGTH_DWORDS_P256);
+}
+
+static void b_ecc_dhkey(bench_state *st, int len)
+{
+    MP_Copy(st->c, st->b, KEY_LENGTH_DWORDS_P256);
+    ECC_PM_B_NAF(&st->q, &st->p, st->c, KEY_LENGTH_DWORDS_P256);
+}
+
+typedef void (*bench_fn)(bench_state *st, int len);
+
+typedef struct
+{
+    const char  *name;
+    bench_fn    fn;
+    int         len;            // bytes processed per call, 0 for the P-256 routines
+    double      max_ns;         // threshold per call
+} bench_entry;
+
+static const bench_entry bench_list[] =
+{
+    { "aes_set_key",                b_aes_set_key,      0,      400 },
+    { "aes_encrypt",                b_aes_encrypt,      16,     60 },
+    { "AES_CMAC 16 B",              b_aes_cmac,         16,     500 },
+    { "AES_CMAC 384 B",             b_aes_cmac,         384,    2000 },
+    { "aes_cmac_ctx_mac 16 B",      b_aes_cmac_ctx,     16,     60 },
+    { "aes_cmac_ctx_mac 384 B",     b_aes_cmac_ctx,     384,    1200 },
+    { "ccm_encrypt_message 29 B",   b_ccm_encrypt,      29,     600 },
+    { "ccm_encrypt_message 384 B",  b_ccm_encrypt,      384,    4000 },
+#ifdef BENCH_CCM_MESH
+    { "ccm_mesh_encrypt 29 B",      b_ccm_mesh_encrypt, 29,     400 },
+    { "ccm_mesh_encrypt 384 B",     b_ccm_mesh_encrypt, 384,    2500 },
+#endif
+    { "MP_Mult",                    b_mp_mult,          0,      300 },
+    { "MP_MersennsMultMod",         b_mp_mult_mod,      0,      200 },
+    { "MP_InvMod",                  b_mp_inv_mod,       0,      40000 },
+    { "ECC_PM_B_NAF G (keygen)",    b_ecc_keygen,       0,      250000 },
+    { "ECC_PM_B_NAF P (DHKey)",     b_ecc_dhkey,        0,      900000 },
+};
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Best of 5 runs of a batch sized to take about 20 ms
+static void bench_run(const bench_entry *e, bench_state *st, double *ns, double *cycles)
+{
+    long count, i;
+    int r;
+    double t;
+    uint64_t c;
+
+    for(count=1; ; count*=2)
+    {
+        t = bench_now_ns();
+        for(i=0; i<count; i++)
+            e->fn(st, e->len);
+        if(bench_now_ns() - t > 20e6 || count >= (1L << 30))
+            break;
+    }
+
+    *ns = *cycles = 0;
+    for(r=0; r<5; r++)
+    {
+        t = bench_now_ns();
+        c = bench_cycles();
+        for(i=0; i<count; i++)
+            e->fn(st, e->len);
+        c = bench_cycles() - c;
+        t = (bench_now_ns() - t) / count;
+        if(r == 0 || t < *ns)
+        {
+            *ns = t;
+            *cycles = (double)c / count;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static bench_state st;
+    double ns, cycles, scale = 1;
+    int i, kat_only = 0, no_limits = 0, slow = 0, ok;
+
+    for(i=1; i<argc; i++)
+    {
+        if(!strcmp(argv[i], "-k"))
+            kat_only = 1;
+        else if(!strcmp(argv[i], "-n"))
+            no_limits = 1;
+        else if(!strcmp(argv[i], "-x") && i+1 < argc)
+            scale = atof(argv[++i]);
+        else
+        {
+            printf("usage: %s [-k] [-n] [-x factor]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    p_256_init_curve(KEY_LENGTH_DWORDS_P256);
+
+    ok = kat_aes();
+    ok &= kat_mesh_keys();
+    ok &= kat_ccm();
+    ok &= kat_p256();
+    printf("known answer tests %s\n\n", ok ? "passed" : "FAILED");
+    if(!ok)
+        return 1;
+    if(kat_only)
+        return 0;
+
+    for(i=0; i<(int)sizeof(st.buf); i++)
+        st.buf[i] = (uint8_t)(i * 7);
+    bench_hex(st.key, "7dd7364cd842ad18c17c2b820c84c3d6");
+    bench_hex(st.iv, "00800000011201000012345678");
+    aes_set_key(st.key, 16, st.aes);
+    aes_cmac_ctx_init(st.cmac, st.key);
+    ccm_init_and_key(st.key, 16, st.ccm);
+    bench_hex_mp(st.a, pub_b_x);
+    bench_hex_mp(st.b, priv_a);
+    bench_hex_mp(st.p.x, pub_b_x);
+    bench_hex_mp(st.p.y, pub_b_y);
+
+    printf("%-28s %12s %12s %10s %12s\n", "", "ns/op", "ops/s", "cyc/B", "limit ns");
+    for(i=0; i<(int)(sizeof(bench_list) / sizeof(bench_list[0])); i++)
+    {
+        const bench_entry *e = &bench_list[i];
+        double limit = e->max_ns * scale;
+        char cyc[16];
+
+        bench_run(e, &st, &ns, &cycles);
+        if(!cycles)
+            strcpy(cyc, "-");
+        else if(e->len)
+            snprintf(cyc, sizeof(cyc), "%.1f", cycles / e->len);
+        else
+            snprintf(cyc, sizeof(cyc), "%.0f/op", cycles);
+
+        printf("%-28s %12.1f %12.0f %10s %12.0f%s\n", e->name, ns, 1e9 / ns, cyc, limit,
+               no_limits || ns <= limit ? "" : "  SLOW");
+        if(ns > limit)
+            slow = 1;
+    }
+    ccm_end(st.ccm);
+
+    return (slow && !no_limits) ? 2 : 0;
+}
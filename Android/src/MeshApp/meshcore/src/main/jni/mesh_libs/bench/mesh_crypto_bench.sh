@@ -0,0 +1,60 @@
+#!/bin/sh
+#
+# Builds mesh_crypto_bench against the Android, iOS and Windows copies of
+# mesh_libs and runs each one, so the copies are checked against the same
+# known answer tests and thresholds. Arguments are passed to every run.
+# Needs gcc/g++ (or CC/CXX) on x86_64 or arm64 Linux.
+#
+#   ./mesh_crypto_bench.sh [-k] [-n] [-x factor]
+#
+# The binaries are left in $OUT (default /tmp/mesh_crypto_bench).
+
+here=$(cd "$(dirname "$0")" && pwd)
+root=$(cd "$here/../../../../../../../../.." && pwd)
+android=$root/Android/src/MeshApp/meshcore/src/main/jni/mesh_libs
+ios=$root/iOS/MeshApp/MeshFramework/meshcore/libwicedmesh/src/mesh_libs
+windows=$root/Windows/mesh_libs
+out=${OUT:-/tmp/mesh_crypto_bench}
+CC=${CC:-gcc}
+CXX=${CXX:-g++}
+CFLAGS=${CFLAGS:--O2}
+
+# Every copy is built as the Android one (__ANDROID__ gives the 32-bit DWORD
+# of the P-256 code); headers a copy lacks come from the Android copy.
+flags="$CFLAGS -D__ANDROID__ -DMESH_OVER_GATT_ONLY -DBOOL32=int -I$here/host"
+
+build()
+{
+    name=$1 src=$2 extra=$3
+    mkdir -p "$out/$name"
+    for f in p_256_ecc_pp p_256_multprecision p_256_curvepara; do
+        $CC $flags $extra -I"$src" -I"$android" -c "$src/$f.c" -o "$out/$name/$f.o" || return 1
+    done
+    for f in aes aes_cmac ccm; do
+        $CXX $flags $extra -I"$src" -I"$android" -c "$src/$f.cpp" -o "$out/$name/$f.o" || return 1
+    done
+    $CXX $flags $extra -I"$src" -I"$android" "$here/mesh_crypto_bench.cpp" "$out/$name"/*.o \
+        -o "$out/mesh_crypto_bench_$name"
+}
+
+mkdir -p "$out"
+status=0
+for copy in android ios windows; do
+    case $copy in
+        android) src=$android extra= ;;
+        ios)     src=$ios     extra= ;;
+        windows) src=$windows extra=-DBENCH_NO_CCM_MESH ;;
+    esac
+    echo "== $copy"
+    if ! build $copy "$src" "$extra" 2>"$out/$copy.log"; then
+        cat "$out/$copy.log"
+        echo "$copy: build failed"
+        status=1
+        continue
+    fi
+    "$out/mesh_crypto_bench_$copy" "$@"
+    rc=$?
+    [ $rc -gt $status ] && status=$rc
+    echo
+done
+exit $status
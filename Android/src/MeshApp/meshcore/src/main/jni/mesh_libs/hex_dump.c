@@ -0,0 +1,344 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Hex dump formatter, see hex_dump.h.
+ */
+#include <string.h>
+#include "hex_dump.h"
+
+// MSVC has no SSSE3 switch, /arch:AVX is the first one that allows pshufb
+#if defined(__SSSE3__) || defined(__AVX__)
+#define HEX_DUMP_SSSE3
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HEX_DUMP_NEON
+#include <arm_neon.h>
+#endif
+
+// The two digits of every byte value, byte b at offset 2 * b
+#define HEX_DUMP_ROW(h) \
+    h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" h "8" h "9" h "a" h "b" h "c" h "d" h "e" h "f"
+static const char hex_dump_pairs[] =
+    HEX_DUMP_ROW("0") HEX_DUMP_ROW("1") HEX_DUMP_ROW("2") HEX_DUMP_ROW("3")
+    HEX_DUMP_ROW("4") HEX_DUMP_ROW("5") HEX_DUMP_ROW("6") HEX_DUMP_ROW("7")
+    HEX_DUMP_ROW("8") HEX_DUMP_ROW("9") HEX_DUMP_ROW("a") HEX_DUMP_ROW("b")
+    HEX_DUMP_ROW("c") HEX_DUMP_ROW("d") HEX_DUMP_ROW("e") HEX_DUMP_ROW("f");
+
+#define HEX_DUMP_PAIR(p, b)     memcpy((p), &hex_dump_pairs[2 * (b)], 2)
+
+#ifdef HEX_DUMP_SSSE3
+#define HEX_DUMP_X16(m, b, r) \
+    m((b) + 0, r),  m((b) + 1, r),  m((b) + 2, r),  m((b) + 3, r),  m((b) + 4, r),  m((b) + 5, r),  \
+    m((b) + 6, r),  m((b) + 7, r),  m((b) + 8, r),  m((b) + 9, r),  m((b) + 10, r), m((b) + 11, r), \
+    m((b) + 12, r), m((b) + 13, r), m((b) + 14, r), m((b) + 15, r)
+
+// Character p of "xx xx ..." is digit r of byte p / 3, 0x80 makes pshufb leave a zero there
+#define HEX_DUMP_FROM(p, r)     ((((p) % 3) == (r)) ? (p) / 3 : 0x80)
+#define HEX_DUMP_SPACE(p, r)    ((((p) % 3) == 2) ? ' ' : 0)
+
+static const uint8_t hex_dump_digits[16] =
+{
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+// Shuffle controls for the three 16 character blocks of a line, high digits and low digits
+static const uint8_t hex_dump_spread[3][2][16] =
+{
+    { { HEX_DUMP_X16(HEX_DUMP_FROM, 0, 0) },  { HEX_DUMP_X16(HEX_DUMP_FROM, 0, 1) } },
+    { { HEX_DUMP_X16(HEX_DUMP_FROM, 16, 0) }, { HEX_DUMP_X16(HEX_DUMP_FROM, 16, 1) } },
+    { { HEX_DUMP_X16(HEX_DUMP_FROM, 32, 0) }, { HEX_DUMP_X16(HEX_DUMP_FROM, 32, 1) } },
+};
+
+static const uint8_t hex_dump_spaces[3][16] =
+{
+    { HEX_DUMP_X16(HEX_DUMP_SPACE, 0, 0) },
+    { HEX_DUMP_X16(HEX_DUMP_SPACE, 16, 0) },
+    { HEX_DUMP_X16(HEX_DUMP_SPACE, 32, 0) },
+};
+
+#define HEX_DUMP_LOAD(p)        _mm_loadu_si128((const __m128i *)(p))
+
+// Looks up the digits of the high and the low nibbles of 16 bytes
+static void hex_dump_digits16(const uint8_t *p_data, __m128i *p_hi, __m128i *p_lo)
+{
+    const __m128i digits = HEX_DUMP_LOAD(hex_dump_digits);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i       v = HEX_DUMP_LOAD(p_data);
+
+    *p_hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    *p_lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+}
+
+// Writes 16 bytes as "xx xx ... xx\n", 48 characters
+static char *hex_dump_line16(char *p, const uint8_t *p_data)
+{
+    __m128i hi, lo, out;
+    int     i;
+
+    hex_dump_digits16(p_data, &hi, &lo);
+    for (i = 0; i < 3; i++)
+    {
+        out = _mm_or_si128(_mm_shuffle_epi8(hi, HEX_DUMP_LOAD(hex_dump_spread[i][0])),
+                           _mm_shuffle_epi8(lo, HEX_DUMP_LOAD(hex_dump_spread[i][1])));
+        _mm_storeu_si128((__m128i *)(p + 16 * i), _mm_or_si128(out, HEX_DUMP_LOAD(hex_dump_spaces[i])));
+    }
+    p[47] = '\n';
+    return p + 48;
+}
+
+// Writes 16 bytes as 32 digits
+static char *hex_dump_run16(char *p, const uint8_t *p_data)
+{
+    __m128i hi, lo;
+
+    hex_dump_digits16(p_data, &hi, &lo);
+    _mm_storeu_si128((__m128i *)p, _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128((__m128i *)(p + 16), _mm_unpackhi_epi8(hi, lo));
+    return p + 32;
+}
+
+#elif defined(HEX_DUMP_NEON)
+// Digits computed as '0' + d, plus 39 more to reach 'a' for d > 9, which needs no table lookup
+static uint8x16_t hex_dump_digit(uint8x16_t d)
+{
+    uint8x16_t c = vaddq_u8(d, vdupq_n_u8('0'));
+    return vaddq_u8(c, vandq_u8(vcgtq_u8(d, vdupq_n_u8(9)), vdupq_n_u8('a' - '0' - 10)));
+}
+
+// Writes 16 bytes as "xx xx ... xx\n", 48 characters, vst3 interleaves digit, digit, space
+static char *hex_dump_line16(char *p, const uint8_t *p_data)
+{
+    uint8x16_t   v = vld1q_u8(p_data);
+    uint8x16x3_t out;
+
+    out.val[0] = hex_dump_digit(vshrq_n_u8(v, 4));
+    out.val[1] = hex_dump_digit(vandq_u8(v, vdupq_n_u8(0x0f)));
+    out.val[2] = vdupq_n_u8(' ');
+    vst3q_u8((uint8_t *)p, out);
+    p[47] = '\n';
+    return p + 48;
+}
+
+// Writes 16 bytes as 32 digits
+static char *hex_dump_run16(char *p, const uint8_t *p_data)
+{
+    uint8x16_t   v = vld1q_u8(p_data);
+    uint8x16x2_t out;
+
+    out.val[0] = hex_dump_digit(vshrq_n_u8(v, 4));
+    out.val[1] = hex_dump_digit(vandq_u8(v, vdupq_n_u8(0x0f)));
+    vst2q_u8((uint8_t *)p, out);
+    return p + 32;
+}
+
+#else
+static char *hex_dump_line16(char *p, const uint8_t *p_data)
+{
+    int i;
+
+    for (i = 0; i < 16; i++, p += 3)
+    {
+        HEX_DUMP_PAIR(p, p_data[i]);
+        p[2] = ' ';
+    }
+    p[-1] = '\n';
+    return p;
+}
+
+static char *hex_dump_run16(char *p, const uint8_t *p_data)
+{
+    int i;
+
+    for (i = 0; i < 16; i++, p += 2)
+        HEX_DUMP_PAIR(p, p_data[i]);
+    return p;
+}
+#endif
+
+uint32_t hex_dump_format(char *p_text, uint32_t text_size, const uint8_t *p_data, uint32_t len, uint32_t bytes_per_line)
+{
+    char     *p = p_text;
+    uint32_t  column = 0;
+
+    if (text_size == 0)
+        return 0;
+
+    if (bytes_per_line == 0)
+    {
+        if (len > (text_size - 1) / 2)
+            len = (text_size - 1) / 2;
+        for ( ; len >= 16; len -= 16, p_data += 16)
+            p = hex_dump_run16(p, p_data);
+        for ( ; len != 0; len--, p += 2)
+            HEX_DUMP_PAIR(p, *p_data++);
+    }
+    else
+    {
+        // Every byte takes three characters, its digits and a space or the newline
+        if (len > (text_size - 1) / 3)
+            len = (text_size - 1) / 3;
+        if (bytes_per_line == 16)
+        {
+            for ( ; len >= 16; len -= 16, p_data += 16)
+                p = hex_dump_line16(p, p_data);
+        }
+        for ( ; len != 0; len--, p += 3)
+        {
+            HEX_DUMP_PAIR(p, *p_data++);
+            if (++column == bytes_per_line)
+                column = 0;
+            p[2] = ((column == 0) || (len == 1)) ? '\n' : ' ';
+        }
+    }
+    *p = 0;
+    return (uint32_t)(p - p_text);
+}
+
+void hex_dump(const uint8_t *p_data, uint32_t len, uint32_t max_lines, HEX_DUMP_OUTPUT *p_output)
+{
+    // Whole lines only, so that a dump split over several blocks still breaks at line ends
+    const uint32_t  block = (HEX_DUMP_SCRATCH_SIZE - 1) / (3 * HEX_DUMP_LINE_BYTES) * HEX_DUMP_LINE_BYTES;
+    char            text[HEX_DUMP_SCRATCH_SIZE];
+    uint32_t        count;
+
+    if ((max_lines != 0) && (len > max_lines * HEX_DUMP_LINE_BYTES))
+        len = max_lines * HEX_DUMP_LINE_BYTES;
+
+    for ( ; len != 0; len -= count, p_data += count)
+    {
+        count = (len < block) ? len : block;
+        p_output(text, hex_dump_format(text, sizeof(text), p_data, count, HEX_DUMP_LINE_BYTES));
+    }
+}
+
+#ifdef HEX_DUMP_UNIT_TEST
+// Checks the output against sprintf for every length and alignment, with and without SIMD:
+//   gcc -O2 -DHEX_DUMP_UNIT_TEST hex_dump.c && ./a.out
+//   gcc -O2 -mssse3 -DHEX_DUMP_UNIT_TEST hex_dump.c && ./a.out
+#include <stdio.h>
+#include <time.h>
+
+#define TEST_MAX_LEN        400
+#define TEST_BENCH_LEN      256
+#define TEST_BENCH_ROUNDS   200000
+
+static uint8_t  test_data[TEST_MAX_LEN + 16];
+static char     test_text[HEX_DUMP_SCRATCH_SIZE * 2];
+static uint32_t test_blocks, test_total;
+
+static uint32_t test_reference(char *p_text, const uint8_t *p_data, uint32_t len, uint32_t bytes_per_line)
+{
+    uint32_t i, n = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (bytes_per_line == 0)
+            n += sprintf(&p_text[n], "%02x", p_data[i]);
+        else
+            n += sprintf(&p_text[n], "%02x%c", p_data[i], (((i + 1) % bytes_per_line == 0) || (i + 1 == len)) ? '\n' : ' ');
+    }
+    p_text[n] = 0;
+    return n;
+}
+
+static void test_output(const char *p_text, uint32_t len)
+{
+    memcpy(&test_text[test_total], p_text, len + 1);
+    test_total += len;
+    test_blocks++;
+}
+
+static double test_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    static const uint32_t layouts[] = { 0, 16, 8, 5 };
+    char     text[HEX_DUMP_TEXT_SIZE(TEST_MAX_LEN)], expected[HEX_DUMP_TEXT_SIZE(TEST_MAX_LEN)];
+    uint32_t i, len, offset, layout, n;
+    double   start, formatter, reference;
+    int      failed = 0;
+
+    for (i = 0; i < sizeof(test_data); i++)
+        test_data[i] = (uint8_t)(i * 167 + 13);
+
+    for (layout = 0; layout < sizeof(layouts) / sizeof(layouts[0]); layout++)
+        for (offset = 0; offset < 16; offset += 3)
+            for (len = 0; len <= TEST_MAX_LEN; len++)
+            {
+                n = hex_dump_format(text, sizeof(text), &test_data[offset], len, layouts[layout]);
+                if ((n != test_reference(expected, &test_data[offset], len, layouts[layout])) || (strcmp(text, expected) != 0))
+                {
+                    printf("layout %u offset %u len %u:\n%s\n%s\n", layouts[layout], offset, len, text, expected);
+                    failed = 1;
+                }
+            }
+
+    // Truncation keeps whole bytes
+    if ((hex_dump_format(text, 10, test_data, 16, 16) != 9) || (text[8] != '\n') || (text[9] != 0))
+        failed = 1;
+    if ((hex_dump_format(text, 6, test_data, 16, 0) != 4) || (hex_dump_format(text, 0, test_data, 16, 0) != 0))
+        failed = 1;
+
+    // A dump longer than the scratch area is passed on in whole lines
+    hex_dump(test_data, TEST_MAX_LEN, 0, test_output);
+    test_reference(expected, test_data, TEST_MAX_LEN, HEX_DUMP_LINE_BYTES);
+    if ((test_blocks != 2) || (strcmp(test_text, expected) != 0))
+        failed = 1;
+    test_blocks = test_total = 0;
+    hex_dump(test_data, TEST_MAX_LEN, 4, test_output);
+    if ((test_blocks != 1) || (test_total != 4 * 48))
+        failed = 1;
+
+    start = test_seconds();
+    for (i = 0; i < TEST_BENCH_ROUNDS; i++)
+        hex_dump_format(text, sizeof(text), &test_data[i & 7], TEST_BENCH_LEN, HEX_DUMP_LINE_BYTES);
+    formatter = test_seconds() - start;
+    start = test_seconds();
+    for (i = 0; i < TEST_BENCH_ROUNDS / 10; i++)
+        test_reference(expected, &test_data[i & 7], TEST_BENCH_LEN, HEX_DUMP_LINE_BYTES);
+    reference = (test_seconds() - start) * 10;
+    printf("%u bytes: %.1f ns, sprintf per byte %.1f ns\n", TEST_BENCH_LEN,
+           formatter * 1e9 / TEST_BENCH_ROUNDS, reference * 1e9 / TEST_BENCH_ROUNDS);
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
+#endif
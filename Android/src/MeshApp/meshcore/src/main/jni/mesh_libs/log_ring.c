@@ -0,0 +1,846 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+/** @file
+ *
+ * Deferred logging, see log_ring.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log_ring.h"
+#include "hex_dump.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#define LOG_RING_TLS                    __declspec(thread)
+#define LOG_RING_LOAD_ACQUIRE(p)        ((uint32_t)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define LOG_RING_STORE_RELEASE(p, v)    InterlockedExchange((volatile LONG *)(p), (LONG)(v))
+#define LOG_RING_INCREMENT(p)           InterlockedIncrement((volatile LONG *)(p))
+#define LOG_RING_EXCHANGE(p, v)         ((uint32_t)InterlockedExchange((volatile LONG *)(p), (LONG)(v)))
+#define LOG_RING_COUNT(p)               (*(volatile uint32_t *)(p) += 1)
+#define LOG_RING_LOAD_COUNT(p)          (*(volatile uint32_t *)(p))
+typedef SRWLOCK                         LOG_RING_MUTEX;
+#define LOG_RING_MUTEX_INIT             SRWLOCK_INIT
+#define LOG_RING_LOCK(p)                AcquireSRWLockExclusive(p)
+#define LOG_RING_UNLOCK(p)              ReleaseSRWLockExclusive(p)
+#else
+#include <pthread.h>
+#include <time.h>
+#define LOG_RING_TLS                    __thread
+#define LOG_RING_LOAD_ACQUIRE(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define LOG_RING_STORE_RELEASE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define LOG_RING_INCREMENT(p)           __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define LOG_RING_EXCHANGE(p, v)         __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#define LOG_RING_COUNT(p)               __atomic_store_n((p), *(p) + 1, __ATOMIC_RELAXED)
+#define LOG_RING_LOAD_COUNT(p)          __atomic_load_n((p), __ATOMIC_RELAXED)
+typedef pthread_mutex_t                 LOG_RING_MUTEX;
+#define LOG_RING_MUTEX_INIT             PTHREAD_MUTEX_INITIALIZER
+#define LOG_RING_LOCK(p)                pthread_mutex_lock(p)
+#define LOG_RING_UNLOCK(p)              pthread_mutex_unlock(p)
+#endif
+
+#define LOG_RING_MASK           (LOG_RING_SIZE - 1)
+#define LOG_RING_ALIGN(n)       (((n) + 7) & ~7u)
+#define LOG_RING_HEX_MAX        128     // bytes of a hex dump per record, written out as one block
+
+// Record types
+#define LOG_RING_REC_PAD        0       // fills the end of the buffer when a record does not fit there
+#define LOG_RING_REC_ARGS       1
+#define LOG_RING_REC_TEXT       2
+#define LOG_RING_REC_BYTES      3
+
+// Ring states, changed with log_ring_lock held
+#define LOG_RING_FREE           0
+#define LOG_RING_OWNED          1
+#define LOG_RING_EXITED         2       // owner thread is gone, the ring is freed once it is empty
+
+typedef struct
+{
+    uint16_t    size;                   /* bytes of the record with this header, multiple of 8 */
+    uint8_t     type;
+    uint8_t     count;                  /* args or bytes after the header */
+    uint32_t    reserved;
+    uint64_t    time_us;
+    const char *fmt;                    /* LOG_RING_REC_ARGS only */
+} LOG_RING_REC;
+
+// Records are packed at multiples of 8 bytes, the header must keep the payload aligned
+typedef char log_ring_rec_size_check[((sizeof(LOG_RING_REC) % 8) == 0) ? 1 : -1];
+
+typedef struct
+{
+    uint32_t    head;                   /* written by the owner thread only */
+    uint32_t    tail;                   /* written by the writer only */
+    uint32_t    thread;
+    uint32_t    state;
+    uint32_t    pad;                    /* bytes skipped at the end of the buffer by the record being written */
+    uint32_t    records;                /* counters of the owner thread, read by others with LOG_RING_LOAD_COUNT */
+    uint32_t    dropped;
+    uint32_t    truncated;
+    uint32_t    max_used;               /* updated by the writer */
+    uint64_t    buf[LOG_RING_SIZE / sizeof(uint64_t)];
+} LOG_RING;
+
+// Rings are never freed, a ring released by an exited thread is handed to the next new thread
+static LOG_RING            *log_ring_rings[LOG_RING_MAX_THREADS];
+static uint32_t             log_ring_allocated;
+static uint32_t             log_ring_threads;
+static uint32_t             log_ring_no_ring;
+static uint32_t             log_ring_dropped_reported;
+static uint32_t             log_ring_running;
+static uint32_t             log_ring_writer_idle;   // set while the writer sleeps, cleared by whoever wakes it
+static LOG_RING_OUTPUT     *log_ring_output;
+static LOG_RING_MUTEX       log_ring_lock = LOG_RING_MUTEX_INIT;        // rings array and ring states
+static LOG_RING_MUTEX       log_ring_drain_lock = LOG_RING_MUTEX_INIT;  // consumer side of all rings
+static LOG_RING_TLS LOG_RING *log_ring_own;
+
+extern uint64_t clock_SystemTimeMicroseconds64(void);
+
+static void log_ring_release(LOG_RING *p_ring)
+{
+    LOG_RING_LOCK(&log_ring_lock);
+    p_ring->state = LOG_RING_EXITED;
+    LOG_RING_UNLOCK(&log_ring_lock);
+}
+
+#if defined(_WIN32)
+static HANDLE               log_ring_thread;
+static HANDLE               log_ring_wake_event;
+static DWORD                log_ring_fls = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI log_ring_thread_exit(PVOID p_ring)
+{
+    if (p_ring != NULL)
+        log_ring_release((LOG_RING *)p_ring);
+}
+
+static void log_ring_set_exit_handler(LOG_RING *p_ring)
+{
+    if (log_ring_fls != FLS_OUT_OF_INDEXES)
+        FlsSetValue(log_ring_fls, p_ring);
+}
+#else
+static pthread_t            log_ring_thread;
+static pthread_key_t        log_ring_key;
+static int                  log_ring_key_created = 0;
+static pthread_mutex_t      log_ring_wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t       log_ring_wake_cond = PTHREAD_COND_INITIALIZER;
+static int                  log_ring_wake_pending = 0;
+
+static void log_ring_thread_exit(void *p_ring)
+{
+    log_ring_release((LOG_RING *)p_ring);
+}
+
+static void log_ring_set_exit_handler(LOG_RING *p_ring)
+{
+    if (log_ring_key_created)
+        pthread_setspecific(log_ring_key, p_ring);
+}
+#endif
+
+// Wakes the writer up before the end of its poll interval
+static void log_ring_wake(void)
+{
+#if defined(_WIN32)
+    SetEvent(log_ring_wake_event);
+#else
+    pthread_mutex_lock(&log_ring_wake_mutex);
+    log_ring_wake_pending = 1;
+    pthread_cond_signal(&log_ring_wake_cond);
+    pthread_mutex_unlock(&log_ring_wake_mutex);
+#endif
+}
+
+static void log_ring_sleep(void)
+{
+#if defined(_WIN32)
+    WaitForSingleObject(log_ring_wake_event, LOG_RING_WRITE_INTERVAL);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += LOG_RING_WRITE_INTERVAL * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&log_ring_wake_mutex);
+    if (!log_ring_wake_pending)
+        pthread_cond_timedwait(&log_ring_wake_cond, &log_ring_wake_mutex, &ts);
+    log_ring_wake_pending = 0;
+    pthread_mutex_unlock(&log_ring_wake_mutex);
+#endif
+}
+
+// Returns the ring of the calling thread, takes a free one on the first call
+static LOG_RING *log_ring_get(void)
+{
+    LOG_RING *p_ring = log_ring_own;
+    uint32_t  i;
+
+    if (p_ring != NULL)
+        return p_ring;
+
+    LOG_RING_LOCK(&log_ring_lock);
+
+    for (i = 0; i < log_ring_allocated; i++)
+    {
+        if (log_ring_rings[i]->state == LOG_RING_FREE)
+        {
+            p_ring = log_ring_rings[i];
+            break;
+        }
+    }
+    if ((p_ring == NULL) && (log_ring_allocated < LOG_RING_MAX_THREADS))
+    {
+        p_ring = (LOG_RING *)calloc(1, sizeof(LOG_RING));
+        if (p_ring != NULL)
+            log_ring_rings[log_ring_allocated++] = p_ring;
+    }
+    if (p_ring != NULL)
+    {
+        p_ring->state  = LOG_RING_OWNED;
+        p_ring->thread = ++log_ring_threads;
+    }
+
+    LOG_RING_UNLOCK(&log_ring_lock);
+
+    if (p_ring == NULL)
+    {
+        LOG_RING_INCREMENT(&log_ring_no_ring);
+        return NULL;
+    }
+
+    log_ring_set_exit_handler(p_ring);
+    log_ring_own = p_ring;
+    return p_ring;
+}
+
+// Returns where a record of up to size bytes goes, NULL when the ring is full
+static LOG_RING_REC *log_ring_reserve(LOG_RING *p_ring, uint32_t size)
+{
+    uint32_t      offset = p_ring->head & LOG_RING_MASK;
+    uint32_t      pad = (LOG_RING_SIZE - offset < size) ? LOG_RING_SIZE - offset : 0;
+    LOG_RING_REC *p_rec;
+
+    if (p_ring->head + pad + size - LOG_RING_LOAD_ACQUIRE(&p_ring->tail) > LOG_RING_SIZE)
+    {
+        LOG_RING_COUNT(&p_ring->dropped);
+        return NULL;
+    }
+
+    // Sizes are multiples of 8, so there is always room for the size and type of the pad record
+    if (pad != 0)
+    {
+        p_rec = (LOG_RING_REC *)((uint8_t *)p_ring->buf + offset);
+        p_rec->size = (uint16_t)pad;
+        p_rec->type = LOG_RING_REC_PAD;
+        offset = 0;
+    }
+    p_ring->pad = pad;
+
+    p_rec = (LOG_RING_REC *)((uint8_t *)p_ring->buf + offset);
+    p_rec->time_us = clock_SystemTimeMicroseconds64();
+    return p_rec;
+}
+
+// Publishes the record to the writer, size may be less than what was reserved
+static void log_ring_commit(LOG_RING *p_ring, LOG_RING_REC *p_rec, uint32_t size)
+{
+    uint32_t head = p_ring->head + p_ring->pad + size;
+
+    p_rec->size = (uint16_t)size;
+    LOG_RING_COUNT(&p_ring->records);
+    LOG_RING_STORE_RELEASE(&p_ring->head, head);
+
+    // A burst fills the ring faster than the poll interval, the first thread over the mark wakes the writer
+    if ((head - LOG_RING_LOAD_ACQUIRE(&p_ring->tail) >= LOG_RING_HIGH_WATER) &&
+        LOG_RING_LOAD_ACQUIRE(&log_ring_writer_idle) && LOG_RING_EXCHANGE(&log_ring_writer_idle, 0))
+        log_ring_wake();
+}
+
+// Commits a text record formatted in place, len is what vsnprintf returned
+static void log_ring_commit_text(LOG_RING *p_ring, LOG_RING_REC *p_rec, int len)
+{
+    if ((len < 0) || (len >= LOG_RING_TEXT_MAX))
+    {
+        LOG_RING_COUNT(&p_ring->truncated);
+        len = LOG_RING_TEXT_MAX - 1;
+        ((char *)(p_rec + 1))[len] = 0;
+    }
+    p_rec->type = LOG_RING_REC_TEXT;
+    log_ring_commit(p_ring, p_rec, LOG_RING_ALIGN(sizeof(LOG_RING_REC) + len + 1));
+}
+
+// Returns nonzero when fmt has a conversion that takes a pointer
+static int log_ring_fmt_has_pointer(const char *fmt)
+{
+    for ( ; *fmt != 0; fmt++)
+    {
+        if (*fmt != '%')
+            continue;
+
+        // Skip flags, width, precision and length to the conversion, %% is a conversion too
+        do
+            fmt++;
+        while ((*fmt != 0) && (strchr("-+ #0123456789.*hlLjztIwq", *fmt) != NULL));
+
+        if ((*fmt == 's') || (*fmt == 'S') || (*fmt == 'p') || (*fmt == 'n'))
+            return 1;
+        if (*fmt == 0)
+            break;
+    }
+    return 0;
+}
+
+int log_ring_args(const char *fmt, const uint32_t *p_args, uint32_t count)
+{
+    LOG_RING     *p_ring;
+    LOG_RING_REC *p_rec;
+    uint32_t      size;
+    uint32_t      args[LOG_RING_MAX_ARGS] = { 0 };
+
+    if (!LOG_RING_LOAD_ACQUIRE(&log_ring_running) || ((p_ring = log_ring_get()) == NULL))
+        return 0;
+
+    if (count > LOG_RING_MAX_ARGS)
+        count = LOG_RING_MAX_ARGS;
+
+    // A string or pointer arg may be gone by the time the writer runs, format it now
+    if (log_ring_fmt_has_pointer(fmt))
+    {
+        if ((p_rec = log_ring_reserve(p_ring, LOG_RING_ALIGN(sizeof(LOG_RING_REC) + LOG_RING_TEXT_MAX))) != NULL)
+        {
+            memcpy(args, p_args, count * sizeof(uint32_t));
+            log_ring_commit_text(p_ring, p_rec,
+                                 snprintf((char *)(p_rec + 1), LOG_RING_TEXT_MAX, fmt, args[0], args[1], args[2], args[3]));
+        }
+        return 1;
+    }
+
+    size = LOG_RING_ALIGN(sizeof(LOG_RING_REC) + count * sizeof(uint32_t));
+    if ((p_rec = log_ring_reserve(p_ring, size)) != NULL)
+    {
+        p_rec->type  = LOG_RING_REC_ARGS;
+        p_rec->count = (uint8_t)count;
+        p_rec->fmt   = fmt;
+        memcpy(p_rec + 1, p_args, count * sizeof(uint32_t));
+        log_ring_commit(p_ring, p_rec, size);
+    }
+    return 1;
+}
+
+int log_ring_vtext(const char *fmt, va_list ap)
+{
+    LOG_RING     *p_ring;
+    LOG_RING_REC *p_rec;
+    int           len;
+
+    if (!LOG_RING_LOAD_ACQUIRE(&log_ring_running) || ((p_ring = log_ring_get()) == NULL))
+        return 0;
+
+    if ((p_rec = log_ring_reserve(p_ring, LOG_RING_ALIGN(sizeof(LOG_RING_REC) + LOG_RING_TEXT_MAX))) != NULL)
+    {
+        len = vsnprintf((char *)(p_rec + 1), LOG_RING_TEXT_MAX, fmt, ap);
+        log_ring_commit_text(p_ring, p_rec, len);
+    }
+    return 1;
+}
+
+int log_ring_text(const char *p_text)
+{
+    LOG_RING     *p_ring;
+    LOG_RING_REC *p_rec;
+    size_t        len;
+
+    if (!LOG_RING_LOAD_ACQUIRE(&log_ring_running) || ((p_ring = log_ring_get()) == NULL))
+        return 0;
+
+    len = strlen(p_text);
+    if (len >= LOG_RING_TEXT_MAX)
+    {
+        LOG_RING_COUNT(&p_ring->truncated);
+        len = LOG_RING_TEXT_MAX - 1;
+    }
+    if ((p_rec = log_ring_reserve(p_ring, LOG_RING_ALIGN(sizeof(LOG_RING_REC) + (uint32_t)len + 1))) != NULL)
+    {
+        memcpy(p_rec + 1, p_text, len);
+        ((char *)(p_rec + 1))[len] = 0;
+        p_rec->type = LOG_RING_REC_TEXT;
+        log_ring_commit(p_ring, p_rec, LOG_RING_ALIGN(sizeof(LOG_RING_REC) + (uint32_t)len + 1));
+    }
+    return 1;
+}
+
+int log_ring_bytes(const uint8_t *p_data, uint32_t len)
+{
+    LOG_RING     *p_ring;
+    LOG_RING_REC *p_rec;
+    uint32_t      count, size;
+
+    if (!LOG_RING_LOAD_ACQUIRE(&log_ring_running) || ((p_ring = log_ring_get()) == NULL))
+        return 0;
+
+    for ( ; len != 0; len -= count, p_data += count)
+    {
+        count = (len < LOG_RING_HEX_MAX) ? len : LOG_RING_HEX_MAX;
+        size  = LOG_RING_ALIGN(sizeof(LOG_RING_REC) + count);
+        if ((p_rec = log_ring_reserve(p_ring, size)) == NULL)
+            continue;
+
+        p_rec->type  = LOG_RING_REC_BYTES;
+        p_rec->count = (uint8_t)count;
+        memcpy(p_rec + 1, p_data, count);
+        log_ring_commit(p_ring, p_rec, size);
+    }
+    return 1;
+}
+
+static void log_ring_write(const LOG_RING *p_ring, const LOG_RING_REC *p_rec)
+{
+    char            line[HEX_DUMP_TEXT_SIZE(LOG_RING_HEX_MAX)];
+    uint32_t        args[LOG_RING_MAX_ARGS] = { 0 };
+    const uint8_t  *p_data = (const uint8_t *)(p_rec + 1);
+    uint32_t        len;
+
+    switch (p_rec->type)
+    {
+    case LOG_RING_REC_ARGS:
+        memcpy(args, p_data, p_rec->count * sizeof(uint32_t));
+        snprintf(line, sizeof(line), p_rec->fmt, args[0], args[1], args[2], args[3]);
+        log_ring_output(p_rec->time_us, p_ring->thread, line);
+        break;
+
+    case LOG_RING_REC_TEXT:
+        log_ring_output(p_rec->time_us, p_ring->thread, (const char *)p_data);
+        break;
+
+    case LOG_RING_REC_BYTES:
+        // The output ends the text with a newline itself
+        len = hex_dump_format(line, sizeof(line), p_data, p_rec->count, HEX_DUMP_LINE_BYTES);
+        line[len - 1] = 0;
+        log_ring_output(p_rec->time_us, p_ring->thread, line);
+        break;
+    }
+}
+
+// Writes the records queued in all rings, oldest first, with log_ring_drain_lock held.
+// Returns the number of records written.
+static uint32_t log_ring_drain(void)
+{
+    LOG_RING       *p_rings[LOG_RING_MAX_THREADS];
+    uint32_t        heads[LOG_RING_MAX_THREADS];
+    uint32_t        i, count = 0, used, dropped = 0, written = 0;
+    LOG_RING       *p_ring;
+    LOG_RING_REC   *p_rec, *p_oldest;
+    int             oldest;
+    char            line[64];
+
+    LOG_RING_LOCK(&log_ring_lock);
+    for (i = 0; i < log_ring_allocated; i++)
+    {
+        p_ring = log_ring_rings[i];
+        dropped += LOG_RING_LOAD_COUNT(&p_ring->dropped);
+
+        // Only what was published before now is written, so a busy thread cannot keep the writer here
+        heads[count] = LOG_RING_LOAD_ACQUIRE(&p_ring->head);
+        used = heads[count] - p_ring->tail;
+        if (used > p_ring->max_used)
+            p_ring->max_used = used;
+
+        if (used != 0)
+            p_rings[count++] = p_ring;
+    }
+    LOG_RING_UNLOCK(&log_ring_lock);
+
+    for ( ; ; )
+    {
+        // Merge the rings on the time of their next record
+        oldest   = -1;
+        p_oldest = NULL;
+        for (i = 0; i < count; i++)
+        {
+            p_ring = p_rings[i];
+            while (p_ring->tail != heads[i])
+            {
+                p_rec = (LOG_RING_REC *)((uint8_t *)p_ring->buf + (p_ring->tail & LOG_RING_MASK));
+                if (p_rec->type != LOG_RING_REC_PAD)
+                {
+                    if ((p_oldest == NULL) || (p_rec->time_us < p_oldest->time_us))
+                    {
+                        oldest   = (int)i;
+                        p_oldest = p_rec;
+                    }
+                    break;
+                }
+                LOG_RING_STORE_RELEASE(&p_ring->tail, p_ring->tail + p_rec->size);
+            }
+        }
+        if (p_oldest == NULL)
+            break;
+
+        p_ring = p_rings[oldest];
+        log_ring_write(p_ring, p_oldest);
+        LOG_RING_STORE_RELEASE(&p_ring->tail, p_ring->tail + p_oldest->size);
+        written++;
+    }
+
+    // Rings of exited threads can go to new threads once everything they logged is out
+    LOG_RING_LOCK(&log_ring_lock);
+    for (i = 0; i < log_ring_allocated; i++)
+    {
+        p_ring = log_ring_rings[i];
+        if ((p_ring->state == LOG_RING_EXITED) && (p_ring->tail == LOG_RING_LOAD_ACQUIRE(&p_ring->head)))
+            p_ring->state = LOG_RING_FREE;
+    }
+    LOG_RING_UNLOCK(&log_ring_lock);
+
+    if (dropped != log_ring_dropped_reported)
+    {
+        snprintf(line, sizeof(line), "log ring: %u records dropped", dropped - log_ring_dropped_reported);
+        log_ring_output(clock_SystemTimeMicroseconds64(), 0, line);
+        log_ring_dropped_reported = dropped;
+    }
+    return written;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI log_ring_writer(LPVOID arg)
+#else
+static void *log_ring_writer(void *arg)
+#endif
+{
+    uint32_t written;
+
+    (void)arg;
+
+    while (LOG_RING_LOAD_ACQUIRE(&log_ring_running))
+    {
+        LOG_RING_LOCK(&log_ring_drain_lock);
+        written = log_ring_drain();
+        LOG_RING_UNLOCK(&log_ring_drain_lock);
+
+        if (written == 0)
+        {
+            LOG_RING_STORE_RELEASE(&log_ring_writer_idle, 1);
+            log_ring_sleep();
+            LOG_RING_STORE_RELEASE(&log_ring_writer_idle, 0);
+        }
+    }
+    return 0;
+}
+
+int log_ring_init(LOG_RING_OUTPUT *p_output)
+{
+    if (LOG_RING_LOAD_ACQUIRE(&log_ring_running))
+        return 0;
+
+    log_ring_output = p_output;
+    LOG_RING_STORE_RELEASE(&log_ring_running, 1);
+
+#if defined(_WIN32)
+    if (log_ring_fls == FLS_OUT_OF_INDEXES)
+        log_ring_fls = FlsAlloc(log_ring_thread_exit);
+    if (log_ring_wake_event == NULL)
+        log_ring_wake_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+    log_ring_thread = CreateThread(NULL, 0, log_ring_writer, NULL, 0, NULL);
+    if (log_ring_thread == NULL)
+    {
+        LOG_RING_STORE_RELEASE(&log_ring_running, 0);
+        return -1;
+    }
+#else
+    if (!log_ring_key_created)
+        log_ring_key_created = (pthread_key_create(&log_ring_key, log_ring_thread_exit) == 0);
+
+    if (pthread_create(&log_ring_thread, NULL, log_ring_writer, NULL) != 0)
+    {
+        LOG_RING_STORE_RELEASE(&log_ring_running, 0);
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+void log_ring_deinit(void)
+{
+    if (!LOG_RING_LOAD_ACQUIRE(&log_ring_running))
+        return;
+
+    LOG_RING_STORE_RELEASE(&log_ring_running, 0);
+
+    log_ring_wake();
+#if defined(_WIN32)
+    WaitForSingleObject(log_ring_thread, INFINITE);
+    CloseHandle(log_ring_thread);
+#else
+    pthread_join(log_ring_thread, NULL);
+#endif
+
+    LOG_RING_LOCK(&log_ring_drain_lock);
+    log_ring_drain();
+    LOG_RING_UNLOCK(&log_ring_drain_lock);
+}
+
+void log_ring_flush(void)
+{
+    if (!LOG_RING_LOAD_ACQUIRE(&log_ring_running))
+        return;
+
+    LOG_RING_LOCK(&log_ring_drain_lock);
+    log_ring_drain();
+    LOG_RING_UNLOCK(&log_ring_drain_lock);
+}
+
+void log_ring_get_stats(LOG_RING_STATS *p_stats)
+{
+    LOG_RING *p_ring;
+    uint32_t  i;
+
+    memset(p_stats, 0, sizeof(*p_stats));
+
+    LOG_RING_LOCK(&log_ring_lock);
+    for (i = 0; i < log_ring_allocated; i++)
+    {
+        p_ring = log_ring_rings[i];
+        p_stats->records   += LOG_RING_LOAD_COUNT(&p_ring->records);
+        p_stats->dropped   += LOG_RING_LOAD_COUNT(&p_ring->dropped);
+        p_stats->truncated += LOG_RING_LOAD_COUNT(&p_ring->truncated);
+        if (p_ring->max_used > p_stats->max_used)
+            p_stats->max_used = p_ring->max_used;
+    }
+    p_stats->threads = log_ring_threads;
+    p_stats->no_ring = LOG_RING_LOAD_ACQUIRE(&log_ring_no_ring);
+    LOG_RING_UNLOCK(&log_ring_lock);
+}
+
+#ifdef LOG_RING_UNIT_TEST
+// Several threads log numbered records, the output must show each thread's records in order with
+// nothing lost that was not counted as dropped. Bursts that fit in the rings and a steady rate
+// above what the writer polls for must not drop anything:
+//   gcc -O2 -DLOG_RING_UNIT_TEST log_ring.c hex_dump.c -lpthread
+#include <unistd.h>
+
+#define TEST_THREADS        4
+#define TEST_RECORDS        200000
+#define TEST_BURSTS         20
+#define TEST_BURST          1500    // records per thread and burst, 48 KB of each ring
+#define TEST_BURST_GAP      20      // ms between bursts
+#define TEST_RATE_RECORDS   100000
+#define TEST_RATE           500     // records per ms, a ring fills in 4 ms without the high water wakeup
+
+typedef struct
+{
+    uint32_t    id;
+    uint32_t    records;            /* records per burst */
+    uint32_t    bursts;
+    uint32_t    gap_us;             /* sleep after each burst */
+} test_producer_t;
+
+static uint32_t test_next[TEST_THREADS + 1];
+static uint32_t test_lines, test_bad;
+static char     test_last[LOG_RING_TEXT_MAX];
+static volatile int test_discard;
+
+uint64_t clock_SystemTimeMicroseconds64(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void test_output(uint64_t time_us, uint32_t thread, const char *p_text)
+{
+    unsigned int id, seq;
+
+    (void)time_us;
+    if (test_discard)
+        return;
+
+    test_lines++;
+    strcpy(test_last, p_text);
+
+    if ((thread != 0) && (sscanf(p_text, "producer %u seq %u", &id, &seq) == 2))
+    {
+        if ((id > TEST_THREADS) || (seq < test_next[id]))
+            test_bad++;
+        test_next[id] = seq + 1;
+    }
+}
+
+static void *test_producer(void *arg)
+{
+    test_producer_t *p = (test_producer_t *)arg;
+    uint32_t         args[2] = { p->id, 0 };
+    uint32_t         burst, i;
+
+    for (burst = 0; burst < p->bursts; burst++)
+    {
+        for (i = 0; i < p->records; i++, args[1]++)
+            log_ring_args("producer %u seq %u", args, 2);
+        if (p->gap_us != 0)
+            usleep(p->gap_us);
+    }
+    return NULL;
+}
+
+// Runs count producers and returns the records they lost
+static uint32_t test_run(uint32_t count, uint32_t records, uint32_t bursts, uint32_t gap_us)
+{
+    pthread_t       threads[TEST_THREADS];
+    test_producer_t producers[TEST_THREADS];
+    LOG_RING_STATS  stats;
+    uint32_t        dropped, i;
+
+    log_ring_flush();
+    log_ring_get_stats(&stats);
+    dropped = stats.dropped;
+
+    memset(test_next, 0, sizeof(test_next));
+    for (i = 0; i < count; i++)
+    {
+        producers[i].id      = i + 1;
+        producers[i].records = records;
+        producers[i].bursts  = bursts;
+        producers[i].gap_us  = gap_us;
+        pthread_create(&threads[i], NULL, test_producer, &producers[i]);
+    }
+    for (i = 0; i < count; i++)
+        pthread_join(threads[i], NULL);
+
+    log_ring_flush();
+    log_ring_get_stats(&stats);
+    return stats.dropped - dropped;
+}
+
+static double test_seconds(void)
+{
+    return clock_SystemTimeMicroseconds64() / 1000000.0;
+}
+
+int main(void)
+{
+    LOG_RING_STATS  stats;
+    uint32_t        args[4] = { 1, 2, 3, 4 }, lines, dropped, i;
+    uint8_t         bytes[20];
+    char            text[300];
+    double          start = 0, elapsed;
+    int             failed = 0;
+
+    // Only formats whose args are numbers may be deferred
+    if (log_ring_fmt_has_pointer("%u %x %08lX 100%%") || log_ring_fmt_has_pointer("%%s %") ||
+        !log_ring_fmt_has_pointer("%d %s") || !log_ring_fmt_has_pointer("%-20.*s") || !log_ring_fmt_has_pointer("at %p"))
+        failed = 1;
+
+    // Nothing is taken before the writer runs
+    if (log_ring_args("%u", args, 1) != 0 || log_ring_init(test_output) != 0)
+        failed = 1;
+
+    log_ring_args("%u %u %u %u", args, 4);
+    log_ring_flush();
+    if (strcmp(test_last, "1 2 3 4") != 0)
+        failed = 1;
+
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = 0;
+    log_ring_text(text);
+    log_ring_flush();
+    if (strlen(test_last) != LOG_RING_TEXT_MAX - 1)
+        failed = 1;
+
+    for (i = 0; i < sizeof(bytes); i++)
+        bytes[i] = (uint8_t)(0xf0 + i);
+    lines = test_lines;
+    log_ring_bytes(bytes, sizeof(bytes));
+    log_ring_flush();
+    if ((test_lines != lines + 1) || (strcmp(test_last, "f0 f1 f2 f3 f4 f5 f6 f7 f8 f9 fa fb fc fd fe ff\n00 01 02 03") != 0))
+        failed = 1;
+
+    // Bursts that fit in the rings, with the writer left to wake up on its own
+    dropped = test_run(TEST_THREADS, TEST_BURST, TEST_BURSTS, TEST_BURST_GAP * 1000);
+    printf("%u bursts of %u records from %u threads: %u dropped\n", TEST_BURSTS, TEST_BURST, TEST_THREADS, dropped);
+    if (dropped != 0 || test_bad)
+        failed = 1;
+
+    // A steady rate that fills a ring well within the poll interval
+    dropped = test_run(1, TEST_RATE, TEST_RATE_RECORDS / TEST_RATE, 1000);
+    printf("%u records at %u per ms: %u dropped\n", TEST_RATE_RECORDS, TEST_RATE, dropped);
+    if (dropped != 0 || test_bad)
+        failed = 1;
+
+    // Producers flood faster than the writer can format, twice so that the second round reuses
+    // the rings of the first. Records may drop, but none may be lost or reordered.
+    for (lines = 0; lines < 2; lines++)
+        test_run(TEST_THREADS, TEST_RECORDS, 1, 0);
+    log_ring_get_stats(&stats);
+    printf("records:%u dropped:%u truncated:%u threads:%u rings:%u max used:%u lines:%u\n", stats.records, stats.dropped,
+           stats.truncated, stats.threads, log_ring_allocated, stats.max_used, test_lines);
+    if (test_bad || stats.records + stats.dropped != 2 * TEST_THREADS * TEST_RECORDS + TEST_RATE_RECORDS +
+                                                     TEST_THREADS * TEST_BURSTS * TEST_BURST + 3 || stats.truncated != 1)
+        failed = 1;
+    if (stats.threads != 3 * TEST_THREADS + 2 || log_ring_allocated > TEST_THREADS + 1)
+        failed = 1;
+
+    // Producer side cost with the writer running, in bursts that fit in the ring
+    test_discard = 1;
+    elapsed = 0;
+    for (i = 0; i < 1000000; i++)
+    {
+        if ((i % 1000) == 0)
+        {
+            log_ring_flush();
+            start = test_seconds();
+        }
+        args[0] = i;
+        log_ring_args("%u", args, 1);
+        if ((i % 1000) == 999)
+            elapsed += test_seconds() - start;
+    }
+    printf("%.1f ns per record\n", elapsed * 1000.0);
+
+    log_ring_deinit();
+    if (log_ring_text("after") != 0)
+        failed = 1;
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+/** @file
+ *
+ * Deferred logging.
+ *
+ * ods() and the ble_trace functions used to format and write every line on the calling thread,
+ * which is often the timer thread or the receive path, sometimes with cs held. With the log ring
+ * running they only copy a record into a ring owned by the calling thread and return. A writer
+ * thread formats the records of all rings in time order and hands the lines to the platform
+ * output.
+ *
+ * Each ring has a single producer, its thread, and a single consumer, the writer, so a record
+ * costs a copy and one release store. The writer polls the rings and is woken up early when one
+ * of them is half full. A full ring drops the record and counts it, the writer reports drops in
+ * the log so that tracing can stay enabled without blocking the hot paths.
+ */
+#ifndef __LOG_RING_H__
+#define __LOG_RING_H__
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define LOG_RING_SIZE           65536   // bytes of the ring of each thread, power of two
+#define LOG_RING_HIGH_WATER     (LOG_RING_SIZE / 2) // bytes queued in one ring that wake the writer up early
+#define LOG_RING_MAX_THREADS    32      // threads with a ring, others log synchronously
+#define LOG_RING_TEXT_MAX       256     // longest text record, longer lines are truncated
+#define LOG_RING_MAX_ARGS       4
+#define LOG_RING_WRITE_INTERVAL 10      // ms the writer sleeps when all rings are empty, unless a ring reaches the high water mark
+
+typedef struct
+{
+    uint32_t    records;                /* records queued */
+    uint32_t    dropped;                /* records dropped because the ring of the thread was full */
+    uint32_t    truncated;              /* text records cut at LOG_RING_TEXT_MAX */
+    uint32_t    no_ring;                /* records logged synchronously because all rings were taken */
+    uint32_t    max_used;               /* most bytes waiting in one ring */
+    uint32_t    threads;                /* rings handed out */
+} LOG_RING_STATS;
+
+/* Writes one line. time_us is clock_SystemTimeMicroseconds64 when the line was logged and thread
+ * numbers the logging threads in the order they first logged. */
+typedef void (LOG_RING_OUTPUT)(uint64_t time_us, uint32_t thread, const char *p_text);
+
+/* Starts the writer thread, returns 0 on success. Safe to call again once started. */
+int  log_ring_init(LOG_RING_OUTPUT *p_output);
+
+/* Writes what is queued and stops the writer thread */
+void log_ring_deinit(void);
+
+/* Each returns 0 when the record was not taken, the writer is not running or no ring is left,
+ * and the caller then outputs the line itself. A dropped record counts as taken. */
+
+/* fmt is kept by pointer and formatted later with the args, it must be a string constant. A format
+ * with a %s or %p conversion is formatted now, its arg points to memory the caller may reuse. */
+int  log_ring_args(const char *fmt, const uint32_t *p_args, uint32_t count);
+
+/* Formats now and defers the output, ap is not used when 0 is returned */
+int  log_ring_vtext(const char *fmt, va_list ap);
+
+/* Copies the text */
+int  log_ring_text(const char *p_text);
+
+/* Queues a hex dump, 16 bytes per line, written out in blocks of up to 8 lines */
+int  log_ring_bytes(const uint8_t *p_data, uint32_t len);
+
+/* Writes everything queued so far before returning */
+void log_ring_flush(void);
+
+void log_ring_get_stats(LOG_RING_STATS *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__LOG_RING_H__
@@ -50,6 +50,11 @@
 #include "wiced_bt_mesh_provision.h"
 #include <pthread.h>
 #include <android/log.h>
+#include "timer_thread.h"
+#include "timer_stats.h"
+#include "log_ring.h"
+#include "hex_dump.h"
+#include "mesh_trace.h"
 
 
 typedef void (TIMER_CBACK)(void *p_tle);
@@ -65,28 +70,23 @@ typedef void (TIMER_CBACK)(void *p_tle);
 #define  LOGY(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG,__VA_ARGS__)
 
 //extern uint32_t SetTimer(uint32_t timer, uint32_t timeout);
-extern uint32_t start_timer(int32_t timeout,  uint16_t type);
-extern void stop_timer(uint32_t timer_id);
+
+#ifndef TIMER_STATS_DUMP_INTERVAL
+#define TIMER_STATS_DUMP_INTERVAL   60000   // ms between dumps of the timer statistics, 0 disables the dump
+#endif
 
 typedef struct _tle
 {
-    struct _tle  *p_next;
-    struct _tle  *p_prev;
+    TIMER_WHEEL_ENT wheel;              /* Link in the timer thread wheel, must be first */
     TIMER_CBACK  *p_cback;
-    uint32_t     idTimer;
-    uint32_t      timeout;
-    uint64_t      end_time;
     TIMER_PARAM_TYPE   param;
-    uint16_t        type;
+    uint32_t      timeout;              /* Timeout in ms, periodic timers are restarted with it */
+    uint8_t         type;
     uint8_t         in_use;
 } TIMER_LIST_ENT;
 
-typedef struct
-{
-    TIMER_LIST_ENT   *p_first;
-    TIMER_LIST_ENT   *p_last;
-    int             last_ticks;
-} TIMER_LIST_Q;
+// TIMER_LIST_ENT lives inside the wiced_timer_t allocated by the caller
+typedef char timer_list_ent_size_check[(sizeof(TIMER_LIST_ENT) <= sizeof(wiced_timer_t)) ? 1 : -1];
 
 typedef unsigned int        UINT32;
 typedef signed   int        INT32;
@@ -102,19 +102,37 @@ extern wiced_bool_t mesh_adv_scan_start(void);
 extern wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
     wiced_bt_ble_conn_mode_t conn_mode, wiced_bool_t is_direct);
 extern wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id);
-extern uint32_t restart_timer(uint32_t timeout, uint32_t timer_id);
 uint32_t SetTimer(uint32_t timer, uint32_t timeout);
 extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+extern void mesh_jni_timer_enter(void);
+extern void mesh_jni_timer_leave(void);
 
 void EnterCriticalSection();
 void LeaveCriticalSection();
 wiced_bool_t initTimer();
 
+// Writes one line of the log ring, logcat shows the writer thread so the logging thread goes in the text
+static void log_write(uint64_t time_us, uint32_t thread, const char *p_text)
+{
+    __android_log_print(ANDROID_LOG_INFO, LOG_TAG, "[%u] %s", thread, p_text);
+}
+
+void mesh_trace_init(void)
+{
+    log_ring_init(log_write);
+}
+
+void mesh_trace_deinit(void)
+{
+    log_ring_deinit();
+}
+
 void Log(const char *fmt, ...)
 {
     va_list ap;
     va_start(ap, fmt);
-    __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt, ap);
+    if (!log_ring_vtext(fmt, ap))
+        __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt, ap);
     va_end(ap);
 }
 
@@ -128,7 +146,8 @@ int wiced_printf(char * buffer, int len, char * fmt_str, ...)
 
     va_list ap;
     va_start(ap, fmt_str);
-    __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt_str, ap);
+    if (!log_ring_vtext(fmt_str, ap))
+        __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt_str, ap);
     va_end(ap);
 
     return 0;
@@ -137,7 +156,8 @@ int wiced_printf(char * buffer, int len, char * fmt_str, ...)
 void ods(char * fmt_str, ...) {
     va_list ap;
     va_start(ap, fmt_str);
-    __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt_str, ap);
+    if (!log_ring_vtext(fmt_str, ap))
+        __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt_str, ap);
     va_end(ap);
 }
 /**
@@ -147,27 +167,38 @@ void ods(char * fmt_str, ...) {
 */
 void ble_trace0(const char *p_str)
 {
-    Log(p_str,1);
+    if (!log_ring_text(p_str))
+        Log(p_str,1);
 }
 
+// The formats are string constants of the mesh core, the log ring keeps just the pointer and the args.
+// Formats with a %s are formatted right away, the string may be gone before the writer runs.
 void ble_trace1(const char *fmt_str, UINT32 p1)
 {
-    Log(fmt_str, p1);
+    UINT32 args[] = { p1 };
+    if (!log_ring_args(fmt_str, args, 1))
+        Log(fmt_str, p1);
 }
 
 void ble_trace2(const char *fmt_str, UINT32 p1, UINT32 p2)
 {
-    Log(fmt_str, p1, p2);
+    UINT32 args[] = { p1, p2 };
+    if (!log_ring_args(fmt_str, args, 2))
+        Log(fmt_str, p1, p2);
 }
 
 void ble_trace3(const char *fmt_str, UINT32 p1, UINT32 p2, UINT32 p3)
 {
-    Log((char *)fmt_str, p1, p2, p3);
+    UINT32 args[] = { p1, p2, p3 };
+    if (!log_ring_args(fmt_str, args, 3))
+        Log((char *)fmt_str, p1, p2, p3);
 }
 
 void ble_trace4(const char *fmt_str, UINT32 p1, UINT32 p2, UINT32 p3, UINT32 p4)
 {
-    Log((char *)fmt_str, p1, p2, p3, p4);
+    UINT32 args[] = { p1, p2, p3, p4 };
+    if (!log_ring_args(fmt_str, args, 4))
+        Log((char *)fmt_str, p1, p2, p3, p4);
 }
 //void Logn(uint8_t* data, int len)
 void ble_tracen(const char *p_str, UINT32 len)
@@ -180,7 +211,8 @@ void ble_tracen(const char *p_str, UINT32 len)
 //        LOGY("%x", *p_str);
 //        p_str++;
 //    }
-    Logn(p_str,len);
+    if (!log_ring_bytes((const uint8_t *)p_str, len))
+        Logn(p_str,len);
 }
 
 void* wiced_memory_allocate(UINT32 length)
@@ -243,12 +275,9 @@ uint64_t GetTickCount64()
 */
 uint64_t clock_SystemTimeMicroseconds64(void)
 {
-    uint64_t res =  1000 * GetTickCount64();
-    return res;
+    return timer_thread_get_time_us();
 }
 
-static wiced_timer_t *wiced_timer_first = NULL;
-
 void wiced_timer_handle(uint64_t timerid)
 {
     /*
@@ -292,20 +321,6 @@ void wiced_timer_handle(uint64_t timerid)
      */
 }
 
-TIMER_LIST_ENT *wiced_find_timer(uint32_t idTimer)
-{
-    //ods("wiced_find_timer finding ...timerid:%x \n", idTimer);
-    TIMER_LIST_ENT  *p_timer;
-    // got through each initialized timer
-    for (p_timer = (TIMER_LIST_ENT *)wiced_timer_first; p_timer != NULL; p_timer = (TIMER_LIST_ENT*)p_timer->p_next)
-    {
-        ods("wiced_find_timer:%x p_timer:%x\n", p_timer->idTimer, p_timer);
-        if (p_timer->idTimer == idTimer)
-            return p_timer;
-    }
-    return NULL;
-}
-
 wiced_result_t wiced_init_timer( wiced_timer_t* p_timer, wiced_timer_callback_t TimerCb,
                                  TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
 {
@@ -314,9 +329,8 @@ wiced_result_t wiced_init_timer( wiced_timer_t* p_timer, wiced_timer_callback_t
 
     pthread_mutex_lock(&cs);
     TIMER_LIST_ENT *p_cur;
-    Log("wiced_init_timer , type = %d " , type);
     TIMER_LIST_ENT *p = (TIMER_LIST_ENT *)p_timer;
-    ods("wiced_init_timer p_timer:%x\n", p_timer);
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_init_timer p_timer:%x type:%d\n", p_timer, type);
 
     memset(p_timer, 0, sizeof(TIMER_LIST_ENT));
     p->p_cback = TimerCb;
@@ -329,31 +343,32 @@ wiced_result_t wiced_init_timer( wiced_timer_t* p_timer, wiced_timer_callback_t
 }
 wiced_result_t wiced_deinit_timer(wiced_timer_t* p)
 {
-    ods("wiced_deinit_timer cback:%x\n", p);
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_deinit_timer cback:%x\n", p);
+    wiced_stop_timer(p);
     return WICED_BT_SUCCESS;
 
 }
 
 wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
 {
-    ods("wiced_start_timer with timeout:%d \n",timeout);
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
+
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_start_timer:%x timeout:%d\n", wt, timeout);
     EnterCriticalSection();
 
+    timer_stats_start(p_timer->p_cback, p_timer->in_use);
+
     // Make sure that we are not starting the same timer twice.
-    if (wiced_is_timer_in_use(wt))
-    wiced_stop_timer(wt);
+    if (p_timer->in_use)
+        timer_thread_remove(&p_timer->wheel);
 
-    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
     if (p_timer->type == WICED_SECONDS_TIMER || p_timer->type == WICED_SECONDS_PERIODIC_TIMER)
         timeout *= 1000;
     p_timer->timeout = timeout;
-    p_timer->idTimer = start_timer(timeout, p_timer->type);
+    p_timer->wheel.target_time = timer_thread_get_tick_count() + timeout;
+    timer_thread_add(&p_timer->wheel);
     p_timer->in_use = WICED_TRUE;
-    //ods("wiced_start_timer %x duration:%d\n", p_timer->idTimer, timeout);
-    //ods("MeshTimerFunc callback...assigned %x id:%x",p_timer->p_cback, p_timer->idTimer);
 
-    p_timer->p_next = (TIMER_LIST_ENT *)wiced_timer_first;
-    wiced_timer_first = (wiced_timer_t *)p_timer;
     LeaveCriticalSection();
     return WICED_BT_SUCCESS;
 
@@ -365,35 +380,16 @@ uint32_t SetTimer(uint32_t timer, uint32_t timeout) {
 
 wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
 {
-
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    TIMER_LIST_ENT *p_cur;
-    ods("wiced_stop_timer:%x\n", p_timer->idTimer);
+
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_stop_timer:%x\n", p_timer);
     EnterCriticalSection();
-    stop_timer( p_timer->idTimer);
-	p_timer->idTimer = 0;
-    p_timer->in_use = WICED_FALSE;
-// unlink the timer from the list
-    if (wiced_timer_first == wt)
+    if (p_timer->in_use)
     {
-        wiced_timer_first = (wiced_timer_t *)((TIMER_LIST_ENT *)wt)->p_next;
-        p_timer->p_next = NULL;
-        LeaveCriticalSection();
-        return WICED_BT_SUCCESS;
+        p_timer->in_use = WICED_FALSE;
+        timer_thread_remove(&p_timer->wheel);
+        timer_stats_stop(p_timer->p_cback);
     }
-
-    // got through each initialized timer
-    for (p_cur = (TIMER_LIST_ENT *)wiced_timer_first; p_cur != NULL; p_cur = (TIMER_LIST_ENT*)p_cur->p_next)
-    {
-        if (p_cur->p_next == p_timer)
-        {
-            p_cur->p_next = p_timer->p_next;
-            p_timer->p_next = NULL;
-            LeaveCriticalSection();
-            return WICED_BT_SUCCESS;
-        }
-    }
-    ods("!!! timer not found\n");
     LeaveCriticalSection();
     return WICED_BT_SUCCESS;
 }
@@ -401,7 +397,7 @@ wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
 wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)p;
-    if (p_timer->idTimer != 0)
+    if (p_timer->in_use)
     {
         return WICED_TRUE;
     }
@@ -411,37 +407,65 @@ wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p)
     }
 }
 
-void MeshTimerFunc(long timer_id)
+int mesh_timer_get_site_stats(TIMER_STATS_REPORT *p_report, int max_reports)
 {
+    int count;
+
     EnterCriticalSection();
-  //  ods("MeshTimerFunc start... %x",timer_id);
-    TIMER_LIST_ENT *p_timer = wiced_find_timer(timer_id);
-    if (p_timer != NULL)
+    count = timer_stats_query(p_report, max_reports);
+    LeaveCriticalSection();
+
+    return count;
+}
+
+#if TIMER_STATS_DUMP_INTERVAL
+// Checked each time a timer expires, so an idle client does not wake up just to dump
+static void mesh_timer_stats_dump(uint64_t now)
+{
+    static uint64_t           dump_time = 0;
+    static TIMER_STATS_REPORT report[TIMER_STATS_MAX_SITES + 1];
+
+    if (dump_time == 0)
+        dump_time = now + TIMER_STATS_DUMP_INTERVAL;
+    if (now < dump_time)
+        return;
+
+    dump_time = now + TIMER_STATS_DUMP_INTERVAL;
+    if (MESH_TRACE_ENABLED(MESH_TRACE_TIMER, MESH_TRACE_LEVEL_INFO))
+        timer_stats_print(report, timer_stats_query(report, TIMER_STATS_MAX_SITES + 1), ods);
+}
+#endif
+
+// Called by the timer thread with cs held
+static void MeshTimerFunc(TIMER_WHEEL_ENT *p_ent)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)p_ent;
+    uint64_t        now_us = timer_thread_get_time_us();
+
+    timer_stats_fired(p_timer->p_cback, p_ent->target_time * 1000, now_us);
+
+    if ((p_timer->type != WICED_SECONDS_PERIODIC_TIMER) && (p_timer->type != WICED_MILLI_SECONDS_PERIODIC_TIMER))
     {
-        if ((p_timer->type != WICED_SECONDS_PERIODIC_TIMER) && (p_timer->type != WICED_MILLI_SECONDS_PERIODIC_TIMER))
-        {
-            wiced_stop_timer((wiced_timer_t *)p_timer);
-        } else {
-            restart_timer(p_timer->timeout, p_timer->idTimer);
-        }
-        if (p_timer->p_cback)
-        {
-           // ods("MeshTimerFunc calling callback... %x",p_timer->p_cback);
-            p_timer->p_cback(p_timer->param);
-        }
+        p_timer->in_use = WICED_FALSE;
+    } else {
+        p_timer->wheel.target_time = timer_thread_get_tick_count() + p_timer->timeout;
+        timer_thread_add(&p_timer->wheel);
     }
-    else
+    if (p_timer->p_cback)
     {
-  //  ods("!!! Timer expired not found:%x\n", timer_id);
+        mesh_jni_timer_enter();
+        p_timer->p_cback(p_timer->param);
+        mesh_jni_timer_leave();
     }
-    LeaveCriticalSection();
-    ods("MeshTimerFunc end... %x",timer_id);
+#if TIMER_STATS_DUMP_INTERVAL
+    mesh_timer_stats_dump(now_us / 1000);
+#endif
 }
 
 
 void wiced_release_timer(wiced_bt_mesh_event_t *p_event)
 {
-    Log("release timer");
+    MESH_TRACE_DEBUG(MESH_TRACE_TIMER, "release timer");
  #if 0
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)&p_event->timer;
     if (p_timer->idTimer != 0)
@@ -510,7 +534,7 @@ wiced_bool_t wiced_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr,
     wiced_bt_ble_conn_mode_t conn_mode,
     wiced_bool_t is_direct)
 {
-    ods("wiced_bt_gatt_le_connect\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "wiced_bt_gatt_le_connect\n");
     return mesh_bt_gatt_le_connect(bd_addr, bd_addr_type, conn_mode, is_direct);
 }
 
@@ -551,82 +575,14 @@ wiced_bt_gatt_status_t wiced_bt_util_set_gatt_client_config_descriptor(uint16_t
 //#define LOG_TAG "MeshSecurity"
 
 
+static void Logn_write(const char *p_text, uint32_t len)
+{
+    __android_log_write(ANDROID_LOG_ERROR, LOG_TAG, p_text);
+}
+
 void Logn(uint8_t* data, int len)
 {
-    int count = 0;
-    int i;
-    for (i = 0; i < len; i += count){
-        count = len - i;
-        if (count >= 16) {
-            count = 16;
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12], data[13], data[14], data[15]);
-        }
-        else if (count == 15) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12], data[13], data[14]);
-        }
-        else if (count == 14) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12], data[13]);
-        }
-        else if (count == 13) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12]);
-        }
-        else if (count == 12) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11]);
-        }
-        else if (count == 11) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10]);
-        }
-        else if (count == 10) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3],
-                data[4],  data[5],  data[6],  data[7], data[8],  data[9]);
-        }
-        else if (count == 9) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3],
-                data[4],  data[5],  data[6],  data[7], data[8]);
-        }
-        else if (count == 8) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
-        }
-        else if (count == 7) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x",
-                data[0], data[1], data[2], data[3], data[4], data[5], data[6]);
-        }
-        else if (count == 6) {
-            LOGY("%02x %02x %02x %02x %02x %02x",
-                data[0], data[1], data[2], data[3], data[4], data[5]);
-        }
-        else if (count == 5) {
-            LOGY("%02x %02x %02x %02x %02x", data[0], data[1], data[2], data[3], data[4]);
-        }
-        else if (count == 4) {
-            LOGY("%02x %02x %02x %02x", data[0], data[1], data[2], data[3]);
-        }
-        else if (count == 3) {
-            LOGY("%02x %02x %02x", data[0], data[1], data[2]);
-        }
-        else if (count == 2) {
-            LOGY("%02x %02x", data[0], data[1]);
-        }
-        else {
-            LOGY("%02x", data[0]);
-        }
-        data += count;
-    }
+    hex_dump(data, (uint32_t)len, 0, Logn_write);
 }
 
 void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh_core_state_t *p_state)
@@ -662,6 +618,11 @@ wiced_bool_t initTimer()
             printf("\n mutex init has failed\n");
             return WICED_FALSE;
         }
+        if (timer_thread_init(&cs, MeshTimerFunc) != 0)
+        {
+            printf("\n timer thread init has failed\n");
+            return WICED_FALSE;
+        }
 
     }
     return WICED_TRUE;
@@ -41,6 +41,7 @@
 
 #include <android/log.h>
 #include <wiced.h>
+#include "timer_stats.h"
 
 #define WICED_BT_MESH_TRACE_ENABLE 1
 #define WICED_BT_TRACE_ENABLE
@@ -63,6 +64,15 @@ void wiced_bt_ble_set_scan_mode(uint8_t is_active);
 extern void mesh_adv_scan_stop(void);
 void Logn(uint8_t* data, int len);
 
+/* Starts and stops the writer thread of the deferred log. Until it is started, Log, ods and the
+ * ble_trace functions write each line to logcat on the calling thread. */
+void mesh_trace_init(void);
+void mesh_trace_deinit(void);
+
+/* Copies the start/stop counts and expiry lateness of up to max_reports timer callbacks, busiest
+ * first, and returns how many were copied. The same report is logged every TIMER_STATS_DUMP_INTERVAL ms. */
+int mesh_timer_get_site_stats(TIMER_STATS_REPORT *p_report, int max_reports);
+
 extern wiced_result_t mesh_transport_send_data( uint16_t opcode, uint8_t* p_data, uint16_t length );
 
 //extern void wiced_hci_process_data( uint16_t opcode, uint8_t* p_data, uint16_t length );
@@ -36,6 +36,8 @@
 * simple pairing algorithms implementation
 */
 
+// #define P256_UNIT_TEST
+
 #include "bt_target.h"
 #include "wiced_bt_app_common.h"
 
@@ -67,7 +69,7 @@ void CopyPoint(Point *q, Point *p)
 }
 
 
-// q=2q
+// q=2p, q may be p
 void ECC_Double(Point *q, Point *p, uint32_t keyLength)
 {
     DWORD t1[KEY_LENGTH_DWORDS_P256], t2[KEY_LENGTH_DWORDS_P256], t3[KEY_LENGTH_DWORDS_P256];
@@ -165,6 +167,72 @@ void ECC_Add(Point *r, Point *p, Point *q, uint32_t keyLength)
     MP_SubMod(y3, y3, z1, keyLength);
 }
 
+// p=p+(x2,y2) in place, (x2,y2) affine
+void ECC_AddMixed(Point *p, DWORD *x2, DWORD *y2, uint32_t keyLength)
+{
+    DWORD t1[KEY_LENGTH_DWORDS_P256], t2[KEY_LENGTH_DWORDS_P256];
+    DWORD t3[KEY_LENGTH_DWORDS_P256], t4[KEY_LENGTH_DWORDS_P256];
+    DWORD *x1, *y1, *z1;
+
+    x1=p->x; y1=p->y; z1=p->z;
+
+    // if P=infinity, return (x2,y2)
+    if(MP_isZero(z1, keyLength))
+    {
+        MP_Copy(x1, x2, keyLength);
+        MP_Copy(y1, y2, keyLength);
+        MP_Init(z1, keyLength);
+        z1[0]=1;
+        return;
+    }
+
+    MP_MersennsSquaMod(t1, z1, keyLength);      // t1=z1^2
+    MP_MersennsMultMod(t2, z1, t1, keyLength);  // t2=t1*z1
+    MP_MersennsMultMod(t1, x2, t1, keyLength);  // t1=t1*x2
+    MP_MersennsMultMod(t2, y2, t2, keyLength);  // t2=t2*y2
+
+    MP_SubMod(t1, t1, x1, keyLength);           // t1=t1-x1
+    MP_SubMod(t2, t2, y1, keyLength);           // t2=t2-y1
+
+    if(MP_isZero(t1, keyLength))
+    {
+        if(MP_isZero(t2, keyLength))
+            ECC_Double(p, p, keyLength);
+        else
+            MP_Init(z1, keyLength);             // return infinity
+        return;
+    }
+
+    MP_MersennsMultMod(z1, z1, t1, keyLength);  // z3=z1*t1
+    MP_MersennsSquaMod(t3, t1, keyLength);      // t3=t1^2
+    MP_MersennsMultMod(t4, t3, t1, keyLength);  // t4=t3*t1
+    MP_MersennsMultMod(t3, t3, x1, keyLength);  // t3=t3*x1
+    MP_LShiftMod(t1, t3, keyLength);            // t1=2*t3
+    MP_MersennsSquaMod(x1, t2, keyLength);      // x3=t2^2
+    MP_SubMod(x1, x1, t1, keyLength);           // x3=x3-t1
+    MP_SubMod(x1, x1, t4, keyLength);           // x3=x3-t4
+    MP_SubMod(t3, t3, x1, keyLength);           // t3=t3-x3
+    MP_MersennsMultMod(t3, t3, t2, keyLength);  // t3=t3*t2
+    MP_MersennsMultMod(t4, t4, y1, keyLength);  // t4=t4*y1
+    MP_SubMod(y1, t3, t4, keyLength);
+}
+
+
+// convert the Jacobian point q to affine x and y
+static void ECC_Affine(Point *q, uint32_t keyLength)
+{
+    DWORD zinv[KEY_LENGTH_DWORDS_P256];
+
+    MP_InvMod(zinv, q->z, keyLength);
+
+    MP_MersennsSquaMod(q->z, zinv, keyLength);
+    MP_MersennsMultMod(q->x, q->x, q->z, keyLength);
+
+    MP_MersennsMultMod(q->z, q->z, zinv, keyLength);
+
+    MP_MersennsMultMod(q->y, q->y, q->z, keyLength);
+}
+
 
 int isBitOne(DWORD *n, int i)
 {
@@ -218,7 +286,7 @@ void ECC_NAF(uint8_t *naf, uint32_t *NumNAF, DWORD *k, uint32_t keyLength)
 }
 
 // Binary NAF for point multiplication
-void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
+static void ECC_PM_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
 {
     int i;
     uint32_t sign;
@@ -275,14 +343,165 @@ void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
     }
 
 
-    MP_InvMod(minus_p.x, q->z, keyLength);
+    ECC_Affine(q, keyLength);
+}
 
-    MP_MersennsSquaMod(q->z, minus_p.x, keyLength);
-    MP_MersennsMultMod(q->x, q->x, q->z, keyLength);
+// Width WNAF_WIDTH NAF of k: odd digits in (-2^(w-1), 2^(w-1)), any two
+// nonzero digits at least w positions apart. Returns the number of digits.
+static uint32_t ECC_WNAF(int8_t *naf, DWORD *n, uint32_t keyLength)
+{
+    DWORD k[KEY_LENGTH_DWORDS_P256+1], c;
+    uint32_t i, j;
+    int d;
 
-    MP_MersennsMultMod(q->z, q->z, minus_p.x, keyLength);
+    MP_Copy(k, n, keyLength);
+    k[keyLength]=0;
 
-    MP_MersennsMultMod(q->y, q->y, q->z, keyLength);
+    for(i=0; !MP_isZero(k, keyLength+1); i++)
+    {
+        d = 0;
+        if(k[0] & 0x01)
+        {
+            d = k[0] & ((1 << WNAF_WIDTH) - 1);
+            if(d >= (1 << (WNAF_WIDTH - 1)))
+                d -= 1 << WNAF_WIDTH;
+
+            // k = k-d
+            if(d > 0)
+                k[0] -= d;
+            else
+                for(c=-d, j=0; c && j<=keyLength; j++)
+                {
+                    k[j] += c;
+                    c = (k[j] < c);
+                }
+        }
+        naf[i] = (int8_t)d;
+        MP_RShift(k, k, keyLength+1);
+    }
+    return i;
+}
+
+// t[i]=(2i+1)*p for i < WNAF_POINTS, as affine points. (2i+1)p is formed as
+// 2(ip)+p so every addition is mixed, then one batch inversion brings all
+// the points to z=1.
+static void ECC_OddMultiples(Point *t, Point *p, uint32_t keyLength)
+{
+    DWORD zinv[WNAF_POINTS][KEY_LENGTH_DWORDS_P256], zz[KEY_LENGTH_DWORDS_P256];
+    DWORD *z[WNAF_POINTS], *zi[WNAF_POINTS];
+    int i, j;
+
+    CopyPoint(&t[0], p);
+    MP_Init(t[0].z, keyLength);
+    t[0].z[0]=1;
+
+    for(i=1; i<WNAF_POINTS; i++)
+    {
+        // i*p from the largest odd multiple dividing it
+        for(j=i; !(j & 0x01); j>>=1)
+            ;
+        CopyPoint(&t[i], &t[j>>1]);
+        for( ; j<=i; j<<=1)
+            ECC_Double(&t[i], &t[i], keyLength);
+        ECC_AddMixed(&t[i], p->x, p->y, keyLength);
+    }
+
+    for(i=0; i<WNAF_POINTS; i++)
+    {
+        z[i] = t[i].z;
+        zi[i] = zinv[i];
+    }
+    MP_InvModBatch(zi, z, WNAF_POINTS, keyLength);
+
+    for(i=0; i<WNAF_POINTS; i++)
+    {
+        MP_MersennsSquaMod(zz, zi[i], keyLength);
+        MP_MersennsMultMod(t[i].x, t[i].x, zz, keyLength);
+        MP_MersennsMultMod(zz, zz, zi[i], keyLength);
+        MP_MersennsMultMod(t[i].y, t[i].y, zz, keyLength);
+        MP_Init(t[i].z, keyLength);
+        t[i].z[0]=1;
+    }
+}
+
+// Windowed NAF point multiplication q=n*p with a table of odd multiples of p
+void ECC_PM_W_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
+{
+    Point t[WNAF_POINTS];
+    DWORD minus_y[WNAF_POINTS][KEY_LENGTH_DWORDS_P256];
+    int8_t naf[KEY_LENGTH_DWORDS_P256*DWORD_BITS+1];
+    DWORD *modp;
+    int i, d;
+
+    if(keyLength == KEY_LENGTH_DWORDS_P256)
+    {
+        modp = curve_p256.p;
+    }
+    else
+    {
+        modp = curve.p;
+    }
+
+    MP_Init(p->z, keyLength);
+    p->z[0]=1;
+
+    ECC_OddMultiples(t, p, keyLength);
+    for(i=0; i<WNAF_POINTS; i++)
+        MP_Sub(minus_y[i], modp, t[i].y, keyLength);
+
+    InitPoint(q);
+    for(i=ECC_WNAF(naf, n, keyLength)-1; i>=0; i--)
+    {
+        ECC_Double(q, q, keyLength);
+
+        d = naf[i];
+        if(d > 0)
+            ECC_AddMixed(q, t[d>>1].x, t[d>>1].y, keyLength);
+        else if(d < 0)
+            ECC_AddMixed(q, t[(-d)>>1].x, minus_y[(-d)>>1], keyLength);
+    }
+
+    ECC_Affine(q, keyLength);
+}
+
+void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
+{
+    if(keyLength == KEY_LENGTH_DWORDS_P256)
+    {
+        // the generator has a precomputed table
+        if(!MP_CMP(p->x, curve_p256.G.x, keyLength) && !MP_CMP(p->y, curve_p256.G.y, keyLength))
+            ECC_PM_Comb_G(q, n);
+        else
+            ECC_PM_W_NAF(q, p, n, keyLength);
+    }
+    else
+        ECC_PM_NAF(q, p, n, keyLength);
+}
+
+// Fixed-base comb point multiplication q=n*G for P-256 (Lim-Lee). Column c
+// of the scalar is the bits c, c+COMB_SPACING, c+2*COMB_SPACING, ... and
+// p256_comb_G[i-1] holds sum(bit j of i * 2^(j*COMB_SPACING)) * G.
+void ECC_PM_Comb_G(Point *q, DWORD *n)
+{
+    uint32_t keyLength = KEY_LENGTH_DWORDS_P256;
+    uint32_t idx;
+    int c, j;
+
+    InitPoint(q);
+
+    for(c=COMB_SPACING-1; c>=0; c--)
+    {
+        ECC_Double(q, q, keyLength);
+
+        for(idx=0, j=0; j<COMB_TEETH; j++)
+            if(isBitOne(n, c+j*COMB_SPACING))
+                idx |= 1 << j;
+
+        if(idx)
+            ECC_AddMixed(q, (DWORD *)p256_comb_G[idx-1][0], (DWORD *)p256_comb_G[idx-1][1], keyLength);
+    }
+
+    ECC_Affine(q, keyLength);
 }
 
 
@@ -363,4 +582,375 @@ int mpConvFromHex(DWORD *a, int ndigits, const char *s)
         return n;
 }
 
+#ifdef P256_UNIT_TEST
+// Field multiplication against shift and add, Fermat and batch inversion
+// against the binary extended Euclid, the generator comb and the windowed
+// NAF against binary NAF, known answer tests for point multiplication (2G, 3G and the
+// Bluetooth Core LE Secure Connections sample keys) and timing of key
+// generation and shared secret computation. Build with -DP256_NO_LIMB64 for
+// the DWORD field code, or with -DP256_COMB_GEN to print p256_comb_G.
+#include <time.h>
+
+static uint32_t test_seed = 1;
+
+static DWORD test_rand(void)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 8) ^ (test_seed << 16);
+}
+
+static void test_hex(DWORD *a, const char *s)
+{
+    int i, j;
+
+    for(i=KEY_LENGTH_DWORDS_P256-1; i>=0; i--)
+        for(a[i]=0, j=0; j<8; j++, s++)
+            a[i] = (a[i] << 4) | (*s <= '9' ? *s - '0' : (*s | 0x20) - 'a' + 10);
+}
+
+// c=a*b mod p by shift and add, independent of either reduction
+static void test_mult_mod(DWORD *c, DWORD *a, DWORD *b)
+{
+    int i;
+
+    MP_Init(c, KEY_LENGTH_DWORDS_P256);
+    for(i=KEY_LENGTH_DWORDS_P256*DWORD_BITS-1; i>=0; i--)
+    {
+        MP_LShiftMod(c, c, KEY_LENGTH_DWORDS_P256);
+        if(isBitOne(b, i))
+            MP_AddMod(c, c, a, KEY_LENGTH_DWORDS_P256);
+    }
+}
+
+static int test_field(int rounds)
+{
+    DWORD a[KEY_LENGTH_DWORDS_P256], b[KEY_LENGTH_DWORDS_P256];
+    DWORD c[KEY_LENGTH_DWORDS_P256], r[KEY_LENGTH_DWORDS_P256];
+    int i, k, ok = 1;
+
+    for(k=0; k<rounds; k++)
+    {
+        for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+        {
+            // mostly random, with runs of all ones and zeros
+            a[i] = (k & 3) == 1 ? 0xFFFFFFFF : test_rand();
+            b[i] = (k & 7) == 2 && i < 4 ? 0 : test_rand();
+        }
+        if(k < 2)
+            MP_Copy(a, curve_p256.p, KEY_LENGTH_DWORDS_P256), a[0] -= k + 1;
+        if(MP_CMP(a, curve_p256.p, KEY_LENGTH_DWORDS_P256)>=0)
+            MP_Sub(a, a, curve_p256.p, KEY_LENGTH_DWORDS_P256);
+        if(MP_CMP(b, curve_p256.p, KEY_LENGTH_DWORDS_P256)>=0)
+            MP_Sub(b, b, curve_p256.p, KEY_LENGTH_DWORDS_P256);
+
+        test_mult_mod(r, a, b);
+        MP_MersennsMultMod(c, a, b, KEY_LENGTH_DWORDS_P256);
+        ok &= !MP_CMP(c, r, KEY_LENGTH_DWORDS_P256);
+
+        test_mult_mod(r, a, a);
+        MP_MersennsSquaMod(c, a, KEY_LENGTH_DWORDS_P256);
+        ok &= !MP_CMP(c, r, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("field mult matches reference  %s\n", ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static int test_inv(int rounds)
+{
+    DWORD a[16][KEY_LENGTH_DWORDS_P256], r[16][KEY_LENGTH_DWORDS_P256];
+    DWORD b[KEY_LENGTH_DWORDS_P256], c[KEY_LENGTH_DWORDS_P256], u[KEY_LENGTH_DWORDS_P256];
+    DWORD *pa[16], *pr[16];
+    int i, j, k, count, ok = 1, ok_batch = 1;
+
+    for(k=0; k<rounds; k++)
+    {
+        // random values below p, then 1, p-1 and 0
+        for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+            u[i] = test_rand();
+        if(MP_CMP(u, curve_p256.p, KEY_LENGTH_DWORDS_P256) >= 0)
+            MP_Sub(u, u, curve_p256.p, KEY_LENGTH_DWORDS_P256);
+        if(k < 3)
+            MP_Init(u, KEY_LENGTH_DWORDS_P256);
+        if(k == 0)
+            u[0] = 1;
+        if(k == 1)
+            MP_Sub(u, curve_p256.p, a[0], KEY_LENGTH_DWORDS_P256);     // a[0] is 1 from k=0
+
+        MP_Copy(a[0], u, KEY_LENGTH_DWORDS_P256);
+        MP_InvMod_P256(b, u);
+        ok &= !MP_CMP(u, a[0], KEY_LENGTH_DWORDS_P256);
+        MP_InvMod_Euclid(c, u, KEY_LENGTH_DWORDS_P256);
+        ok &= !MP_CMP(b, c, KEY_LENGTH_DWORDS_P256);
+        if(k != 2)
+        {
+            MP_MersennsMultMod(c, a[0], b, KEY_LENGTH_DWORDS_P256);
+            ok &= c[0] == 1 && MP_MostSignBits(c, KEY_LENGTH_DWORDS_P256) == 1;
+        }
+        if(k == 0)
+            MP_Copy(a[0], b, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("Fermat inverse matches Euclid %s\n", ok ? "pass" : "FAIL");
+
+    for(k=0; k<rounds/10; k++)
+    {
+        // batches of 1 to 16 with some zeros
+        count = 1 + test_rand() % 16;
+        for(j=0; j<count; j++)
+        {
+            for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+                a[j][i] = (test_rand() % 5) ? test_rand() : 0;
+            a[j][KEY_LENGTH_DWORDS_P256-1] >>= 1;
+            if(test_rand() % 6 == 0)
+                MP_Init(a[j], KEY_LENGTH_DWORDS_P256);
+            pa[j] = a[j];
+            pr[j] = r[j];
+        }
+        MP_InvModBatch(pr, pa, count, KEY_LENGTH_DWORDS_P256);
+        for(j=0; j<count; j++)
+        {
+            MP_Copy(u, a[j], KEY_LENGTH_DWORDS_P256);
+            MP_InvMod_Euclid(c, u, KEY_LENGTH_DWORDS_P256);
+            ok_batch &= !MP_CMP(r[j], c, KEY_LENGTH_DWORDS_P256);
+        }
+    }
+    printf("batch inverse                 %s\n", ok_batch ? "pass" : "FAIL");
+    return ok && ok_batch;
+}
+
+static int test_point(const char *name, Point *p, const char *k, const char *x, const char *y)
+{
+    DWORD n[KEY_LENGTH_DWORDS_P256], ex[KEY_LENGTH_DWORDS_P256], ey[KEY_LENGTH_DWORDS_P256];
+    Point q;
+    int ok;
+
+    test_hex(n, k);
+    test_hex(ex, x);
+    if(y)
+        test_hex(ey, y);
+    ECC_PM(&q, p, n, KEY_LENGTH_DWORDS_P256);
+    ok = !MP_CMP(q.x, ex, KEY_LENGTH_DWORDS_P256) && (!y || !MP_CMP(q.y, ey, KEY_LENGTH_DWORDS_P256));
+    printf("%-29s %s\n", name, ok ? "pass" : "FAIL");
+    return ok;
+}
+
+// the comb table from doublings and additions alone, as affine points
+static void test_comb_table(Point *t)
+{
+    Point p, r, s;
+    int i, j, top;
+
+    CopyPoint(&p, &curve_p256.G);
+    MP_Init(p.z, KEY_LENGTH_DWORDS_P256);
+    p.z[0] = 1;
+    for(j=0; j<COMB_TEETH; j++)
+    {
+        CopyPoint(&t[(1 << j) - 1], &p);
+        for(i=0; i<COMB_SPACING; i++)
+        {
+            CopyPoint(&r, &p);
+            ECC_Double(&p, &r, KEY_LENGTH_DWORDS_P256);
+        }
+        ECC_Affine(&p, KEY_LENGTH_DWORDS_P256);
+        MP_Init(p.z, KEY_LENGTH_DWORDS_P256);
+        p.z[0] = 1;
+    }
+
+    for(i=1; i<=COMB_POINTS; i++)
+    {
+        for(top=COMB_TEETH-1; !(i & (1 << top)); top--)
+            ;
+        if(i == (1 << top))
+            continue;
+        CopyPoint(&s, &t[(i ^ (1 << top)) - 1]);
+        ECC_Add(&t[i-1], &s, &t[(1 << top) - 1], KEY_LENGTH_DWORDS_P256);
+        ECC_Affine(&t[i-1], KEY_LENGTH_DWORDS_P256);
+        MP_Init(t[i-1].z, KEY_LENGTH_DWORDS_P256);
+        t[i-1].z[0] = 1;
+    }
+}
+
+#ifdef P256_COMB_GEN
+// print p256_comb_G for p_256_curvepara.c
+static void test_comb_print(Point *t)
+{
+    int i, j;
+
+    printf("const DWORD p256_comb_G[COMB_POINTS][2][KEY_LENGTH_DWORDS_P256] =\n{\n");
+    for(i=0; i<COMB_POINTS; i++)
+    {
+        printf("    {{");
+        for(j=0; j<KEY_LENGTH_DWORDS_P256; j++)
+            printf("0x%08x%s", (unsigned int)t[i].x[j], j < KEY_LENGTH_DWORDS_P256-1 ? ", " : "},\n     {");
+        for(j=0; j<KEY_LENGTH_DWORDS_P256; j++)
+            printf("0x%08x%s", (unsigned int)t[i].y[j], j < KEY_LENGTH_DWORDS_P256-1 ? ", " : "}},\n");
+    }
+    printf("};\n");
+}
+#endif
+
+// the table, and the comb against binary NAF: k*G by comb, (k/2)*2G by NAF
+static int test_comb(int rounds)
+{
+    static Point t[COMB_POINTS];
+    DWORD n[KEY_LENGTH_DWORDS_P256], h[KEY_LENGTH_DWORDS_P256];
+    Point g2, q, r;
+    int i, k, ok = 1;
+
+    test_comb_table(t);
+    for(i=0; i<COMB_POINTS; i++)
+        ok &= !MP_CMP(t[i].x, (DWORD *)p256_comb_G[i][0], KEY_LENGTH_DWORDS_P256) &&
+              !MP_CMP(t[i].y, (DWORD *)p256_comb_G[i][1], KEY_LENGTH_DWORDS_P256);
+    printf("comb table                    %s\n", ok ? "pass" : "FAIL");
+
+    CopyPoint(&g2, &t[0]);
+    CopyPoint(&r, &g2);
+    ECC_Double(&g2, &r, KEY_LENGTH_DWORDS_P256);
+    ECC_Affine(&g2, KEY_LENGTH_DWORDS_P256);
+
+    for(k=0; k<rounds; k++)
+    {
+        for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+            n[i] = test_rand();
+        n[0] &= ~1;
+        n[KEY_LENGTH_DWORDS_P256-1] >>= 1;
+        if(k == 0)
+            MP_Init(n, KEY_LENGTH_DWORDS_P256), n[0] = 2;
+        MP_RShift(h, n, KEY_LENGTH_DWORDS_P256);
+
+        ECC_PM_Comb_G(&q, n);
+        ECC_PM_NAF(&r, &g2, h, KEY_LENGTH_DWORDS_P256);
+        ok &= !MP_CMP(q.x, r.x, KEY_LENGTH_DWORDS_P256) && !MP_CMP(q.y, r.y, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("comb matches binary NAF       %s\n", ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static int test_wnaf(int rounds)
+{
+    DWORD n[KEY_LENGTH_DWORDS_P256];
+    Point p, q, r;
+    int i, k, ok = 1;
+
+    // 2^256-1 carries out of the top word while recoding; binary NAF cannot
+    // take it, the comb can
+    BT_MEMSET(n, 0xff, sizeof(n));
+    CopyPoint(&p, &curve_p256.G);
+    ECC_PM_W_NAF(&q, &p, n, KEY_LENGTH_DWORDS_P256);
+    ECC_PM_Comb_G(&r, n);
+    ok &= !MP_CMP(q.x, r.x, KEY_LENGTH_DWORDS_P256) && !MP_CMP(q.y, r.y, KEY_LENGTH_DWORDS_P256);
+
+    for(k=0; k<rounds; k++)
+    {
+        // random point, then scalars of every length including 0 and 1
+        for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+            n[i] = test_rand();
+        ECC_PM_Comb_G(&p, n);
+
+        for(i=0; i<KEY_LENGTH_DWORDS_P256; i++)
+            n[i] = (i <= k % KEY_LENGTH_DWORDS_P256) ? test_rand() : 0;
+        n[KEY_LENGTH_DWORDS_P256-1] >>= 1;
+        if(k < 2)
+            MP_Init(n, KEY_LENGTH_DWORDS_P256), n[0] = k;
+
+        ECC_PM_W_NAF(&q, &p, n, KEY_LENGTH_DWORDS_P256);
+        ECC_PM_NAF(&r, &p, n, KEY_LENGTH_DWORDS_P256);
+        ok &= !MP_CMP(q.x, r.x, KEY_LENGTH_DWORDS_P256) && !MP_CMP(q.y, r.y, KEY_LENGTH_DWORDS_P256);
+    }
+    printf("wNAF matches binary NAF       %s\n", ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static const char priv_a[] = "3f49f6d4a3c55f3874c9b3e3d2103f504aff607beb40b7995899b8a6cd3c1abd";
+static const char priv_b[] = "55188b3d32f6bb9a900afcfbeed4e72a59cb9ac2f19d7cfb6b4fdd49f47fc5fd";
+static const char pub_b_x[] = "1ea1f0f01faf1d9609592284f19e4c0047b58afd8615a69f559077b22faaa190";
+static const char pub_b_y[] = "4c55f33e429dad377356703a9ab85160472d1130e28e36765f89aff915b1214a";
+
+static void test_speed(const char *name, Point *p, const char *k,
+                       void (*pm)(Point *, Point *, DWORD *, uint32_t))
+{
+    DWORD n[KEY_LENGTH_DWORDS_P256];
+    Point q;
+    int i, count = 200;
+    clock_t t = clock();
+
+    for(i=0; i<count; i++)
+    {
+        test_hex(n, k);
+        pm(&q, p, n, KEY_LENGTH_DWORDS_P256);
+    }
+    t = clock() - t;
+    printf("%-20s %8.1f us\n", name, (double)t * 1e6 / CLOCKS_PER_SEC / count);
+}
+
+static void test_speed_inv(const char *name, void (*inv)(DWORD *, DWORD *, uint32_t))
+{
+    DWORD a[16][KEY_LENGTH_DWORDS_P256], b[KEY_LENGTH_DWORDS_P256], u[KEY_LENGTH_DWORDS_P256];
+    int i, count = 2000;
+    clock_t t;
+
+    test_seed = 1;
+    for(i=0; i<16*KEY_LENGTH_DWORDS_P256; i++)
+        a[i / KEY_LENGTH_DWORDS_P256][i % KEY_LENGTH_DWORDS_P256] = test_rand();
+
+    t = clock();
+    for(i=0; i<count; i++)
+    {
+        MP_Copy(u, a[i % 16], KEY_LENGTH_DWORDS_P256);
+        inv(b, u, KEY_LENGTH_DWORDS_P256);
+    }
+    t = clock() - t;
+    printf("%-20s %8.1f us\n", name, (double)t * 1e6 / CLOCKS_PER_SEC / count);
+}
+
+int main()
+{
+    Point g, pub_b;
+    int ok;
+
+    p_256_init_curve(KEY_LENGTH_DWORDS_P256);
+#ifdef P256_COMB_GEN
+    {
+        static Point t[COMB_POINTS];
+
+        test_comb_table(t);
+        test_comb_print(t);
+        return 0;
+    }
+#endif
+#ifdef P256_NO_LIMB64
+    printf("DWORD field code\n");
+#endif
+    ok = test_field(20000);
+    ok &= test_inv(2000);
+    ok &= test_comb(500);
+    ok &= test_wnaf(500);
+
+    CopyPoint(&g, &curve_p256.G);
+    ok &= test_point("2G", &g,
+                     "0000000000000000000000000000000000000000000000000000000000000002",
+                     "7cf27b188d034f7e8a52380304b51ac3c08969e277f21b35a60b48fc47669978",
+                     "07775510db8ed040293d9ac69f7430dbba7dade63ce982299e04b79d227873d1");
+    ok &= test_point("3G", &g,
+                     "0000000000000000000000000000000000000000000000000000000000000003",
+                     "5ecbe4d1a6330a44c8f7ef951d4bf165e6c6b721efada985fb41661bc6e7fd6c",
+                     "8734640c4998ff7e374b06ce1a64a2ecd82ab036384fb83d9a79b127a27d5032");
+    ok &= test_point("LE SC public key A", &g, priv_a,
+                     "20b003d2f297be2c5e2c83a7e9f9a5b9eff49111acf4fddbcc0301480e359de6",
+                     "dc809c49652aeb6d63329abf5a52155c766345c28fed3024741c8ed01589d28b");
+    ok &= test_point("LE SC public key B", &g, priv_b, pub_b_x, pub_b_y);
+
+    test_hex(pub_b.x, pub_b_x);
+    test_hex(pub_b.y, pub_b_y);
+    ok &= test_point("LE SC DHKey", &pub_b, priv_a,
+                     "ec0234a357c8ad05341010a60a397d9b99796b13b4f866f1868d34f373bfa698", NULL);
+
+    test_speed("key generation", &g, priv_a, ECC_PM_B_NAF);
+    test_speed("shared secret", &pub_b, priv_a, ECC_PM_B_NAF);
+    test_speed("  binary NAF", &pub_b, priv_a, ECC_PM_NAF);
+    test_speed_inv("inversion", MP_InvMod);
+    test_speed_inv("  Euclid", MP_InvMod_Euclid);
+    return ok ? 0 : 1;
+}
+#endif
+
 #endif
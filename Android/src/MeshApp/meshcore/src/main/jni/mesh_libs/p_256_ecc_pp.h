@@ -43,6 +43,11 @@
 
 #define width 4
 
+// Windowed NAF for variable base points: odd digits below 2^(WNAF_WIDTH-1)
+// select one of WNAF_POINTS precomputed odd multiples of the point
+#define WNAF_WIDTH      5
+#define WNAF_POINTS     (1 << (WNAF_WIDTH - 2))
+
 struct _point
 {
     DWORD x[KEY_LENGTH_DWORDS_P256];
@@ -71,14 +76,26 @@ typedef struct
 
 }EC;
 
+// Fixed-base comb for the P-256 generator: COMB_TEETH bits of the scalar,
+// COMB_SPACING bits apart, select one of the (2^COMB_TEETH)-1 precomputed
+// affine points in p256_comb_G, so k*G takes COMB_SPACING doublings and
+// additions
+#define COMB_TEETH      8
+#define COMB_SPACING    (256 / COMB_TEETH)
+#define COMB_POINTS     ((1 << COMB_TEETH) - 1)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 extern EC curve;
 extern EC curve_p256;
+extern const DWORD p256_comb_G[COMB_POINTS][2][KEY_LENGTH_DWORDS_P256];
 
 void ECC_PM_B_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength);
+void ECC_PM_Comb_G(Point *q, DWORD *n);
+void ECC_PM_W_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength);
+void ECC_AddMixed(Point *p, DWORD *x2, DWORD *y2, uint32_t keyLength);
 
 #define ECC_PM(q, p, n, keyLength)  ECC_PM_B_NAF(q, p, n, keyLength)
 
@@ -64,6 +64,9 @@ uint32_t MP_DWORDBits (DWORD a);
 uint32_t MP_MostSignDWORDs(DWORD *a, uint32_t keyLength);
 uint32_t MP_MostSignBits(DWORD *a, uint32_t keyLength);
 void MP_InvMod(DWORD *aminus, DWORD *a, uint32_t keyLength);
+void MP_InvMod_Euclid(DWORD *aminus, DWORD *u, uint32_t keyLength);
+void MP_InvMod_P256(DWORD *aminus, DWORD *a);
+void MP_InvModBatch(DWORD *aminus[], DWORD *a[], uint32_t count, uint32_t keyLength);
 
 DWORD MP_Add(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);           // c=a+b
 void MP_AddMod(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);
@@ -75,6 +78,7 @@ DWORD MP_LShift(DWORD * c, DWORD * a, uint32_t keyLength);                // c=a
 void MP_Mult(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);           // c=a*b
 void MP_MersennsMultMod(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);
 void MP_MersennsSquaMod(DWORD *c, DWORD *a, uint32_t keyLength);
+void MP_Squa(DWORD *c, DWORD *a, uint32_t keyLength);                    // c=a^2
 DWORD MP_LShift(DWORD * c, DWORD * a, uint32_t keyLength);
 void MP_Mult(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength);
 void MP_FastMod(DWORD *c, DWORD *a);
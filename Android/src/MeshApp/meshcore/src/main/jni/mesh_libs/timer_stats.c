@@ -0,0 +1,322 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Timer latency statistics, see timer_stats.h.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "timer_stats.h"
+
+#define TIMER_STATS_LINEAR          16      // one bucket per us below this
+#define TIMER_STATS_SUB_BITS        3       // 8 buckets per power of two above
+#define TIMER_STATS_SUB_MASK        ((1 << TIMER_STATS_SUB_BITS) - 1)
+#define TIMER_STATS_FIRST_OCTAVE    4       // log2(TIMER_STATS_LINEAR)
+#define TIMER_STATS_BUCKETS         (TIMER_STATS_LINEAR + ((32 - TIMER_STATS_FIRST_OCTAVE) << TIMER_STATS_SUB_BITS))
+
+typedef struct
+{
+    void       *p_cback;
+    uint32_t    starts;
+    uint32_t    restarts;
+    uint32_t    stops;
+    uint32_t    fired;
+    uint32_t    max_us;
+    uint32_t    histogram[TIMER_STATS_BUCKETS];
+} TIMER_STATS_SITE;
+
+// Open addressing on the callback address, the extra last entry collects the sites that did not fit
+static TIMER_STATS_SITE timer_stats_sites[TIMER_STATS_MAX_SITES + 1];
+
+static TIMER_STATS_SITE *timer_stats_find(void *p_cback)
+{
+    uint32_t hash = (uint32_t)(((uintptr_t)p_cback >> 2) * 2654435761u);
+    int      i, index;
+
+    if (p_cback == NULL)
+        return &timer_stats_sites[TIMER_STATS_MAX_SITES];
+
+    for (i = 0; i < TIMER_STATS_MAX_SITES; i++)
+    {
+        index = (hash + i) % TIMER_STATS_MAX_SITES;
+        if (timer_stats_sites[index].p_cback == p_cback)
+            return &timer_stats_sites[index];
+        if (timer_stats_sites[index].p_cback == NULL)
+        {
+            timer_stats_sites[index].p_cback = p_cback;
+            return &timer_stats_sites[index];
+        }
+    }
+    return &timer_stats_sites[TIMER_STATS_MAX_SITES];
+}
+
+static int timer_stats_bucket(uint32_t us)
+{
+    int octave = TIMER_STATS_FIRST_OCTAVE;
+
+    if (us < TIMER_STATS_LINEAR)
+        return (int)us;
+
+    while ((us >> octave) > 1)
+        octave++;
+
+    return TIMER_STATS_LINEAR + ((octave - TIMER_STATS_FIRST_OCTAVE) << TIMER_STATS_SUB_BITS) +
+           (int)((us >> (octave - TIMER_STATS_SUB_BITS)) & TIMER_STATS_SUB_MASK);
+}
+
+// Largest lateness that goes in the bucket
+static uint32_t timer_stats_bucket_max(int bucket)
+{
+    int      octave, sub;
+    uint32_t width;
+
+    if (bucket < TIMER_STATS_LINEAR)
+        return (uint32_t)bucket;
+
+    octave = TIMER_STATS_FIRST_OCTAVE + ((bucket - TIMER_STATS_LINEAR) >> TIMER_STATS_SUB_BITS);
+    sub    = (bucket - TIMER_STATS_LINEAR) & TIMER_STATS_SUB_MASK;
+    width  = (uint32_t)1 << (octave - TIMER_STATS_SUB_BITS);
+
+    return ((uint32_t)1 << octave) + (uint32_t)sub * width + (width - 1);
+}
+
+// Lateness below which percent of the expiries fall
+static uint32_t timer_stats_percentile(const TIMER_STATS_SITE *p_site, uint32_t percent)
+{
+    uint64_t rank = ((uint64_t)p_site->fired * percent + 99) / 100;
+    uint64_t total = 0;
+    uint32_t value;
+    int      i;
+
+    if (rank == 0)
+        return 0;
+
+    for (i = 0; i < TIMER_STATS_BUCKETS; i++)
+    {
+        total += p_site->histogram[i];
+        if (total >= rank)
+            break;
+    }
+    value = timer_stats_bucket_max(i < TIMER_STATS_BUCKETS ? i : TIMER_STATS_BUCKETS - 1);
+    return (value < p_site->max_us) ? value : p_site->max_us;
+}
+
+void timer_stats_start(void *p_cback, int restart)
+{
+    TIMER_STATS_SITE *p_site = timer_stats_find(p_cback);
+
+    if (restart)
+        p_site->restarts++;
+    else
+        p_site->starts++;
+}
+
+void timer_stats_stop(void *p_cback)
+{
+    timer_stats_find(p_cback)->stops++;
+}
+
+void timer_stats_fired(void *p_cback, uint64_t deadline_us, uint64_t now_us)
+{
+    TIMER_STATS_SITE *p_site = timer_stats_find(p_cback);
+    uint64_t          late = (now_us > deadline_us) ? now_us - deadline_us : 0;
+    uint32_t          late_us = (late > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)late;
+
+    p_site->fired++;
+    p_site->histogram[timer_stats_bucket(late_us)]++;
+    if (late_us > p_site->max_us)
+        p_site->max_us = late_us;
+}
+
+void timer_stats_reset(void)
+{
+    memset(timer_stats_sites, 0, sizeof(timer_stats_sites));
+}
+
+static int timer_stats_compare(const void *p1, const void *p2)
+{
+    const TIMER_STATS_REPORT *p_r1 = (const TIMER_STATS_REPORT *)p1;
+    const TIMER_STATS_REPORT *p_r2 = (const TIMER_STATS_REPORT *)p2;
+    uint32_t                  ops1 = p_r1->fired + p_r1->starts + p_r1->restarts;
+    uint32_t                  ops2 = p_r2->fired + p_r2->starts + p_r2->restarts;
+
+    return (ops1 < ops2) ? 1 : (ops1 > ops2) ? -1 : 0;
+}
+
+int timer_stats_query(TIMER_STATS_REPORT *p_report, int max_reports)
+{
+    TIMER_STATS_REPORT reports[TIMER_STATS_MAX_SITES + 1];
+    int                i, count = 0;
+
+    for (i = 0; i <= TIMER_STATS_MAX_SITES; i++)
+    {
+        TIMER_STATS_SITE *p_site = &timer_stats_sites[i];
+
+        if (p_site->starts + p_site->restarts + p_site->stops + p_site->fired == 0)
+            continue;
+
+        reports[count].p_cback  = p_site->p_cback;
+        reports[count].starts   = p_site->starts;
+        reports[count].restarts = p_site->restarts;
+        reports[count].stops    = p_site->stops;
+        reports[count].fired    = p_site->fired;
+        reports[count].p50_us   = timer_stats_percentile(p_site, 50);
+        reports[count].p99_us   = timer_stats_percentile(p_site, 99);
+        reports[count].max_us   = p_site->max_us;
+        count++;
+    }
+
+    qsort(reports, count, sizeof(reports[0]), timer_stats_compare);
+
+    if (count > max_reports)
+        count = max_reports;
+    memcpy(p_report, reports, count * sizeof(reports[0]));
+    return count;
+}
+
+void timer_stats_print(const TIMER_STATS_REPORT *p_report, int count, TIMER_STATS_PRINT *p_print)
+{
+    int i;
+
+    p_print("timer stats: %d sites\n", count);
+    for (i = 0; i < count; i++, p_report++)
+    {
+        p_print("timer %p: fired:%u late p50:%uus p99:%uus max:%uus starts:%u restarts:%u stops:%u\n",
+            p_report->p_cback, p_report->fired, p_report->p50_us, p_report->p99_us, p_report->max_us,
+            p_report->starts, p_report->restarts, p_report->stops);
+    }
+}
+
+#ifdef TIMER_STATS_UNIT_TEST
+// Checks the bucket boundaries and the percentiles against a sorted reference:
+//   gcc -O2 -DTIMER_STATS_UNIT_TEST timer_stats.c
+#include <stdio.h>
+#include <stdarg.h>
+
+#define TEST_SAMPLES        100000
+
+static uint32_t test_seed = 1;
+static uint32_t test_samples[TEST_SAMPLES];
+
+static uint32_t test_rand(void)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 8) ^ (test_seed << 16);
+}
+
+static int test_compare(const void *p1, const void *p2)
+{
+    uint32_t v1 = *(const uint32_t *)p1, v2 = *(const uint32_t *)p2;
+    return (v1 > v2) - (v1 < v2);
+}
+
+static void test_main_site(void *p_param)
+{
+    (void)p_param;
+}
+
+static void test_print(char *fmt_str, ...)
+{
+    va_list ap;
+    va_start(ap, fmt_str);
+    vprintf(fmt_str, ap);
+    va_end(ap);
+}
+
+// Bucket upper bound must not be below the value and at most 12.5% above it
+static int test_check(const char *name, uint32_t reported, uint32_t exact)
+{
+    if (reported < exact || (uint64_t)reported > (uint64_t)exact + exact / 8 + 1)
+    {
+        printf("%s: reported %u exact %u\n", name, reported, exact);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    TIMER_STATS_REPORT report[4];
+    uint64_t           v;
+    int                i, count, failed = 0;
+
+    // Every value maps to a bucket whose range contains it, buckets are in order
+    for (v = 0; v <= 0xFFFFFFFF; v += 1 + (v >> 6))
+    {
+        int b = timer_stats_bucket((uint32_t)v);
+        if (b >= TIMER_STATS_BUCKETS || timer_stats_bucket_max(b) < v || (b > 0 && timer_stats_bucket_max(b - 1) >= v))
+        {
+            printf("bucket of %u: %d\n", (uint32_t)v, b);
+            failed = 1;
+            break;
+        }
+    }
+    if (timer_stats_bucket(0xFFFFFFFF) != TIMER_STATS_BUCKETS - 1 || timer_stats_bucket_max(TIMER_STATS_BUCKETS - 1) != 0xFFFFFFFF)
+        failed = 1;
+
+    // Lateness spread over several decades, one site
+    for (i = 0; i < TEST_SAMPLES; i++)
+    {
+        test_samples[i] = (test_rand() % 100 == 0) ? 10000 + test_rand() % 1000000 : test_rand() % 5000;
+        timer_stats_start((void *)test_main_site, 0);
+        timer_stats_fired((void *)test_main_site, 1000000, 1000000 + (uint64_t)test_samples[i]);
+    }
+    timer_stats_stop((void *)test_rand);
+    qsort(test_samples, TEST_SAMPLES, sizeof(test_samples[0]), test_compare);
+
+    count = timer_stats_query(report, 4);
+    timer_stats_print(report, count, test_print);
+    if (count != 2 || report[0].p_cback != (void *)test_main_site || report[0].fired != TEST_SAMPLES || report[1].stops != 1)
+        failed = 1;
+    failed |= test_check("p50", report[0].p50_us, test_samples[TEST_SAMPLES / 2 - 1]);
+    failed |= test_check("p99", report[0].p99_us, test_samples[TEST_SAMPLES * 99 / 100 - 1]);
+    if (report[0].max_us != test_samples[TEST_SAMPLES - 1])
+        failed = 1;
+
+    // Early dispatch counts as on time, more sites than fit go to the shared entry
+    timer_stats_reset();
+    timer_stats_fired((void *)test_rand, 2000, 1000);
+    for (i = 1; i <= TIMER_STATS_MAX_SITES + 10; i++)
+        timer_stats_start((void *)(uintptr_t)(i * 64), 0);
+    count = timer_stats_query(report, 1);
+    if (count != 1 || timer_stats_query(report, 0) != 0)
+        failed = 1;
+    if (timer_stats_find(NULL)->starts != 11 || timer_stats_find((void *)test_rand)->max_us != 0)
+        failed = 1;
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Timer latency statistics.
+ *
+ * The platform timer code reports every start, stop and expiry here. Statistics are kept per
+ * callback function, which identifies the place in the mesh code that owns the timer. Lateness,
+ * the time between the scheduled deadline and the dispatch of the callback, goes into a
+ * log-linear histogram: one bucket per microsecond up to 16 us, then 8 buckets per power of two,
+ * so percentiles are reported within 12.5%.
+ *
+ * The functions do no locking, the caller serializes them with the lock that protects its timers.
+ */
+#ifndef __TIMER_STATS_H__
+#define __TIMER_STATS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TIMER_STATS_MAX_SITES       64      // callback sites tracked, the rest are counted together
+
+typedef struct
+{
+    void       *p_cback;                /* Timer callback, NULL for the sites that did not fit */
+    uint32_t    starts;                 /* Starts of a timer that was not running */
+    uint32_t    restarts;               /* Starts of a timer that was running */
+    uint32_t    stops;                  /* Stops of a timer that was running */
+    uint32_t    fired;                  /* Expiries */
+    uint32_t    p50_us;                 /* Lateness percentiles in us, upper bound of the bucket */
+    uint32_t    p99_us;
+    uint32_t    max_us;
+} TIMER_STATS_REPORT;
+
+/* Matches ods() of the platform layers */
+typedef void (TIMER_STATS_PRINT)(char *fmt_str, ...);
+
+void timer_stats_start(void *p_cback, int restart);
+void timer_stats_stop(void *p_cback);
+void timer_stats_fired(void *p_cback, uint64_t deadline_us, uint64_t now_us);
+void timer_stats_reset(void);
+
+/* Copies up to max_reports sites, busiest first, and returns how many were copied */
+int  timer_stats_query(TIMER_STATS_REPORT *p_report, int max_reports);
+
+/* Prints reports returned by timer_stats_query, one line per site */
+void timer_stats_print(const TIMER_STATS_REPORT *p_report, int count, TIMER_STATS_PRINT *p_print);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIMER_STATS_H__
@@ -0,0 +1,473 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Native timer service, a pthread driven by a timer wheel.
+ */
+#include <stddef.h>
+#include <time.h>
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#endif
+#include "timer_thread.h"
+
+// Longest single wait, keeps the timespec arithmetic far from overflow
+#define TIMER_THREAD_MAX_WAIT_MS    (24 * 60 * 60 * 1000)
+
+static TIMER_WHEEL                  timer_wheel;
+static pthread_mutex_t             *p_timer_lock = NULL;
+static TIMER_THREAD_EXPIRED_CBACK  *p_timer_expired_cback = NULL;
+static TIMER_THREAD_DISPATCH_CBACK *p_timer_dispatch_cback = NULL;
+static int                          timer_dispatch_pending = 0; // due timers handed to the owner, not run yet
+static pthread_cond_t               timer_cond;
+static pthread_t                    timer_thread_id;
+static int                          timer_thread_running = 0;
+static uint64_t                     timer_wakeup_time = 0;      // tick the thread sleeps until, 0 while it is running
+
+uint64_t timer_thread_get_time_us(void)
+{
+#if defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+    return mach_absolute_time() * timebase.numer / timebase.denom / 1000;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+uint64_t timer_thread_get_tick_count(void)
+{
+    return timer_thread_get_time_us() / 1000;
+}
+
+static void timer_thread_wait(uint64_t now, uint64_t next)
+{
+    uint64_t        wait_ms;
+    struct timespec ts;
+
+    if (next == TIMER_WHEEL_NEVER)
+    {
+        pthread_cond_wait(&timer_cond, p_timer_lock);
+        return;
+    }
+    wait_ms = next - now;
+    if (wait_ms > TIMER_THREAD_MAX_WAIT_MS)
+        wait_ms = TIMER_THREAD_MAX_WAIT_MS;
+
+#if defined(__APPLE__)
+    // Darwin condition variables cannot wait on the monotonic clock, use the relative wait
+    ts.tv_sec  = (time_t)(wait_ms / 1000);
+    ts.tv_nsec = (long)(wait_ms % 1000) * 1000000;
+    pthread_cond_timedwait_relative_np(&timer_cond, p_timer_lock, &ts);
+#else
+    // The condition variable runs on CLOCK_MONOTONIC, the same clock as the ticks
+    ts.tv_sec  = (time_t)((now + wait_ms) / 1000);
+    ts.tv_nsec = (long)((now + wait_ms) % 1000) * 1000000;
+    pthread_cond_timedwait(&timer_cond, p_timer_lock, &ts);
+#endif
+}
+
+static void *timer_thread_proc(void *arg)
+{
+    TIMER_WHEEL_ENT *p_ent;
+    uint64_t         now, next;
+
+    (void)arg;
+
+    pthread_mutex_lock(p_timer_lock);
+
+    while (timer_thread_running)
+    {
+        // The owner is running the due timers, timer_thread_run_expired wakes the thread up when done
+        if (timer_dispatch_pending)
+        {
+            pthread_cond_wait(&timer_cond, p_timer_lock);
+            continue;
+        }
+
+        now = timer_thread_get_tick_count();
+
+        // Cascades run here, the owner is only disturbed when a timer is actually due
+        p_ent = timer_wheel_peek_expired(&timer_wheel, now);
+        if (p_ent != NULL)
+        {
+            if (p_timer_dispatch_cback != NULL)
+            {
+                timer_dispatch_pending = 1;
+                p_timer_dispatch_cback();
+            }
+            else
+            {
+                // Execute expired timers one at a time, the callback may start or stop any timer
+                timer_wheel_remove(&timer_wheel, p_ent);
+                p_timer_expired_cback(p_ent);
+            }
+            continue;
+        }
+
+        next = timer_wheel_next_event(&timer_wheel);
+        if (next <= now)
+            continue;
+
+        timer_wakeup_time = next;
+        timer_thread_wait(now, next);
+        timer_wakeup_time = 0;
+    }
+
+    pthread_mutex_unlock(p_timer_lock);
+    return NULL;
+}
+
+int timer_thread_init(pthread_mutex_t *p_lock, TIMER_THREAD_EXPIRED_CBACK *p_expired_cback)
+{
+    pthread_condattr_t attr;
+
+    pthread_mutex_lock(p_lock);
+    if (timer_thread_running)
+    {
+        pthread_mutex_unlock(p_lock);
+        return 0;
+    }
+
+    p_timer_lock           = p_lock;
+    p_timer_expired_cback  = p_expired_cback;
+    timer_wakeup_time      = 0;
+    timer_dispatch_pending = 0;
+    timer_wheel_init(&timer_wheel, timer_thread_get_tick_count());
+
+    pthread_condattr_init(&attr);
+#if !defined(__APPLE__)
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    pthread_cond_init(&timer_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    timer_thread_running = 1;
+    if (pthread_create(&timer_thread_id, NULL, timer_thread_proc, NULL) != 0)
+    {
+        timer_thread_running = 0;
+        pthread_cond_destroy(&timer_cond);
+        pthread_mutex_unlock(p_lock);
+        return -1;
+    }
+
+    pthread_mutex_unlock(p_lock);
+    return 0;
+}
+
+// Must not be called with the lock held, the timer thread needs it to exit
+void timer_thread_deinit(void)
+{
+    if (p_timer_lock == NULL)
+        return;
+
+    pthread_mutex_lock(p_timer_lock);
+    if (!timer_thread_running)
+    {
+        pthread_mutex_unlock(p_timer_lock);
+        return;
+    }
+    timer_thread_running = 0;
+    pthread_cond_signal(&timer_cond);
+    pthread_mutex_unlock(p_timer_lock);
+
+    pthread_join(timer_thread_id, NULL);
+    pthread_cond_destroy(&timer_cond);
+}
+
+void timer_thread_set_dispatch(TIMER_THREAD_DISPATCH_CBACK *p_dispatch_cback)
+{
+    p_timer_dispatch_cback = p_dispatch_cback;
+}
+
+void timer_thread_run_expired(void)
+{
+    TIMER_WHEEL_ENT *p_ent;
+    uint64_t         now = timer_thread_get_tick_count();
+
+    // A dispatch may still be queued after timer_thread_deinit
+    if (!timer_thread_running)
+        return;
+
+    while ((p_ent = timer_wheel_pop_expired(&timer_wheel, now)) != NULL)
+        p_timer_expired_cback(p_ent);
+
+    timer_dispatch_pending = 0;
+    pthread_cond_signal(&timer_cond);
+}
+
+void timer_thread_add(TIMER_WHEEL_ENT *p_ent)
+{
+    timer_wheel_add(&timer_wheel, p_ent);
+
+    // Only wake the thread up if it sleeps past the new deadline
+    if (p_ent->target_time < timer_wakeup_time)
+    {
+        timer_wakeup_time = 0;
+        pthread_cond_signal(&timer_cond);
+    }
+}
+
+void timer_thread_remove(TIMER_WHEEL_ENT *p_ent)
+{
+    // No need to wake the thread up, at worst it wakes up early and goes back to sleep
+    timer_wheel_remove(&timer_wheel, p_ent);
+}
+
+#ifdef TIMER_THREAD_UNIT_TEST
+// Runs the timer thread on the host:
+//   gcc -O2 -DTIMER_THREAD_UNIT_TEST timer_thread.c timer_wheel.c -lpthread
+// Checks that timers never fire early, stopped timers never fire, callbacks can restart
+// their own timer, dispatched timers run on the owner's thread, and measures the cost of a
+// start and stop with 10k timers armed.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_TIMERS         200
+#define TEST_MAX_TIMEOUT    200
+#define TEST_PERIODIC_COUNT 10
+#define BENCH_TIMERS        10000
+#define BENCH_OPS           1000000
+
+typedef struct
+{
+    TIMER_WHEEL_ENT ent;                // first, the wheel hands back this pointer
+    uint32_t        timeout;
+    int             periodic;
+    int             fired;
+    uint64_t        max_late;
+    int             early;
+    int             wrong_thread;
+} test_timer_t;
+
+static pthread_mutex_t  test_lock;
+static test_timer_t     test_timers[BENCH_TIMERS];
+static int              test_dispatch_mode = 0;
+static int              test_dispatched = 0;
+static int              test_fired_total = 0;
+static pthread_t        test_owner;
+
+static void test_dispatch(void)
+{
+    test_dispatched = 1;
+}
+
+static void test_expired(TIMER_WHEEL_ENT *p_ent)
+{
+    test_timer_t *p = (test_timer_t *)p_ent;
+    uint64_t      now = timer_thread_get_tick_count();
+
+    if (now < p_ent->target_time)
+        p->early++;
+    else if (now - p_ent->target_time > p->max_late)
+        p->max_late = now - p_ent->target_time;
+    p->fired++;
+    test_fired_total++;
+    if (test_dispatch_mode && !pthread_equal(pthread_self(), test_owner))
+        p->wrong_thread++;
+
+    if (p->periodic && p->fired < TEST_PERIODIC_COUNT)
+    {
+        p_ent->target_time += p->timeout;
+        timer_thread_add(p_ent);
+    }
+}
+
+static void test_start(test_timer_t *p, uint32_t timeout)
+{
+    p->timeout = timeout;
+    p->ent.target_time = timer_thread_get_tick_count() + timeout;
+    timer_thread_add(&p->ent);
+}
+
+static double test_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    pthread_mutexattr_t attr;
+    uint64_t            max_late = 0;
+    int                 i, failed = 0;
+    int                 dispatches = 0, empty_dispatches = 0;
+    double              t;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&test_lock, &attr);
+
+    if (timer_thread_init(&test_lock, test_expired) != 0)
+    {
+        printf("timer_thread_init failed\n");
+        return 1;
+    }
+
+    // One shot timers, every other one stopped before it expires, plus periodic ones
+    pthread_mutex_lock(&test_lock);
+    for (i = 0; i < TEST_TIMERS; i++)
+    {
+        test_timers[i].periodic = (i % 10) == 0;
+        test_start(&test_timers[i], 20 + rand() % TEST_MAX_TIMEOUT);
+    }
+    for (i = 1; i < TEST_TIMERS; i += 2)
+        timer_thread_remove(&test_timers[i].ent);
+    pthread_mutex_unlock(&test_lock);
+
+    usleep((20 + TEST_MAX_TIMEOUT) * TEST_PERIODIC_COUNT * 1000 + 200000);
+
+    pthread_mutex_lock(&test_lock);
+    for (i = 0; i < TEST_TIMERS; i++)
+    {
+        test_timer_t *p = &test_timers[i];
+        int           expected = (i & 1) ? 0 : (p->periodic ? TEST_PERIODIC_COUNT : 1);
+
+        if (p->fired != expected || p->early)
+        {
+            printf("timer %d fired %d times, expected %d, early %d\n", i, p->fired, expected, p->early);
+            failed = 1;
+        }
+        if (p->max_late > max_late)
+            max_late = p->max_late;
+    }
+    pthread_mutex_unlock(&test_lock);
+    printf("%d timers, max lateness %u ms\n", TEST_TIMERS, (unsigned)max_late);
+
+    // Cost of a restart with BENCH_TIMERS armed, each start or stop takes and releases the lock
+    for (i = 0; i < BENCH_TIMERS; i++)
+    {
+        pthread_mutex_lock(&test_lock);
+        test_timers[i].periodic = 0;
+        test_start(&test_timers[i], 60000 + rand() % 60000);
+        pthread_mutex_unlock(&test_lock);
+    }
+    t = test_seconds();
+    for (i = 0; i < BENCH_OPS; i++)
+    {
+        test_timer_t *p = &test_timers[rand() % BENCH_TIMERS];
+
+        pthread_mutex_lock(&test_lock);
+        timer_thread_remove(&p->ent);
+        pthread_mutex_unlock(&test_lock);
+
+        pthread_mutex_lock(&test_lock);
+        test_start(p, 1000 + rand() % 60000);
+        pthread_mutex_unlock(&test_lock);
+    }
+    t = test_seconds() - t;
+    printf("%d stop+start pairs with %d timers: %.1f ns per pair\n", BENCH_OPS, BENCH_TIMERS, t * 1e9 / BENCH_OPS);
+
+    pthread_mutex_lock(&test_lock);
+    for (i = 0; i < BENCH_TIMERS; i++)
+        timer_thread_remove(&test_timers[i].ent);
+    pthread_mutex_unlock(&test_lock);
+
+    timer_thread_deinit();
+
+    // Dispatch mode, the due timers run on this thread each time it finds them dispatched
+    memset(test_timers, 0, sizeof(test_timers[0]) * TEST_TIMERS);
+    test_dispatch_mode = 1;
+    test_owner = pthread_self();
+    timer_thread_set_dispatch(test_dispatch);
+    if (timer_thread_init(&test_lock, test_expired) != 0)
+    {
+        printf("timer_thread_init failed\n");
+        return 1;
+    }
+
+    pthread_mutex_lock(&test_lock);
+    for (i = 0; i < TEST_TIMERS; i++)
+    {
+        test_timers[i].periodic = (i % 10) == 0;
+        test_start(&test_timers[i], 20 + rand() % TEST_MAX_TIMEOUT);
+    }
+    pthread_mutex_unlock(&test_lock);
+
+    // A dispatch that finds nothing to run is a wasted wakeup of the owner, cascades must not cause one
+    t = test_seconds();
+    while (test_seconds() - t < ((20 + TEST_MAX_TIMEOUT) * TEST_PERIODIC_COUNT + 200) / 1000.0)
+    {
+        usleep(1000);
+        pthread_mutex_lock(&test_lock);
+        if (test_dispatched)
+        {
+            int fired = test_fired_total;
+
+            test_dispatched = 0;
+            dispatches++;
+            timer_thread_run_expired();
+            if (test_fired_total == fired)
+                empty_dispatches++;
+        }
+        pthread_mutex_unlock(&test_lock);
+    }
+
+    pthread_mutex_lock(&test_lock);
+    for (i = 0; i < TEST_TIMERS; i++)
+    {
+        test_timer_t *p = &test_timers[i];
+        int           expected = p->periodic ? TEST_PERIODIC_COUNT : 1;
+
+        if (p->fired != expected || p->early || p->wrong_thread)
+        {
+            printf("dispatched timer %d fired %d times, expected %d, early %d, wrong thread %d\n",
+                   i, p->fired, expected, p->early, p->wrong_thread);
+            failed = 1;
+        }
+    }
+    if (empty_dispatches != 0)
+    {
+        printf("%d of %d dispatches had no due timer\n", empty_dispatches, dispatches);
+        failed = 1;
+    }
+    pthread_mutex_unlock(&test_lock);
+    printf("%d dispatched timers run on the owner thread in %d dispatches\n", TEST_TIMERS, dispatches);
+
+    timer_thread_deinit();
+    timer_thread_set_dispatch(NULL);
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
+#endif
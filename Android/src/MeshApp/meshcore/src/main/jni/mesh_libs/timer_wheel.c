@@ -0,0 +1,496 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Hierarchical timing wheel used by the wiced_timer_t implementation.
+ */
+
+#include <string.h>
+#include "timer_wheel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit, x is not 0
+static int timer_wheel_ctz(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    if ((uint32_t)x != 0)
+    {
+        _BitScanForward(&i, (uint32_t)x);
+        return (int)i;
+    }
+    _BitScanForward(&i, (uint32_t)(x >> 32));
+    return (int)i + 32;
+#else
+    int i = 0;
+    while (!(x & 1))
+    {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+// Rotates the slot bitmap so that bit 0 is slot n
+static uint64_t timer_wheel_rotate(uint64_t x, int n)
+{
+    return (x >> n) | (x << ((TIMER_WHEEL_SLOTS - n) & TIMER_WHEEL_MASK));
+}
+
+static void timer_wheel_link(TIMER_WHEEL *p_wheel, TIMER_WHEEL_ENT *p_ent, int level, int slot)
+{
+    TIMER_WHEEL_ENT **p_head = &p_wheel->slots[level][slot];
+
+    p_ent->level  = (uint8_t)level;
+    p_ent->slot   = (uint8_t)slot;
+    p_ent->p_prev = NULL;
+    p_ent->p_next = *p_head;
+    if (*p_head != NULL)
+        (*p_head)->p_prev = p_ent;
+    *p_head = p_ent;
+    p_wheel->in_use[level] |= (uint64_t)1 << slot;
+}
+
+void timer_wheel_init(TIMER_WHEEL *p_wheel, uint64_t now)
+{
+    memset(p_wheel, 0, sizeof(TIMER_WHEEL));
+    p_wheel->base = now;
+}
+
+void timer_wheel_add(TIMER_WHEEL *p_wheel, TIMER_WHEEL_ENT *p_ent)
+{
+    uint64_t expires = p_ent->target_time;
+    uint64_t delta;
+    int      level;
+
+    // A timer that is already due goes in the slot processed next
+    if (expires < p_wheel->base)
+        expires = p_wheel->base;
+
+    delta = expires - p_wheel->base;
+    if (delta >= TIMER_WHEEL_RANGE)
+    {
+        // Out of range, park it in the last slot in range. It is placed again when that slot cascades.
+        delta   = TIMER_WHEEL_RANGE - 1;
+        expires = p_wheel->base + delta;
+    }
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++)
+        if (delta < ((uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1))))
+            break;
+
+    timer_wheel_link(p_wheel, p_ent, level, (int)(expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+    p_wheel->count++;
+}
+
+void timer_wheel_remove(TIMER_WHEEL *p_wheel, TIMER_WHEEL_ENT *p_ent)
+{
+    if (p_ent->p_prev != NULL)
+        p_ent->p_prev->p_next = p_ent->p_next;
+    else
+    {
+        p_wheel->slots[p_ent->level][p_ent->slot] = p_ent->p_next;
+        if (p_ent->p_next == NULL)
+            p_wheel->in_use[p_ent->level] &= ~((uint64_t)1 << p_ent->slot);
+    }
+    if (p_ent->p_next != NULL)
+        p_ent->p_next->p_prev = p_ent->p_prev;
+
+    p_ent->p_next = NULL;
+    p_ent->p_prev = NULL;
+    p_wheel->count--;
+}
+
+// Moves the base forward. Landing on a multiple of the slot count moves the timers of the
+// upper level slots that start at the new base down to lower levels.
+static void timer_wheel_set_base(TIMER_WHEEL *p_wheel, uint64_t base)
+{
+    TIMER_WHEEL_ENT *p_ent, *p_next;
+    int             level, slot;
+
+    p_wheel->base = base;
+    if (base & TIMER_WHEEL_MASK)
+        return;
+
+    for (level = 1; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        slot  = (int)(base >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+        p_ent = p_wheel->slots[level][slot];
+
+        p_wheel->slots[level][slot] = NULL;
+        p_wheel->in_use[level] &= ~((uint64_t)1 << slot);
+
+        for (; p_ent != NULL; p_ent = p_next)
+        {
+            p_next = p_ent->p_next;
+            p_wheel->count--;
+            timer_wheel_add(p_wheel, p_ent);
+        }
+        if (slot != 0)
+            break;
+    }
+}
+
+uint64_t timer_wheel_next_event(TIMER_WHEEL *p_wheel)
+{
+    uint64_t next = TIMER_WHEEL_NEVER;
+    uint64_t bits, t;
+    int      level, shift, slot;
+
+    if (p_wheel->count == 0)
+        return TIMER_WHEEL_NEVER;
+
+    // Level 0 slots hold single ticks, the slot at base is the earliest
+    bits = timer_wheel_rotate(p_wheel->in_use[0], (int)(p_wheel->base & TIMER_WHEEL_MASK));
+    if (bits != 0)
+        next = p_wheel->base + timer_wheel_ctz(bits);
+
+    // Upper level slots are due when the base reaches their start. The current slot was
+    // cascaded already, anything in it belongs to the next turn of that level.
+    for (level = 1; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        if (p_wheel->in_use[level] == 0)
+            continue;
+        shift = TIMER_WHEEL_BITS * level;
+        slot  = (int)(p_wheel->base >> shift) & TIMER_WHEEL_MASK;
+        bits  = timer_wheel_rotate(p_wheel->in_use[level], (slot + 1) & TIMER_WHEEL_MASK);
+        t     = ((p_wheel->base >> shift) + timer_wheel_ctz(bits) + 1) << shift;
+        if (t < next)
+            next = t;
+    }
+    return next;
+}
+
+TIMER_WHEEL_ENT *timer_wheel_peek_expired(TIMER_WHEEL *p_wheel, uint64_t now)
+{
+    TIMER_WHEEL_ENT *p_ent;
+    uint64_t        next;
+
+    while (p_wheel->base <= now)
+    {
+        p_ent = p_wheel->slots[0][p_wheel->base & TIMER_WHEEL_MASK];
+        if (p_ent != NULL)
+            return p_ent;
+
+        // Jump to the next tick with work, slots in between are empty
+        next = timer_wheel_next_event(p_wheel);
+        timer_wheel_set_base(p_wheel, (next <= now) ? next : now + 1);
+    }
+    return NULL;
+}
+
+TIMER_WHEEL_ENT *timer_wheel_pop_expired(TIMER_WHEEL *p_wheel, uint64_t now)
+{
+    TIMER_WHEEL_ENT *p_ent = timer_wheel_peek_expired(p_wheel, now);
+
+    if (p_ent != NULL)
+        timer_wheel_remove(p_wheel, p_ent);
+    return p_ent;
+}
+
+#ifdef TIMER_WHEEL_UNIT_TEST
+// Random start, stop and expiry against a brute force model, including time jumps past the
+// range of the wheel, then a churn benchmark with 10k timers against the sorted list the
+// wheel replaced.
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define TEST_TIMERS         1000
+#define TEST_OPS            300000
+#define BENCH_TIMERS        10000
+#define BENCH_OPS           1000000
+#define BENCH_LIST_OPS      20000
+
+typedef struct
+{
+    TIMER_WHEEL_ENT ent;                // first, the wheel hands back this pointer
+    uint32_t        timeout;
+    int             active;
+} test_timer_t;
+
+static uint32_t test_seed = 1;
+
+static uint32_t test_rand(void)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 8) ^ (test_seed << 16);
+}
+
+static double test_seconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Timeouts in ms shaped like the mesh core: mostly segment and ack timers, some seconds
+// long, a few in hours (IV update) and past the wheel range
+static uint32_t test_timeout(void)
+{
+    uint32_t r = test_rand() % 100;
+
+    if (r < 60)
+        return 10 + test_rand() % 500;
+    if (r < 90)
+        return 1000 + test_rand() % 60000;
+    if (r < 99)
+        return 3600000 + test_rand() % (96 * 3600000);
+    return 0x40000000 + (test_rand() % 0x40000000) * 2;
+}
+
+static int test_wheel(void)
+{
+    static test_timer_t timers[TEST_TIMERS];
+    TIMER_WHEEL         wheel;
+    TIMER_WHEEL_ENT     *p_ent;
+    test_timer_t        *p;
+    uint64_t            now = 12345, next, earliest;
+    uint32_t            expired = 0;
+    int                 op, i, fails = 0;
+
+    timer_wheel_init(&wheel, now);
+    memset(timers, 0, sizeof(timers));
+
+    for (op = 0; op < TEST_OPS && fails < 10; op++)
+    {
+        p = &timers[test_rand() % TEST_TIMERS];
+        switch (test_rand() % 4)
+        {
+        case 0:
+        case 1:
+            if (p->active)
+                timer_wheel_remove(&wheel, &p->ent);
+            p->timeout         = test_timeout();
+            p->ent.target_time = now + p->timeout;
+            p->active          = 1;
+            timer_wheel_add(&wheel, &p->ent);
+            break;
+        case 2:
+            if (p->active)
+                timer_wheel_remove(&wheel, &p->ent);
+            p->active = 0;
+            break;
+        default:
+            // mostly small steps, sometimes a jump to the next expiry or far beyond
+            if ((test_rand() % 64) == 0)
+            {
+                next = timer_wheel_next_event(&wheel);
+                now  = (next != TIMER_WHEEL_NEVER) ? next : now + 1;
+            }
+            else if ((test_rand() % 1024) == 0)
+                now += (uint64_t)test_rand() * 16;
+            else
+                now += test_rand() % 50;
+
+            while ((p_ent = timer_wheel_pop_expired(&wheel, now)) != NULL)
+            {
+                p = (test_timer_t *)p_ent;
+                if (!p->active || (p->ent.target_time > now))
+                {
+                    printf("FAIL op %d: popped timer active:%d target:%llu now:%llu\n", op, p->active,
+                        (unsigned long long)p->ent.target_time, (unsigned long long)now);
+                    fails++;
+                }
+                p->active = 0;
+                expired++;
+            }
+            break;
+        }
+
+        earliest = TIMER_WHEEL_NEVER;
+        for (i = 0; i < TEST_TIMERS; i++)
+            if (timers[i].active && timers[i].ent.target_time < earliest)
+                earliest = timers[i].ent.target_time;
+        if (earliest <= now)
+        {
+            printf("FAIL op %d: due timer left in the wheel\n", op);
+            fails++;
+        }
+        next = timer_wheel_next_event(&wheel);
+        if ((earliest != TIMER_WHEEL_NEVER) && (next > earliest))
+        {
+            printf("FAIL op %d: next event %llu after earliest expiry %llu\n", op,
+                (unsigned long long)next, (unsigned long long)earliest);
+            fails++;
+        }
+    }
+    printf("wheel model test: %d ops, %u expired, %s\n", op, expired, fails ? "FAILED" : "passed");
+    return fails;
+}
+
+// The sorted singly linked list the wheel replaced, for comparison
+typedef struct _list_tle
+{
+    struct _list_tle *p_next;
+    uint64_t          target_time;
+    uint32_t          timeout;
+    int               active;
+} list_timer_t;
+
+static list_timer_t *list_head;
+
+static void list_stop(list_timer_t *p)
+{
+    list_timer_t *pt;
+
+    p->active = 0;
+    if (p == list_head)
+    {
+        list_head = p->p_next;
+        return;
+    }
+    for (pt = list_head; pt != NULL; pt = pt->p_next)
+        if (pt->p_next == p)
+            break;
+    if (pt != NULL)
+        pt->p_next = p->p_next;
+}
+
+static void list_start(list_timer_t *p, uint64_t now)
+{
+    list_timer_t **pp;
+
+    list_stop(p);
+    p->target_time = now + p->timeout;
+    for (pp = &list_head; *pp != NULL && (*pp)->target_time <= p->target_time; pp = &(*pp)->p_next)
+        ;
+    p->p_next = *pp;
+    *pp = p;
+    p->active = 1;
+}
+
+static void bench(void)
+{
+    static test_timer_t timers[BENCH_TIMERS];
+    static list_timer_t list_timers[BENCH_TIMERS];
+    TIMER_WHEEL         wheel;
+    TIMER_WHEEL_ENT     *p_ent;
+    test_timer_t        *p;
+    list_timer_t        *pl;
+    uint64_t            now = 0;
+    uint32_t            expired = 0;
+    double              t0, t1;
+    int                 op, i;
+
+    // Every timer is periodic and one is restarted per op, the time moves 1 ms every 10 ops
+    test_seed = 7;
+    timer_wheel_init(&wheel, now);
+    for (i = 0; i < BENCH_TIMERS; i++)
+    {
+        timers[i].timeout         = test_timeout();
+        timers[i].ent.target_time = now + timers[i].timeout;
+        timer_wheel_add(&wheel, &timers[i].ent);
+    }
+    t0 = test_seconds();
+    for (op = 0; op < BENCH_OPS; op++)
+    {
+        p = &timers[test_rand() % BENCH_TIMERS];
+        timer_wheel_remove(&wheel, &p->ent);
+        p->ent.target_time = now + p->timeout;
+        timer_wheel_add(&wheel, &p->ent);
+
+        if ((op % 10) == 9)
+        {
+            now++;
+            while ((p_ent = timer_wheel_pop_expired(&wheel, now)) != NULL)
+            {
+                p = (test_timer_t *)p_ent;
+                p->ent.target_time = now + p->timeout;
+                timer_wheel_add(&wheel, &p->ent);
+                expired++;
+            }
+            timer_wheel_next_event(&wheel);
+        }
+    }
+    t1 = test_seconds();
+    printf("timing wheel: %d timers, %d restarts, %u expiries: %.1f ns per start or expiry\n",
+        BENCH_TIMERS, BENCH_OPS, expired, (t1 - t0) * 1e9 / (BENCH_OPS + expired));
+
+    test_seed = 7;
+    now = 0;
+    expired = 0;
+    list_head = NULL;
+    for (i = 0; i < BENCH_TIMERS; i++)
+    {
+        list_timers[i].timeout = test_timeout();
+        list_start(&list_timers[i], now);
+    }
+    t0 = test_seconds();
+    for (op = 0; op < BENCH_LIST_OPS; op++)
+    {
+        list_start(&list_timers[test_rand() % BENCH_TIMERS], now);
+
+        if ((op % 10) == 9)
+        {
+            now++;
+            while ((list_head != NULL) && (list_head->target_time <= now))
+            {
+                pl = list_head;
+                list_start(pl, now);
+                expired++;
+            }
+        }
+    }
+    t1 = test_seconds();
+    printf("sorted list:  %d timers, %d restarts, %u expiries: %.1f ns per start or expiry\n",
+        BENCH_TIMERS, BENCH_LIST_OPS, expired, (t1 - t0) * 1e9 / (BENCH_LIST_OPS + expired));
+}
+
+int main(void)
+{
+    int fails = test_wheel();
+
+    bench();
+    return fails ? 1 : 0;
+}
+#endif
@@ -40,6 +40,7 @@
 #include "trace.h"
 #include "wiced_mesh_client.h"
 #include "mesh_main.h"
+#include "mesh_trace.h"
 #include <unistd.h>
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -53,7 +54,8 @@
 #endif
 
 //#define LOG_TAG "Jni"
-#define  Log(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG,__VA_ARGS__)
+// Every JNI entry point logs, they are debug traces of the jni category
+#define  Log(...)  MESH_TRACE_DEBUG(MESH_TRACE_JNI, __VA_ARGS__)
 #define UUID_LEN 16
 static jclass jniWrapperClass;
 static JNIEnv *sCallbackEnv = NULL;
@@ -85,8 +87,6 @@ static jmethodID meshClientDfuStatusCb;
 static jmethodID meshClientLinkStatusCb;
 static jmethodID meshClientNetworkOpenedCb;
 static jmethodID meshClientComponentInfoCb;
-static jmethodID startTimercb;
-static jmethodID stopTimercb;
 static jmethodID sensorStatuscb;
 static jmethodID vendorStatusCb;
 static jmethodID lightLcModeStatusCb;
@@ -99,7 +99,6 @@ static uint8_t WICED_MESH_TRANSPORT_GATEWAY = 2;
 
 extern uint8_t mesh_client_is_connecting_provisioning();
 extern void mesh_client_advert_report(uint8_t *bd_addr, uint8_t addr_type, int8_t rssi, uint8_t *adv_data);
-extern void MeshTimerFunc(long timer_id);
 
 extern pthread_mutex_t cs;
 
@@ -129,7 +128,6 @@ typedef struct
 
 device_config_params_t DeviceConfig = { 1, 1, 1, 1, 3, 100, 8, 3, 100, 0, 8, 0, 0, 500 };
 
-static uint32_t timer_id = 1;
 static char* dfu_firmware_file;
 
 
@@ -149,12 +147,62 @@ JNIEnv* AttachJava()
     return java;
 }
 
+static pthread_key_t  timer_thread_key;
+static pthread_once_t timer_thread_key_once = PTHREAD_ONCE_INIT;
+static int            timer_thread_frame = 0;
+
+static void timer_thread_detach(void *unused)
+{
+    (void)unused;
+    (*svm)->DetachCurrentThread(svm);
+}
+
+static void timer_thread_key_create(void)
+{
+    pthread_key_create(&timer_thread_key, timer_thread_detach);
+}
+
+/*
+ * Mesh timer callbacks run on the native timer thread with cs held, the lock every JNI entry point
+ * takes. The thread attaches once and is detached when it exits. It never returns to Java, so each
+ * callback gets its own local frame for the refs its upcalls create.
+ */
+void mesh_jni_timer_enter(void)
+{
+    JNIEnv *env;
+
+    pthread_once(&timer_thread_key_once, timer_thread_key_create);
+    env = pthread_getspecific(timer_thread_key);
+    if (env == NULL) {
+        env = AttachJava();
+        pthread_setspecific(timer_thread_key, env);
+    }
+    if ((*env)->PushLocalFrame(env, 16) != 0)
+        (*env)->ExceptionClear(env);
+    else
+        timer_thread_frame = 1;
+}
+
+void mesh_jni_timer_leave(void)
+{
+    JNIEnv *env = pthread_getspecific(timer_thread_key);
+
+    if ((*env)->ExceptionCheck(env)) {
+        (*env)->ExceptionDescribe(env);
+        (*env)->ExceptionClear(env);
+    }
+    if (timer_thread_frame)
+        (*env)->PopLocalFrame(env, NULL);
+    timer_thread_frame = 0;
+}
+
 void JNI_OnUnload(JavaVM *vm, void *reserved)
 {
     Log("JNI_OnUnload");
     JNIEnv  *env;
     (*vm)->GetEnv(vm, (void **)&env, JNI_VERSION_1_6);
     (*env)->DeleteGlobalRef(env, jniWrapperClass);
+    mesh_trace_deinit();
 }
 
 
@@ -225,7 +273,7 @@ int cdToExtStorage(void) {
         mkdir(pathname, 0777);
     }
     if (chdir(pathname) != 0) {
-        Log("Error: Unable to change working directory to %s\n", pathname);
+        MESH_TRACE_ERROR(MESH_TRACE_JNI, "Error: Unable to change working directory to %s\n", pathname);
         perror(NULL);
     }
 //    else if (path) {
@@ -243,7 +291,7 @@ int cdToExtStorage(void) {
     goto retAndroid;
 
     bailAndroid:
-    Log("Error: JNI call failure.\n");
+    MESH_TRACE_ERROR(MESH_TRACE_JNI, "Error: JNI call failure.\n");
     ret = -1;
     retAndroid:
     if (isAttached) (*svm)->DetachCurrentThread(svm); // Clean up.
@@ -252,37 +300,37 @@ int cdToExtStorage(void) {
 
 wiced_bool_t mesh_adv_scan_start(void)
 {
-    Log("mesh_adv_scan_start\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_ADV, "mesh_adv_scan_start\n");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     (*env)->CallStaticVoidMethod(env, cls2, meshGattAdvScanStartCb);
     return WICED_TRUE;
 }
 
 wiced_bool_t mesh_set_scan_type(uint8_t is_active)
 {
-    Log("mesh_set_adv_scan_type\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_ADV, "mesh_set_adv_scan_type\n");
     JNIEnv *env = AttachJava();
     jbyte isactive = is_active;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     (*env)->CallStaticVoidMethod(env, cls2, meshGattSetScanTypeCb, isactive);
     return WICED_TRUE;
 }
 
 void mesh_adv_scan_stop(void)
 {
-    Log("mesh_adv_scan_stop\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_ADV, "mesh_adv_scan_stop\n");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     (*env)->CallStaticVoidMethod(env, cls2, meshGattAdvScanStopCb);
 }
 
 wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
                                             wiced_bt_ble_conn_mode_t conn_mode, wiced_bool_t is_direct)
 {
-    Log("mesh_bt_gatt_le_connect\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "mesh_bt_gatt_le_connect\n");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyteArray  bda = (*env)->NewByteArray(env ,6);
     (*env)->SetByteArrayRegion(env,bda,0,6,bd_addr);
     (*env)->CallStaticVoidMethod(env, cls2, meshGattConnectCb, bda);
@@ -291,9 +339,9 @@ wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt
 
 wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id)
 {
-    Log("mesh_bt_gatt_le_disconnect\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "mesh_bt_gatt_le_disconnect\n");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     (*env)->CallStaticVoidMethod(env, cls2, meshGattDisconnectCb, conn_id);
     return WICED_TRUE;
 }
@@ -305,14 +353,14 @@ uint32_t wiced_bt_get_fw_image_size(uint8_t partition)
 
     if (dfu_firmware_file == NULL)
     {
-        Log("dfu_firmware_file is NULL\n");
+        MESH_TRACE_ERROR(MESH_TRACE_DFU, "dfu_firmware_file is NULL\n");
         return 0;
     }
 
     file = fopen(dfu_firmware_file, "rb");
     if (file == NULL)
     {
-        Log("Failed to open dfu_firmware_file %s\n", dfu_firmware_file);
+        MESH_TRACE_ERROR(MESH_TRACE_DFU, "Failed to open dfu_firmware_file %s\n", dfu_firmware_file);
         return 0;
     }
 
@@ -320,17 +368,17 @@ uint32_t wiced_bt_get_fw_image_size(uint8_t partition)
     fseek(file, 0, SEEK_END);
     file_size = (int)ftell(file);
     fclose(file);
-    Log("fw_image_size = %d\n", file_size);
+    MESH_TRACE_DEBUG(MESH_TRACE_DFU, "fw_image_size = %d\n", file_size);
     return file_size;
 }
 
 void wiced_bt_get_fw_image_chunk(uint8_t partition, uint32_t offset, uint8_t *p_data, uint16_t data_len)
 {
-    Log("wiced_bt_get_fw_image_chunk: partition:%d, offset:%d, data_len:%d\n", partition, offset, data_len);
+    MESH_TRACE_VERBOSE(MESH_TRACE_DFU, "wiced_bt_get_fw_image_chunk: partition:%d, offset:%d, data_len:%d\n", partition, offset, data_len);
 
     FILE *file = fopen(dfu_firmware_file, "rb");
     if (file == NULL) {
-        Log("get_fw_image_chunk: File error %s\n", dfu_firmware_file);
+        MESH_TRACE_ERROR(MESH_TRACE_DFU, "get_fw_image_chunk: File error %s\n", dfu_firmware_file);
         return;
     }
 
@@ -347,9 +395,9 @@ wiced_bool_t wiced_bt_fw_is_ota_supported()
 {
     jboolean ota_supported;
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env, "com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     ota_supported = (*env)->CallStaticBooleanMethod(env, cls2, meshClientDfuIsOtaSupportedCb);
-    Log("wiced_bt_fw_is_ota_supported: %d\n", ota_supported);
+    MESH_TRACE_DEBUG(MESH_TRACE_DFU, "wiced_bt_fw_is_ota_supported: %d\n", ota_supported);
     return ota_supported;
 }
 
@@ -357,7 +405,7 @@ void wiced_bt_fw_start_ota()
 {
     JNIEnv *env = AttachJava();
     jstring dfu_firmware_file_name;
-    jclass cls2 = (*env)->FindClass(env, "com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     dfu_firmware_file_name = (*env)->NewStringUTF(env, dfu_firmware_file);
     (*env)->CallStaticVoidMethod(env, cls2, meshClientDfuStartOtaCb, dfu_firmware_file_name);
 }
@@ -365,9 +413,9 @@ void wiced_bt_fw_start_ota()
 
 void mesh_client_dfu_status(uint8_t state, uint8_t *p_data, uint32_t data_len)
 {
-    Log("mesh_client_dfu_status: state:%x\n", state);
+    MESH_TRACE_DEBUG(MESH_TRACE_DFU, "mesh_client_dfu_status: state:%x\n", state);
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte state_val = state;
     jbyteArray data_val = (*env)->NewByteArray(env, data_len);
     (*env)->SetByteArrayRegion(env, data_val, 0, data_len, p_data);
@@ -405,9 +453,9 @@ Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_SendGattPktToCore(JNIEnv *env
 }
 
 wiced_result_t wiced_send_gatt_packet( uint16_t opcode, const uint8_t* p_data, uint16_t length ) {
-    Log("wiced_send_gatt_packet\n");
+    MESH_TRACE_VERBOSE(MESH_TRACE_GATT, "wiced_send_gatt_packet opcode:%x len:%d\n", opcode, length);
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jshort event = opcode;
     jint lengthx = length;
     jbyteArray  data = (*env)->NewByteArray(env ,length);
@@ -418,10 +466,10 @@ wiced_result_t wiced_send_gatt_packet( uint16_t opcode, const uint8_t* p_data, u
 
 static void unprovisioned_device(uint8_t *p_uuid, uint16_t oob, uint8_t *name, uint8_t name_len)
 {
-    Log("unprovisioned_device\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_PROV, "unprovisioned_device\n");
     jstring deviceName;
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyteArray  data = (*env)->NewByteArray(env ,17);
     (*env)->SetByteArrayRegion(env,data,0,16,p_uuid);
     char *device_name = (char*)malloc(name_len + 1);
@@ -433,9 +481,9 @@ static void unprovisioned_device(uint8_t *p_uuid, uint16_t oob, uint8_t *name, u
 }
 
 void meshClientProvisionCompleted(uint8_t is_success, uint8_t *p_uuid) {
-    Log("meshClientProvisionCompleted\n");
+    MESH_TRACE_INFO(MESH_TRACE_PROV, "meshClientProvisionCompleted success:%d\n", is_success);
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte isSuccess = is_success;
     jint lengthx = 16;
     jbyteArray  data = (*env)->NewByteArray(env ,lengthx);
@@ -450,10 +498,10 @@ void meshClientProvisionCompleted(uint8_t is_success, uint8_t *p_uuid) {
  */
 void linkStatus(uint8_t is_connected, uint32_t conn_id, uint16_t addr, uint8_t is_over_gatt)
 {
-    Log("linkStatus is connected %x",is_connected);
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "linkStatus is connected %x\n", is_connected);
 
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte isConnected = is_connected;
     jint connId = conn_id;
     jshort address = addr;
@@ -466,7 +514,7 @@ void meshClientNetworkOpened(uint8_t status)
     Log("meshClientNetworkOpened %x",status);
 
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte statusval = status;
 
     (*env)->CallStaticVoidMethod(env, cls2, meshClientNetworkOpenedCb, statusval);
@@ -478,7 +526,7 @@ void meshComponentInfoStatus(uint8_t status, char *component_name, char *compone
     JNIEnv *env = AttachJava();
     jstring componentName;
     jstring componentInfo;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte statusval = status;
     componentName = (*env)->NewStringUTF(env, component_name);
     componentInfo = (*env)->NewStringUTF(env, component_info);
@@ -489,7 +537,7 @@ void meshClientOnOffState(const char *device_name, uint8_t target, uint8_t prese
     Log("meshClientOnOffState\n");
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte targetOnOff = target;
     jbyte presentOnOff = present;
     jint remainingTime =  remaining_time;
@@ -503,7 +551,7 @@ void meshClientSensorState(const char *device_name, int property_id, uint8_t len
     JNIEnv *env = AttachJava();
     jstring deviceName;
     jstring targetName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyteArray  data = (*env)->NewByteArray(env ,length);
     (*env)->SetByteArrayRegion(env, data, 0, length, value);
     deviceName = (*env)->NewStringUTF(env, device_name);
@@ -515,7 +563,7 @@ void meshClientVendorSpecificDataStatus(uint16_t src, uint16_t company_id, uint1
 {
     Log("meshClientVendorSpecificDataState\n");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyteArray  data = (*env)->NewByteArray(env ,data_len);
     (*env)->SetByteArrayRegion(env, data, 0, data_len, p_data);
     (*env)->CallStaticVoidMethod(env, cls2, vendorStatusCb, src, company_id, model_id, opcode, ttl, data, data_len);
@@ -524,7 +572,7 @@ void meshClientNodeConnectionState(uint8_t status, char *p_name) {
     Log("meshClientNodeConnectionState status :%x\n",status);
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jbyte status_x = status;
     deviceName = (*env)->NewStringUTF(env, p_name);
     (*env)->CallStaticVoidMethod(env, cls2, meshClientNodeConnectStateCb, status_x, deviceName);
@@ -534,7 +582,7 @@ void meshClientDbChangedState(char *mesh_name) {
     Log("meshClientDatabaseChangedState status :%s\n",mesh_name);
     JNIEnv *env = AttachJava();
     jstring meshName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     meshName = (*env)->NewStringUTF(env, mesh_name);
     (*env)->CallStaticVoidMethod(env, cls2, meshClientDbStateCb, meshName);
 }
@@ -543,7 +591,7 @@ void meshClientLevelState(const char *device_name, uint16_t target, uint16_t pre
     Log("meshClientLevelState\n");
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jshort targetLevel = target;
     jshort presentLevel = present;
     jint remainingTime = remaining_time;
@@ -555,7 +603,7 @@ void meshClientHslState(const char *device_name, uint16_t lightness, uint16_t hu
     Log("meshClientHslState\n");
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint lightness_val = lightness;
     jint hue_val = hue;
     jint saturation_val = saturation;
@@ -568,7 +616,7 @@ void meshClientCtlState(const char *device_name, uint16_t present_lightness, uin
     Log("meshClientCtlState\n");
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint presentLightness = present_lightness;
     jshort presentTemperature = present_temperature;
     jint targetLightness = target_lightness;
@@ -582,7 +630,7 @@ void meshClientLightnessState(const char *device_name, uint16_t target, uint16_t
     Log("meshClientLightnessState\n");
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint presentval = present;
     jint targetval = target;
     jint remainingtime = remaining_time;
@@ -596,7 +644,7 @@ void meshClientLightLcModeStatus (const char* device_name, int mode)
     Log("meshClientLightLcModeStatus mode :%x\n",mode);
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint mode_x = mode;
     deviceName = (*env)->NewStringUTF(env, device_name);
     (*env)->CallStaticVoidMethod(env, cls2, lightLcModeStatusCb, deviceName, mode_x);
@@ -606,7 +654,7 @@ void meshClientLightLcOccupancyModeStatus (const char* device_name, int mode)
     Log("meshClientLightLcOccupancyModeStatus mode :%x\n",mode);
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint mode_x = mode;
     deviceName = (*env)->NewStringUTF(env, device_name);
     (*env)->CallStaticVoidMethod(env, cls2, lightLcOccupancyModeStatusCb, deviceName, mode_x);
@@ -616,7 +664,7 @@ void meshClientLightLcPropertyStatus(const char* device_name, int property_id, i
     Log("meshClientLightLcPropertyStatus value :%x\n",value);
     JNIEnv *env = AttachJava();
     jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint property_id_x = property_id;
     jint value_x = value;
     deviceName = (*env)->NewStringUTF(env, device_name);
@@ -1172,12 +1220,6 @@ Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientHslSet(JNIEnv *env,
     return return_val;
 }
 
-JNIEXPORT void JNICALL
-Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_timerCallback(JNIEnv *env, jclass type,
-                                                                 jlong timerid) {
-    MeshTimerFunc(timerid);
-}
-
 JNIEXPORT jint JNICALL
 Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientSetDeviceConfig(JNIEnv *env,
                                                                              jclass type,
@@ -1362,7 +1404,7 @@ void mesh_provision_gatt_send(uint16_t conn_id, const uint8_t *packet, uint32_t
     // send this packet to JAVA
     Log("\n mesh_provision_gatt_send");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
      jint lengthx = packet_len;
     jbyteArray  data = (*env)->NewByteArray(env ,packet_len);
     (*env)->SetByteArrayRegion(env,data,0,packet_len,packet);
@@ -1373,44 +1415,13 @@ void proxy_gatt_send_cb(uint32_t conn_id, uint32_t ref_data, const uint8_t *pack
     // send this packet to JAVA
     Log("\n proxy_gatt_send_cb");
     JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    jclass cls2 = jniWrapperClass;
     jint lengthx = packet_len;
     jbyteArray  data = (*env)->NewByteArray(env ,packet_len);
     (*env)->SetByteArrayRegion(env,data,0,packet_len,packet);
     (*env)->CallStaticVoidMethod(env, cls2, meshGattProxySendCb,data, lengthx);
 }
 
-uint32_t start_timer(uint32_t timeout, uint16_t type) {
-    JNIEnv *env = AttachJava();
-    jstring deviceName;
-    uint32_t curr_timerid = timer_id;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    jint time = timeout;
-    Log("start_timer timer_id:%x\n",curr_timerid);
-    (*env)->CallStaticVoidMethod(env, cls2, startTimercb, curr_timerid, time, type);
-    timer_id++;
-    if (timer_id == 0) {
-        timer_id = 1;
-    }
-    return curr_timerid;
-}
-
-uint32_t restart_timer(uint32_t timeout, uint32_t timerId ) {
-    Log("restart_timer timer_id:%x timeout:%d\n", timerId, timeout);
-    JNIEnv *env = AttachJava();
-    jstring deviceName;
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    jint time = timeout;
-    (*env)->CallStaticVoidMethod(env, cls2, startTimercb, timerId, time);
-}
-void stop_timer(uint32_t timerId){
-    Log("stop_timer timer_id:%x\n",timerId);
-    JNIEnv *env = AttachJava();
-    jclass cls2 = (*env)->FindClass(env,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    jint time_id = timerId;
-    (*env)->CallStaticVoidMethod(env, cls2, stopTimercb, time_id);
-}
-
 JNIEXPORT jint JNICALL
 Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientIdentify(JNIEnv *env, jclass type,
                                                                       jstring name_,
@@ -1624,7 +1635,7 @@ Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_setFileStorge(JNIEnv *env, jo
         mkdir(pathname, 0777);
     }
     if (chdir(pathname) != 0) {
-        Log("Error: Unable to change working directory to %s\n", pathname);
+        MESH_TRACE_ERROR(MESH_TRACE_JNI, "Error: Unable to change working directory to %s\n", pathname);
         perror(NULL);
     }
 
@@ -1730,6 +1741,23 @@ Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientNetworkDelete(JNIEn
     return return_val;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientSetTraceLevels(JNIEnv *env, jclass type, jstring spec_) {
+    const char *spec = (*env)->GetStringUTFChars(env, spec_, 0);
+    jint        res = mesh_trace_configure(spec);
+
+    (*env)->ReleaseStringUTFChars(env, spec_, spec);
+    return res;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientGetTraceLevels(JNIEnv *env, jclass type) {
+    char buf[128];
+
+    mesh_trace_describe(buf, sizeof(buf));
+    return (*env)->NewStringUTF(env, buf);
+}
+
 JNIEXPORT void JNICALL
 Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientSetGattMtu(JNIEnv *env, jclass type,
                                                                         jint mtu) {
@@ -2417,6 +2445,7 @@ Java_com_cypress_le_mesh_meshcore_MeshNativeHelper_meshClientSetLightLcOnoffSet(
 jint
 JNI_OnLoad(JavaVM *vm, void *reserved)
 {
+    mesh_trace_init();
     Log("OnLoad");
     JNIEnv  *env;
     svm = vm;
@@ -2424,103 +2453,102 @@ JNI_OnLoad(JavaVM *vm, void *reserved)
         return -1;
 
     sCallbackEnv = env;
-    jniWrapperClass = (*sCallbackEnv)->FindClass(sCallbackEnv,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
-    if (jniWrapperClass == 0) {
-        Log("NO CLASS");
+    // Callbacks come from native threads where FindClass only sees the system class loader,
+    // keep the class resolved here by the app class loader
+    jclass cls = (*sCallbackEnv)->FindClass(sCallbackEnv,"com/cypress/le/mesh/meshcore/MeshNativeHelper");
+    if (cls == 0) {
+        MESH_TRACE_ERROR(MESH_TRACE_JNI, "NO CLASS");
+        return -1;
     }
+    jniWrapperClass = (*sCallbackEnv)->NewGlobalRef(sCallbackEnv, cls);
+    (*sCallbackEnv)->DeleteLocalRef(sCallbackEnv, cls);
 
     processDataCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "ProcessData", "(S[BI)V");
-    if(processDataCb == NULL) Log("processDataCb is null");
+    if(processDataCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "processDataCb is null");
 
     processGattPktCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "ProcessGattPacket", "(S[BI)V");
-    if(processGattPktCb == NULL) Log("processGattPktCb is null");
+    if(processGattPktCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "processGattPktCb is null");
 
     meshClientUnProvisionedDeviceCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientUnProvisionedDeviceCb", "([BILjava/lang/String;)V");
-    if(meshClientUnProvisionedDeviceCb == NULL) Log("meshClientUnProvisionedDeviceCb is null");
+    if(meshClientUnProvisionedDeviceCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientUnProvisionedDeviceCb is null");
 
     meshGattAdvScanStartCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientAdvScanStartCb", "()V");
-    if(meshGattAdvScanStartCb == NULL) Log("meshGattAdvScanStartCb is null");
+    if(meshGattAdvScanStartCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattAdvScanStartCb is null");
 
     meshGattSetScanTypeCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientSetAdvScanTypeCb", "(B)V");
-    if(meshGattAdvScanStartCb == NULL) Log("meshGattSetScanTypeCb is null");
+    if(meshGattAdvScanStartCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattSetScanTypeCb is null");
 
     meshGattAdvScanStopCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientAdvScanStopCb", "()V");
-    if(meshGattAdvScanStopCb == NULL) Log("meshGattAdvScanStopCb is null");
+    if(meshGattAdvScanStopCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattAdvScanStopCb is null");
     meshGattProvisSendCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientProvSendCb", "([BI)V");
-    if(meshGattProvisSendCb == NULL) Log("meshGattProvisSendCb is null");
+    if(meshGattProvisSendCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattProvisSendCb is null");
 
     meshGattProxySendCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientProxySendCb", "([BI)V");
-    if(meshGattProxySendCb == NULL) Log("meshGattProxySendCb is null");
+    if(meshGattProxySendCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattProxySendCb is null");
 
     meshGattConnectCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientConnectCb", "([B)V");
-    if(meshGattConnectCb == NULL) Log("meshGattConnectCb is null");
+    if(meshGattConnectCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattConnectCb is null");
 
     meshGattDisconnectCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientDisconnectCb", "(I)V");
-    if(meshGattDisconnectCb == NULL) Log("meshGattDisconnectCb is null");
+    if(meshGattDisconnectCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshGattDisconnectCb is null");
 
 #ifdef MESH_DFU_ENABLED
     meshClientDfuIsOtaSupportedCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientDfuIsOtaSupportedCb", "()Z");
-    if(meshClientDfuIsOtaSupportedCb == NULL) Log("meshClientDfuIsOtaSupportedCb is null");
+    if(meshClientDfuIsOtaSupportedCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientDfuIsOtaSupportedCb is null");
 
     meshClientDfuStartOtaCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientDfuStartOtaCb", "(Ljava/lang/String;)V");
-    if(meshClientDfuStartOtaCb == NULL) Log("meshClientDfuStartOtaCb is null");
+    if(meshClientDfuStartOtaCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientDfuStartOtaCb is null");
 
     meshClientDfuStatusCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientDfuStatusCb", "(B[B)V");
-    if(meshClientDfuStatusCb == NULL) Log("meshClientDfuStatusCb is null");
+    if(meshClientDfuStatusCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientDfuStatusCb is null");
 #endif
     meshClientProvisionCompletedCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientProvisionCompletedCb", "(B[B)V");
-    if(meshClientProvisionCompletedCb == NULL) Log("provisionCompletedCb is null");
+    if(meshClientProvisionCompletedCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "provisionCompletedCb is null");
 
     onOffStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientOnOffStateCb", "(Ljava/lang/String;BBI)V");
-    if(onOffStateCb == NULL) Log("onOffStateCb is null");
+    if(onOffStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "onOffStateCb is null");
 
     levelStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientLevelStateCb", "(Ljava/lang/String;SSI)V");
-    if(levelStateCb == NULL) Log("levelStateCb is null");
+    if(levelStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "levelStateCb is null");
 
     meshClientHslStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientHslStateCb", "(Ljava/lang/String;IIII)V");
-    if(meshClientHslStateCb == NULL) Log("meshClientHslStateCb is null");
+    if(meshClientHslStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientHslStateCb is null");
 
     meshClientLightnessStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientLightnessStateCb", "(Ljava/lang/String;III)V");
-    if(meshClientLightnessStateCb == NULL) Log("meshClientLightnessStateCb is null");
+    if(meshClientLightnessStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientLightnessStateCb is null");
 
     meshClientCtlStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientCtlStateCb", "(Ljava/lang/String;ISISI)V");
-    if(meshClientCtlStateCb == NULL) Log("meshClientCtlStateCb is null");
+    if(meshClientCtlStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientCtlStateCb is null");
 
     meshClientNodeConnectStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientNodeConnectStateCb", "(BLjava/lang/String;)V");
-    if(meshClientNodeConnectStateCb == NULL) Log("meshClientNodeConnectStateCb is null");
+    if(meshClientNodeConnectStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientNodeConnectStateCb is null");
 
     meshClientDbStateCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientDbStateCb", "(Ljava/lang/String;)V");
-    if(meshClientDbStateCb == NULL) Log("meshClientDbStateCb is null");
+    if(meshClientDbStateCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientDbStateCb is null");
 
     meshClientLinkStatusCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientLinkStatusCb", "(BISB)V");
-    if(meshClientLinkStatusCb == NULL) Log("meshClientLinkStatusCb is null");
+    if(meshClientLinkStatusCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientLinkStatusCb is null");
 
     meshClientNetworkOpenedCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientNetworkOpenedCb", "(B)V");
-    if(meshClientNetworkOpenedCb == NULL) Log("meshClientNetworkOpenedCb is null");
+    if(meshClientNetworkOpenedCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientNetworkOpenedCb is null");
 
     meshClientComponentInfoCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientComponentInfoCallback", "(BLjava/lang/String;Ljava/lang/String;)V");
-    if(meshClientComponentInfoCb == NULL) Log("meshClientComponentInfoCallback is null");
-
-    startTimercb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "startTimercb", "(II)V");
-    if(startTimercb == NULL) Log("startTimercb is null");
-
-    stopTimercb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "stopTimercb", "(I)V");
-    if(stopTimercb == NULL) Log("stopTimercb is null");
+    if(meshClientComponentInfoCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientComponentInfoCallback is null");
 
     sensorStatuscb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientSensorStatusCb", "(Ljava/lang/String;I[B)V");
-    if(sensorStatuscb == NULL) Log("sensorStatuscb is null");
+    if(sensorStatuscb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "sensorStatuscb is null");
 
     vendorStatusCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientVendorStatusCb", "(SSSBB[BS)V");
-    if(vendorStatusCb == NULL) Log("vendorStatusCb is null");
+    if(vendorStatusCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "vendorStatusCb is null");
 
     lightLcModeStatusCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientLightLcModeStatusCb", "(Ljava/lang/String;I)V");
-    if(lightLcModeStatusCb == NULL) Log("meshClientLightLcModeStatusCb is null");
+    if(lightLcModeStatusCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "meshClientLightLcModeStatusCb is null");
 
     lightLcOccupancyModeStatusCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientLightLcOccupancyModeStatusCb", "(Ljava/lang/String;I)V");
-    if(lightLcOccupancyModeStatusCb == NULL) Log("lightLcOccupancyModeStatusCb is null");
+    if(lightLcOccupancyModeStatusCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "lightLcOccupancyModeStatusCb is null");
 
     lightLcPropertyStatusCb = (*sCallbackEnv)->GetStaticMethodID(sCallbackEnv, jniWrapperClass, "meshClientLightLcPropertyStatusCb", "(Ljava/lang/String;II)V");
-    if(lightLcPropertyStatusCb == NULL) Log("lightLcPropertyStatusCb is null");
+    if(lightLcPropertyStatusCb == NULL) MESH_TRACE_ERROR(MESH_TRACE_JNI, "lightLcPropertyStatusCb is null");
 
     //cdToExtStorage();
     //setting seed for random number generation
@@ -0,0 +1,1012 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Headless mesh client for Linux.
+ *
+ * Runs the mesh core and mesh_client_lib without a UI. Bluetooth LE is reached through a
+ * WICED board running the hci_control application, using the same UDP framing that
+ * WicedHciBridge forwards: every datagram holds one WICED HCI packet. Commands are read
+ * line by line from stdin and results are printed to stdout as "EVT ..." lines, so the
+ * daemon can be driven by a script or by another process over a pipe.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include "wiced.h"
+#include "mesh_main.h"
+#include "mesh_trace.h"
+#include "wiced_bt_ble.h"
+#include "bt_types.h"
+#include "wiced_bt_mesh_core.h"
+#include "wiced_bt_mesh_provision.h"
+#include "wiced_mesh_client.h"
+#include "hci_control_api.h"
+
+#define MESH_DAEMON_UDP_PORT            9877        // port used by WicedHciBridge on both ends
+
+#define MESH_PROVISIONING_DATA_IN       0x2ADB
+#define MESH_PROVISIONING_DATA_OUT      0x2ADC
+#define MESH_PROXY_DATA_IN              0x2ADD
+#define MESH_PROXY_DATA_OUT             0x2ADE
+
+#define MESH_DEFAULT_MTU                23
+#define MESH_MAX_HCI_PACKET             1500
+#define MESH_ADV_DATA_MAX               62
+#define MESH_CMD_LINE_MAX               512
+#define MESH_CMD_MAX_ARGS               8
+
+typedef enum
+{
+    GATT_STATE_IDLE,
+    GATT_STATE_CONNECTING,
+    GATT_STATE_DISCOVERING,
+    GATT_STATE_ENABLING_NOTIFY,
+    GATT_STATE_CONNECTED,
+} mesh_gatt_state_t;
+
+typedef struct
+{
+    int                 sock;
+    struct sockaddr_in  bridge_addr;
+    mesh_gatt_state_t   state;
+    wiced_bool_t        provisioning;           // connection is for PB-GATT, otherwise for the proxy
+    uint16_t            conn_id;
+    uint16_t            mtu;
+    uint16_t            handle[4];              // value handles of 0x2ADB..0x2ADE, 0 if not found
+    uint16_t            data_in_handle;
+    uint16_t            data_out_handle;
+
+    uint32_t            tx_packets;
+    uint32_t            tx_bytes;
+    uint32_t            rx_packets;
+    uint32_t            rx_bytes;
+    uint32_t            tx_errors;
+    uint32_t            adv_reports;
+    uint32_t            data_packets_in;
+    uint32_t            data_packets_out;
+} mesh_transport_t;
+
+static mesh_transport_t transport;
+
+static char provisioner_name[64];
+static char provisioner_uuid[33];
+static char cmd_line[MESH_CMD_LINE_MAX];
+static int  cmd_line_len;
+
+extern void mesh_client_advert_report(uint8_t *bd_addr, uint8_t addr_type, int8_t rssi, uint8_t *adv_data);
+
+/******************************************************
+ *          Transport
+ ******************************************************/
+static wiced_bool_t transport_send(uint16_t opcode, const uint8_t *p_data, uint16_t len)
+{
+    uint8_t buf[MESH_MAX_HCI_PACKET];
+    ssize_t sent;
+
+    if (len > sizeof(buf) - 5)
+        return WICED_FALSE;
+
+    buf[0] = HCI_WICED_PKT;
+    buf[1] = (uint8_t)opcode;
+    buf[2] = (uint8_t)(opcode >> 8);
+    buf[3] = (uint8_t)len;
+    buf[4] = (uint8_t)(len >> 8);
+    if (len != 0)
+        memcpy(&buf[5], p_data, len);
+
+    sent = sendto(transport.sock, buf, len + 5, 0, (struct sockaddr *)&transport.bridge_addr, sizeof(transport.bridge_addr));
+    if (sent != len + 5)
+    {
+        transport.tx_errors++;
+        Log("transport_send opcode:%04x failed: %s\n", opcode, strerror(errno));
+        return WICED_FALSE;
+    }
+    transport.tx_packets++;
+    transport.tx_bytes += (uint32_t)sent;
+    return WICED_TRUE;
+}
+
+static void transport_gatt_write(uint16_t opcode, uint16_t handle, const uint8_t *p_data, uint16_t len)
+{
+    uint8_t buf[MESH_MAX_HCI_PACKET];
+    uint8_t *p = buf;
+
+    if (len > sizeof(buf) - 4)
+        return;
+
+    UINT16_TO_STREAM(p, transport.conn_id);
+    UINT16_TO_STREAM(p, handle);
+    memcpy(p, p_data, len);
+    transport_send(opcode, buf, (uint16_t)(len + 4));
+}
+
+static void transport_connection_up(void)
+{
+    transport.state = GATT_STATE_CONNECTED;
+    printf("EVT connected conn_id:%d mtu:%d %s\n", transport.conn_id, transport.mtu, transport.provisioning ? "provisioning" : "proxy");
+    mesh_client_connection_state_changed(transport.conn_id, transport.mtu);
+}
+
+static void transport_connection_down(void)
+{
+    mesh_gatt_state_t state = transport.state;
+
+    transport.state   = GATT_STATE_IDLE;
+    transport.conn_id = 0;
+    transport.mtu     = MESH_DEFAULT_MTU;
+    memset(transport.handle, 0, sizeof(transport.handle));
+
+    // The client only knows about connections that made it to the connected state or that it asked for
+    if (state != GATT_STATE_IDLE)
+        mesh_client_connection_state_changed(0, 0);
+}
+
+static void transport_discovery_complete(void)
+{
+    static const uint8_t cccd_notify[2] = { 0x01, 0x00 };
+
+    if (transport.provisioning)
+    {
+        transport.data_in_handle  = transport.handle[0];
+        transport.data_out_handle = transport.handle[1];
+    }
+    else
+    {
+        transport.data_in_handle  = transport.handle[2];
+        transport.data_out_handle = transport.handle[3];
+    }
+
+    if ((transport.data_in_handle == 0) || (transport.data_out_handle == 0))
+    {
+        uint8_t buf[2];
+        uint8_t *p = buf;
+
+        Log("mesh %s service not found\n", transport.provisioning ? "provisioning" : "proxy");
+        UINT16_TO_STREAM(p, transport.conn_id);
+        transport_send(HCI_CONTROL_LE_COMMAND_DISCONNECT, buf, 2);
+        return;
+    }
+
+    // The client characteristic configuration descriptor follows the characteristic value
+    transport.state = GATT_STATE_ENABLING_NOTIFY;
+    transport_gatt_write(HCI_CONTROL_GATT_COMMAND_WRITE_REQUEST, transport.data_out_handle + 1, cccd_notify, sizeof(cccd_notify));
+}
+
+static void transport_handle_event(uint16_t opcode, uint8_t *p, uint16_t len)
+{
+    uint8_t     bda[BD_ADDR_LEN];
+    uint8_t     adv_data[MESH_ADV_DATA_MAX + 1];
+    uint16_t    conn_id, handle, uuid, mtu;
+    uint8_t     addr_type;
+    int8_t      rssi;
+    int         i;
+
+    switch (opcode)
+    {
+    case HCI_CONTROL_EVENT_DEVICE_STARTED:
+        Log("bridge device started\n");
+        if (transport.state != GATT_STATE_IDLE)
+            transport_connection_down();
+        break;
+
+    case HCI_CONTROL_LE_EVENT_ADVERTISEMENT_REPORT:
+        if (len < 9)
+            break;
+        transport.adv_reports++;
+        addr_type = p[1];
+        // HCI carries the address LSB first, mesh_client expects it MSB first
+        for (i = 0; i < BD_ADDR_LEN; i++)
+            bda[i] = p[2 + BD_ADDR_LEN - 1 - i];
+        rssi = (int8_t)p[8];
+        // mesh_client parses length-type-value records up to a zero length, so terminate the data
+        memset(adv_data, 0, sizeof(adv_data));
+        memcpy(adv_data, &p[9], (len - 9 < MESH_ADV_DATA_MAX) ? len - 9 : MESH_ADV_DATA_MAX);
+        mesh_client_advert_report(bda, addr_type, rssi, adv_data);
+        break;
+
+    case HCI_CONTROL_LE_EVENT_CONNECTED:
+        if (len < 9)
+            break;
+        p += 1 + BD_ADDR_LEN;
+        STREAM_TO_UINT16(conn_id, p);
+        transport.conn_id = conn_id;
+        transport.mtu     = MESH_DEFAULT_MTU;
+        memset(transport.handle, 0, sizeof(transport.handle));
+        transport.state   = GATT_STATE_DISCOVERING;
+        {
+            uint8_t buf[6];
+            uint8_t *q = buf;
+            UINT16_TO_STREAM(q, conn_id);
+            UINT16_TO_STREAM(q, 0x0001);
+            UINT16_TO_STREAM(q, 0xffff);
+            transport_send(HCI_CONTROL_GATT_COMMAND_DISCOVER_CHARACTERISTICS, buf, sizeof(buf));
+        }
+        break;
+
+    case HCI_CONTROL_LE_EVENT_DISCONNECTED:
+        if (len < 2)
+            break;
+        STREAM_TO_UINT16(conn_id, p);
+        printf("EVT disconnected conn_id:%d reason:%d\n", conn_id, (len > 2) ? *p : 0);
+        transport_connection_down();
+        break;
+
+    case HCI_CONTROL_LE_EVENT_PEER_MTU:
+        if (len < 4)
+            break;
+        STREAM_TO_UINT16(conn_id, p);
+        STREAM_TO_UINT16(mtu, p);
+        if (conn_id == transport.conn_id)
+        {
+            transport.mtu = mtu;
+            if (transport.state == GATT_STATE_CONNECTED)
+                wiced_bt_mesh_core_set_gatt_mtu(mtu);
+        }
+        break;
+
+    case HCI_CONTROL_GATT_EVENT_CHARACTERISTIC_DISCOVERED:
+        // conn_id, characteristic handle, 2 or 16 byte UUID, properties, value handle
+        if ((len != 9) && (len != 23))
+            break;
+        // only the 16-bit SIG UUIDs are of interest
+        if (len == 23)
+            break;
+        p += 4;
+        STREAM_TO_UINT16(uuid, p);
+        p += 1;
+        STREAM_TO_UINT16(handle, p);
+        if ((uuid >= MESH_PROVISIONING_DATA_IN) && (uuid <= MESH_PROXY_DATA_OUT))
+            transport.handle[uuid - MESH_PROVISIONING_DATA_IN] = handle;
+        break;
+
+    case HCI_CONTROL_GATT_EVENT_DISCOVERY_COMPLETE:
+        if (transport.state == GATT_STATE_DISCOVERING)
+            transport_discovery_complete();
+        break;
+
+    case HCI_CONTROL_GATT_EVENT_WRITE_RESPONSE:
+        if (transport.state == GATT_STATE_ENABLING_NOTIFY)
+            transport_connection_up();
+        break;
+
+    case HCI_CONTROL_GATT_EVENT_NOTIFICATION:
+        if ((len < 4) || (transport.state != GATT_STATE_CONNECTED))
+            break;
+        STREAM_TO_UINT16(conn_id, p);
+        STREAM_TO_UINT16(handle, p);
+        if (handle != transport.data_out_handle)
+            break;
+        transport.data_packets_in++;
+        if (transport.provisioning)
+            mesh_client_provisioning_data(WICED_TRUE, p, len - 4);
+        else
+            mesh_client_proxy_data(p, len - 4);
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Loop callback for the bridge socket, runs with the mesh lock held
+static void transport_sock_cback(int fd, uint32_t events, void *arg)
+{
+    uint8_t  buf[MESH_MAX_HCI_PACKET];
+    ssize_t  len;
+    uint16_t opcode, param_len;
+
+    while ((len = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+    {
+        transport.rx_packets++;
+        transport.rx_bytes += (uint32_t)len;
+
+        if ((len < 5) || (buf[0] != HCI_WICED_PKT))
+            continue;
+        opcode    = (uint16_t)(buf[1] | (buf[2] << 8));
+        param_len = (uint16_t)(buf[3] | (buf[4] << 8));
+        if (param_len > len - 5)
+            continue;
+        transport_handle_event(opcode, &buf[5], param_len);
+    }
+}
+
+static wiced_bool_t transport_open(const char *bridge_ip, uint16_t port)
+{
+    struct sockaddr_in local;
+
+    memset(&transport, 0, sizeof(transport));
+    transport.mtu = MESH_DEFAULT_MTU;
+
+    transport.bridge_addr.sin_family = AF_INET;
+    transport.bridge_addr.sin_port   = htons(port);
+    if (inet_pton(AF_INET, bridge_ip, &transport.bridge_addr.sin_addr) != 1)
+    {
+        fprintf(stderr, "bad bridge address %s\n", bridge_ip);
+        return WICED_FALSE;
+    }
+
+    transport.sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (transport.sock < 0)
+        return WICED_FALSE;
+
+    memset(&local, 0, sizeof(local));
+    local.sin_family      = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port        = htons(port);
+    if (bind(transport.sock, (struct sockaddr *)&local, sizeof(local)) != 0)
+    {
+        fprintf(stderr, "cannot bind UDP port %d: %s\n", port, strerror(errno));
+        close(transport.sock);
+        return WICED_FALSE;
+    }
+    return mesh_loop_add_fd(transport.sock, EPOLLIN, transport_sock_cback, NULL);
+}
+
+/******************************************************
+ *          Platform hooks called by the mesh core and mesh_client_lib
+ ******************************************************/
+wiced_bool_t mesh_adv_scan_start(void)
+{
+    uint8_t param[2] = { 1, 0 };    // enable, do not filter duplicates
+
+    return transport_send(HCI_CONTROL_LE_COMMAND_SCAN, param, sizeof(param));
+}
+
+void mesh_adv_scan_stop(void)
+{
+    uint8_t param[2] = { 0, 0 };
+
+    transport_send(HCI_CONTROL_LE_COMMAND_SCAN, param, sizeof(param));
+}
+
+wiced_bool_t mesh_set_scan_type(uint8_t is_active)
+{
+    return WICED_TRUE;
+}
+
+void wiced_bt_ble_set_scan_mode(uint8_t is_active)
+{
+}
+
+wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
+    wiced_bt_ble_conn_mode_t conn_mode, wiced_bool_t is_direct)
+{
+    uint8_t param[1 + BD_ADDR_LEN];
+    int     i;
+
+    if (transport.state != GATT_STATE_IDLE)
+    {
+        MESH_TRACE_DEBUG(MESH_TRACE_GATT, "mesh_bt_gatt_le_connect: busy state:%d\n", transport.state);
+        return WICED_FALSE;
+    }
+    transport.provisioning = mesh_client_is_connecting_provisioning();
+
+    param[0] = (uint8_t)bd_addr_type;
+    for (i = 0; i < BD_ADDR_LEN; i++)
+        param[1 + i] = bd_addr[BD_ADDR_LEN - 1 - i];
+
+    if (!transport_send(HCI_CONTROL_LE_COMMAND_CONNECT, param, sizeof(param)))
+        return WICED_FALSE;
+    transport.state = GATT_STATE_CONNECTING;
+    return WICED_TRUE;
+}
+
+wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id)
+{
+    uint8_t param[2];
+    uint8_t *p = param;
+
+    UINT16_TO_STREAM(p, conn_id);
+    return transport_send(HCI_CONTROL_LE_COMMAND_DISCONNECT, param, sizeof(param));
+}
+
+void mesh_provision_gatt_send(uint16_t conn_id, const uint8_t *packet, uint32_t packet_len)
+{
+    if ((transport.state != GATT_STATE_CONNECTED) || !transport.provisioning)
+        return;
+    transport.data_packets_out++;
+    transport_gatt_write(HCI_CONTROL_GATT_COMMAND_WRITE_COMMAND, transport.data_in_handle, packet, (uint16_t)packet_len);
+}
+
+void proxy_gatt_send_cb(uint32_t conn_id, uint32_t ref_data, const uint8_t *packet, uint32_t packet_len)
+{
+    if ((transport.state != GATT_STATE_CONNECTED) || transport.provisioning)
+        return;
+    transport.data_packets_out++;
+    transport_gatt_write(HCI_CONTROL_GATT_COMMAND_WRITE_COMMAND, transport.data_in_handle, packet, (uint16_t)packet_len);
+}
+
+wiced_result_t wiced_send_gatt_packet(uint16_t opcode, const uint8_t* p_data, uint16_t length)
+{
+    return WICED_BT_SUCCESS;
+}
+
+uint32_t wiced_bt_get_fw_image_size(uint8_t partition)
+{
+    return 0;
+}
+
+void wiced_bt_get_fw_image_chunk(uint8_t partition, uint32_t offset, uint8_t *p_data, uint16_t data_len)
+{
+}
+
+/******************************************************
+ *          mesh_client callbacks
+ ******************************************************/
+static void print_uuid(const char *prefix, const uint8_t *p_uuid)
+{
+    int i;
+
+    printf("%s", prefix);
+    for (i = 0; i < 16; i++)
+        printf("%02x", p_uuid[i]);
+}
+
+static void unprovisioned_device(uint8_t *p_uuid, uint16_t oob, uint8_t *name, uint8_t name_len)
+{
+    print_uuid("EVT unprovisioned uuid:", p_uuid);
+    printf(" oob:%04x name:%.*s\n", oob, name_len, (name != NULL) ? (char *)name : "");
+}
+
+static void provision_status(uint8_t status, uint8_t *p_uuid)
+{
+    print_uuid("EVT provision uuid:", p_uuid);
+    printf(" status:%d\n", status);
+}
+
+static void link_status(uint8_t is_connected, uint32_t conn_id, uint16_t addr, uint8_t is_over_gatt)
+{
+    printf("EVT link connected:%d conn_id:%u addr:%04x gatt:%d\n", is_connected, conn_id, addr, is_over_gatt);
+}
+
+static void node_connect_status(uint8_t status, char *p_name)
+{
+    printf("EVT node_connect %s status:%d\n", p_name, status);
+}
+
+static void database_changed(char *mesh_name)
+{
+    printf("EVT db_changed %s\n", mesh_name);
+}
+
+static void network_opened(uint8_t status)
+{
+    printf("EVT network_opened status:%d\n", status);
+}
+
+static void component_info_status(uint8_t status, char *component_name, char *component_info)
+{
+    printf("EVT info %s status:%d %s\n", component_name, status, (component_info != NULL) ? component_info : "");
+}
+
+static void onoff_status(const char *device_name, uint8_t present, uint8_t target, uint32_t remaining_time)
+{
+    printf("EVT onoff %s present:%d target:%d remaining:%u\n", device_name, present, target, remaining_time);
+}
+
+static void level_status(const char *device_name, int16_t present, int16_t target, uint32_t remaining_time)
+{
+    printf("EVT level %s present:%d target:%d remaining:%u\n", device_name, present, target, remaining_time);
+}
+
+static void lightness_status(const char *device_name, uint16_t present, uint16_t target, uint32_t remaining_time)
+{
+    printf("EVT lightness %s present:%d target:%d remaining:%u\n", device_name, present, target, remaining_time);
+}
+
+static void hsl_status(const char *device_name, uint16_t lightness, uint16_t hue, uint16_t saturation, uint32_t remaining_time)
+{
+    printf("EVT hsl %s lightness:%d hue:%d saturation:%d remaining:%u\n", device_name, lightness, hue, saturation, remaining_time);
+}
+
+static void ctl_status(const char *device_name, uint16_t present_lightness, uint16_t present_temperature, uint16_t target_lightness, uint16_t target_temperature, uint32_t remaining_time)
+{
+    printf("EVT ctl %s lightness:%d temperature:%d target_lightness:%d target_temperature:%d remaining:%u\n",
+        device_name, present_lightness, present_temperature, target_lightness, target_temperature, remaining_time);
+}
+
+static void sensor_status(const char *device_name, int property_id, uint8_t length, uint8_t *value)
+{
+    int i;
+
+    printf("EVT sensor %s property:%04x value:", device_name, property_id);
+    for (i = 0; i < length; i++)
+        printf("%02x", value[i]);
+    printf("\n");
+}
+
+void meshClientVendorSpecificDataStatus(uint16_t src, uint16_t company_id, uint16_t model_id, uint8_t opcode, uint8_t ttl, uint8_t *p_data, uint16_t data_len)
+{
+    int i;
+
+    printf("EVT vendor src:%04x company:%04x model:%04x opcode:%02x ttl:%d data:", src, company_id, model_id, opcode, ttl);
+    for (i = 0; i < data_len; i++)
+        printf("%02x", p_data[i]);
+    printf("\n");
+}
+
+mesh_client_init_t mesh_client_init_callbacks =
+{
+    unprovisioned_device,
+    provision_status,
+    link_status,
+    node_connect_status,
+    database_changed,
+    onoff_status,
+    level_status,
+    lightness_status,
+    hsl_status,
+    ctl_status,
+    sensor_status,
+    meshClientVendorSpecificDataStatus,
+};
+
+/******************************************************
+ *          Command line interface
+ ******************************************************/
+static void print_list(const char *what, char *list)
+{
+    char *p;
+
+    printf("EVT %s", what);
+    for (p = list; (p != NULL) && (*p != 0); p += strlen(p) + 1)
+        printf(" \"%s\"", p);
+    printf("\n");
+    free(list);
+}
+
+static int parse_uuid(const char *str, uint8_t *p_uuid)
+{
+    int i;
+
+    if (strlen(str) != 32)
+        return 0;
+    for (i = 0; i < 16; i++)
+        if (sscanf(&str[i * 2], "%2hhx", &p_uuid[i]) != 1)
+            return 0;
+    return 1;
+}
+
+// Splits a command line into arguments. Double quotes group words, for names with spaces.
+static int split_args(char *line, char *argv[], int max_args)
+{
+    int argc = 0;
+
+    while (*line && argc < max_args)
+    {
+        while (*line == ' ' || *line == '\t')
+            line++;
+        if (*line == 0)
+            break;
+        if (*line == '"')
+        {
+            argv[argc++] = ++line;
+            while (*line && *line != '"')
+                line++;
+        }
+        else
+        {
+            argv[argc++] = line;
+            while (*line && *line != ' ' && *line != '\t')
+                line++;
+        }
+        if (*line)
+            *line++ = 0;
+    }
+    return argc;
+}
+
+static const char *help_text =
+    "networks | create <mesh> | open <mesh> | close | delete <mesh>\n"
+    "groups [<group>] | components <group> | group-create <name> [<parent>]\n"
+    "scan <0|1> [<uuid>] | provision <name> <group> <uuid> [<identify_s>]\n"
+    "connect [<scan_s>] | disconnect | connect-component <name> [<scan_s>]\n"
+    "identify <name> [<s>] | onoff <name> <0|1> | onoff-get <name>\n"
+    "level <name> <level> | level-get <name> | lightness <name> <value> | lightness-get <name>\n"
+    "hsl-get <name> | ctl-get <name> | reset <name> | rename <old> <new>\n"
+    "info <name> | export <mesh> | stats | trace [<category>=<level>,...] | help | quit\n";
+
+// Runs with the mesh lock held
+static void process_command(char *line)
+{
+    char    *argv[MESH_CMD_MAX_ARGS];
+    int     argc = split_args(line, argv, MESH_CMD_MAX_ARGS);
+    int     res = 0;
+    uint8_t uuid[16];
+    char    *cmd;
+
+    if (argc == 0)
+        return;
+    cmd = argv[0];
+
+#define ARGS(n) if (argc < (n) + 1) { printf("EVT error %s: missing arguments\n", cmd); return; }
+
+    if (!strcmp(cmd, "networks"))
+        print_list("networks", mesh_client_get_all_networks());
+    else if (!strcmp(cmd, "create"))
+    {
+        ARGS(1);
+        res = mesh_client_network_create(provisioner_name, provisioner_uuid, argv[1]);
+    }
+    else if (!strcmp(cmd, "open"))
+    {
+        ARGS(1);
+        res = mesh_client_network_open(provisioner_name, provisioner_uuid, argv[1], network_opened);
+    }
+    else if (!strcmp(cmd, "close"))
+        mesh_client_network_close();
+    else if (!strcmp(cmd, "delete"))
+    {
+        ARGS(1);
+        res = mesh_client_network_delete(provisioner_name, provisioner_uuid, argv[1]);
+    }
+    else if (!strcmp(cmd, "groups"))
+        print_list("groups", mesh_client_get_all_groups(argc > 1 ? argv[1] : NULL));
+    else if (!strcmp(cmd, "components"))
+    {
+        ARGS(1);
+        print_list("components", mesh_client_get_group_components(argv[1]));
+    }
+    else if (!strcmp(cmd, "group-create"))
+    {
+        ARGS(1);
+        res = mesh_client_group_create(argv[1], argc > 2 ? argv[2] : NULL);
+    }
+    else if (!strcmp(cmd, "scan"))
+    {
+        ARGS(1);
+        if ((argc > 2) && !parse_uuid(argv[2], uuid))
+        {
+            printf("EVT error scan: bad uuid\n");
+            return;
+        }
+        res = mesh_client_scan_unprovisioned(atoi(argv[1]), (argc > 2) ? uuid : NULL);
+    }
+    else if (!strcmp(cmd, "provision"))
+    {
+        ARGS(3);
+        if (!parse_uuid(argv[3], uuid))
+        {
+            printf("EVT error provision: bad uuid\n");
+            return;
+        }
+        res = mesh_client_provision(argv[1], argv[2], uuid, (uint8_t)(argc > 4 ? atoi(argv[4]) : 10));
+    }
+    else if (!strcmp(cmd, "connect"))
+        res = mesh_client_connect_network(WICED_TRUE, (uint8_t)(argc > 1 ? atoi(argv[1]) : 100));
+    else if (!strcmp(cmd, "disconnect"))
+        res = mesh_client_disconnect_network();
+    else if (!strcmp(cmd, "connect-component"))
+    {
+        ARGS(1);
+        res = mesh_client_connect_component(argv[1], WICED_TRUE, (uint8_t)(argc > 2 ? atoi(argv[2]) : 100));
+    }
+    else if (!strcmp(cmd, "identify"))
+    {
+        ARGS(1);
+        res = mesh_client_identify(argv[1], (uint8_t)(argc > 2 ? atoi(argv[2]) : 10));
+    }
+    else if (!strcmp(cmd, "onoff"))
+    {
+        ARGS(2);
+        res = mesh_client_on_off_set(argv[1], (uint8_t)atoi(argv[2]), WICED_TRUE, 0, 0);
+    }
+    else if (!strcmp(cmd, "onoff-get"))
+    {
+        ARGS(1);
+        res = mesh_client_on_off_get(argv[1]);
+    }
+    else if (!strcmp(cmd, "level"))
+    {
+        ARGS(2);
+        res = mesh_client_level_set(argv[1], (int16_t)atoi(argv[2]), WICED_TRUE, 0, 0);
+    }
+    else if (!strcmp(cmd, "level-get"))
+    {
+        ARGS(1);
+        res = mesh_client_level_get(argv[1]);
+    }
+    else if (!strcmp(cmd, "lightness"))
+    {
+        ARGS(2);
+        res = mesh_client_lightness_set(argv[1], (uint16_t)atoi(argv[2]), WICED_TRUE, 0, 0);
+    }
+    else if (!strcmp(cmd, "lightness-get"))
+    {
+        ARGS(1);
+        res = mesh_client_lightness_get(argv[1]);
+    }
+    else if (!strcmp(cmd, "hsl-get"))
+    {
+        ARGS(1);
+        res = mesh_client_hsl_get(argv[1]);
+    }
+    else if (!strcmp(cmd, "ctl-get"))
+    {
+        ARGS(1);
+        res = mesh_client_ctl_get(argv[1]);
+    }
+    else if (!strcmp(cmd, "reset"))
+    {
+        ARGS(1);
+        res = mesh_client_reset_device(argv[1]);
+    }
+    else if (!strcmp(cmd, "rename"))
+    {
+        ARGS(2);
+        res = mesh_client_rename(argv[1], argv[2]);
+    }
+    else if (!strcmp(cmd, "info"))
+    {
+        ARGS(1);
+        res = mesh_client_get_component_info(argv[1], component_info_status);
+    }
+    else if (!strcmp(cmd, "export"))
+    {
+        char *json;
+
+        ARGS(1);
+        json = mesh_client_network_export(argv[1]);
+        if (json == NULL)
+            res = -1;
+        else
+        {
+            printf("EVT export %s\n", json);
+            free(json);
+        }
+    }
+    else if (!strcmp(cmd, "stats"))
+    {
+        printf("EVT stats state:%d conn_id:%d mtu:%d tx:%u/%uB rx:%u/%uB tx_err:%u adv:%u data_in:%u data_out:%u\n",
+            transport.state, transport.conn_id, transport.mtu, transport.tx_packets, transport.tx_bytes,
+            transport.rx_packets, transport.rx_bytes, transport.tx_errors, transport.adv_reports,
+            transport.data_packets_in, transport.data_packets_out);
+    }
+    else if (!strcmp(cmd, "trace"))
+    {
+        char levels[128];
+
+        if ((argc > 1) && (mesh_trace_configure(argv[1]) < 0))
+        {
+            printf("EVT error trace: bad level spec %s\n", argv[1]);
+            return;
+        }
+        mesh_trace_describe(levels, sizeof(levels));
+        printf("EVT trace %s\n", levels);
+    }
+    else if (!strcmp(cmd, "help"))
+        fputs(help_text, stdout);
+    else if (!strcmp(cmd, "quit"))
+    {
+        kill(getpid(), SIGTERM);
+        return;
+    }
+    else
+    {
+        printf("EVT error unknown command %s\n", cmd);
+        return;
+    }
+#undef ARGS
+
+    printf("EVT result %s %d\n", cmd, res);
+}
+
+// Loop callback for stdin, runs with the mesh lock held
+static void stdin_cback(int fd, uint32_t events, void *arg)
+{
+    ssize_t n;
+    char    *nl;
+
+    n = read(fd, &cmd_line[cmd_line_len], sizeof(cmd_line) - 1 - cmd_line_len);
+    if (n <= 0)
+    {
+        // end of input, keep serving the network until a signal arrives
+        mesh_loop_remove_fd(fd);
+        return;
+    }
+    cmd_line_len += (int)n;
+    cmd_line[cmd_line_len] = 0;
+
+    while ((nl = strchr(cmd_line, '\n')) != NULL)
+    {
+        *nl = 0;
+        process_command(cmd_line);
+        cmd_line_len -= (int)(nl + 1 - cmd_line);
+        memmove(cmd_line, nl + 1, cmd_line_len + 1);
+    }
+    if (cmd_line_len == sizeof(cmd_line) - 1)
+    {
+        printf("EVT error command too long\n");
+        cmd_line_len = 0;
+    }
+    fflush(stdout);
+}
+
+/******************************************************
+ *          Startup
+ ******************************************************/
+static void create_prov_uuid(void)
+{
+    uint8_t rnd[16];
+    FILE    *fp;
+    int     i;
+
+    fp = fopen("prov_uuid.bin", "rb");
+    if (fp != NULL)
+    {
+        if (fread(provisioner_uuid, 1, sizeof(provisioner_uuid), fp) == sizeof(provisioner_uuid))
+        {
+            provisioner_uuid[32] = 0;
+            fclose(fp);
+            return;
+        }
+        fclose(fp);
+    }
+
+    fp = fopen("/dev/urandom", "rb");
+    if ((fp == NULL) || (fread(rnd, 1, sizeof(rnd), fp) != sizeof(rnd)))
+    {
+        for (i = 0; i < 16; i++)
+            rnd[i] = (uint8_t)rand();
+    }
+    if (fp != NULL)
+        fclose(fp);
+
+    // Version 4 UUID (Random) per rfc4122
+    rnd[6] = (rnd[6] & 0x0f) | 0x40;
+    rnd[8] = (rnd[8] & 0x3f) | 0x80;
+    for (i = 0; i < 16; i++)
+        sprintf(&provisioner_uuid[i * 2], "%02X", rnd[i]);
+
+    Log("create prov_uuid.bin %s\n", provisioner_uuid);
+    fp = fopen("prov_uuid.bin", "wb");
+    if (fp != NULL)
+    {
+        fwrite(provisioner_uuid, 1, sizeof(provisioner_uuid), fp);
+        fclose(fp);
+    }
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-b bridge_ip] [-p udp_port] [-d data_dir] [-L log_file] [-q] [-n provisioner_name] [-t trace_levels]\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *bridge_ip = "127.0.0.1";
+    const char *data_dir  = ".";
+    const char *log_file  = NULL;
+    uint16_t   port       = MESH_DAEMON_UDP_PORT;
+    wiced_bool_t echo     = WICED_TRUE;
+    sigset_t   sigs;
+    int        sig, opt;
+
+    gethostname(provisioner_name, sizeof(provisioner_name) - 1);
+
+    while ((opt = getopt(argc, argv, "b:p:d:L:qn:t:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b': bridge_ip = optarg; break;
+        case 'p': port = (uint16_t)atoi(optarg); break;
+        case 'd': data_dir = optarg; break;
+        case 'L': log_file = optarg; break;
+        case 'q': echo = WICED_FALSE; break;
+        case 'n': snprintf(provisioner_name, sizeof(provisioner_name), "%s", optarg); break;
+        case 't':
+            if (mesh_trace_configure(optarg) < 0)
+            {
+                fprintf(stderr, "bad trace levels %s\n", optarg);
+                return 1;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!mesh_log_open(log_file, echo))
+    {
+        fprintf(stderr, "cannot open log file %s\n", log_file);
+        return 1;
+    }
+
+    // mesh_client_lib keeps the network databases in the current directory
+    if (((mkdir(data_dir, 0700) != 0) && (errno != EEXIST)) || (chdir(data_dir) != 0) || !mesh_nvram_init("."))
+    {
+        fprintf(stderr, "cannot use data directory %s\n", data_dir);
+        return 1;
+    }
+    create_prov_uuid();
+
+    // Signals are taken synchronously by the main thread, the loop thread never sees them
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    sigaddset(&sigs, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigs, NULL);
+
+    if (!mesh_loop_init() || !transport_open(bridge_ip, port))
+        return 1;
+
+    EnterCriticalSection();
+    mesh_client_init(&mesh_client_init_callbacks);
+    LeaveCriticalSection();
+
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    mesh_loop_add_fd(STDIN_FILENO, EPOLLIN, stdin_cback, NULL);
+
+    if (!mesh_loop_start())
+        return 1;
+
+    printf("EVT ready provisioner:%s uuid:%s bridge:%s:%d\n", provisioner_name, provisioner_uuid, bridge_ip, port);
+    fflush(stdout);
+
+    do
+    {
+        if (sigwait(&sigs, &sig) != 0)
+            break;
+    } while (sig == SIGPIPE);
+
+    mesh_loop_stop();
+    mesh_loop_join();
+
+    EnterCriticalSection();
+    if (transport.state != GATT_STATE_IDLE)
+        mesh_bt_gatt_le_disconnect(transport.conn_id);
+    mesh_client_network_close();
+    LeaveCriticalSection();
+
+    close(transport.sock);
+    mesh_log_close();
+    return 0;
+}
@@ -0,0 +1,956 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+*
+* Mesh Main implementation for Linux.
+*
+* POSIX platform layer for running the mesh core and mesh_client_lib without a phone or a
+* Windows host. Timers are kept in a list sorted by deadline, as in the Windows port, and a
+* single timerfd is armed for the head of the list. The timerfd and the descriptors added by
+* the application (transport socket, command input) are served by one epoll loop, so timer
+* callbacks, received packets and commands all run on the same thread under the cs lock.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+
+#include "mesh_main.h"
+#include "mesh_trace.h"
+#include "hex_dump.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_timer.h"
+#include "wiced_bt_mesh_core.h"
+#include "wiced_bt_mesh_provision.h"
+
+typedef void (TIMER_CBACK)(void *p_tle);
+
+#define TIMER_ACTIVE          0x0001
+
+typedef struct _tle
+{
+    struct _tle  *p_next;
+    TIMER_CBACK  *p_cback;
+    uint16_t      flags;                /* Flags for timer*/
+    uint16_t      type;
+    uint32_t      interval;             /* Timeout passed to wiced_start_timer, in seconds or ms depending on type */
+    TIMER_PARAM_TYPE arg;               /* parameter for expiration function */
+    uint64_t      target_time;          /* Target time for timer expire, in us of CLOCK_MONOTONIC */
+} TIMER_LIST_ENT;
+
+// TIMER_LIST_ENT lives inside the wiced_timer_t the caller allocated
+typedef char timer_list_ent_size_check[(sizeof(TIMER_LIST_ENT) <= sizeof(wiced_timer_t)) ? 1 : -1];
+
+typedef struct
+{
+    int                 fd;
+    mesh_loop_cback_t   *p_cback;
+    void                *arg;
+} MESH_LOOP_FD;
+
+static TIMER_LIST_ENT   *pOsTimerHead = NULL;
+static uint64_t         timer_armed_time = 0;       // deadline the timerfd is armed for, 0 if disarmed
+
+static int              epoll_fd  = -1;
+static int              timer_fd  = -1;
+static int              wakeup_fd = -1;
+static volatile int     loop_stop = 0;
+static pthread_t        loop_thread;
+static wiced_bool_t     loop_thread_started = WICED_FALSE;
+static MESH_LOOP_FD     loop_fds[MESH_LOOP_MAX_FDS];
+
+static pthread_mutex_t  cs = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+static FILE             *log_fp = NULL;
+static wiced_bool_t     log_to_stderr = WICED_TRUE;
+static pthread_mutex_t  log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static char             nvram_dir[256] = ".";
+
+extern wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
+    wiced_bt_ble_conn_mode_t conn_mode, wiced_bool_t is_direct);
+extern wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id);
+extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
+
+static void mesh_timer_expired(void);
+
+void EnterCriticalSection(void)
+{
+    pthread_mutex_lock(&cs);
+}
+
+void LeaveCriticalSection(void)
+{
+    pthread_mutex_unlock(&cs);
+}
+
+/*
+* Logging
+*/
+int mesh_log_open(const char *filename, wiced_bool_t echo_to_stderr)
+{
+    pthread_mutex_lock(&log_mutex);
+    if (log_fp != NULL)
+        fclose(log_fp);
+    log_fp = NULL;
+    if (filename != NULL)
+    {
+        log_fp = fopen(filename, "a");
+        if (log_fp != NULL)
+            setvbuf(log_fp, NULL, _IOLBF, 0);
+    }
+    log_to_stderr = echo_to_stderr;
+    pthread_mutex_unlock(&log_mutex);
+    return (filename == NULL) || (log_fp != NULL);
+}
+
+void mesh_log_close(void)
+{
+    mesh_log_open(NULL, log_to_stderr);
+}
+
+static void mesh_log_v(const char *fmt, va_list ap)
+{
+    char            buf[1024];
+    struct timespec ts;
+    struct tm       tm;
+    int             len;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    localtime_r(&ts.tv_sec, &tm);
+
+    len = snprintf(buf, sizeof(buf), "%02d:%02d:%02d.%03ld ", tm.tm_hour, tm.tm_min, tm.tm_sec, ts.tv_nsec / 1000000);
+    vsnprintf(&buf[len], sizeof(buf) - len - 1, fmt, ap);
+
+    len = (int)strlen(buf);
+    if (buf[len - 1] != '\n')
+    {
+        buf[len++] = '\n';
+        buf[len] = 0;
+    }
+
+    pthread_mutex_lock(&log_mutex);
+    if (log_fp != NULL)
+        fputs(buf, log_fp);
+    if (log_to_stderr)
+        fputs(buf, stderr);
+    pthread_mutex_unlock(&log_mutex);
+}
+
+void Log(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    mesh_log_v(fmt, ap);
+    va_end(ap);
+}
+
+void ods(char * fmt_str, ...)
+{
+    va_list ap;
+    va_start(ap, fmt_str);
+    mesh_log_v(fmt_str, ap);
+    va_end(ap);
+}
+
+int wiced_printf(char * buffer, int len, char * fmt_str, ...)
+{
+    va_list ap;
+    va_start(ap, fmt_str);
+    mesh_log_v(fmt_str, ap);
+    va_end(ap);
+    return 0;
+}
+
+static void Logn_write(const char *p_text, uint32_t len)
+{
+    Log("%s", p_text);
+}
+
+void Logn(uint8_t* data, int len)
+{
+    if (len > 0)
+        hex_dump(data, (uint32_t)len, 0, Logn_write);
+}
+
+void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh_core_state_t *p_state)
+{
+    if (type == WICED_BT_MESH_CORE_STATE_TYPE_SEQ)
+        mesh_provision_process_event(WICED_BT_MESH_SEQ_CHANGED, NULL, &p_state->seq);
+    else if(type == WICED_BT_MESH_CORE_STATE_IV)
+        mesh_provision_process_event(WICED_BT_MESH_IV_CHANGED, NULL, &p_state->iv);
+}
+
+/**
+* mesh trace functions.
+* These are just wrapper function for WICED trace function call. We use these
+* wrapper functions to make the mesh code easier to port on different platforms.
+*/
+void ble_trace0(const char *p_str)
+{
+    Log("%s", p_str);
+}
+
+void ble_trace1(const char *fmt_str, uint32_t p1)
+{
+    Log(fmt_str, p1);
+}
+
+void ble_trace2(const char *fmt_str, uint32_t p1, uint32_t p2)
+{
+    Log(fmt_str, p1, p2);
+}
+
+void ble_trace3(const char *fmt_str, uint32_t p1, uint32_t p2, uint32_t p3)
+{
+    Log(fmt_str, p1, p2, p3);
+}
+
+void ble_trace4(const char *fmt_str, uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4)
+{
+    Log(fmt_str, p1, p2, p3, p4);
+}
+
+void ble_tracen(const char *p_str, uint32_t len)
+{
+    Logn((uint8_t *)p_str, (int)len);
+}
+
+void* wiced_memory_allocate(uint32_t length)
+{
+    return malloc(length);
+}
+void* wiced_memory_permanent_allocate(uint32_t length)
+{
+    return malloc(length);
+}
+void wiced_memory_free(void *memoryBlock)
+{
+    free(memoryBlock);
+}
+
+void *wiced_bt_get_buffer(uint16_t len)
+{
+    return malloc(len);
+}
+void wiced_bt_free_buffer(void* buffer)
+{
+    free(buffer);
+}
+
+static uint64_t mesh_clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+uint64_t GetTickCount64(void)
+{
+    return mesh_clock_us() / 1000;
+}
+
+uint64_t clock_SystemTimeMicroseconds64(void)
+{
+    return mesh_clock_us();
+}
+
+/*
+* Timers
+*/
+
+// Arm the timerfd for the deadline of the first timer on the list. Called with cs held.
+static void mesh_timer_rearm(void)
+{
+    struct itimerspec its;
+    uint64_t          target = (pOsTimerHead != NULL) ? pOsTimerHead->target_time : 0;
+
+    if ((timer_fd < 0) || (target == timer_armed_time))
+        return;
+
+    memset(&its, 0, sizeof(its));
+    if (target != 0)
+    {
+        its.it_value.tv_sec  = target / 1000000;
+        its.it_value.tv_nsec = (target % 1000000) * 1000;
+    }
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+    timer_armed_time = target;
+}
+
+wiced_result_t wiced_init_timer(wiced_timer_t* p_timer, wiced_timer_callback_t TimerCb, TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
+{
+    TIMER_LIST_ENT *p = (TIMER_LIST_ENT *)p_timer;
+
+    memset(p_timer, 0, sizeof(TIMER_LIST_ENT));
+    p->p_cback  = TimerCb;
+    p->arg      = cBackparam;
+    p->type     = type;
+    p->interval = 0;
+
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_deinit_timer(wiced_timer_t* p)
+{
+    wiced_stop_timer(p);
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
+    TIMER_LIST_ENT *p_cur, *p_prev;
+    uint64_t       timeout_us;
+
+    if ((epoll_fd < 0) && !mesh_loop_init())
+        return WICED_BT_BADARG;
+
+    EnterCriticalSection();
+
+    // Make sure that we are not starting the same timer twice.
+    wiced_stop_timer(wt);
+
+    p_timer->interval = timeout;
+
+    timeout_us = (uint64_t)timeout * 1000;
+    if (p_timer->type == WICED_SECONDS_TIMER || p_timer->type == WICED_SECONDS_PERIODIC_TIMER)
+        timeout_us *= 1000;
+
+    p_timer->target_time = mesh_clock_us() + timeout_us;
+
+    // Put the timer in the appropriate place
+    if ((pOsTimerHead == NULL) || (pOsTimerHead->target_time > p_timer->target_time))
+    {
+        // New timer goes at start of list
+        p_timer->p_next = pOsTimerHead;
+        pOsTimerHead = p_timer;
+    }
+    else
+    {
+        p_prev = pOsTimerHead;
+        p_cur = p_prev->p_next;
+
+        while ((p_cur != NULL) && (p_cur->target_time <= p_timer->target_time))
+        {
+            p_prev = p_cur;
+            p_cur = p_cur->p_next;
+        }
+        p_prev->p_next  = p_timer;
+        p_timer->p_next = p_cur;
+    }
+
+    p_timer->flags |= TIMER_ACTIVE;
+
+    mesh_timer_rearm();
+
+    LeaveCriticalSection();
+
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
+    TIMER_LIST_ENT *pt;
+
+    EnterCriticalSection();
+
+    if (!(p_timer->flags & TIMER_ACTIVE))
+    {
+        LeaveCriticalSection();
+        return WICED_BT_SUCCESS;
+    }
+    p_timer->flags &= ~TIMER_ACTIVE;
+
+    if (p_timer == pOsTimerHead)
+    {
+        pOsTimerHead = pOsTimerHead->p_next;
+        mesh_timer_rearm();
+    }
+    else
+    {
+        /* Find timer in the queue */
+        for (pt = pOsTimerHead; pt != NULL; pt = pt->p_next)
+            if (pt->p_next == p_timer)
+                break;
+
+        if (pt != NULL)
+            pt->p_next = p_timer->p_next;
+    }
+    p_timer->p_next = NULL;
+
+    LeaveCriticalSection();
+
+    return WICED_BT_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)p;
+    if (p_timer->flags & TIMER_ACTIVE)
+        return WICED_TRUE;
+    else
+        return WICED_FALSE;
+}
+
+void wiced_release_timer(wiced_bt_mesh_event_t *p_event)
+{
+    wiced_stop_timer(&p_event->timer);
+}
+
+// Runs on the loop thread with cs held when the timerfd fires. Expires every timer that is due.
+static void mesh_timer_expired(void)
+{
+    uint64_t        expirations;
+    uint64_t        cur_time;
+    TIMER_LIST_ENT  *pTimer;
+
+    if (read(timer_fd, &expirations, sizeof(expirations)) < 0)
+    {
+        // EAGAIN: the timer was rearmed after this wakeup was queued
+    }
+    timer_armed_time = 0;
+
+    cur_time = mesh_clock_us();
+
+    while ((pTimer = pOsTimerHead) != NULL && (pTimer->target_time <= cur_time))
+    {
+        // Check for periodic timer. A periodic timer with no interval would expire forever.
+        if (((pTimer->type == WICED_SECONDS_PERIODIC_TIMER) || (pTimer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER)) &&
+            (pTimer->interval != 0))
+            wiced_start_timer((wiced_timer_t *)pTimer, pTimer->interval);
+        else
+            wiced_stop_timer((wiced_timer_t *)pTimer);
+
+        pTimer->p_cback(pTimer->arg);
+    }
+    mesh_timer_rearm();
+}
+
+/*
+* Event loop
+*/
+wiced_bool_t mesh_loop_init(void)
+{
+    struct epoll_event ev;
+    int                i;
+
+    EnterCriticalSection();
+    if (epoll_fd >= 0)
+    {
+        LeaveCriticalSection();
+        return WICED_TRUE;
+    }
+
+    for (i = 0; i < MESH_LOOP_MAX_FDS; i++)
+        loop_fds[i].fd = -1;
+
+    epoll_fd  = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd  = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((epoll_fd < 0) || (timer_fd < 0) || (wakeup_fd < 0))
+    {
+        ods("mesh_loop_init failed: %s\n", strerror(errno));
+        LeaveCriticalSection();
+        return WICED_FALSE;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN;
+    ev.data.fd = timer_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+    ev.data.fd = wakeup_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &ev);
+
+    // timers may have been started before the loop existed
+    timer_armed_time = 0;
+    mesh_timer_rearm();
+
+    LeaveCriticalSection();
+    return WICED_TRUE;
+}
+
+wiced_bool_t mesh_loop_add_fd(int fd, uint32_t events, mesh_loop_cback_t *p_cback, void *arg)
+{
+    struct epoll_event ev;
+    int                i;
+
+    if ((epoll_fd < 0) && !mesh_loop_init())
+        return WICED_FALSE;
+
+    EnterCriticalSection();
+    for (i = 0; i < MESH_LOOP_MAX_FDS; i++)
+        if (loop_fds[i].fd < 0)
+            break;
+    if (i == MESH_LOOP_MAX_FDS)
+    {
+        LeaveCriticalSection();
+        return WICED_FALSE;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        ods("mesh_loop_add_fd %d failed: %s\n", fd, strerror(errno));
+        LeaveCriticalSection();
+        return WICED_FALSE;
+    }
+    loop_fds[i].fd      = fd;
+    loop_fds[i].p_cback = p_cback;
+    loop_fds[i].arg     = arg;
+    LeaveCriticalSection();
+    return WICED_TRUE;
+}
+
+void mesh_loop_remove_fd(int fd)
+{
+    int i;
+
+    EnterCriticalSection();
+    for (i = 0; i < MESH_LOOP_MAX_FDS; i++)
+    {
+        if (loop_fds[i].fd == fd)
+        {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+            loop_fds[i].fd = -1;
+            break;
+        }
+    }
+    LeaveCriticalSection();
+}
+
+void mesh_loop_run(void)
+{
+    struct epoll_event events[MESH_LOOP_MAX_FDS + 2];
+    uint64_t           value;
+    int                n, i, j;
+
+    if ((epoll_fd < 0) && !mesh_loop_init())
+        return;
+
+    while (!loop_stop)
+    {
+        n = epoll_wait(epoll_fd, events, MESH_LOOP_MAX_FDS + 2, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            ods("epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+
+        EnterCriticalSection();
+        for (i = 0; i < n; i++)
+        {
+            int fd = events[i].data.fd;
+
+            if (fd == timer_fd)
+            {
+                mesh_timer_expired();
+            }
+            else if (fd == wakeup_fd)
+            {
+                if (read(wakeup_fd, &value, sizeof(value)) < 0)
+                    value = 0;
+            }
+            else
+            {
+                // a callback earlier in this batch may have removed the descriptor
+                for (j = 0; j < MESH_LOOP_MAX_FDS; j++)
+                {
+                    if (loop_fds[j].fd == fd)
+                    {
+                        loop_fds[j].p_cback(fd, events[i].events, loop_fds[j].arg);
+                        break;
+                    }
+                }
+            }
+        }
+        LeaveCriticalSection();
+    }
+}
+
+static void *mesh_loop_thread(void *arg)
+{
+    mesh_loop_run();
+    return NULL;
+}
+
+wiced_bool_t mesh_loop_start(void)
+{
+    if ((epoll_fd < 0) && !mesh_loop_init())
+        return WICED_FALSE;
+
+    loop_stop = 0;
+    if (pthread_create(&loop_thread, NULL, mesh_loop_thread, NULL) != 0)
+        return WICED_FALSE;
+    loop_thread_started = WICED_TRUE;
+    return WICED_TRUE;
+}
+
+void mesh_loop_stop(void)
+{
+    uint64_t value = 1;
+
+    loop_stop = 1;
+    if (wakeup_fd >= 0)
+    {
+        if (write(wakeup_fd, &value, sizeof(value)) < 0)
+            ods("mesh_loop_stop: %s\n", strerror(errno));
+    }
+}
+
+void mesh_loop_join(void)
+{
+    if (loop_thread_started)
+    {
+        pthread_join(loop_thread, NULL);
+        loop_thread_started = WICED_FALSE;
+    }
+}
+
+/*
+* File backed NVRAM
+*/
+wiced_bool_t mesh_nvram_init(const char *dir)
+{
+    if ((mkdir(dir, 0700) != 0) && (errno != EEXIST))
+    {
+        ods("mesh_nvram_init: cannot create %s: %s\n", dir, strerror(errno));
+        return WICED_FALSE;
+    }
+    snprintf(nvram_dir, sizeof(nvram_dir), "%s", dir);
+    return WICED_TRUE;
+}
+
+/*
+* Reads or writes one NVRAM index. A read of an index that was never written returns 0 bytes.
+* A write goes to a temporary file that is synced and renamed over the old one, so a crash
+* leaves either the old or the new contents. Writing 0 bytes deletes the index.
+*/
+uint32_t mesh_nvram_file_access(wiced_bool_t is_write, int inx, uint8_t* value, uint16_t len, wiced_result_t *p_result)
+{
+    char        name[300];
+    char        tmp_name[310];
+    int         fd;
+    ssize_t     n;
+    uint32_t    done = 0;
+    wiced_result_t result = WICED_BT_SUCCESS;
+
+    snprintf(name, sizeof(name), "%s/nvram_%04x.bin", nvram_dir, inx & 0xffff);
+
+    if (!is_write)
+    {
+        fd = open(name, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno != ENOENT)
+                result = WICED_ERROR;
+        }
+        else
+        {
+            while (done < len)
+            {
+                n = read(fd, value + done, len - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n < 0)
+                    result = WICED_ERROR;
+                if (n <= 0)
+                    break;
+                done += (uint32_t)n;
+            }
+            close(fd);
+        }
+    }
+    else if (len == 0)
+    {
+        if ((unlink(name) != 0) && (errno != ENOENT))
+            result = WICED_ERROR;
+    }
+    else
+    {
+        snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", name);
+        fd = open(tmp_name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0)
+        {
+            result = WICED_ERROR;
+        }
+        else
+        {
+            while (done < len)
+            {
+                n = write(fd, value + done, len - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                {
+                    result = WICED_ERROR;
+                    break;
+                }
+                done += (uint32_t)n;
+            }
+            if ((fdatasync(fd) != 0) || (close(fd) != 0) || (result != WICED_BT_SUCCESS) || (rename(tmp_name, name) != 0))
+            {
+                result = WICED_ERROR;
+                done = 0;
+                unlink(tmp_name);
+            }
+        }
+    }
+
+    if (result != WICED_BT_SUCCESS)
+        ods("mesh_nvram_file_access %s inx:%x failed: %s\n", is_write ? "write" : "read", inx, strerror(errno));
+    if (p_result)
+        *p_result = result;
+    return done;
+}
+
+// empty functions not needed in MeshController
+
+// ------------------- advertisements functions - not needed for now --------------------
+// it should be defined somewhere else
+typedef struct
+{
+    uint16_t    opcode;
+    uint16_t    param_len;
+    uint8_t     *p_param_buf;
+} tBTM_VSC_CMPL;
+typedef void (tBTM_VSC_CMPL_CB)(tBTM_VSC_CMPL *p1);
+typedef uint8_t tBTM_STATUS;
+tBTM_STATUS BTM_VendorSpecificCommand(uint16_t opcode, uint8_t param_len, uint8_t *p_param_buf, tBTM_VSC_CMPL_CB *p_cb)
+{
+    return 1;
+}
+//--------------------- end of advertisements functions --------------------
+
+void mesh_discovery_start(void)
+{
+}
+
+void mesh_update_beacon(void)
+{
+}
+
+void wiced_hal_wdog_reset_system(void)
+{
+}
+
+void mesh_discovery_stop(void)
+{
+}
+
+void provision_gatt_send(uint16_t conn_id, const uint8_t *packet, uint32_t packet_len)
+{
+}
+
+void mesh_provisioner_hci_event_scan_report_send(wiced_bt_mesh_event_t *p_event, wiced_bt_mesh_provision_scan_report_data_t *p_scan_report_data)
+{
+
+}
+
+/*
+* Send Proxy Device Network Data event over transport
+*/
+void mesh_provisioner_hci_event_proxy_device_send(wiced_bt_mesh_proxy_device_network_data_t *p_data)
+{
+
+}
+
+wiced_bt_dev_status_t wiced_bt_ble_observe(wiced_bool_t start, uint8_t duration, wiced_bt_ble_scan_result_cback_t *p_scan_result_cback)
+{
+    if (start)
+        mesh_adv_scan_start();
+    else
+        mesh_adv_scan_stop();
+
+    return WICED_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback)
+{
+    return WICED_TRUE;
+}
+
+wiced_bool_t wiced_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr,
+    wiced_bt_ble_address_type_t bd_addr_type,
+    wiced_bt_ble_conn_mode_t conn_mode,
+    wiced_bool_t is_direct)
+{
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "wiced_bt_gatt_le_connect\n");
+    return mesh_bt_gatt_le_connect(bd_addr, bd_addr_type, conn_mode, is_direct);
+}
+
+wiced_bool_t wiced_bt_gatt_cancel_connect(wiced_bt_device_address_t bd_addr, wiced_bool_t is_direct)
+{
+    return WICED_TRUE;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_disconnect(uint16_t conn_id)
+{
+    return mesh_bt_gatt_le_disconnect(conn_id);
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_configure_mtu(uint16_t conn_id, uint16_t mtu)
+{
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_discover(uint16_t conn_id, wiced_bt_gatt_discovery_type_t type, uint16_t uuid, uint16_t s_handle, uint16_t e_handle)
+{
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_util_set_gatt_client_config_descriptor(uint16_t conn_id, uint16_t handle, uint16_t value)
+{
+    return WICED_BT_GATT_SUCCESS;
+}
+
+#ifdef MESH_MAIN_UNIT_TEST
+// Timer ordering, stop, periodic restart and restart from a callback on the loop thread,
+// then a round trip through the file backed NVRAM.
+
+wiced_bool_t mesh_adv_scan_start(void) { return WICED_TRUE; }
+void mesh_adv_scan_stop(void) { }
+wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
+    wiced_bt_ble_conn_mode_t conn_mode, wiced_bool_t is_direct) { return WICED_TRUE; }
+wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id) { return WICED_TRUE; }
+
+static wiced_timer_t test_timers[5];
+static int           test_fired[5];
+static int           test_order[16];
+static int           test_order_len;
+
+static void test_timer_cback(TIMER_PARAM_TYPE arg)
+{
+    int idx = (int)(intptr_t)arg;
+
+    test_fired[idx]++;
+    if (test_order_len < 16)
+        test_order[test_order_len++] = idx;
+    // the 10 ms timer starts another one from its callback
+    if (idx == 1)
+        wiced_start_timer(&test_timers[4], 5);
+}
+
+int main(void)
+{
+    char           dir[64];
+    uint8_t        value[8] = { 1, 2, 3, 4, 5 }, read_back[8];
+    wiced_result_t result;
+    uint32_t       len;
+    int            i, fails = 0;
+
+    mesh_log_open(NULL, WICED_FALSE);
+
+    wiced_init_timer(&test_timers[0], test_timer_cback, (TIMER_PARAM_TYPE)(intptr_t)0, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&test_timers[1], test_timer_cback, (TIMER_PARAM_TYPE)(intptr_t)1, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&test_timers[2], test_timer_cback, (TIMER_PARAM_TYPE)(intptr_t)2, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+    wiced_init_timer(&test_timers[3], test_timer_cback, (TIMER_PARAM_TYPE)(intptr_t)3, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&test_timers[4], test_timer_cback, (TIMER_PARAM_TYPE)(intptr_t)4, WICED_MILLI_SECONDS_TIMER);
+
+    if (!mesh_loop_start())
+        return 1;
+
+    EnterCriticalSection();
+    wiced_start_timer(&test_timers[0], 40);
+    wiced_start_timer(&test_timers[1], 10);
+    wiced_start_timer(&test_timers[2], 25);
+    wiced_start_timer(&test_timers[3], 20);
+    wiced_stop_timer(&test_timers[3]);
+    LeaveCriticalSection();
+
+    usleep(115000);
+
+    EnterCriticalSection();
+    wiced_stop_timer(&test_timers[2]);
+    LeaveCriticalSection();
+
+    mesh_loop_stop();
+    mesh_loop_join();
+
+    printf("timer order:");
+    for (i = 0; i < test_order_len; i++)
+        printf(" %d", test_order[i]);
+    printf("\n");
+
+    if ((test_fired[0] != 1) || (test_fired[1] != 1) || (test_fired[3] != 0) || (test_fired[4] != 1))
+        fails++, printf("FAIL one shot timers fired %d %d %d %d\n", test_fired[0], test_fired[1], test_fired[3], test_fired[4]);
+    if ((test_fired[2] < 3) || (test_fired[2] > 5))
+        fails++, printf("FAIL periodic timer fired %d times\n", test_fired[2]);
+    if ((test_order_len < 3) || (test_order[0] != 1) || (test_order[1] != 4) || (test_order[2] != 2))
+        fails++, printf("FAIL timer order\n");
+    if (wiced_is_timer_in_use(&test_timers[2]) || wiced_is_timer_in_use(&test_timers[0]))
+        fails++, printf("FAIL timer still in use\n");
+
+    snprintf(dir, sizeof(dir), "/tmp/mesh_main_test_%d", (int)getpid());
+    if (!mesh_nvram_init(dir))
+        return 1;
+    len = mesh_nvram_file_access(WICED_FALSE, 0x12, read_back, sizeof(read_back), &result);
+    if ((len != 0) || (result != WICED_BT_SUCCESS))
+        fails++, printf("FAIL read of missing index\n");
+    len = mesh_nvram_file_access(WICED_TRUE, 0x12, value, 5, &result);
+    if ((len != 5) || (result != WICED_BT_SUCCESS))
+        fails++, printf("FAIL write\n");
+    memset(read_back, 0, sizeof(read_back));
+    len = mesh_nvram_file_access(WICED_FALSE, 0x12, read_back, sizeof(read_back), &result);
+    if ((len != 5) || (result != WICED_BT_SUCCESS) || memcmp(read_back, value, 5))
+        fails++, printf("FAIL read back\n");
+    mesh_nvram_file_access(WICED_TRUE, 0x12, value, 0, &result);
+    len = mesh_nvram_file_access(WICED_FALSE, 0x12, read_back, sizeof(read_back), &result);
+    if ((len != 0) || (result != WICED_BT_SUCCESS))
+        fails++, printf("FAIL delete\n");
+    rmdir(dir);
+
+    printf("%s\n", fails ? "FAILED" : "PASSED");
+    return fails ? 1 : 0;
+}
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Mesh Main definitions for the Linux (POSIX) platform layer
+ */
+#ifndef __MESH_MAIN_H__
+#define __MESH_MAIN_H__
+
+#include <stdint.h>
+#include <wiced.h>
+#include <wiced_result.h>
+
+#define WICED_BT_MESH_TRACE_ENABLE 1
+#define WICED_BT_TRACE_ENABLE
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#define BT_MEMSET memset
+#define BT_MEMCPY memcpy
+
+void wiced_hal_wdog_reset_system(void);
+uint8_t wiced_bt_gatt_disconnect(uint16_t conn_id);
+
+/*
+ * Implemented by the application (transport side): start/stop the LE scan, open and close the
+ * GATT connection to a proxy or an unprovisioned device and send provisioning and proxy PDUs.
+ */
+extern wiced_bool_t mesh_adv_scan_start(void);
+extern void mesh_adv_scan_stop(void);
+void wiced_bt_ble_set_scan_mode(uint8_t is_active);
+extern void mesh_provision_gatt_send(uint16_t conn_id, const uint8_t *packet, uint32_t packet_len);
+extern void proxy_gatt_send_cb(uint32_t conn_id, uint32_t ref_data, const uint8_t *packet, uint32_t packet_len);
+
+void Log(const char *fmt, ...);
+void Logn(uint8_t* data, int len);
+void ods(char * fmt_str, ...);
+int wiced_printf(char * buffer, int len, char * fmt_str, ...);
+#define WICED_BT_TRACE Log
+#define WICED_BT_TRACE_CRIT(...) wiced_printf(NULL, 0, __VA_ARGS__)
+#define WICED_BT_TRACE_ARRAY(ptr, len, ...) wiced_printf(NULL, 0, __VA_ARGS__); Logn((uint8_t *)(ptr), len);
+
+/*
+ * Logging. Every line is time stamped and written to the log file (if one is open) and,
+ * unless disabled, to stderr.
+ */
+int  mesh_log_open(const char *filename, wiced_bool_t echo_to_stderr);
+void mesh_log_close(void);
+
+/*
+ * Lock that serializes every call into the mesh core and mesh_client_lib. The event loop
+ * holds it while it runs timer and descriptor callbacks, other threads take it around their
+ * own calls. It is recursive.
+ */
+void EnterCriticalSection(void);
+void LeaveCriticalSection(void);
+
+/*
+ * Event loop. One thread waits in epoll_wait on the timer descriptor and on the descriptors
+ * the application registers (transport socket, command input) and runs their callbacks.
+ */
+typedef void (mesh_loop_cback_t)(int fd, uint32_t events, void *arg);
+
+#define MESH_LOOP_MAX_FDS   16
+
+wiced_bool_t mesh_loop_init(void);
+wiced_bool_t mesh_loop_add_fd(int fd, uint32_t events, mesh_loop_cback_t *p_cback, void *arg);
+void         mesh_loop_remove_fd(int fd);
+void         mesh_loop_run(void);           // runs on the calling thread until mesh_loop_stop
+wiced_bool_t mesh_loop_start(void);         // runs the loop on its own thread
+void         mesh_loop_stop(void);
+void         mesh_loop_join(void);
+
+/*
+ * File backed NVRAM. Each NVRAM index is kept in its own file in the directory passed to
+ * mesh_nvram_init. mesh_nvram_file_access has the signature of the core nvram_access_callback.
+ */
+wiced_bool_t mesh_nvram_init(const char *dir);
+uint32_t     mesh_nvram_file_access(wiced_bool_t write, int inx, uint8_t* value, uint16_t len, wiced_result_t *p_result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__MESH_MAIN_H__
@@ -34,6 +34,24 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <ctype.h>
+#include <stdarg.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
 
 #include "fid_app.h"
 
@@ -141,9 +159,36 @@ const char *fid_to_file_name(unsigned int fid)
     return i < sizeof(files) / sizeof(files[0]) ? files[i].file_rel_path : NULL;
 }
 
-char trace_line_buf[1024];
+char *trace_line_buf = NULL;
+size_t trace_line_buf_size = 0;
 unsigned int trace_line_num = 0;
 
+/* Reads the whole next line of the input trace file into trace_line_buf growing it as needed, so
+*  trace_line_num counts the same lines as the parallel decoder does.
+*  Return:  trace_line_buf; NULL on EOF or error
+*/
+char *read_trace_line(FILE* f)
+{
+    size_t len = 0, size;
+    char *p;
+    while (1)
+    {
+        if (trace_line_buf_size - len < 2)
+        {
+            size = trace_line_buf_size ? 2 * trace_line_buf_size : 1024;
+            if (NULL == (p = (char *)realloc(trace_line_buf, size)))
+                return NULL;
+            trace_line_buf = p;
+            trace_line_buf_size = size;
+        }
+        if (NULL == fgets(trace_line_buf + len, (int)(trace_line_buf_size - len), f))
+            return len ? trace_line_buf : NULL;
+        len += strlen(trace_line_buf + len);
+        if ((len && trace_line_buf[len - 1] == '\n') || feof(f))
+            return trace_line_buf;
+    }
+}
+
 /* Extracts next trace line from the input trace file and parses it. On parsing error prints line to stdout.
 *  Parameters:
 *   f:      handle of the input trace file.
@@ -162,7 +207,7 @@ int get_next_trace_line(FILE* f, unsigned int *fid, unsigned int *line, unsigned
     {
         trace_line_num++;
         // read next line and exit on error or EOF
-        if (NULL == fgets(trace_line_buf, sizeof(trace_line_buf), f))
+        if (NULL == read_trace_line(f))
         {
             if (feof(f))
                 break;
@@ -210,143 +255,1628 @@ int get_next_trace_line(FILE* f, unsigned int *fid, unsigned int *line, unsigned
     return ret;
 }
 
-FILE *f_src = NULL;         // Handle of the opened source file
-unsigned int fid_prev;      // File ID of the opened source file
+/* Format string index
+*  The indexer reads every source file of the files[] map once and records the format string and
+*  the number of parameters of each TRACE0..TRACE4 line. The result is one flat table which can be
+*  saved to a file and mapped back into memory, so finding the format string of a trace line is two
+*  array lookups instead of re-reading the source file up to that line.
+*  Layout of the table:
+*   dtd_index_hdr_t     header
+*   dtd_index_fid_t     fids[fid_count]     indexed by fid
+*   unsigned int        slots[slot_count]   per fid, indexed by (line - first_line). 0 - no trace on
+*                                           that line, otherwise offset of the record in strings[]
+*   char                strings[strings_size] records {unsigned char params_num; char fmt[]} where fmt
+*                                           is NUL terminated, has its trailing "\n" removed and
+*                                           \" and \\ replaced with the characters they stand for
+*/
+#define DTD_INDEX_MAGIC     0x49445444  // "DTDI"
+#define DTD_INDEX_VERSION   2
+#define DTD_INDEX_FID_MAX   0x10000     // fid is 16 bits
+
+typedef struct
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int fid_count;             // max fid + 1
+    unsigned int slot_count;
+    unsigned int strings_size;
+}dtd_index_hdr_t;
+
+typedef struct
+{
+    unsigned int first_line;            // line number of the first trace in the file
+    unsigned int line_count;            // lines from the first to the last trace, 0 if file has no traces
+    unsigned int slot_offset;           // index of the first_line slot in slots[]
+    unsigned int file_lines;            // number of lines in the file
+}dtd_index_fid_t;
+
+// growable buffer used while the index is built
+typedef struct
+{
+    unsigned char *p;
+    size_t size;
+    size_t alloc;
+}dtd_buf_t;
+
+const dtd_index_hdr_t *idx_hdr = NULL;  // index being used by the decoder
+const dtd_index_fid_t *idx_fids;
+const unsigned int *idx_slots;
+const char *idx_strings;
+
 char src_file_path[256];    // buffer with path to the source files folder
 int src_file_path_len;      // length of the path to the source files folder
 
-/* Returns format string from the TRACE macro on the line line_num of the file fid.
-*  In future it can be implemented using pre parsing of all source file to create
-*  the file with all format srings of all source files
+/* Appends data to the growable buffer.
+*  Return:  offset of the appended data in the buffer. On error return (size_t)-1.
+*/
+size_t dtd_buf_append(dtd_buf_t *b, const void *data, size_t len)
+{
+    size_t offset = b->size;
+    if (b->size + len > b->alloc)
+    {
+        size_t alloc = b->alloc ? b->alloc : 64 * 1024;
+        while (alloc < b->size + len)
+            alloc *= 2;
+        unsigned char *p = (unsigned char *)realloc(b->p, alloc);
+        if (p == NULL)
+            return (size_t)-1;
+        b->p = p;
+        b->alloc = alloc;
+    }
+    if (data)
+        memcpy(&b->p[b->size], data, len);
+    else
+        memset(&b->p[b->size], 0, len);
+    b->size += len;
+    return offset;
+}
+
+/* Extracts the format string from the source line with TRACE macro.
+*  Parameters:
+*   buf:            source line
+*   p_fmt_len:      variable to receive length of the format string without trailing "\n"
+*   p_params_num:   variable to receive number of parameters (it can be TRACE0, TRACE1, TRACE2, TRACE3 or TRACE4)
+*  Return:  pointer to the format string in buf. If line has no TRACE macro return NULL.
+*/
+const char *parse_trace_macro(const char *buf, int *p_fmt_len, unsigned int *p_params_num)
+{
+    const char *p = buf, *p_fmt, *p_end, *p_nl;
+    // find trace macro
+    while (NULL != (p = strstr(p, "TRACE")))
+    {
+        p += 5;
+        if (*p < '0' || *p > '4')
+            continue;
+        *p_params_num = (unsigned int)(*p++ - '0');
+        // skip white space
+        while (*p != 0 && (unsigned char)*p <= 0x20) p++;
+        if (*p++ != '(')
+            continue;
+        // find start of the format string
+        if (NULL == (p_fmt = strchr(p, '\"')))
+            return NULL;
+        p_fmt++;
+        // find end of the format string skipping escaped characters (\" or \\)
+        for (p_end = p_fmt, p_nl = NULL; *p_end != 0 && *p_end != '\"'; p_end++)
+        {
+            // remember where the last \n starts
+            if (*p_end == '\\' && p_end[1] != 0)
+            {
+                if (*++p_end == 'n')
+                    p_nl = p_end - 1;
+            }
+        }
+        if (*p_end == 0)
+            return NULL;
+        *p_fmt_len = (int)(p_end - p_fmt);
+        // remove new_line at the end
+        if (p_nl == p_end - 2)
+            *p_fmt_len -= 2;
+        return p_fmt;
+    }
+    return NULL;
+}
+
+/* Appends the format string to the index strings. \" and \\ are replaced with the characters they
+*  stand for, other escapes are kept as they are in the source.
+*  Return:  0 - success; 1 - error
+*/
+int append_format_string(dtd_buf_t *strings, const char *p_fmt, int fmt_len)
+{
+    const char *end = p_fmt + fmt_len, *p;
+    while (NULL != (p = (const char *)memchr(p_fmt, '\\', end - p_fmt)) && p + 1 < end)
+    {
+        if (dtd_buf_append(strings, p_fmt, p - p_fmt + (p[1] != '\"' && p[1] != '\\')) == (size_t)-1
+            || dtd_buf_append(strings, p + 1, 1) == (size_t)-1)
+            return 1;
+        p_fmt = p + 2;
+    }
+    return dtd_buf_append(strings, p_fmt, end - p_fmt) == (size_t)-1 || dtd_buf_append(strings, "", 1) == (size_t)-1;
+}
+
+/* Indexes TRACE macros of one source file.
+*  Parameters:
+*   f:          opened source file
+*   p_fid:      variable to receive position of the file traces in the index
+*   slots:      index slots
+*   strings:    index strings
+*  Return:  0 - success; 1 - error
+*/
+int index_source_file(FILE *f, dtd_index_fid_t *p_fid, dtd_buf_t *slots, dtd_buf_t *strings)
+{
+    char buf[1024];
+    unsigned int line_num = 1, params_num;
+    int fmt_len, line_end = 1;
+    const char *p_fmt;
+
+    p_fid->first_line = 0;
+    p_fid->line_count = 0;
+    p_fid->slot_offset = (unsigned int)(slots->size / sizeof(unsigned int));
+    while (NULL != fgets(buf, sizeof(buf), f))
+    {
+        // long line is read in several parts, count it once
+        if (!line_end)
+            line_num--;
+        line_end = strchr(buf, '\n') != NULL;
+        if (NULL != (p_fmt = parse_trace_macro(buf, &fmt_len, &params_num)))
+        {
+            if (p_fid->line_count == 0)
+                p_fid->first_line = line_num;
+            // add empty slots for lines without traces and the slot of this line
+            size_t slot = dtd_buf_append(slots, NULL, (line_num - p_fid->first_line + 1 - p_fid->line_count) * sizeof(unsigned int));
+            unsigned char c = (unsigned char)params_num;
+            size_t offset = dtd_buf_append(strings, &c, 1);
+            if (slot == (size_t)-1 || offset == (size_t)-1
+                || append_format_string(strings, p_fmt, fmt_len))
+                return 1;
+            p_fid->line_count = line_num - p_fid->first_line + 1;
+            ((unsigned int *)slots->p)[p_fid->slot_offset + p_fid->line_count - 1] = (unsigned int)offset;
+        }
+        line_num++;
+    }
+    p_fid->file_lines = line_num - 1;
+    if (ferror(f))
+    {
+        printf("Decoder: fgets failed. errno:0x%x file:%s\n", errno, &src_file_path[src_file_path_len]);
+        return 1;
+    }
+    return 0;
+}
+
+/* Builds the index of all source files in the folder src_file_path.
+*  Parameters:
+*   p_size:     variable to receive size of the index
+*  Return:  allocated index. On error return NULL.
+*/
+dtd_index_hdr_t *build_index(size_t *p_size)
+{
+    static dtd_index_fid_t fids[DTD_INDEX_FID_MAX];
+    dtd_buf_t slots = { NULL, 0, 0 }, strings = { NULL, 0, 0 }, index = { NULL, 0, 0 };
+    dtd_index_hdr_t hdr = { DTD_INDEX_MAGIC, DTD_INDEX_VERSION, 0, 0, 0 };
+    unsigned int i;
+    int ok = 1;
+
+    memset(fids, 0, sizeof(fids));
+    // offset 0 of the strings means no trace on the line
+    ok = dtd_buf_append(&strings, "", 1) != (size_t)-1;
+    for (i = 0; ok && i < sizeof(files) / sizeof(files[0]); i++)
+    {
+        strcpy(&src_file_path[src_file_path_len], files[i].file_rel_path);
+        FILE *f = fopen(src_file_path, "rt");
+        if (f == NULL)
+        {
+            // traces of that file will fail to decode but others are fine
+            printf("Decoder: failed to read file. errno=0x%x fid:0x%x file:%s\n", errno, files[i].fid, src_file_path);
+            continue;
+        }
+        if (index_source_file(f, &fids[files[i].fid], &slots, &strings))
+            ok = 0;
+        fclose(f);
+        if (files[i].fid >= hdr.fid_count)
+            hdr.fid_count = files[i].fid + 1;
+    }
+    hdr.slot_count = (unsigned int)(slots.size / sizeof(unsigned int));
+    hdr.strings_size = (unsigned int)strings.size;
+    if (!ok
+        || dtd_buf_append(&index, &hdr, sizeof(hdr)) == (size_t)-1
+        || dtd_buf_append(&index, fids, hdr.fid_count * sizeof(dtd_index_fid_t)) == (size_t)-1
+        || dtd_buf_append(&index, slots.p, slots.size) == (size_t)-1
+        || dtd_buf_append(&index, strings.p, strings.size) == (size_t)-1)
+    {
+        printf("Decoder: failed to build index\n");
+        free(index.p);
+        index.p = NULL;
+    }
+    free(slots.p);
+    free(strings.p);
+    *p_size = index.size;
+    return (dtd_index_hdr_t *)index.p;
+}
+
+/* Maps file into memory for reading.
+*  Parameters:
+*   file_name:  file name
+*   p_size:     variable to receive size of the file
+*  Return:  address of the mapped file. On error or if it isn't a regular file return NULL.
+*/
+const void *map_file(const char *file_name, size_t *p_size)
+{
+    const void *p = NULL;
+#ifdef _WIN32
+    HANDLE h_file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h_file == INVALID_HANDLE_VALUE)
+        return NULL;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(h_file, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= (size_t)-1)
+    {
+        HANDLE h_map = CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (h_map)
+        {
+            // the view keeps the mapping alive
+            p = MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(h_map);
+        }
+        *p_size = (size_t)size.QuadPart;
+    }
+    CloseHandle(h_file);
+#else
+    struct stat st;
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+            p = NULL;
+        *p_size = (size_t)st.st_size;
+    }
+    close(fd);
+#endif
+    return p;
+}
+
+void unmap_file(const void *p, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(p);
+#else
+    munmap((void *)p, size);
+#endif
+}
+
+/* Validates the index and makes it the one used by get_format_string.
+*  Return:  0 - success; 1 - error
+*/
+int use_index(const void *p, size_t size)
+{
+    const dtd_index_hdr_t *hdr = (const dtd_index_hdr_t *)p;
+    unsigned long long expected;
+    unsigned int i;
+
+    if (size < sizeof(dtd_index_hdr_t) || hdr->magic != DTD_INDEX_MAGIC || hdr->version != DTD_INDEX_VERSION
+        || hdr->fid_count > DTD_INDEX_FID_MAX || hdr->strings_size == 0)
+        return 1;
+    expected = sizeof(dtd_index_hdr_t) + (unsigned long long)hdr->fid_count * sizeof(dtd_index_fid_t)
+        + (unsigned long long)hdr->slot_count * sizeof(unsigned int) + hdr->strings_size;
+    if (size != expected)
+        return 1;
+    idx_fids = (const dtd_index_fid_t *)(hdr + 1);
+    idx_slots = (const unsigned int *)(idx_fids + hdr->fid_count);
+    idx_strings = (const char *)(idx_slots + hdr->slot_count);
+    // check bounds once here, so lookups don't need to
+    for (i = 0; i < hdr->fid_count; i++)
+    {
+        if ((unsigned long long)idx_fids[i].slot_offset + idx_fids[i].line_count > hdr->slot_count)
+            return 1;
+    }
+    for (i = 0; i < hdr->slot_count; i++)
+    {
+        if (idx_slots[i] != 0 && idx_slots[i] + 1 >= hdr->strings_size)
+            return 1;
+    }
+    if (idx_strings[hdr->strings_size - 1] != 0)
+        return 1;
+    idx_hdr = hdr;
+    return 0;
+}
+
+#define DTD_FMT_OK              0
+#define DTD_FMT_INVALID_PARAM   1
+#define DTD_FMT_NO_FID          2
+#define DTD_FMT_NO_STRING       3
+#define DTD_FMT_NO_LINE         4
+
+/* Looks up format string of the TRACE macro on the line line_num of the file fid in the index.
 *   Parameters:
 *       fid:            source file id
 *       line_num:       line number
-*       fmt:            buffer to receive format string
-*       fmt_size:       size of the buffer fmt
+*       p_fmt:          variable to receive the format string
 *       p_params_num:   variable to receive number of parameters in the format string.
-*   Return:  0 - success; 1 - error
+*   Return:  DTD_FMT_OK or one of DTD_FMT_ errors
 */
-int get_format_string(unsigned int fid, unsigned int line_num, char* fmt, int fmt_size, unsigned int *p_params_num)
+int lookup_format_string(unsigned int fid, unsigned int line_num, const char **p_fmt, unsigned int *p_params_num)
 {
-    char buf[1024];
-    unsigned int line_num_cnt;
+    unsigned int i;
     // fid and line_num can not be 0
     if (fid == 0 || line_num == 0)
+        return DTD_FMT_INVALID_PARAM;
+    if (fid >= idx_hdr->fid_count || idx_fids[fid].line_count == 0)
+    {
+        if (fid_to_file_name(fid) == NULL)
+            return DTD_FMT_NO_FID;
+        return fid < idx_hdr->fid_count && line_num > idx_fids[fid].file_lines ? DTD_FMT_NO_LINE : DTD_FMT_NO_STRING;
+    }
+    if (line_num > idx_fids[fid].file_lines)
+        return DTD_FMT_NO_LINE;
+    i = line_num - idx_fids[fid].first_line;
+    if (line_num < idx_fids[fid].first_line || i >= idx_fids[fid].line_count
+        || 0 == (i = idx_slots[idx_fids[fid].slot_offset + i]))
+        return DTD_FMT_NO_STRING;
+    *p_params_num = (unsigned char)idx_strings[i];
+    *p_fmt = &idx_strings[i + 1];
+    return DTD_FMT_OK;
+}
+
+/* Returns format string from the TRACE macro on the line line_num of the file fid.
+*   Parameters:
+*       fid:            source file id
+*       line_num:       line number
+*       p_params_num:   variable to receive number of parameters in the format string.
+*   Return:  format string. On error return NULL.
+*/
+const char *get_format_string(unsigned int fid, unsigned int line_num, unsigned int *p_params_num)
+{
+    const char *fmt = NULL;
+    switch (lookup_format_string(fid, line_num, &fmt, p_params_num))
     {
+    case DTD_FMT_INVALID_PARAM:
         printf("Decoder: invalid param. fid:0x%x line_num:%d trace_line_num:%d\n", fid, line_num, trace_line_num);
+        break;
+    case DTD_FMT_NO_FID:
+        printf("Decoder: no such fid:0x%x\n", fid);
+        break;
+    case DTD_FMT_NO_LINE:
+        printf("Decoder: no such line number %d in %s\n", idx_fids[fid].file_lines, fid_to_file_name(fid));
+        break;
+    case DTD_FMT_NO_STRING:
+        printf("Decoder: no format string. line number:%d file:%s trace_line_num:%d trace_line_buf:%s\n", line_num, fid_to_file_name(fid), trace_line_num, trace_line_buf);
+        break;
+    }
+    return fmt;
+}
+
+/* Sets path of the source files folder.
+*  Return:  0 - success; 1 - error
+*/
+int set_src_file_path(const char *path)
+{
+    // copy path of the source files folder to the buffer and calculate its length
+    src_file_path_len = (int)strlen(path);
+    if (src_file_path_len == 0 || src_file_path_len + 2 > (int)sizeof(src_file_path))
+    {
+        printf("Decoder: Invalid folder path\n");
         return 1;
     }
+    strcpy(src_file_path, path);
+    // make sure it is terminated with slash
+    if (src_file_path[src_file_path_len - 1] != '\\' && src_file_path[src_file_path_len - 1] != '/')
+    {
+        src_file_path[src_file_path_len++] = '\\';
+        src_file_path[src_file_path_len] = 0;
+    }
+    return 0;
+}
+
+/* Parallel decoding
+*  The capture is split into DTD_CHUNK_SIZE chunks. Each worker thread maps a view of one chunk,
+*  decodes the lines which start in it into its own output buffer and the main thread writes the
+*  buffers out in order. At most two chunks per thread are in flight, so memory use doesn't
+*  depend on the capture size and a 32 bit build can decode captures of any size.
+*  Error messages contain trace_line_num which depends on the lines of all previous chunks. The
+*  worker puts a DTD_OUT_ESC_LINE_NUM escape with the chunk local line number there and the
+*  writer replaces it with the absolute one.
+*/
+#define DTD_CHUNK_SIZE          (4 * 1024 * 1024)
+#define DTD_LINE_MAX            (64 * 1024)     // mapped past the chunk end first, more if the last line is longer
+#define DTD_THREADS_MAX         64
 
-    if (f_src == NULL           // if it is firs call
-        || fid != fid_prev)     // or source file other then previous one
+#define DTD_OUT_ESC             0               // escape byte in the chunk output
+#define DTD_OUT_ESC_NUL         0               // escaped NUL written by the trace format
+#define DTD_OUT_ESC_LINE_NUM    1               // followed by 4 bytes of the chunk local line number
+
+#ifdef _WIN32
+typedef SRWLOCK                 dtd_mutex_t;
+typedef CONDITION_VARIABLE      dtd_cond_t;
+typedef HANDLE                  dtd_thread_t;
+#define DTD_THREAD_RET          DWORD WINAPI
+#define DTD_MUTEX_INIT(p)       InitializeSRWLock(p)
+#define DTD_LOCK(p)             AcquireSRWLockExclusive(p)
+#define DTD_UNLOCK(p)           ReleaseSRWLockExclusive(p)
+#define DTD_COND_INIT(p)        InitializeConditionVariable(p)
+#define DTD_COND_WAIT(c, m)     SleepConditionVariableSRW(c, m, INFINITE, 0)
+#define DTD_COND_BROADCAST(c)   WakeAllConditionVariable(c)
+#else
+typedef pthread_mutex_t         dtd_mutex_t;
+typedef pthread_cond_t          dtd_cond_t;
+typedef pthread_t               dtd_thread_t;
+#define DTD_THREAD_RET          void *
+#define DTD_MUTEX_INIT(p)       pthread_mutex_init(p, NULL)
+#define DTD_LOCK(p)             pthread_mutex_lock(p)
+#define DTD_UNLOCK(p)           pthread_mutex_unlock(p)
+#define DTD_COND_INIT(p)        pthread_cond_init(p, NULL)
+#define DTD_COND_WAIT(c, m)     pthread_cond_wait(c, m)
+#define DTD_COND_BROADCAST(c)   pthread_cond_broadcast(c)
+#endif
+
+// writes decoded text to the output
+typedef void (dtd_write_t)(const char *p, size_t len);
+
+typedef struct
+{
+    dtd_buf_t out;                      // decoded text with DTD_OUT_ESC escapes
+    unsigned int lines;                 // number of lines which start in the chunk
+    int done;                           // set by the worker when out is ready
+    int failed;
+}dtd_chunk_t;
+
+typedef struct
+{
+#ifdef _WIN32
+    HANDLE h_map;
+#else
+    int fd;
+#endif
+    unsigned long long size;            // capture size
+    unsigned long long granularity;     // alignment of the view offset
+    unsigned long long chunk_count;
+    unsigned long long next_chunk;      // next chunk to decode
+    unsigned long long next_write;      // next chunk to write
+    unsigned int slot_count;            // chunks in flight
+    dtd_chunk_t slots[2 * DTD_THREADS_MAX];
+    dtd_mutex_t mutex;
+    dtd_cond_t cond;
+}dtd_decoder_t;
+
+/* Appends data to the chunk output escaping NUL bytes.
+*  Return:  0 - success; 1 - error
+*/
+int dtd_out_append(dtd_buf_t *b, const char *data, size_t len)
+{
+    static const unsigned char esc_nul[2] = { DTD_OUT_ESC, DTD_OUT_ESC_NUL };
+    const char *p;
+    while (len && NULL != (p = (const char *)memchr(data, 0, len)))
     {
-        // open new source file and close previous one
-        const char * file_name = fid_to_file_name(fid);
-        if (file_name == NULL)
+        if (dtd_buf_append(b, data, p - data) == (size_t)-1 || dtd_buf_append(b, esc_nul, 2) == (size_t)-1)
+            return 1;
+        len -= p + 1 - data;
+        data = p + 1;
+    }
+    return dtd_buf_append(b, data, len) == (size_t)-1;
+}
+
+/* Appends formatted text to the chunk output.
+*  Return:  0 - success; 1 - error
+*/
+int dtd_out_printf(dtd_buf_t *b, const char *fmt, ...)
+{
+    char buf[1024], *p = buf;
+    va_list ap;
+    int n, ret;
+
+    va_start(ap, fmt);
+    n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return 1;
+    // format again into the allocated buffer if it doesn't fit
+    if (n >= (int)sizeof(buf))
+    {
+        if (NULL == (p = (char *)malloc(n + 1)))
+            return 1;
+        va_start(ap, fmt);
+        vsnprintf(p, n + 1, fmt, ap);
+        va_end(ap);
+    }
+    ret = dtd_out_append(b, p, n);
+    if (p != buf)
+        free(p);
+    return ret;
+}
+
+/* Appends escape with the chunk local line number to the chunk output.
+*  Return:  0 - success; 1 - error
+*/
+int dtd_out_line_num(dtd_buf_t *b, unsigned int line_num)
+{
+    unsigned char esc[2 + sizeof(line_num)] = { DTD_OUT_ESC, DTD_OUT_ESC_LINE_NUM };
+    memcpy(&esc[2], &line_num, sizeof(line_num));
+    return dtd_buf_append(b, esc, sizeof(esc)) == (size_t)-1;
+}
+
+/* Parses hexadecimal number the same way as sscanf "%x".
+*  Return:  1 - success; 0 - no number
+*/
+int parse_hex(const char **pp, const char *end, unsigned int *p_val)
+{
+    const char *p = *pp;
+    unsigned int val = 0, digits = 0;
+    int neg = 0, c;
+
+    while (p < end && (*p == ' ' || (*p >= '\t' && *p <= '\r')))
+        p++;
+    if (p < end && (*p == '+' || *p == '-'))
+        neg = *p++ == '-';
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && isxdigit((unsigned char)p[2]))
+        p += 2;
+    for (; p < end && isxdigit(c = (unsigned char)*p); p++, digits++)
+        val = (val << 4) | (unsigned int)(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    if (digits == 0)
+        return 0;
+    *p_val = neg ? 0 - val : val;
+    *pp = p;
+    return 1;
+}
+
+/* Parses trace record of the line the same way as get_next_trace_line does.
+*  Parameters:
+*   line:       line without the line end
+*   len:        length of the line
+*   v:          array to receive fid, line, var and time. Time is 0xffffffff if line has no time.
+*  Return:  pointer to the start signature "~@" in the line. If line has no trace record return NULL.
+*/
+const char *parse_trace_record(const char *line, size_t len, unsigned int v[4])
+{
+    const char *end = line + len, *p = line, *q;
+    unsigned int n;
+
+    // find start signature "~@" followed by fid, line, var and optional time
+    while (len > 1 && p < end - 1 && NULL != (p = (const char *)memchr(p, '~', end - 1 - p)))
+    {
+        if (p[1] == '@')
+        {
+            for (q = p + 2, n = 0; n < 4 && parse_hex(&q, end, &v[n]); n++)
+                ;
+            if (n >= 3)
+            {
+                // no time
+                if (n == 3)
+                    v[3] = 0xffffffff;
+                return p;
+            }
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/* Decodes one line of the capture to the chunk output the same way as get_next_trace_line and main do.
+*  Parameters:
+*   b:          chunk output
+*   line:       line without the line end
+*   len:        length of the line
+*   has_nl:     the line ends with new line
+*   line_num:   chunk local line number
+*  Return:  0 - success; 1 - error
+*/
+int decode_line(dtd_buf_t *b, const char *line, size_t len, int has_nl, unsigned int line_num)
+{
+    const char *p, *fmt;
+    unsigned int v[4], params_num;
+    int err = 0;
+
+    // copy line if it doesn't contain correct trace line
+    if (NULL == (p = parse_trace_record(line, len, v)))
+        return dtd_out_append(b, line, len) || (has_nl && dtd_out_append(b, "\n", 1));
+    // copy signature preceeding string
+    err = dtd_out_append(b, line, p - line);
+    switch (lookup_format_string(v[0], v[1], &fmt, &params_num))
+    {
+    case DTD_FMT_OK:
+        break;
+    case DTD_FMT_INVALID_PARAM:
+        return err || dtd_out_printf(b, "Decoder: invalid param. fid:0x%x line_num:%d trace_line_num:", v[0], v[1])
+            || dtd_out_line_num(b, line_num) || dtd_out_append(b, "\n", 1);
+    case DTD_FMT_NO_FID:
+        return err || dtd_out_printf(b, "Decoder: no such fid:0x%x\n", v[0]);
+    case DTD_FMT_NO_LINE:
+        return err || dtd_out_printf(b, "Decoder: no such line number %d in %s\n", idx_fids[v[0]].file_lines, fid_to_file_name(v[0]));
+    default:
+        return err || dtd_out_printf(b, "Decoder: no format string. line number:%d file:%s trace_line_num:", v[1], fid_to_file_name(v[0]))
+            || dtd_out_line_num(b, line_num) || dtd_out_append(b, " trace_line_buf:", 16)
+            || dtd_out_append(b, line, len) || dtd_out_append(b, has_nl ? "\n\n" : "\n", has_nl ? 2 : 1);
+    }
+    // print time if it present
+    if (v[3] != 0xffffffff)
+        err = err || dtd_out_printf(b, " %03d.%03d ", (v[3] / 1000) % 1000, v[3] % 1000);
+    // print trace
+    switch (params_num)
+    {
+    case 0:
+        if (*fmt)
+            err = err || dtd_out_printf(b, fmt);
+        break;
+    case 1:
+        err = err || dtd_out_printf(b, fmt, v[2]);
+        break;
+    case 2:
+        err = err || dtd_out_printf(b, fmt, (unsigned short)(v[2] >> 16), (unsigned short)v[2]);
+        break;
+    case 3:
+        err = err || dtd_out_printf(b, fmt, (unsigned char)(v[2] >> 24), (unsigned char)(v[2] >> 16), (unsigned short)v[2]);
+        break;
+    case 4:
+        err = err || dtd_out_printf(b, fmt, (unsigned char)(v[2] >> 24), (unsigned char)(v[2] >> 16), (unsigned char)(v[2] >> 8), (unsigned char)v[2]);
+        break;
+    }
+    return err || dtd_out_append(b, "\n", 1);
+}
+
+/* Maps view of the chunk k and decodes lines which start in it.
+*  Return:  0 - success; 1 - error
+*/
+int decode_chunk(dtd_decoder_t *d, unsigned long long k, dtd_chunk_t *c)
+{
+    unsigned long long start = k * DTD_CHUNK_SIZE;
+    unsigned long long end = start + DTD_CHUNK_SIZE < d->size ? start + DTD_CHUNK_SIZE : d->size;
+    unsigned long long view_start = (start ? start - 1 : 0) / d->granularity * d->granularity;
+    unsigned long long view_end, ext = DTD_LINE_MAX;
+    size_t view_size;
+    const char *base, *p, *e, *limit, *nl, *le;
+
+    while (1)
+    {
+        view_end = end + ext < d->size ? end + ext : d->size;
+        view_size = (size_t)(view_end - view_start);
+#ifdef _WIN32
+        base = (const char *)MapViewOfFile(d->h_map, FILE_MAP_READ, (DWORD)(view_start >> 32), (DWORD)view_start, view_size);
+        if (base == NULL)
         {
-            printf("Decoder: no such fid:0x%x\n", fid);
+            printf("Decoder: failed to map trace file. error:%d\n", GetLastError());
             return 1;
         }
-        strcpy(&src_file_path[src_file_path_len], file_name);
-        FILE *f = fopen(src_file_path, "rt");
-        if (f == NULL)
+#else
+        base = (const char *)mmap(NULL, view_size, PROT_READ, MAP_PRIVATE, d->fd, (off_t)view_start);
+        if (base == (const char *)MAP_FAILED)
         {
-            printf("Decoder: failed to read file. errno=0x%x fid:0x%x file:%s", errno, fid, src_file_path);
+            printf("Decoder: failed to map trace file. errno:0x%x\n", errno);
             return 1;
         }
-        if (f_src)
-            fclose(f_src);
-        f_src = f;
+#endif
+        p = base + (start - view_start);
+        e = base + (end - view_start);
+        limit = base + view_size;
+        // skip the line which started in the previous chunk
+        if (start && p[-1] != '\n')
+            p = NULL != (nl = (const char *)memchr(p, '\n', limit - p)) ? nl + 1 : limit;
+        // the last line which starts in the chunk is decoded in full, map more of the file till it ends
+        if (p >= e || view_end == d->size || e[-1] == '\n' || NULL != memchr(e, '\n', limit - e))
+            break;
+        unmap_file(base, view_size);
+        ext *= 2;
     }
-    // read line line_num from opened file
-    fseek(f_src, 0, SEEK_SET);
-    line_num_cnt = line_num;
-    while (line_num_cnt)
+    while (p < e)
     {
-        if (NULL == fgets(buf, sizeof(buf), f_src))
-        {
-            // on error print trace and exit
-            if (feof(f_src))
-                printf("Decoder: no such line number %d in %s\n", line_num - line_num_cnt, &src_file_path[src_file_path_len]);
-            else
-                printf("Decoder: fgets failed. errno:0x%x file:%s", errno, &src_file_path[src_file_path_len]);
+        nl = (const char *)memchr(p, '\n', limit - p);
+        le = nl ? nl : limit;
+        // text mode reading of the trace file drops CR of the CRLF line end
+        if (nl && le > p && le[-1] == '\r')
+            le--;
+        if (decode_line(&c->out, p, le - p, nl != NULL, ++c->lines))
             break;
+        p = nl ? nl + 1 : limit;
+    }
+    unmap_file(base, view_size);
+    return p < e;
+}
+
+DTD_THREAD_RET decode_worker(void *p_arg)
+{
+    dtd_decoder_t *d = (dtd_decoder_t *)p_arg;
+    dtd_chunk_t *c;
+    unsigned long long k;
+
+    DTD_LOCK(&d->mutex);
+    while (d->next_chunk < d->chunk_count)
+    {
+        // wait till writer frees the slot
+        if (d->next_chunk >= d->next_write + d->slot_count)
+        {
+            DTD_COND_WAIT(&d->cond, &d->mutex);
+            continue;
         }
-        line_num_cnt--;
+        k = d->next_chunk++;
+        c = &d->slots[k % d->slot_count];
+        DTD_UNLOCK(&d->mutex);
+        c->failed = decode_chunk(d, k, c);
+        DTD_LOCK(&d->mutex);
+        c->done = 1;
+        DTD_COND_BROADCAST(&d->cond);
     }
-    // just exit on error
-    if (line_num_cnt)
-        return 1;
-    char *p, *p_end = NULL;
-    do
+    DTD_UNLOCK(&d->mutex);
+    return 0;
+}
+
+/* Writes decoded output replacing escapes.
+*  Parameters:
+*   out:        decoded output
+*   line_base:  trace_line_num of the line before the output
+*   p_write:    output
+*/
+void write_out(const dtd_buf_t *out, unsigned int line_base, dtd_write_t *p_write)
+{
+    const char *p = (const char *)out->p, *end = p + out->size, *esc;
+    unsigned int line_num;
+    char buf[16];
+
+    while (p < end)
     {
-        // find trace macro
-        if(NULL == (p = strstr(buf, "TRACE")))
+        if (NULL == (esc = (const char *)memchr(p, DTD_OUT_ESC, end - p)))
+        {
+            p_write(p, end - p);
             break;
-        p += 5;
-        // get parameters number from the trace macro name(it can be TRACE0, TRACE1, TRACE2, TRACE3 or TRACE4)
-        *p_params_num = (int)(*p++ - '0');
-        if (*p_params_num < 0 || *p_params_num > 4)
+        }
+        if (esc > p)
+            p_write(p, esc - p);
+        if (esc[1] == DTD_OUT_ESC_NUL)
+        {
+            p_write(esc, 1);
+            p = esc + 2;
+        }
+        else
+        {
+            memcpy(&line_num, &esc[2], sizeof(line_num));
+            p_write(buf, sprintf(buf, "%u", line_base + line_num));
+            p = esc + 2 + sizeof(line_num);
+        }
+    }
+}
+
+unsigned int get_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned int)n : 1;
+#endif
+}
+
+/* Decodes the trace file on the threads pool.
+*   Parameters:
+*       file_name:  trace file
+*       threads:    number of decoding threads. 0 - number of CPUs
+*       p_write:    output of the decoded text
+*       p_size:     variable to receive size of the trace file. Can be NULL.
+*   Return:  0 - success; 2 - error
+*/
+int decode_parallel(const char *file_name, unsigned int threads, dtd_write_t *p_write, unsigned long long *p_size)
+{
+    dtd_thread_t thread[DTD_THREADS_MAX];
+    unsigned int i, started = 0, line_base = 0;
+    unsigned long long k;
+    int ret = 2;
+    dtd_decoder_t *d = (dtd_decoder_t *)calloc(1, sizeof(dtd_decoder_t));
+    if (d == NULL)
+        return ret;
+    if (threads == 0)
+        threads = get_cpu_count();
+    if (threads > DTD_THREADS_MAX)
+        threads = DTD_THREADS_MAX;
+    d->slot_count = 2 * threads;
+    DTD_MUTEX_INIT(&d->mutex);
+    DTD_COND_INIT(&d->cond);
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    LARGE_INTEGER size;
+    GetSystemInfo(&si);
+    d->granularity = si.dwAllocationGranularity;
+    HANDLE h_file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(h_file, &size))
+    {
+        printf("Decoder: failed to open trace file. error:%d", GetLastError());
+        if (h_file != INVALID_HANDLE_VALUE)
+            CloseHandle(h_file);
+        free(d);
+        return ret;
+    }
+    d->size = size.QuadPart;
+    d->h_map = d->size ? CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(h_file);
+    if (d->size && d->h_map == NULL)
+    {
+        printf("Decoder: failed to map trace file. error:%d\n", GetLastError());
+        free(d);
+        return ret;
+    }
+#else
+    struct stat st;
+    d->granularity = (unsigned long long)sysconf(_SC_PAGESIZE);
+    if ((d->fd = open(file_name, O_RDONLY)) < 0 || fstat(d->fd, &st) != 0)
+    {
+        printf("Decoder: failed to open trace file. errno:0x%x", errno);
+        if (d->fd >= 0)
+            close(d->fd);
+        free(d);
+        return ret;
+    }
+    d->size = (unsigned long long)st.st_size;
+#endif
+    if (p_size)
+        *p_size = d->size;
+    d->chunk_count = (d->size + DTD_CHUNK_SIZE - 1) / DTD_CHUNK_SIZE;
+    for (i = 0; i < threads && i < d->chunk_count; i++, started++)
+    {
+#ifdef _WIN32
+        if (NULL == (thread[i] = CreateThread(NULL, 0, decode_worker, d, 0, NULL)))
             break;
-        // skip white space
-        while (*p != 0 && (unsigned char)*p <= 0x20) p++;
-        if (*p++ != '(')
+#else
+        if (pthread_create(&thread[i], NULL, decode_worker, d) != 0)
             break;
-        // find start of the format string
-        if (NULL == (p = strchr(p, '\"')))
+#endif
+    }
+    ret = started || d->chunk_count == 0 ? 0 : 2;
+    // write decoded chunks in order
+    for (k = 0; ret == 0 && k < d->chunk_count; k++)
+    {
+        dtd_chunk_t *c = &d->slots[k % d->slot_count];
+        DTD_LOCK(&d->mutex);
+        while (!c->done)
+            DTD_COND_WAIT(&d->cond, &d->mutex);
+        DTD_UNLOCK(&d->mutex);
+        if (c->failed)
+        {
+            printf("Decoder: failed to decode trace file chunk at 0x%llx\n", k * DTD_CHUNK_SIZE);
+            ret = 2;
+        }
+        write_out(&c->out, line_base, p_write);
+        line_base += c->lines;
+        c->out.size = 0;
+        c->lines = 0;
+        DTD_LOCK(&d->mutex);
+        c->done = 0;
+        d->next_write++;
+        // stop workers on error
+        if (ret)
+            d->chunk_count = d->next_chunk;
+        DTD_COND_BROADCAST(&d->cond);
+        DTD_UNLOCK(&d->mutex);
+    }
+    for (i = 0; i < started; i++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(thread[i], INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i], NULL);
+#endif
+    }
+    for (i = 0; i < d->slot_count; i++)
+        free(d->slots[i].out.p);
+#ifdef _WIN32
+    if (d->h_map)
+        CloseHandle(d->h_map);
+#else
+    close(d->fd);
+#endif
+    free(d);
+    return ret;
+}
+
+void write_stdout(const char *p, size_t len)
+{
+    fwrite(p, 1, len, stdout);
+}
+
+void write_discard(const char *p, size_t len)
+{
+    (void)p;
+    (void)len;
+}
+
+double get_time_sec(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, cnt;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+    return (double)cnt.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+/* Live decoding
+*  WicedHciBridge started with the trace decoder port sends every WICED trace packet to that
+*  local UDP port in the same format it uses for BTSpy: 16 bit type, 16 bit length, 0, 1 and
+*  the trace text. The decoder decodes packets as they arrive. Packets which are already queued
+*  are decoded together, up to DTD_UDP_BATCH of them, and the output is flushed after each batch,
+*  so latency stays within one batch and memory use within the output of one batch.
+*/
+#define DTD_UDP_PKT_MAX             1100    // size of the TraceHciPkt buffer in WicedHciBridge
+#define DTD_UDP_HDR_SIZE            8
+#define DTD_UDP_BATCH               256
+#define DTD_UDP_RCV_BUF_SIZE        (1024 * 1024)   // absorbs bursts while output is written
+#define DTD_SPY_TYPE_WICED_TRACE    0
+
+#ifdef _WIN32
+typedef SOCKET                      dtd_socket_t;
+#define DTD_INVALID_SOCKET          INVALID_SOCKET
+#define DTD_SOCKET_ERROR            WSAGetLastError()
+#define dtd_close_socket(s)         closesocket(s)
+#else
+typedef int                         dtd_socket_t;
+#define DTD_INVALID_SOCKET          (-1)
+#define DTD_SOCKET_ERROR            errno
+#define dtd_close_socket(s)         close(s)
+#endif
+
+/* Decodes trace lines of one packet received from WicedHciBridge.
+*  Parameters:
+*   b:          output
+*   pkt:        packet
+*   len:        packet length
+*   p_line_num: trace_line_num of the previous line, updated
+*  Return:  0 - success; 1 - error
+*/
+int decode_udp_packet(dtd_buf_t *b, const unsigned char *pkt, int len, unsigned int *p_line_num)
+{
+    const char *p, *end, *nl;
+    unsigned int type, length;
+
+    if (len < DTD_UDP_HDR_SIZE)
+        return 0;
+    type = pkt[0] | (pkt[1] << 8);
+    length = pkt[2] | (pkt[3] << 8);
+    if (type != DTD_SPY_TYPE_WICED_TRACE)
+        return 0;
+    p = (const char *)&pkt[DTD_UDP_HDR_SIZE];
+    if (length > (unsigned int)(len - DTD_UDP_HDR_SIZE))
+        length = len - DTD_UDP_HDR_SIZE;
+    // bridge sends the text NUL terminated
+    end = (const char *)memchr(p, 0, length);
+    if (end == NULL)
+        end = p + length;
+    // each packet is at least one line
+    while (p < end)
+    {
+        nl = (const char *)memchr(p, '\n', end - p);
+        if (decode_line(b, p, (nl ? nl : end) - p, 1, ++*p_line_num))
+            return 1;
+        p = nl ? nl + 1 : end;
+    }
+    return 0;
+}
+
+/* Decodes WICED traces received from WicedHciBridge on the local UDP port till receive error.
+*   Parameters:
+*       port:       UDP port
+*       p_write:    output of the decoded text
+*   Return:  2 - error
+*/
+int decode_udp(unsigned short port, dtd_write_t *p_write)
+{
+    dtd_socket_t sock;
+    struct sockaddr_in addr;
+    unsigned char pkt[DTD_UDP_PKT_MAX];
+    unsigned int line_num = 0, batch;
+    int len, buf_size = DTD_UDP_RCV_BUF_SIZE;
+    dtd_buf_t out = { NULL, 0, 0 };
+    fd_set fds;
+    struct timeval tv;
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 0), &wsaData) != 0)
+        return 2;
+#endif
+    if ((sock = socket(AF_INET, SOCK_DGRAM, 0)) == DTD_INVALID_SOCKET)
+    {
+        printf("Decoder: failed to create UDP socket. error:%d\n", DTD_SOCKET_ERROR);
+        return 2;
+    }
+    // larger buffer is best effort, default one works too
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char *)&buf_size, sizeof(buf_size));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        printf("Decoder: failed to bind UDP port %u. error:%d\n", port, DTD_SOCKET_ERROR);
+        dtd_close_socket(sock);
+        return 2;
+    }
+    printf("Decoder: listening on UDP port %u\n", port);
+    fflush(stdout);
+    while (1)
+    {
+        // wait for the first packet of the batch
+        if ((len = recv(sock, (char *)pkt, sizeof(pkt), 0)) < 0)
             break;
-        p++;
-        // find end of the format string
-        p_end = p;
-        while (p_end)
+        for (batch = 0; ; )
         {
-            p_end = strchr(p_end, '\"');
-            // exit loop if no end of string or found quote with escape (\")
-            if (p_end == NULL || *p_end != '\\')
+            if (decode_udp_packet(&out, pkt, len, &line_num))
+                break;
+            if (++batch >= DTD_UDP_BATCH)
+                break;
+            // take the next packet only if it is already there
+            FD_ZERO(&fds);
+            FD_SET(sock, &fds);
+            tv.tv_sec = 0;
+            tv.tv_usec = 0;
+            if (select((int)sock + 1, &fds, NULL, NULL, &tv) <= 0 || (len = recv(sock, (char *)pkt, sizeof(pkt), 0)) < 0)
                 break;
-            p_end++;
         }
-    } while (0);
-    if (p_end == NULL)
+        write_out(&out, 0, p_write);
+        fflush(stdout);
+        out.size = 0;
+    }
+    printf("Decoder: UDP receive failed. error:%d\n", DTD_SOCKET_ERROR);
+    free(out.p);
+    dtd_close_socket(sock);
+    return 2;
+}
+
+/* Aggregation
+*  Instead of printing the traces the decoder counts hits of each trace site (fid, line), its
+*  average rate and its peak rate over a sliding window, and the time between hits of chosen
+*  site pairs, like entry and exit of a handler, in log2 histograms. Time comes from the time
+*  field of the trace records, ms since device start. Time going back means device restart:
+*  capture time continues from the last record and pending pairs are dropped.
+*  The sliding window is split into DTD_AGG_BUCKETS buckets, so a site needs fixed memory and
+*  the peak rate is exact to one bucket.
+*/
+#define DTD_AGG_BUCKETS         8
+#define DTD_AGG_PAIRS_MAX       16
+#define DTD_AGG_HIST_SIZE       33      // 0 ms, then [2^(k-1), 2^k) ms for k = 1..32
+#define DTD_AGG_WINDOW_MS       1000
+
+typedef struct
+{
+    unsigned int slot;                  // index slot of the site
+    unsigned int fid;
+    unsigned int line;
+    unsigned long long hits;
+    unsigned long long first_t;         // capture time of the first and last hit with time
+    unsigned long long last_t;
+    unsigned long long bucket_t;        // newest bucket, in bucket units of capture time
+    unsigned int bucket[DTD_AGG_BUCKETS];
+    unsigned int window_hits;           // sum of bucket[]
+    unsigned int peak_hits;             // max of window_hits
+}dtd_site_t;
+
+typedef struct
+{
+    unsigned int start_slot;
+    unsigned int end_slot;
+    unsigned int start_fid, start_line, end_fid, end_line;
+    int pending;                        // start seen and end not yet
+    unsigned long long start_t;
+    unsigned long long count;
+    unsigned long long sum;
+    unsigned int min;
+    unsigned int max;
+    unsigned long long hist[DTD_AGG_HIST_SIZE];
+}dtd_pair_t;
+
+typedef struct
+{
+    unsigned int *site_of_slot;         // site index + 1 for each index slot, 0 - no hits yet
+    dtd_site_t *sites;
+    unsigned int site_count;
+    unsigned int site_alloc;
+    dtd_pair_t pairs[DTD_AGG_PAIRS_MAX];
+    unsigned int pair_count;
+    unsigned int window_ms;
+    unsigned int bucket_ms;
+    unsigned long long records;         // trace records
+    unsigned long long unknown;         // records of sites not in the index
+    unsigned long long untimed;         // records without time
+    unsigned int restarts;
+    int has_time;                       // time of the previous record is valid
+    unsigned int prev_time;
+    unsigned long long t;               // capture time, ms
+    unsigned long long first_t;
+}dtd_agg_t;
+
+/* Returns index slot of the trace site.
+*  Return:  slot. If site isn't in the index return (unsigned int)-1.
+*/
+unsigned int get_site_slot(unsigned int fid, unsigned int line_num)
+{
+    unsigned int i;
+    if (fid >= idx_hdr->fid_count || line_num < idx_fids[fid].first_line
+        || (i = line_num - idx_fids[fid].first_line) >= idx_fids[fid].line_count
+        || idx_slots[idx_fids[fid].slot_offset + i] == 0)
+        return (unsigned int)-1;
+    return idx_fids[fid].slot_offset + i;
+}
+
+/* Parses site pair "<fid>:<line>[-<fid>:<line>]". Without the end site it is time between hits of the start site.
+*  Return:  0 - success; 1 - error
+*/
+int parse_pair(const char *s, dtd_pair_t *p_pair)
+{
+    char *p;
+    p_pair->start_fid = (unsigned int)strtoul(s, &p, 0);
+    if (*p++ != ':')
+        return 1;
+    p_pair->start_line = (unsigned int)strtoul(p, &p, 0);
+    p_pair->end_fid = p_pair->start_fid;
+    p_pair->end_line = p_pair->start_line;
+    if (*p == '-')
     {
-        printf("Decoder: no format string. line number:%d file:%s trace_line_num:%d trace_line_buf:%s\n", line_num, &src_file_path[src_file_path_len], trace_line_num, trace_line_buf);
+        p_pair->end_fid = (unsigned int)strtoul(p + 1, &p, 0);
+        if (*p++ != ':')
+            return 1;
+        p_pair->end_line = (unsigned int)strtoul(p, &p, 0);
+    }
+    if (*p != 0
+        || (p_pair->start_slot = get_site_slot(p_pair->start_fid, p_pair->start_line)) == (unsigned int)-1
+        || (p_pair->end_slot = get_site_slot(p_pair->end_fid, p_pair->end_line)) == (unsigned int)-1)
         return 1;
+    p_pair->min = 0xffffffff;
+    return 0;
+}
+
+/* Counts one trace record.
+*  Return:  0 - success; 1 - error
+*/
+int aggregate_record(dtd_agg_t *a, const unsigned int v[4])
+{
+    unsigned int slot, i, k, delta;
+    unsigned long long b;
+    dtd_site_t *s;
+
+    a->records++;
+    if ((slot = get_site_slot(v[0], v[1])) == (unsigned int)-1)
+    {
+        a->unknown++;
+        return 0;
     }
-    int len = (int)(p_end - p);
-    if (len >= fmt_size)
+    if (a->site_of_slot[slot] == 0)
     {
-        printf("Decoder: format string doesn't fit into buffer. line number:%d file:%s\n", line_num, &src_file_path[src_file_path_len]);
-        return 1;
+        if (a->site_count == a->site_alloc)
+        {
+            unsigned int alloc = a->site_alloc ? 2 * a->site_alloc : 256;
+            dtd_site_t *p = (dtd_site_t *)realloc(a->sites, alloc * sizeof(dtd_site_t));
+            if (p == NULL)
+                return 1;
+            a->sites = p;
+            a->site_alloc = alloc;
+        }
+        s = &a->sites[a->site_count++];
+        memset(s, 0, sizeof(*s));
+        s->slot = slot;
+        s->fid = v[0];
+        s->line = v[1];
+        a->site_of_slot[slot] = a->site_count;
+    }
+    s = &a->sites[a->site_of_slot[slot] - 1];
+    s->hits++;
+    if (v[3] == 0xffffffff)
+    {
+        a->untimed++;
+        return 0;
+    }
+    // advance capture time, time going back is device restart
+    if (a->has_time)
+    {
+        delta = v[3] - a->prev_time;
+        if (delta & 0x80000000)
+        {
+            a->restarts++;
+            for (i = 0; i < a->pair_count; i++)
+                a->pairs[i].pending = 0;
+        }
+        else
+            a->t += delta;
+    }
+    else
+        a->first_t = a->t;
+    a->has_time = 1;
+    a->prev_time = v[3];
+
+    // peak is 0 till the first hit with time
+    if (s->peak_hits == 0)
+        s->first_t = a->t;
+    s->last_t = a->t;
+    // drop buckets which left the window and count the hit in the newest one
+    b = a->t / a->bucket_ms;
+    for (k = 0; b > s->bucket_t && k < DTD_AGG_BUCKETS; k++)
+    {
+        i = (unsigned int)((s->bucket_t + 1 + k) % DTD_AGG_BUCKETS);
+        s->window_hits -= s->bucket[i];
+        s->bucket[i] = 0;
+        if (s->bucket_t + 1 + k == b)
+            break;
+    }
+    s->bucket_t = b;
+    s->bucket[b % DTD_AGG_BUCKETS]++;
+    if (++s->window_hits > s->peak_hits)
+        s->peak_hits = s->window_hits;
+
+    for (i = 0; i < a->pair_count; i++)
+    {
+        dtd_pair_t *p = &a->pairs[i];
+        // check end first, so a pair of the same site measures time between its hits
+        if (slot == p->end_slot && p->pending)
+        {
+            delta = (unsigned int)(a->t - p->start_t);
+            p->count++;
+            p->sum += delta;
+            if (delta < p->min)
+                p->min = delta;
+            if (delta > p->max)
+                p->max = delta;
+            for (k = 0; delta; k++)
+                delta >>= 1;
+            p->hist[k]++;
+            p->pending = 0;
+        }
+        if (slot == p->start_slot)
+        {
+            p->pending = 1;
+            p->start_t = a->t;
+        }
     }
-    // remove new_line at the end
-    if (len > 1 && p[len - 1] == 'n' && p[len - 2] == '\\')
-        len -= 2;
-    // it can be empty string
-    if (len)
-        memcpy(fmt, p, len);
-    fmt[len] = 0;
     return 0;
 }
 
+int compare_sites(const void *p1, const void *p2)
+{
+    const dtd_site_t *s1 = (const dtd_site_t *)p1, *s2 = (const dtd_site_t *)p2;
+    if (s1->hits != s2->hits)
+        return s1->hits < s2->hits ? 1 : -1;
+    return s1->slot < s2->slot ? -1 : s1->slot > s2->slot;
+}
+
+/* Returns format string of the index slot */
+const char *get_slot_format(unsigned int slot)
+{
+    return &idx_strings[idx_slots[slot] + 1];
+}
+
+/* Writes string as the CSV field */
+void write_csv_string(FILE *f, const char *s)
+{
+    fputc('\"', f);
+    for (; *s; s++)
+    {
+        if (*s == '\"')
+            fputc('\"', f);
+        fputc(*s, f);
+    }
+    fputc('\"', f);
+}
+
+/* Creates CSV file, prints error on failure */
+FILE *create_csv(const char *csv_file_name)
+{
+    FILE *f = fopen(csv_file_name, "w");
+    if (f == NULL)
+        printf("Decoder: failed to create CSV file %s. errno:0x%x\n", csv_file_name, errno);
+    return f;
+}
+
+/* Closes CSV file, prints error on failure.
+*  Return:  0 - success; 2 - error
+*/
+int close_csv(FILE *f, const char *csv_file_name)
+{
+    if (fclose(f) != 0)
+    {
+        printf("Decoder: failed to write CSV file %s. errno:0x%x\n", csv_file_name, errno);
+        return 2;
+    }
+    return 0;
+}
+
+/* Prints summary of the aggregation sorted by hits and writes the sites to the CSV file.
+*  Site pairs go to the second CSV file, one row per pair with its histogram in columns.
+*  Return:  0 - success; 2 - error
+*/
+int write_aggregation(dtd_agg_t *a, const char *csv_file_name, const char *pairs_csv_file_name)
+{
+    double span = (a->t - a->first_t) / 1000.0, window = a->window_ms / 1000.0;
+    unsigned int i, k;
+    FILE *f;
+
+    qsort(a->sites, a->site_count, sizeof(dtd_site_t), compare_sites);
+    printf("Decoder: %llu trace records, %llu of unknown sites, %llu without time, %.3f s, %u device restarts, peak window %u ms\n",
+        a->records, a->unknown, a->untimed, span, a->restarts, a->window_ms);
+    printf("       hits  share    avg/s   peak/s  site\n");
+    for (i = 0; i < a->site_count; i++)
+    {
+        dtd_site_t *s = &a->sites[i];
+        printf("%11llu %5.1f%% %8.1f %8.1f  %s:%u %s\n", s->hits, 100.0 * s->hits / a->records,
+            span > 0 ? s->hits / span : 0.0, s->peak_hits / window, fid_to_file_name(s->fid), s->line, get_slot_format(s->slot));
+    }
+    for (i = 0; i < a->pair_count; i++)
+    {
+        dtd_pair_t *p = &a->pairs[i];
+        printf("\n%s:%u -> %s:%u  count:%llu", fid_to_file_name(p->start_fid), p->start_line, fid_to_file_name(p->end_fid), p->end_line, p->count);
+        if (p->count)
+            printf(" min:%u avg:%.1f max:%u ms", p->min, (double)p->sum / p->count, p->max);
+        printf("\n");
+        for (k = 0; k < DTD_AGG_HIST_SIZE; k++)
+        {
+            if (p->hist[k])
+                printf("  %10u .. %10u ms %11llu\n", k ? 1u << (k - 1) : 0, k ? (unsigned int)((2ull << (k - 1)) - 1) : 0, p->hist[k]);
+        }
+    }
+
+    if (NULL == (f = create_csv(csv_file_name)))
+        return 2;
+    fprintf(f, "fid,line,file,hits,share,avg_per_s,peak_per_s,first_ms,last_ms,format\n");
+    for (i = 0; i < a->site_count; i++)
+    {
+        dtd_site_t *s = &a->sites[i];
+        fprintf(f, "0x%x,%u,%s,%llu,%.4f,%.3f,%.3f,%llu,%llu,", s->fid, s->line, fid_to_file_name(s->fid), s->hits,
+            (double)s->hits / a->records, span > 0 ? s->hits / span : 0.0, s->peak_hits / window, s->first_t, s->last_t);
+        write_csv_string(f, get_slot_format(s->slot));
+        fputc('\n', f);
+    }
+    if (close_csv(f, csv_file_name))
+        return 2;
+    if (a->pair_count == 0)
+        return 0;
+
+    if (NULL == (f = create_csv(pairs_csv_file_name)))
+        return 2;
+    fprintf(f, "start_fid,start_line,start_file,end_fid,end_line,end_file,count,min_ms,avg_ms,max_ms");
+    for (k = 0; k < DTD_AGG_HIST_SIZE; k++)
+    {
+        if (k < 2)
+            fprintf(f, ",%u_ms", k);
+        else
+            fprintf(f, ",%u_%u_ms", 1u << (k - 1), (unsigned int)((2ull << (k - 1)) - 1));
+    }
+    fputc('\n', f);
+    for (i = 0; i < a->pair_count; i++)
+    {
+        dtd_pair_t *p = &a->pairs[i];
+        fprintf(f, "0x%x,%u,%s,", p->start_fid, p->start_line, fid_to_file_name(p->start_fid));
+        fprintf(f, "0x%x,%u,%s,%llu,", p->end_fid, p->end_line, fid_to_file_name(p->end_fid), p->count);
+        if (p->count)
+            fprintf(f, "%u,%.3f,%u", p->min, (double)p->sum / p->count, p->max);
+        else
+            fprintf(f, ",,");
+        for (k = 0; k < DTD_AGG_HIST_SIZE; k++)
+            fprintf(f, ",%llu", p->hist[k]);
+        fputc('\n', f);
+    }
+    return close_csv(f, pairs_csv_file_name);
+}
+
+/* Aggregates trace file.
+*   Parameters:
+*       file_name:      trace file
+*       csv_file_name:  CSV file to write, pairs go to the same name with .pairs.csv extension
+*       window_ms:      sliding window of the peak rate, ms, rounded up to a multiple of DTD_AGG_BUCKETS
+*       pairs:          site pairs "<fid>:<line>[-<fid>:<line>]" to measure time between
+*       pair_count:     number of pairs
+*   Return:  0 - success; 2 - error
+*/
+int run_aggregation(const char *file_name, const char *csv_file_name, unsigned int window_ms, char *pairs[], unsigned int pair_count)
+{
+    static char line[DTD_LINE_MAX];
+    char *pairs_csv_file_name;
+    dtd_agg_t *a;
+    unsigned int v[4], i;
+    size_t len;
+    int ret = 2;
+    FILE *f = NULL;
+
+    // sites.csv -> sites.pairs.csv
+    len = strlen(csv_file_name);
+    if (len >= 4 && strcmp(&csv_file_name[len - 4], ".csv") == 0)
+        len -= 4;
+    if (NULL == (pairs_csv_file_name = (char *)malloc(len + sizeof(".pairs.csv"))))
+        return ret;
+    memcpy(pairs_csv_file_name, csv_file_name, len);
+    strcpy(&pairs_csv_file_name[len], ".pairs.csv");
+
+    if (NULL == (a = (dtd_agg_t *)calloc(1, sizeof(dtd_agg_t)))
+        || NULL == (a->site_of_slot = (unsigned int *)calloc(idx_hdr->slot_count + 1, sizeof(unsigned int))))
+    {
+        free(a);
+        free(pairs_csv_file_name);
+        return ret;
+    }
+    // window is a whole number of buckets, round it up so that it never gets shorter than asked
+    a->window_ms = window_ms ? window_ms : DTD_AGG_WINDOW_MS;
+    a->bucket_ms = (a->window_ms + DTD_AGG_BUCKETS - 1) / DTD_AGG_BUCKETS;
+    if (a->bucket_ms * DTD_AGG_BUCKETS != a->window_ms)
+        printf("Decoder: peak window %u ms rounded up to %u ms\n", a->window_ms, a->bucket_ms * DTD_AGG_BUCKETS);
+    a->window_ms = a->bucket_ms * DTD_AGG_BUCKETS;
+    do
+    {
+        for (i = 0; i < pair_count; i++)
+        {
+            if (parse_pair(pairs[i], &a->pairs[i]))
+            {
+                printf("Decoder: invalid site pair %s\n", pairs[i]);
+                break;
+            }
+        }
+        if (i < pair_count)
+            break;
+        a->pair_count = pair_count;
+        if (NULL == (f = fopen(file_name, "rt")))
+        {
+            printf("Decoder: failed to open trace file. errno:0x%x\n", errno);
+            break;
+        }
+        ret = 0;
+        while (ret == 0 && NULL != fgets(line, sizeof(line), f))
+        {
+            len = strlen(line);
+            if (parse_trace_record(line, len, v) && aggregate_record(a, v))
+                ret = 2;
+        }
+        if (ret || ferror(f))
+        {
+            printf("Decoder: failed to aggregate trace file. errno:0x%x\n", errno);
+            ret = 2;
+            break;
+        }
+        ret = write_aggregation(a, csv_file_name, pairs_csv_file_name);
+    } while (0);
+    if (f)
+        fclose(f);
+    free(a->sites);
+    free(a->site_of_slot);
+    free(a);
+    free(pairs_csv_file_name);
+    return ret;
+}
+
+/* Creates synthetic capture with random traces of the index if it doesn't exist yet and prints
+*  decoding throughput for 1, 2, 4 ... threads_max threads. Decoded text is discarded.
+*   Parameters:
+*       file_name:  capture file
+*       size_mb:    capture size in MB
+*       threads_max: max number of decoding threads. 0 - number of CPUs
+*   Return:  0 - success; 2 - error
+*/
+int run_benchmark(const char *file_name, unsigned int size_mb, unsigned int threads_max)
+{
+    unsigned long long size = (unsigned long long)size_mb * 1024 * 1024, written = 0;
+    unsigned int i, j, site_count = 0, *sites, threads, x = 2463534242u, n = 0;
+    static char buf[1024 * 1024];
+    size_t len = 0;
+    double t;
+    FILE *f;
+
+    // collect (fid, line) of all traces in the index
+    if (NULL == (sites = (unsigned int *)malloc(idx_hdr->slot_count * 2 * sizeof(unsigned int))))
+        return 2;
+    for (i = 0; i < idx_hdr->fid_count; i++)
+    {
+        for (j = 0; j < idx_fids[i].line_count; j++)
+        {
+            if (idx_slots[idx_fids[i].slot_offset + j])
+            {
+                sites[2 * site_count] = i;
+                sites[2 * site_count++ + 1] = idx_fids[i].first_line + j;
+            }
+        }
+    }
+    if (site_count == 0 || size_mb == 0)
+    {
+        printf("Decoder: no traces in the index\n");
+        free(sites);
+        return 2;
+    }
+    // reuse the capture of the previous run
+    if (NULL == (f = fopen(file_name, "rb")))
+    {
+        printf("Decoder: creating %u MB capture %s\n", size_mb, file_name);
+        if (NULL == (f = fopen(file_name, "wb")))
+        {
+            printf("Decoder: failed to create capture. errno:0x%x\n", errno);
+            free(sites);
+            return 2;
+        }
+        while (written < size)
+        {
+            // xorshift random numbers
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            i = x % site_count;
+            // every 64th line is a plain text line like the ones the host app writes between traces
+            if ((++n & 63) == 0)
+                len += sprintf(&buf[len], "%u host: plain text line without trace\n", n);
+            else
+                len += sprintf(&buf[len], "~@%x %x %x %x\n", sites[2 * i], sites[2 * i + 1], x, n);
+            if (len > sizeof(buf) - 128 || written + len >= size)
+            {
+                if (fwrite(buf, 1, len, f) != len)
+                    break;
+                written += len;
+                len = 0;
+            }
+        }
+    }
+    free(sites);
+    if (fclose(f) != 0 || (written && written < size))
+    {
+        printf("Decoder: failed to write capture. errno:0x%x\n", errno);
+        return 2;
+    }
+    if (threads_max == 0)
+        threads_max = get_cpu_count();
+    for (threads = 1; ; threads = threads * 2 < threads_max ? threads * 2 : threads_max)
+    {
+        t = get_time_sec();
+        if (decode_parallel(file_name, threads, write_discard, &size))
+            return 2;
+        t = get_time_sec() - t;
+        printf("Decoder: threads:%u %.1f MB/s\n", threads, size / (1024.0 * 1024.0) / t);
+        if (threads >= threads_max)
+            break;
+    }
+    return 0;
+}
 
 const char *help =
 "command line format:\n"
-"    DbgTraceEncoder.exe <trace_file> <sources_folder_path>\n"
+"    DbgTraceDecoder.exe [-j <threads>] <trace_file> <sources_folder_path | index_file>\n"
+"    DbgTraceDecoder.exe -i <index_file> <sources_folder_path>\n"
+"    DbgTraceDecoder.exe [-j <threads>] -b <capture_file> <size_mb> <sources_folder_path | index_file>\n"
+"    DbgTraceDecoder.exe -u <udp_port> <sources_folder_path | index_file>\n"
+"    DbgTraceDecoder.exe -a <trace_file> <sources_folder_path | index_file> <csv_file> [<window_ms> [<site_pair> ...]]\n"
 "where:\n"
 "    <trace_file> - full or relative path file name of the trace file\n"
 "    <sources_folder_path> - full or relative path to the sources folder\n"
+"    <index_file> - format strings index created with -i. Decoding with an index doesn't need the sources\n"
+"    -j <threads> - decode memory mapped trace file on <threads> threads, 0 - one per CPU\n"
+"    -b - create synthetic <capture_file> of <size_mb> MB if it doesn't exist and print decoding throughput\n"
+"    -u <udp_port> - decode traces live as WicedHciBridge started with the same trace decoder port sends them\n"
+"    -a - print hits, average and peak rates of each trace site sorted by hits and write them to <csv_file>\n"
+"    <window_ms> - sliding window of the peak rate, 1000 ms by default. Rounded up to a multiple of 8 ms,\n"
+"        the window is kept in 8 buckets\n"
+"    <site_pair> - <fid>:<line>-<fid>:<line> to print histogram of time from the first site to the second one,\n"
+"        <fid>:<line> for time between hits of one site. Pairs are written to <csv_file> with .pairs.csv\n"
+"        extension, one row per pair with count, min, avg, max and the histogram\n"
 "example:\n"
-"    DbgTraceEncoder.exe C:\\Users\\viako\\Documents\\WICED\\WICED-Studio-4.1\\20735-B0_Bluetooth\\libraries\\mesh_core_lib\n";
+"    DbgTraceDecoder.exe -i mesh.dtdi C:\\Users\\viako\\Documents\\WICED\\WICED-Studio-4.1\\20735-B0_Bluetooth\\libraries\n"
+"    DbgTraceDecoder.exe -j 0 trace.txt mesh.dtdi\n"
+"    DbgTraceDecoder.exe -b bench.txt 4096 mesh.dtdi\n"
+"    DbgTraceDecoder.exe -u 9878 mesh.dtdi\n"
+"    DbgTraceDecoder.exe -a trace.txt mesh.dtdi sites.csv 100 0x3d:120-0x3d:164\n";
 int main(int argc, char* argv[])
 {
     int ret = 2;
-    char fmt[1024];
+    const char *fmt;
     FILE *f_trace_in = NULL;
     unsigned int fid, line_num, var, params_num, time;
+    dtd_index_hdr_t *p_built = NULL;
+    const void *p_mapped = NULL;
+    size_t index_size = 0;
+    int arg = 1, threads = -1, mode = 0;
     do
     {
-        // make sure command line has two params
-        if (argc != 3)
+        // parse options
+        if (argc > 2 && strcmp(argv[1], "-j") == 0)
+        {
+            threads = atoi(argv[2]);
+            arg = 3;
+        }
+        if (arg < argc && (strcmp(argv[arg], "-i") == 0 || strcmp(argv[arg], "-b") == 0 || strcmp(argv[arg], "-u") == 0
+            || strcmp(argv[arg], "-a") == 0))
+            mode = argv[arg++][1];
+        // make sure command line has two params, three for the benchmark or three and more for the aggregation
+        if ((mode == 'a' ? argc - arg < 3 || argc - arg > 4 + DTD_AGG_PAIRS_MAX : argc - arg != (mode == 'b' ? 3 : 2))
+            || ((mode == 'i' || mode == 'u' || mode == 'a') && arg != 2) || (arg == 3 && threads < 0))
         {
             printf("Decoder: Invalid command line\n");
             // pring help text
@@ -354,22 +1884,62 @@ int main(int argc, char* argv[])
             break;
         }
 
-        // copy path of the source files folder to the buffer and calculate its length
-        strcpy(src_file_path, argv[2]);
-        src_file_path_len = (int)strlen(src_file_path);
-        if (src_file_path_len == 0)
+        if (mode == 'i')
+        {
+            // build index of the sources and save it to the file
+            if (set_src_file_path(argv[3]) || NULL == (p_built = build_index(&index_size)))
+                break;
+            FILE *f = fopen(argv[2], "wb");
+            if (f == NULL || fwrite(p_built, 1, index_size, f) != index_size)
+                printf("Decoder: failed to write index file. errno:0x%x\n", errno);
+            else
+                ret = 0;
+            if (f && fclose(f) != 0)
+                ret = 2;
+            break;
+        }
+
+        // last param, or second one of the aggregation, is either the index file or the sources folder to index now
+        const char *index_arg = (mode == 'a') ? argv[arg + 1] : argv[argc - 1];
+        if (NULL != (p_mapped = map_file(index_arg, &index_size)))
         {
-            printf("Decoder: Invalid folder path\n");
+            if (use_index(p_mapped, index_size))
+            {
+                printf("Decoder: invalid index file %s\n", index_arg);
+                break;
+            }
+        }
+        else
+        {
+            if (set_src_file_path(index_arg) || NULL == (p_built = build_index(&index_size)))
+                break;
+            use_index(p_built, index_size);
+        }
+        if (mode == 'a')
+        {
+            ret = run_aggregation(argv[arg], argv[arg + 2], argc - arg > 3 ? (unsigned int)atoi(argv[arg + 3]) : 0,
+                &argv[arg + 4], argc - arg > 4 ? argc - arg - 4 : 0);
             break;
         }
-        // make sure it is terminated with slash
-        if (src_file_path[src_file_path_len - 1] != '\\' && src_file_path[src_file_path_len - 1] != '/')
+        if (mode == 'u')
         {
-            src_file_path[src_file_path_len++] = '\\';
-            src_file_path[src_file_path_len] = 0;
+            ret = decode_udp((unsigned short)atoi(argv[arg]), write_stdout);
+            break;
+        }
+        if (mode == 'b')
+        {
+            ret = run_benchmark(argv[arg], (unsigned int)atoi(argv[arg + 1]), threads < 0 ? 0 : threads);
+            break;
+        }
+        if (threads >= 0)
+        {
+            // decoded chunks are written with few large writes
+            setvbuf(stdout, NULL, _IOFBF, 1024 * 1024);
+            ret = decode_parallel(argv[arg], threads, write_stdout, NULL);
+            break;
         }
         // open trace file
-        if (NULL == (f_trace_in = fopen(argv[1], "rt")))
+        if (NULL == (f_trace_in = fopen(argv[arg], "rt")))
         {
             printf("Decoder: failed to open trace file. errno:0x%x", errno);
             break;
@@ -382,7 +1952,7 @@ int main(int argc, char* argv[])
             if (ret)
                 break;
             // get format string from the line line_num of the file fid ignorin that trace line on error
-            if (get_format_string(fid, line_num, fmt, sizeof(fmt), &params_num))
+            if (NULL == (fmt = get_format_string(fid, line_num, &params_num)))
                 continue;
             // print time if it present
             if(time != 0xffffffff)
@@ -416,8 +1986,10 @@ int main(int argc, char* argv[])
     // close files
     if (f_trace_in)
         fclose(f_trace_in);
-    if (f_src)
-        fclose(f_src);
+    if (p_mapped)
+        unmap_file(p_mapped, index_size);
+    free(p_built);
+    free(trace_line_buf);
 
     return ret;
 }
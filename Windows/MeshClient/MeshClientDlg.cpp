@@ -55,6 +55,7 @@
 #include "wiced_bt_mesh_db.h"
 #include "wiced_bt_dev.h"
 #include "MeshScanner.h"
+#include "mesh_trace.h"
 
 // #define MESH_AUTOMATION_ENABLED TRUE
 
@@ -65,6 +66,11 @@
 
 
 //extern "C" void ods(char * fmt_str, ...);
+extern "C" void mesh_trace_init(void);
+extern "C" void mesh_trace_deinit(void);
+
+// System menu items which set the trace level of every category, one per level
+#define IDM_TRACE_LEVEL     0x0100
 
 char *log_filename = "trace.txt";  // if you add full path make sure that directory exists, otherwise it will crash
 
@@ -335,6 +341,7 @@ CMeshClientDlg::CMeshClientDlg(CWnd* pParent /*=NULL*/)
 {
 
     InitializeCriticalSection(&cs);
+    mesh_trace_init();
     m_hIcon = AfxGetApp()->LoadIcon(IDR_MAINFRAME);
     m_szCurrentGroup[0] = 0;
     m_pDownloader = NULL;
@@ -358,6 +365,7 @@ CMeshClientDlg::~CMeshClientDlg()
 {
     DeleteCriticalSection(&cs);
     delete m_btInterface;
+    mesh_trace_deinit();
 }
 
 void CMeshClientDlg::DoDataExchange(CDataExchange* pDX)
@@ -602,6 +610,13 @@ BOOL CMeshClientDlg::OnInitDialog()
             pSysMenu->AppendMenu(MF_SEPARATOR);
             pSysMenu->AppendMenu(MF_STRING, IDM_ABOUTBOX, strAboutMenu);
         }
+
+        // Trace levels can also be changed while running, the MESH_TRACE variable is only read at start
+        CMenu traceMenu;
+        traceMenu.CreatePopupMenu();
+        for (int level = MESH_TRACE_LEVEL_OFF; level <= MESH_TRACE_LEVEL_VERBOSE; level++)
+            traceMenu.AppendMenu(MF_STRING, IDM_TRACE_LEVEL + level * 0x10, CA2W(mesh_trace_level_name(level)));
+        pSysMenu->AppendMenu(MF_POPUP, (UINT_PTR)traceMenu.Detach(), L"Trace level");
     }
 
     // Set the icon for this dialog.  The framework does this automatically
@@ -704,6 +719,14 @@ void CMeshClientDlg::OnSysCommand(UINT nID, LPARAM lParam)
         CAboutDlg dlgAbout;
         dlgAbout.DoModal();
     }
+    else if (((nID & 0xFFF0) >= IDM_TRACE_LEVEL) && ((nID & 0xFFF0) <= IDM_TRACE_LEVEL + MESH_TRACE_LEVEL_VERBOSE * 0x10))
+    {
+        char levels[128];
+
+        mesh_trace_set_level(MESH_TRACE_ALL, ((nID & 0xFFF0) - IDM_TRACE_LEVEL) / 0x10);
+        mesh_trace_describe(levels, sizeof(levels));
+        trace("Trace levels: %s", levels);
+    }
     else
     {
         CDialogEx::OnSysCommand(nID, lParam);
@@ -1373,18 +1396,63 @@ void network_opened(uint8_t status)
 
 typedef void (TIMER_CBACK)(void *p_tle);
 #define TIMER_PARAM_TYPE    void *
-extern "C" void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg);
+extern "C" void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg, uint64_t deadline_us);
+extern "C" void mesh_timer_callback_started(void *p_cback, uint64_t deadline_us);
+
+// Filled by the timer thread and emptied in the same order by OnTimerCallback, so an expiry needs no allocation
+#define TIMER_CALLBACK_SLOTS    256
 
-void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg)
+typedef struct
+{
+    TIMER_PARAM_TYPE arg;
+    uint64_t         deadline_us;
+} timer_callback_t;
+
+static timer_callback_t timer_callback_slot[TIMER_CALLBACK_SLOTS];
+static ULONG            timer_callback_posted;      // timer thread only
+static volatile LONG    timer_callback_done;        // incremented by the UI thread
+
+void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg, uint64_t deadline_us)
 {
     CMeshClientDlg *pDlg = (CMeshClientDlg *)theApp.m_pMainWnd;
-    pDlg->PostMessage(WM_TIMER_CALLBACK, (WPARAM)p_callback, (LPARAM)arg);
+    ULONG posted = timer_callback_posted;
+    timer_callback_t *p_timer_callback;
+
+    // Every slot is still queued, hold the timer thread back rather than lose the callback
+    while (posted - (ULONG)timer_callback_done >= TIMER_CALLBACK_SLOTS)
+    {
+        if (!::IsWindow(pDlg->GetSafeHwnd()))
+        {
+            ods("execute_timer_callback: no window, timer callback dropped\n");
+            return;
+        }
+        Sleep(1);
+    }
+    p_timer_callback = &timer_callback_slot[posted % TIMER_CALLBACK_SLOTS];
+    p_timer_callback->arg = arg;
+    p_timer_callback->deadline_us = deadline_us;
+
+    // Taken before the post, the UI thread may be done with the slot before PostMessage returns
+    timer_callback_posted = posted + 1;
+    if (!pDlg->PostMessage(WM_TIMER_CALLBACK, (WPARAM)p_callback, (LPARAM)p_timer_callback))
+    {
+        timer_callback_posted = posted;
+        ods("execute_timer_callback: PostMessage failed error:%u, timer callback dropped\n", GetLastError());
+    }
 }
 
 LRESULT CMeshClientDlg::OnTimerCallback(WPARAM op, LPARAM lparam)
 {
     TIMER_CBACK *p_cback = (TIMER_CBACK *)op;
-    p_cback((TIMER_PARAM_TYPE)lparam);
+    timer_callback_t *p_timer_callback = (timer_callback_t *)lparam;
+    TIMER_PARAM_TYPE arg = p_timer_callback->arg;
+
+    // The lateness is taken here, the callback waited in the message queue since the timer thread posted it
+    mesh_timer_callback_started((void *)p_cback, p_timer_callback->deadline_us);
+
+    // The slot is free once copied, the callback may start timers which expire right away
+    InterlockedIncrement(&timer_callback_done);
+    p_cback(arg);
     return S_OK;
 }
 
@@ -54,6 +54,7 @@
 #include "wiced_bt_mesh_dfu.h"
 #endif
 #include "wiced_bt_cfg.h"
+#include "hex_dump.h"
 wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
 #define MESH_VENDOR_COMPANY_ID          0x131   // Cypress Company ID
@@ -396,7 +397,7 @@ void mesh_core_state_changed(wiced_bt_mesh_core_state_type_t type, wiced_bt_mesh
 
 wiced_bool_t vendor_data_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
 {
-    char buf[100] = { 0 };
+    char buf[100];
 
     // 0xffff model_id means request to check if that opcode belongs to that model
     if (p_event->model_id == 0xffff)
@@ -414,8 +415,7 @@ wiced_bool_t vendor_data_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data
 
     WICED_BT_TRACE("Vendor Data Opcode:%d\n", p_event->opcode);
 
-    for (int i = 0; i < data_len && i < 33; i++)
-        sprintf(&buf[strlen(buf)], "%02x", p_data[i]);
+    hex_dump_format(buf, sizeof(buf), p_data, (data_len < 33) ? data_len : 33, 0);
 
     WICED_BT_TRACE("%s\n", buf);
     mesh_vendor_specific_data(p_event->src, p_event->company_id, p_event->model_id, (uint8_t)p_event->opcode, (uint8_t)p_event->ttl, p_data, data_len);
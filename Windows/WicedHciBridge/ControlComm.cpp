@@ -50,15 +50,22 @@ static char* _stopBits[] = { "1", "1.5", "2" };
 //Class ComHelper Implementation
 //
 ComHelper::ComHelper() :
-    m_handle(INVALID_HANDLE_VALUE)
+    m_handle(INVALID_HANDLE_VALUE),
+    m_dwRingRead(0),
+    m_dwRingWrite(0),
+    m_dwSkip(0),
+    m_bResync(FALSE)
 {
     memset(&m_OverlapRead, 0, sizeof(m_OverlapRead));
     memset(&m_OverlapWrite, 0, sizeof(m_OverlapWrite));
+    memset(&m_stats, 0, sizeof(m_stats));
+    InitializeCriticalSection(&m_csStats);
 }
 
 ComHelper::~ComHelper()
 {
     ClosePort();
+    DeleteCriticalSection(&m_csStats);
 }
 
 DWORD WINAPI ReadThread(LPVOID lpdwThreadParam)
@@ -159,9 +166,10 @@ BOOL ComHelper::OpenPort(int port, int baudRate)
             Log ("OpenPort GetCommProperties failed %d\n", GetLastError());
         else
         {
-            // use 4096 byte as preferred buffer size, adjust to fit within allowed Max
+            // use 4096 byte as preferred Tx buffer size and 64K for Rx to ride out bursts of traces
+            // at 3-4 Mbaud, adjust to fit within allowed Max
             commProp.dwCurrentTxQueue = 4096;
-            commProp.dwCurrentRxQueue = 4096;
+            commProp.dwCurrentRxQueue = 65536;
             if (commProp.dwCurrentTxQueue > commProp.dwMaxTxQueue)
                 commProp.dwCurrentTxQueue = commProp.dwMaxTxQueue;
             if (commProp.dwCurrentRxQueue > commProp.dwMaxRxQueue)
@@ -199,9 +207,16 @@ BOOL ComHelper::OpenPort(int port, int baudRate)
 
 void ComHelper::ClosePort()
 {
+    COM_HELPER_STATS stats;
+
     SetEvent(m_hShutdown);
     WaitForSingleObject(m_hThreadRead, INFINITE);
 
+    GetStats(&stats);
+    if (stats.bytes)
+        Log("ComHelper: received %llu bytes %llu packets in %u reads, %u resyncs dropped %u bytes, %u oversized frames\n",
+            stats.bytes, stats.packets, stats.reads, stats.resyncs, stats.dropped, stats.oversized);
+
     if (m_OverlapRead.hEvent != NULL)
     {
         CloseHandle(m_OverlapRead.hEvent);
@@ -229,74 +244,73 @@ BOOL ComHelper::IsOpened()
     return (m_handle != NULL && m_handle != INVALID_HANDLE_VALUE);
 }
 
-// read a number of bytes from Serial Bus Device
+// read bytes which are available from Serial Bus Device, waits for at least one
 // Parameters:
 //	lpBytes - Pointer to the buffer
-//	dwLen   - number of bytes to read
-// Return:	Number of byte read from the device.
+//	dwLen   - max number of bytes to read
+// Return:	Number of byte read from the device. 0 on error or shutdown.
 //
-DWORD ComHelper::Read(LPBYTE lpBytes, DWORD dwLen)
+DWORD ComHelper::ReadSome(LPBYTE lpBytes, DWORD dwLen)
 {
-    LPBYTE p = lpBytes;
-    DWORD Length = dwLen;
+    DWORD dwRet = WAIT_TIMEOUT;
     DWORD dwRead = 0;
-    DWORD dwTotalRead = 0;
 
-    // Loop here until request is fulfilled
-    while (Length)
+    ResetEvent(m_OverlapRead.hEvent);
+    if (!ReadFile(m_handle, (LPVOID)lpBytes, dwLen, &dwRead, &m_OverlapRead))
     {
-        DWORD dwRet = WAIT_TIMEOUT;
-        dwRead = 0;
-        ResetEvent(m_OverlapRead.hEvent);
-//        m_OverlapRead.Internal = ERROR_SUCCESS;
-//        m_OverlapRead.InternalHigh = 0;
-        if (!ReadFile(m_handle, (LPVOID)p, Length, &dwRead, &m_OverlapRead))
+        // Overlapped IO returns FALSE with ERROR_IO_PENDING
+        if (GetLastError() != ERROR_IO_PENDING)
         {
-            // Overlapped IO returns FALSE with ERROR_IO_PENDING
-            if (GetLastError() != ERROR_IO_PENDING)
-            {
-                Log ("ComHelper::ReadFile failed with %ld\n", GetLastError());
-                m_bClosing = TRUE;
-                dwTotalRead = 0;
-                PostMessage(m_hWnd, WM_CLOSE, 0, 0);
-                break;
-            }
+            Log ("ComHelper::ReadFile failed with %ld\n", GetLastError());
+            m_bClosing = TRUE;
+            PostMessage(m_hWnd, WM_CLOSE, 0, 0);
+            return 0;
+        }
 
-//            //Clear the LastError and wait for the IO to Complete
-//            SetLastError(ERROR_SUCCESS);
-//			dwRet = WaitForSingleObject(m_OverlapRead.hEvent, 10000);
-            HANDLE handles[2];
-            handles[0] = m_OverlapRead.hEvent;
-            handles[1] = m_hShutdown;
+        HANDLE handles[2];
+        handles[0] = m_OverlapRead.hEvent;
+        handles[1] = m_hShutdown;
 
-            dwRet = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
-            // dwRet = WaitForSingleObject(m_OverlapRead.hEvent, INFINITE);
-            if (dwRet == WAIT_OBJECT_0 + 1)
-            {
-                m_bClosing = TRUE;
-                break;
-            }
-            else if (dwRet != WAIT_OBJECT_0)
-            {
-                Log ("ComHelper::WaitForSingleObject returned with %ld err=%d\n", dwRet, GetLastError());
-                dwTotalRead = 0;
-                break;
-            }
-
-            // IO completed, retrieve Overlapped result
+        dwRet = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (dwRet == WAIT_OBJECT_0 + 1)
+        {
+            // cancel pending read, the buffer may be gone when it completes
+            CancelIo(m_handle);
             GetOverlappedResult(m_handle, &m_OverlapRead, &dwRead, TRUE);
-
-//			// if dwRead is not updated, retrieve it from OVERLAPPED structure
-//            if (dwRead == 0)
-//                dwRead = (DWORD)m_OverlapRead.InternalHigh;
+            m_bClosing = TRUE;
+            return 0;
         }
-        if (dwRead > Length)
-            break;
-        p += dwRead;
-        Length -= dwRead;
-        dwTotalRead += dwRead;
+        else if (dwRet != WAIT_OBJECT_0)
+        {
+            Log ("ComHelper::WaitForSingleObject returned with %ld err=%d\n", dwRet, GetLastError());
+            return 0;
+        }
+
+        // IO completed, retrieve Overlapped result
+        GetOverlappedResult(m_handle, &m_OverlapRead, &dwRead, TRUE);
     }
+    return (dwRead > dwLen) ? 0 : dwRead;
+}
 
+// read a number of bytes from Serial Bus Device
+// Parameters:
+//	lpBytes - Pointer to the buffer
+//	dwLen   - number of bytes to read
+// Return:	Number of byte read from the device.
+//
+DWORD ComHelper::Read(LPBYTE lpBytes, DWORD dwLen)
+{
+    DWORD dwRead;
+    DWORD dwTotalRead = 0;
+
+    // Loop here until request is fulfilled
+    while (dwTotalRead < dwLen)
+    {
+        dwRead = ReadSome(lpBytes + dwTotalRead, dwLen - dwTotalRead);
+        if (dwRead == 0)
+            return m_bClosing ? dwTotalRead : 0;
+        dwTotalRead += dwRead;
+    }
     return dwTotalRead;
 }
 
@@ -350,75 +364,119 @@ DWORD ComHelper::Write(LPBYTE lpBytes, DWORD dwLen)
 
 
 
-DWORD ComHelper::ReadNewHciPacket(BYTE * pu8Buffer, int bufLen, int * pOffset)
+void ComHelper::GetStats(COM_HELPER_STATS *pStats)
 {
-    DWORD dwLen, len = 0, offset = 0;
+    EnterCriticalSection(&m_csStats);
+    *pStats = m_stats;
+    LeaveCriticalSection(&m_csStats);
+}
 
-    dwLen = Read(&pu8Buffer[offset], 1);
+// Extracts complete packets from the receive ring and dispatches them. Partial packet stays in the ring
+// till the rest is received. Unknown packet type means framing is lost, bytes are dropped till the next
+// known type. Payload of the frame longer than COM_PAYLOAD_MAX is skipped without losing the framing.
+void ComHelper::ParseFrames()
+{
+    DWORD dwAvail, dwHdrLen, dwLen, dwOffset, dwCopy, dwPackets = 0, dwDropped = 0, dwResyncs = 0, dwOversized = 0;
+    BYTE  type, *p;
 
-    if (dwLen == 0)
-        return (0);
+    while ((dwAvail = m_dwRingWrite - m_dwRingRead) != 0)
+    {
+        // skip rest of the oversized frame
+        if (m_dwSkip)
+        {
+            dwLen = min(m_dwSkip, dwAvail);
+            m_dwRingRead += dwLen;
+            m_dwSkip -= dwLen;
+            continue;
+        }
+        type = m_ring[m_dwRingRead & (COM_RING_SIZE - 1)];
+        dwHdrLen = (type == HCI_EVENT_PKT) ? 3 : (type == HCI_ACL_DATA_PKT || type == HCI_WICED_PKT) ? 5 : 0;
+        if (dwHdrLen == 0)
+        {
+            if (!m_bResync)
+                dwResyncs++;
+            m_bResync = TRUE;
+            m_dwRingRead++;
+            dwDropped++;
+            continue;
+        }
+        if (dwAvail < dwHdrLen)
+            break;
+        if (type == HCI_EVENT_PKT)
+            dwLen = m_ring[(m_dwRingRead + 2) & (COM_RING_SIZE - 1)];
+        else
+            dwLen = m_ring[(m_dwRingRead + 3) & (COM_RING_SIZE - 1)] | (m_ring[(m_dwRingRead + 4) & (COM_RING_SIZE - 1)] << 8);
+        m_bResync = FALSE;
+        if (dwLen > COM_PAYLOAD_MAX)
+        {
+            dwOversized++;
+            m_dwRingRead += dwHdrLen;
+            m_dwSkip = dwLen;
+            continue;
+        }
+        // wait for the rest of the packet
+        if (dwAvail < dwHdrLen + dwLen)
+            break;
+
+        // handlers need the packet in one piece
+        dwOffset = m_dwRingRead & (COM_RING_SIZE - 1);
+        if (dwOffset + dwHdrLen + dwLen <= COM_RING_SIZE)
+            p = &m_ring[dwOffset];
+        else
+        {
+            dwCopy = COM_RING_SIZE - dwOffset;
+            memcpy(m_frame, &m_ring[dwOffset], dwCopy);
+            memcpy(&m_frame[dwCopy], m_ring, dwHdrLen + dwLen - dwCopy);
+            p = m_frame;
+        }
+        switch (type)
+        {
+        case HCI_EVENT_PKT:
+            HandleHciEvent(p, dwHdrLen + dwLen);
+            break;
 
-    offset++;
+        case HCI_ACL_DATA_PKT:
+            break;
 
-    switch (pu8Buffer[0])
-    {
-    case HCI_EVENT_PKT:
-        Read(&pu8Buffer[offset], 2);
-        len = pu8Buffer[2];
-        offset += 2;
-        break;
-
-    case HCI_ACL_DATA_PKT:
-        Read(&pu8Buffer[offset], 4);
-        len = pu8Buffer[3] | (pu8Buffer[4] << 8);
-        offset += 4;
-        break;
-
-    case HCI_WICED_PKT:
-        Read(&pu8Buffer[offset], 4);
-        len = pu8Buffer[3] | (pu8Buffer[4] << 8);
-        offset += 4;
-        break;
+        case HCI_WICED_PKT:
+            HandleWicedEvent(p, dwHdrLen + dwLen);
+            break;
+        }
+        m_dwRingRead += dwHdrLen + dwLen;
+        dwPackets++;
     }
 
-    if (len)
-        Read(&pu8Buffer[offset], min(len, (DWORD)bufLen));
-
-    *pOffset = offset;
-    return len;
+    EnterCriticalSection(&m_csStats);
+    m_stats.packets += dwPackets;
+    m_stats.resyncs += dwResyncs;
+    m_stats.dropped += dwDropped;
+    m_stats.oversized += dwOversized;
+    LeaveCriticalSection(&m_csStats);
 }
 
-
 DWORD ComHelper::ReadWorker()
 {
-    unsigned char au8Hdr[1024 + 6];
-    int           offset = 0, pktLen;
-    int           packetType;
+    DWORD dwOffset, dwLen, dwRead;
 
     while (1)
     {
-        pktLen = ReadNewHciPacket(au8Hdr, sizeof(au8Hdr), &offset);
+        // read as much as is available into the free space up to the end of the ring
+        dwOffset = m_dwRingWrite & (COM_RING_SIZE - 1);
+        dwLen = min(COM_RING_SIZE - (m_dwRingWrite - m_dwRingRead), COM_RING_SIZE - dwOffset);
+        dwRead = ReadSome(&m_ring[dwOffset], min(dwLen, (DWORD)COM_READ_SIZE));
         if (m_bClosing)
             break;
 
-        if (pktLen + offset == 0)
+        if (dwRead == 0)
             continue;
 
-        packetType = au8Hdr[0];
-        switch (packetType)
-        {
-        case HCI_EVENT_PKT:
-            HandleHciEvent(au8Hdr, pktLen + offset);
-            break;
-
-        case HCI_ACL_DATA_PKT:
-            break;
+        m_dwRingWrite += dwRead;
+        EnterCriticalSection(&m_csStats);
+        m_stats.bytes += dwRead;
+        m_stats.reads++;
+        LeaveCriticalSection(&m_csStats);
 
-        case HCI_WICED_PKT:
-            HandleWicedEvent(au8Hdr, pktLen + offset);
-            break;
-        }
+        ParseFrames();
     }
 
     return 0;
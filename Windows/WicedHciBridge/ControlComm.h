@@ -37,6 +37,22 @@
 //*** Definitions for BTW Serial Bus
 //**************************************************************************************************
 
+#define COM_RING_SIZE       0x8000      // receive ring, power of two
+#define COM_READ_SIZE       4096        // max bytes of one read, limits latency at high baud rates
+#define COM_HDR_MAX         5           // type and header of ACL and WICED packets
+#define COM_PAYLOAD_MAX     4096        // frames with longer payload are skipped as a whole
+
+// receive counters
+typedef struct
+{
+    ULONGLONG bytes;        // bytes received
+    ULONGLONG packets;      // complete packets parsed
+    DWORD     reads;        // completed reads
+    DWORD     resyncs;      // times parser met unknown packet type and skipped to the next known one
+    DWORD     dropped;      // bytes skipped while resyncing
+    DWORD     oversized;    // frames skipped because payload is longer than COM_PAYLOAD_MAX
+} COM_HELPER_STATS;
+
 //
 // Serial Bus class, use this class to read/write from/to the serial bus device
 //
@@ -52,9 +68,11 @@ public:
 
 	// read data from device
     DWORD Read( LPBYTE b, DWORD dwLen );
-    DWORD ReadNewHciPacket( BYTE * pu8Buffer, int bufLen, int * pOffset );
+    DWORD ReadSome( LPBYTE b, DWORD dwLen );
     DWORD ReadWorker( );
 
+    void GetStats( COM_HELPER_STATS *pStats );
+
 	// write data to device
     DWORD Write( LPBYTE b, DWORD dwLen );
 
@@ -74,6 +92,17 @@ private:
     HANDLE m_hShutdown;
     BOOL m_bClosing;
     BOOL m_CleanHciState;
+
+    // received bytes are parsed into packets in place, only frames which wrap around are copied
+    void ParseFrames( );
+    BYTE m_ring[COM_RING_SIZE];
+    BYTE m_frame[COM_HDR_MAX + COM_PAYLOAD_MAX];
+    DWORD m_dwRingRead;     // free running read and write positions
+    DWORD m_dwRingWrite;
+    DWORD m_dwSkip;         // bytes left of the oversized frame being skipped
+    BOOL m_bResync;
+    COM_HELPER_STATS m_stats;
+    CRITICAL_SECTION m_csStats;
 };
 
 #endif
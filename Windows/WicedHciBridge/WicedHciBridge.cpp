@@ -38,6 +38,7 @@
 
 #include <WinSock2.h>
 #include "ControlComm.h"
+#include "../mesh_libs/hex_dump.h"
 
 ComHelper *m_ComHelper;
 
@@ -46,6 +47,7 @@ DWORD WINAPI UdpReceiveThread(LPVOID Context);
 
 #define APP_UDP_PORT 9877
 #define SPY_UDP_PORT 9876
+#define DECODER_UDP_PORT 9878   // suggested port of the DbgTraceDecoder live mode
 
 #define HCI_CONTROL_GROUP_DEVICE                              0x00
 #define HCI_CONTROL_EVENT_WICED_TRACE                       ( ( HCI_CONTROL_GROUP_DEVICE << 8 ) | 0x02 )    /* WICED trace packet */
@@ -53,6 +55,7 @@ DWORD WINAPI UdpReceiveThread(LPVOID Context);
 
 SOCKADDR_IN log_socket_addr;
 SOCKADDR_IN app_socket_addr;
+SOCKADDR_IN decoder_socket_addr;    // WICED traces are also sent there if port is set
 
 SOCKET log_sock = INVALID_SOCKET;
 SOCKET app_sock = INVALID_SOCKET;
@@ -63,9 +66,9 @@ static HANDLE m_hMutex;
 
 int main(int argc, char* argv[])
 {
-    if (argc != 4)
+    if (argc != 4 && argc != 5)
     {
-        printf("usage WicedHciBridge <COM port number> <baud_rate> <app IPv4 addr\n");
+        printf("usage WicedHciBridge <COM port number> <baud_rate> <app IPv4 addr> [<trace decoder UDP port, e.g. %d>]\n", DECODER_UDP_PORT);
         return -1;
     }
     long com_port_number = atol(argv[1]);
@@ -74,9 +77,10 @@ int main(int argc, char* argv[])
     int i = sscanf_s(argv[3], "%d.%d.%d.%d", &ip[0], &ip[1], &ip[2], &ip[3]);
     if (i != 4)
     {
-        printf("usage WicedHciBridge <COM port number> <baud_rate> <app IPv4 addr\n");
+        printf("usage WicedHciBridge <COM port number> <baud_rate> <app IPv4 addr> [<trace decoder UDP port, e.g. %d>]\n", DECODER_UDP_PORT);
         return -1;
     }
+    int decoder_port = (argc == 5) ? atoi(argv[4]) : 0;
     m_ComHelper = new ComHelper();
     if (!m_ComHelper->OpenPort(com_port_number, baud_rate))
     {
@@ -118,6 +122,12 @@ int main(int argc, char* argv[])
     app_socket_addr.sin_addr.s_addr = (ip[3] << 24) + (ip[2] << 16) + (ip[1] << 8) + ip[0];
     app_socket_addr.sin_port = htons(APP_UDP_PORT);
 
+    // DbgTraceDecoder listens on the loopback only
+    memset(&decoder_socket_addr, 0, sizeof(decoder_socket_addr));
+    decoder_socket_addr.sin_family = AF_INET;
+    decoder_socket_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    decoder_socket_addr.sin_port = htons((u_short)decoder_port);
+
     SOCKADDR_IN saExt;
 //    SOCKET      app_sock;
 
@@ -263,6 +273,10 @@ void TraceHciPkt(BYTE type, BYTE *buffer, USHORT length)
     *p++ = 1;
     memcpy(p, buffer, length);
 
+    // decoder gets the same packet BTSpy does, so it can be started and stopped independently
+    if (type == 0 && decoder_socket_addr.sin_port != 0)
+        sendto(log_sock, (const char *)buf, length + 8, 0, (SOCKADDR *)&decoder_socket_addr, sizeof(SOCKADDR_IN));
+
     length = sendto(log_sock, (const char *)buf, length + 8, 0, (SOCKADDR *)&log_socket_addr, sizeof(SOCKADDR_IN));
 }
 
@@ -588,21 +602,14 @@ char *mesh_opcode_string(unsigned short opcode, unsigned int is_command)
     return "???";
 }
 
+static void DumpText(const char *p_text, uint32_t len)
+{
+    fwrite(p_text, 1, len, stdout);
+}
+
 // prints data in ascii format to the std out
 void DumpData(UINT8 *p, UINT32 length, UINT32 max_lines)
 {
-    char    buff[100];
-    UINT    i, j;
-
     if (p != NULL)
-    {
-        for (j = 0; j < max_lines && (16 * j) < length; j++)
-        {
-            for (i = 0; (i < 16) && ((i + (16 * j)) < length); i++)
-            {
-                sprintf_s(&buff[3 * i], sizeof(buff) - 3 * i, "%02x \n", ((UINT8*)p)[i + (j * 16)]);
-            }
-            printf("%s", buff);
-        }
-    }
+        hex_dump(p, length, max_lines, DumpText);
 }
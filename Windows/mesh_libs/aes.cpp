@@ -31,6 +31,8 @@
  that developed by Karl Malbrain. His contribution is acknowledged.
  */
 
+// #define AES_UNIT_TEST
+
 /* define if you have a fast memcpy function on your system */
 
 #if 1
@@ -63,8 +65,65 @@
 #  define VERSION_1
 #endif
 
+/* define to use 32-bit T-table rounds for block encryption (this needs
+   USE_TABLES and HAVE_UINT_32T and adds 4 kbytes of tables)           */
+#if 1
+#  define AES_ENC_TTABLE
+#endif
+
+#if defined( AES_ENC_TTABLE ) && ( !defined( USE_TABLES ) || !defined( HAVE_UINT_32T ) )
+#  undef AES_ENC_TTABLE
+#endif
+
+/* define to detect the AES instructions (AES-NI on x86 and x86_64, the
+   ARMv8 Crypto Extensions on arm64) at run time and use them for block
+   encryption, falling back to the portable rounds when they are absent */
+#if 1
+#  define AES_HW_DISPATCH
+#endif
+
 #include "aes.h"
 
+#if defined( AES_HW_DISPATCH ) && defined( AES_ENC_PREKEYED )
+#  if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+#    include <intrin.h>
+#    include <wmmintrin.h>
+#    define AES_HW_X86
+#    define AES_HW_TARGET
+#  elif defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+#    include <cpuid.h>
+#    include <wmmintrin.h>
+#    define AES_HW_X86
+#    define AES_HW_TARGET __attribute__((target("aes,sse2")))
+#  elif defined( __GNUC__ ) && defined( __aarch64__ ) && ( defined( __ARM_FEATURE_CRYPTO ) \
+        || defined( __ARM_FEATURE_AES ) || ( defined( __clang__ ) && __clang_major__ >= 13 ) \
+        || ( !defined( __clang__ ) && __GNUC__ >= 6 ) )
+#    include <arm_neon.h>
+#    if defined( __linux__ )
+#      include <sys/auxv.h>
+#      ifndef HWCAP_AES
+#        define HWCAP_AES (1 << 3)
+#      endif
+#    endif
+#    define AES_HW_ARM64
+#    if defined( __clang__ )
+#      define AES_HW_TARGET __attribute__((target("aes")))
+#    else
+#      define AES_HW_TARGET __attribute__((target("+crypto")))
+#    endif
+#  endif
+#endif
+
+#if !defined( AES_HW_X86 ) && !defined( AES_HW_ARM64 )
+#  undef AES_HW_DISPATCH
+#endif
+
+/* aes_encrypt_128 expands the key and uses the pre-keyed block encryption
+   when that is faster than the byte oriented 'on the fly' rounds */
+#if ( defined( AES_ENC_TTABLE ) || defined( AES_HW_DISPATCH ) ) && defined( AES_ENC_PREKEYED )
+#  define AES_ENC_128_PREKEYED
+#endif
+
 #if defined( HAVE_UINT_32T )
   typedef unsigned long uint_32t;
 #endif
@@ -212,6 +271,26 @@ static const uint_8t gfmul_e[256] = mm_data(fe);
 #define gfm_d(x)     gfmul_d[(x)]
 #define gfm_e(x)     gfmul_e[(x)]
 
+#if defined( AES_ENC_TTABLE )
+
+/*  The encryption T-tables combine sub_bytes and mix_columns for one byte
+    of the state. The state is held as four little endian column words so
+    row 0 is in the least significant byte; table n is for a byte in row n
+    (t_fn1..t_fn3 are byte rotations of t_fn0).
+*/
+
+#define t0_w(x) ((uint_32t)f2(x) | ((uint_32t)(x) << 8) | ((uint_32t)(x) << 16) | ((uint_32t)f3(x) << 24))
+#define t1_w(x) ((uint_32t)f3(x) | ((uint_32t)f2(x) << 8) | ((uint_32t)(x) << 16) | ((uint_32t)(x) << 24))
+#define t2_w(x) ((uint_32t)(x) | ((uint_32t)f3(x) << 8) | ((uint_32t)f2(x) << 16) | ((uint_32t)(x) << 24))
+#define t3_w(x) ((uint_32t)(x) | ((uint_32t)(x) << 8) | ((uint_32t)f3(x) << 16) | ((uint_32t)f2(x) << 24))
+
+static const uint_32t t_fn0[256] = sb_data(t0_w);
+static const uint_32t t_fn1[256] = sb_data(t1_w);
+static const uint_32t t_fn2[256] = sb_data(t2_w);
+static const uint_32t t_fn3[256] = sb_data(t3_w);
+
+#endif
+
 #else
 
 /* this is the high bit of x right shifted by 1 */
@@ -492,6 +571,66 @@ static void inv_shift_sub_rows( uint_8t st[N_BLOCK] )
     dt[11] = is_box(gfm_b(st[12]) ^ gfm_d(st[13]) ^ gfm_9(st[14]) ^ gfm_e(st[15]));
   }
 
+#if defined( AES_ENC_TTABLE )
+
+/*  Load and store a state column as a little endian word; this is
+    independent of the alignment of the buffer and of the size of uint_32t */
+
+static uint_32t word_in( const uint_8t *p )
+{
+    return (uint_32t)p[0] | ((uint_32t)p[1] << 8) | ((uint_32t)p[2] << 16) | ((uint_32t)p[3] << 24);
+}
+
+static void word_out( uint_8t *p, uint_32t v )
+{
+    p[0] = (uint_8t)(v);
+    p[1] = (uint_8t)(v >> 8);
+    p[2] = (uint_8t)(v >> 16);
+    p[3] = (uint_8t)(v >> 24);
+}
+
+/*  One output column of a full round (shift_rows, sub_bytes, mix_columns
+    and add_round_key) and of the final round (no mix_columns); the column
+    words a, b, c and d supply rows 0, 1, 2 and 3 respectively */
+
+#define t_col(a, b, c, d, k) \
+    ( t_fn0[(a) & 0xff] ^ t_fn1[((b) >> 8) & 0xff] \
+    ^ t_fn2[((c) >> 16) & 0xff] ^ t_fn3[((d) >> 24) & 0xff] ^ word_in(k) )
+
+#define t_last(a, b, c, d, k) \
+    ( ( (uint_32t)s_box((a) & 0xff) | ((uint_32t)s_box(((b) >> 8) & 0xff) << 8) \
+    | ((uint_32t)s_box(((c) >> 16) & 0xff) << 16) | ((uint_32t)s_box(((d) >> 24) & 0xff) << 24) ) ^ word_in(k) )
+
+/*  Encrypt a single block with an expanded key schedule of rnd rounds */
+
+static void t_encrypt( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{   uint_32t s0, s1, s2, s3, t0, t1, t2, t3;
+    uint_8t r;
+
+    s0 = word_in(in     ) ^ word_in(ks     );
+    s1 = word_in(in +  4) ^ word_in(ks +  4);
+    s2 = word_in(in +  8) ^ word_in(ks +  8);
+    s3 = word_in(in + 12) ^ word_in(ks + 12);
+
+    for( r = 1 ; r < rnd ; ++r )
+    {
+        ks += N_BLOCK;
+        t0 = t_col(s0, s1, s2, s3, ks     );
+        t1 = t_col(s1, s2, s3, s0, ks +  4);
+        t2 = t_col(s2, s3, s0, s1, ks +  8);
+        t3 = t_col(s3, s0, s1, s2, ks + 12);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    ks += N_BLOCK;
+    word_out(out     , t_last(s0, s1, s2, s3, ks     ));
+    word_out(out +  4, t_last(s1, s2, s3, s0, ks +  4));
+    word_out(out +  8, t_last(s2, s3, s0, s1, ks +  8));
+    word_out(out + 12, t_last(s3, s0, s1, s2, ks + 12));
+}
+
+#endif
+
 #if defined( AES_ENC_PREKEYED ) || defined( AES_DEC_PREKEYED )
 
 /*  Set the cipher key for the pre-keyed version */
@@ -557,35 +696,319 @@ return_type aes_set_key( const unsigned char key[], length_type keylen, aes_cont
 
 #if defined( AES_ENC_PREKEYED )
 
+#if !defined( AES_ENC_TTABLE ) || defined( AES_UNIT_TEST )
+
+/*  Encrypt a single block of 16 bytes with the byte oriented rounds */
+
+static void b_encrypt( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{   uint_8t s1[N_BLOCK], r;
+
+    copy_and_key( s1, in, ks );
+
+    for( r = 1 ; r < rnd ; ++r )
+#if defined( VERSION_1 )
+    {
+        mix_sub_columns( s1 );
+        add_round_key( s1, ks + r * N_BLOCK);
+    }
+#else
+    {   uint_8t s2[N_BLOCK];
+        mix_sub_columns( s2, s1 );
+        copy_and_key( s1, s2, ks + r * N_BLOCK);
+    }
+#endif
+    shift_sub_rows( s1 );
+    copy_and_key( out, s1, ks + r * N_BLOCK );
+}
+
+#endif
+
+#if defined( AES_ENC_TTABLE )
+#  define sw_encrypt    t_encrypt
+#else
+#  define sw_encrypt    b_encrypt
+#endif
+
+#if defined( AES_HW_DISPATCH )
+
+/*  Encrypt a single block of 16 bytes with the AES instructions; the round
+    keys are used as they are laid out in the byte oriented key schedule */
+
+#define N_LANES     4
+
+#if defined( AES_HW_X86 )
+
+static AES_HW_TARGET void hw_encrypt( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{   __m128i s1;
+    uint_8t r;
+
+    s1 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)in ), _mm_loadu_si128( (const __m128i*)ks ) );
+    for( r = 1 ; r < rnd ; ++r )
+        s1 = _mm_aesenc_si128( s1, _mm_loadu_si128( (const __m128i*)(ks + r * N_BLOCK) ) );
+    s1 = _mm_aesenclast_si128( s1, _mm_loadu_si128( (const __m128i*)(ks + r * N_BLOCK) ) );
+    _mm_storeu_si128( (__m128i*)out, s1 );
+}
+
+/*  Encrypt N_LANES independent blocks in place with their rounds
+    interleaved; all the key schedules must have the same number of rounds.
+    The lanes are unrolled by hand so that the states stay in registers */
+
+#define hw_lanes_load(i) \
+    k##i = ctx[i]->ksch; \
+    s##i = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)blk[i] ), _mm_loadu_si128( (const __m128i*)k##i ) )
+#define hw_lanes_round(i) \
+    s##i = _mm_aesenc_si128( s##i, _mm_loadu_si128( (const __m128i*)(k##i + r * N_BLOCK) ) )
+#define hw_lanes_last(i) \
+    _mm_storeu_si128( (__m128i*)blk[i], _mm_aesenclast_si128( s##i, _mm_loadu_si128( (const __m128i*)(k##i + r * N_BLOCK) ) ) )
+
+static AES_HW_TARGET void hw_encrypt_lanes( uint_8t *blk[], const aes_context *ctx[] )
+{   __m128i s0, s1, s2, s3;
+    const uint_8t *k0, *k1, *k2, *k3;
+    uint_8t r;
+
+    hw_lanes_load(0); hw_lanes_load(1); hw_lanes_load(2); hw_lanes_load(3);
+    for( r = 1 ; r < ctx[0]->rnd ; ++r )
+    {
+        hw_lanes_round(0); hw_lanes_round(1); hw_lanes_round(2); hw_lanes_round(3);
+    }
+    hw_lanes_last(0); hw_lanes_last(1); hw_lanes_last(2); hw_lanes_last(3);
+}
+
+/*  Encrypt two blocks in place with the same key schedule, sharing the
+    round key loads between them */
+
+static AES_HW_TARGET void hw_encrypt_pair( uint_8t b0[N_BLOCK], uint_8t b1[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{   __m128i s0, s1, k;
+    uint_8t r;
+
+    k = _mm_loadu_si128( (const __m128i*)ks );
+    s0 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)b0 ), k );
+    s1 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)b1 ), k );
+    for( r = 1 ; r < rnd ; ++r )
+    {
+        k = _mm_loadu_si128( (const __m128i*)(ks + r * N_BLOCK) );
+        s0 = _mm_aesenc_si128( s0, k );
+        s1 = _mm_aesenc_si128( s1, k );
+    }
+    k = _mm_loadu_si128( (const __m128i*)(ks + r * N_BLOCK) );
+    _mm_storeu_si128( (__m128i*)b0, _mm_aesenclast_si128( s0, k ) );
+    _mm_storeu_si128( (__m128i*)b1, _mm_aesenclast_si128( s1, k ) );
+}
+
+static int hw_aes_available( void )
+{
+#if defined( _MSC_VER )
+    int info[4];
+
+    __cpuid( info, 1 );
+    return ( info[2] & (1 << 25) ) && ( info[3] & (1 << 26) );
+#else
+    unsigned int a, b, c, d;
+
+    if( !__get_cpuid( 1, &a, &b, &c, &d ) )
+        return 0;
+    return ( c & bit_AES ) && ( d & bit_SSE2 );
+#endif
+}
+
+#else
+
+static AES_HW_TARGET void hw_encrypt( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{   uint8x16_t s1;
+    uint_8t r;
+
+    /* aese does add_round_key, sub_bytes and shift_rows, aesmc mix_columns */
+    s1 = vld1q_u8( in );
+    for( r = 1 ; r < rnd ; ++r )
+        s1 = vaesmcq_u8( vaeseq_u8( s1, vld1q_u8( ks + (r - 1) * N_BLOCK ) ) );
+    s1 = vaeseq_u8( s1, vld1q_u8( ks + (r - 1) * N_BLOCK ) );
+    s1 = veorq_u8( s1, vld1q_u8( ks + r * N_BLOCK ) );
+    vst1q_u8( out, s1 );
+}
+
+#define hw_lanes_load(i) \
+    k##i = ctx[i]->ksch; \
+    s##i = vld1q_u8( blk[i] )
+#define hw_lanes_round(i) \
+    s##i = vaesmcq_u8( vaeseq_u8( s##i, vld1q_u8( k##i + (r - 1) * N_BLOCK ) ) )
+#define hw_lanes_last(i) \
+    vst1q_u8( blk[i], veorq_u8( vaeseq_u8( s##i, vld1q_u8( k##i + (r - 1) * N_BLOCK ) ), vld1q_u8( k##i + r * N_BLOCK ) ) )
+
+static AES_HW_TARGET void hw_encrypt_lanes( uint_8t *blk[], const aes_context *ctx[] )
+{   uint8x16_t s0, s1, s2, s3;
+    const uint_8t *k0, *k1, *k2, *k3;
+    uint_8t r;
+
+    hw_lanes_load(0); hw_lanes_load(1); hw_lanes_load(2); hw_lanes_load(3);
+    for( r = 1 ; r < ctx[0]->rnd ; ++r )
+    {
+        hw_lanes_round(0); hw_lanes_round(1); hw_lanes_round(2); hw_lanes_round(3);
+    }
+    hw_lanes_last(0); hw_lanes_last(1); hw_lanes_last(2); hw_lanes_last(3);
+}
+
+static AES_HW_TARGET void hw_encrypt_pair( uint_8t b0[N_BLOCK], uint_8t b1[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{   uint8x16_t s0, s1, k;
+    uint_8t r;
+
+    s0 = vld1q_u8( b0 );
+    s1 = vld1q_u8( b1 );
+    for( r = 1 ; r < rnd ; ++r )
+    {
+        k = vld1q_u8( ks + (r - 1) * N_BLOCK );
+        s0 = vaesmcq_u8( vaeseq_u8( s0, k ) );
+        s1 = vaesmcq_u8( vaeseq_u8( s1, k ) );
+    }
+    k = vld1q_u8( ks + (r - 1) * N_BLOCK );
+    s0 = vaeseq_u8( s0, k );
+    s1 = vaeseq_u8( s1, k );
+    k = vld1q_u8( ks + r * N_BLOCK );
+    vst1q_u8( b0, veorq_u8( s0, k ) );
+    vst1q_u8( b1, veorq_u8( s1, k ) );
+}
+
+static int hw_aes_available( void )
+{
+#if defined( __APPLE__ )
+    return 1;   /* every arm64 Apple core has the Crypto Extensions */
+#elif defined( __linux__ )
+    return ( getauxval( AT_HWCAP ) & HWCAP_AES ) != 0;
+#else
+    return 0;
+#endif
+}
+
+#endif
+
+/*  The block encryption is selected on first use. Concurrent first calls
+    all store the same function so no locking is needed */
+
+typedef void (*enc_block_fn)( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd );
+typedef void (*enc_lanes_fn)( uint_8t *blk[], const aes_context *ctx[] );
+typedef void (*enc_pair_fn)( uint_8t b0[N_BLOCK], uint_8t b1[N_BLOCK], const uint_8t *ks, uint_8t rnd );
+
+static void sel_encrypt( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd );
+static void sel_encrypt_lanes( uint_8t *blk[], const aes_context *ctx[] );
+static void sel_encrypt_pair( uint_8t b0[N_BLOCK], uint_8t b1[N_BLOCK], const uint_8t *ks, uint_8t rnd );
+
+static enc_block_fn enc_block = sel_encrypt;
+static enc_lanes_fn enc_lanes = sel_encrypt_lanes;
+static enc_pair_fn  enc_pair  = sel_encrypt_pair;
+
+static void sw_encrypt_lanes( uint_8t *blk[], const aes_context *ctx[] )
+{   int i;
+
+    for( i = 0 ; i < N_LANES ; ++i )
+        sw_encrypt( blk[i], blk[i], ctx[i]->ksch, ctx[i]->rnd );
+}
+
+static void sw_encrypt_pair( uint_8t b0[N_BLOCK], uint_8t b1[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{
+    sw_encrypt( b0, b0, ks, rnd );
+    sw_encrypt( b1, b1, ks, rnd );
+}
+
+static void sel_hw( void )
+{
+    if( hw_aes_available() )
+    {
+        enc_pair = hw_encrypt_pair;
+        enc_lanes = hw_encrypt_lanes;
+        enc_block = hw_encrypt;
+    }
+    else
+    {
+        enc_pair = sw_encrypt_pair;
+        enc_lanes = sw_encrypt_lanes;
+        enc_block = sw_encrypt;
+    }
+}
+
+static void sel_encrypt( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{
+    sel_hw();
+    enc_block( in, out, ks, rnd );
+}
+
+static void sel_encrypt_lanes( uint_8t *blk[], const aes_context *ctx[] )
+{
+    sel_hw();
+    enc_lanes( blk, ctx );
+}
+
+static void sel_encrypt_pair( uint_8t b0[N_BLOCK], uint_8t b1[N_BLOCK], const uint_8t *ks, uint_8t rnd )
+{
+    sel_hw();
+    enc_pair( b0, b1, ks, rnd );
+}
+
+#endif
+
 /*  Encrypt a single block of 16 bytes */
 
 return_type aes_encrypt( const unsigned char in[N_BLOCK], unsigned char  out[N_BLOCK], const aes_context ctx[1] )
 {
     if( ctx->rnd )
     {
-        uint_8t s1[N_BLOCK], r;
-        copy_and_key( s1, in, ctx->ksch );
-
-        for( r = 1 ; r < ctx->rnd ; ++r )
-#if defined( VERSION_1 )
-        {
-            mix_sub_columns( s1 );
-            add_round_key( s1, ctx->ksch + r * N_BLOCK);
-        }
+#if defined( AES_HW_DISPATCH )
+        enc_block( in, out, ctx->ksch, ctx->rnd );
 #else
-        {   uint_8t s2[N_BLOCK];
-            mix_sub_columns( s2, s1 );
-            copy_and_key( s1, s2, ctx->ksch + r * N_BLOCK);
-        }
+        sw_encrypt( in, out, ctx->ksch, ctx->rnd );
 #endif
-        shift_sub_rows( s1 );
-        copy_and_key( out, s1, ctx->ksch + r * N_BLOCK );
     }
     else
         return (return_type)-1;
     return 0;
 }
 
+/*  Encrypt n independent 16 byte blocks in place, block i with the key
+    schedule ctx[i]. When the AES instructions are available groups of
+    blocks with the same key length go through the cipher together */
+
+return_type aes_encrypt_n( unsigned char *blk[], const aes_context *ctx[], int n )
+{   int i;
+
+    for( i = 0 ; i < n ; ++i )
+        if( !ctx[i]->rnd )
+            return (return_type)-1;
+#if defined( AES_HW_DISPATCH )
+    while( n > 0 )
+    {   int j;
+
+        for( i = 1 ; i < n && i < N_LANES && ctx[i]->rnd == ctx[0]->rnd ; ++i )
+            ;
+        if( i == N_LANES )
+            enc_lanes( blk, ctx );
+        else
+            for( j = 0 ; j < i ; ++j )
+                enc_block( blk[j], blk[j], ctx[j]->ksch, ctx[j]->rnd );
+        blk += i;
+        ctx += i;
+        n -= i;
+    }
+#else
+    for( i = 0 ; i < n ; ++i )
+        sw_encrypt( blk[i], blk[i], ctx[i]->ksch, ctx[i]->rnd );
+#endif
+    return 0;
+}
+
+/*  Encrypt two independent 16 byte blocks in place with the same key, as
+    used by modes that run two cipher streams side by side */
+
+return_type aes_encrypt_pair( unsigned char b0[N_BLOCK], unsigned char b1[N_BLOCK], const aes_context ctx[1] )
+{
+    if( !ctx->rnd )
+        return (return_type)-1;
+#if defined( AES_HW_DISPATCH )
+    enc_pair( b0, b1, ctx->ksch, ctx->rnd );
+#else
+    sw_encrypt( b0, b0, ctx->ksch, ctx->rnd );
+    sw_encrypt( b1, b1, ctx->ksch, ctx->rnd );
+#endif
+    return 0;
+}
+
 /* CBC encrypt a number of blocks (input and return an IV) */
 
 return_type aes_cbc_encrypt( const unsigned char *in, unsigned char *out,
@@ -660,6 +1083,8 @@ return_type aes_cbc_decrypt( const unsigned char *in, unsigned char *out,
 
 #if defined( AES_ENC_128_OTFK )
 
+#if !defined( AES_ENC_128_PREKEYED )
+
 /*  The 'on the fly' encryption key update for for 128 bit keys */
 
 static void update_encrypt_key_128( uint_8t k[N_BLOCK], uint_8t *rc )
@@ -680,10 +1105,21 @@ static void update_encrypt_key_128( uint_8t k[N_BLOCK], uint_8t *rc )
     }
 }
 
+#endif
+
 /*  Encrypt a single block of 16 bytes with 'on the fly' 128 bit keying */
 
 void aes_encrypt_128( const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK],
                      const unsigned char key[N_BLOCK], unsigned char o_key[N_BLOCK] )
+#if defined( AES_ENC_128_PREKEYED )
+{   aes_context ctx[1];
+
+    /* the last round key is the key that aes_decrypt_128 needs */
+    aes_set_key( key, N_BLOCK, ctx );
+    aes_encrypt( in, out, ctx );
+    block_copy( o_key, ctx->ksch + ctx->rnd * N_BLOCK );
+}
+#else
 {   uint_8t s1[N_BLOCK], r, rc = 1;
 
     if(o_key != key)
@@ -709,6 +1145,7 @@ void aes_encrypt_128( const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK
     update_encrypt_key_128( o_key, &rc );
     copy_and_key( out, s1, o_key );
 }
+#endif
 
 #endif
 
@@ -925,3 +1362,138 @@ void aes_decrypt_256( const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK
 }
 
 #endif
+
+#ifdef AES_UNIT_TEST
+/*  FIPS-197 appendix C known answer tests of every block encryption path
+    built in, and a cycles per block comparison of those paths */
+#include <stdio.h>
+#include <time.h>
+#if defined( _MSC_VER )
+#  include <intrin.h>
+#  define AES_TEST_CYCLES() __rdtsc()
+#elif defined( __i386__ ) || defined( __x86_64__ )
+#  include <x86intrin.h>
+#  define AES_TEST_CYCLES() __rdtsc()
+#endif
+
+#define AES_TEST_BLOCKS 1000000
+
+typedef void (*test_enc_fn)( const uint_8t in[N_BLOCK], uint_8t out[N_BLOCK], const uint_8t *ks, uint_8t rnd );
+
+static const struct
+{
+    const char  *name;
+    test_enc_fn fn;
+} test_paths[] =
+{
+    { "byte rounds", b_encrypt },
+#if defined( AES_ENC_TTABLE )
+    { "T-table rounds", t_encrypt },
+#endif
+#if defined( AES_HW_DISPATCH )
+    { "AES instructions", hw_encrypt },
+#endif
+};
+
+static const uint_8t test_key[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static const uint_8t test_pt[N_BLOCK] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+static const struct
+{
+    uint_8t key_len;
+    uint_8t ct[N_BLOCK];
+} test_kat[] =
+{
+    { 16, { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a } },
+    { 24, { 0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91 } },
+    { 32, { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 } },
+};
+
+static int check_block( const char *name, int key_len, const uint_8t *res, const uint_8t *exp )
+{
+    int ok = memcmp( res, exp, N_BLOCK ) == 0;
+    printf("%-20s AES-%d %s\n", name, key_len * 8, ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static void time_encrypt( const char *name, test_enc_fn fn, const aes_context ctx[1] )
+{
+    uint_8t blk[N_BLOCK] = { 0 };
+    clock_t t = clock();
+    long i;
+#ifdef AES_TEST_CYCLES
+    unsigned long long c = AES_TEST_CYCLES();
+#endif
+
+    for( i = 0; i < AES_TEST_BLOCKS; i++ )
+        fn( blk, blk, ctx->ksch, ctx->rnd );
+#ifdef AES_TEST_CYCLES
+    c = AES_TEST_CYCLES() - c;
+    printf("%-20s %6.1f cycles/block ", name, (double)c / AES_TEST_BLOCKS);
+#else
+    printf("%-20s ", name);
+#endif
+    t = clock() - t;
+    printf("%6.1f ns/block (%02x)\n", (double)t * 1e9 / CLOCKS_PER_SEC / AES_TEST_BLOCKS, blk[0]);
+}
+
+int main()
+{
+    aes_context ctx[1];
+    uint_8t res[N_BLOCK], res2[N_BLOCK], o_key[N_BLOCK];
+    unsigned int i, k;
+    int ok = 1;
+
+#if defined( AES_HW_DISPATCH )
+    printf("AES instructions %savailable\n", hw_aes_available() ? "" : "not ");
+#endif
+    for( k = 0; k < sizeof(test_kat) / sizeof(test_kat[0]); k++ )
+    {
+        aes_set_key( test_key, test_kat[k].key_len, ctx );
+        for( i = 0; i < sizeof(test_paths) / sizeof(test_paths[0]); i++ )
+        {
+#if defined( AES_HW_DISPATCH )
+            if( test_paths[i].fn == hw_encrypt && !hw_aes_available() )
+                continue;
+#endif
+            test_paths[i].fn( test_pt, res, ctx->ksch, ctx->rnd );
+            ok &= check_block( test_paths[i].name, test_kat[k].key_len, res, test_kat[k].ct );
+        }
+        aes_encrypt( test_pt, res, ctx );
+        ok &= check_block( "aes_encrypt", test_kat[k].key_len, res, test_kat[k].ct );
+        memcpy( res, test_pt, N_BLOCK );
+        memcpy( res2, test_pt, N_BLOCK );
+        aes_encrypt_pair( res, res2, ctx );
+        ok &= check_block( "aes_encrypt_pair", test_kat[k].key_len, res, test_kat[k].ct )
+            & check_block( "aes_encrypt_pair", test_kat[k].key_len, res2, test_kat[k].ct );
+        aes_decrypt( test_kat[k].ct, res, ctx );
+        ok &= check_block( "aes_decrypt", test_kat[k].key_len, res, test_pt );
+    }
+
+    aes_encrypt_128( test_pt, res, test_key, o_key );
+    ok &= check_block( "aes_encrypt_128", 16, res, test_kat[0].ct );
+    aes_decrypt_128( res, res, o_key, o_key );
+    ok &= check_block( "aes_decrypt_128", 16, res, test_pt );
+
+    aes_set_key( test_key, 16, ctx );
+    for( i = 0; i < sizeof(test_paths) / sizeof(test_paths[0]); i++ )
+    {
+#if defined( AES_HW_DISPATCH )
+        if( test_paths[i].fn == hw_encrypt && !hw_aes_available() )
+            continue;
+#endif
+        time_encrypt( test_paths[i].name, test_paths[i].fn, ctx );
+    }
+    return ok ? 0 : 1;
+}
+
+#endif
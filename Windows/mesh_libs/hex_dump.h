@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Hex dump formatter shared by the trace paths that print packet bytes.
+ *
+ * A whole buffer is formatted into text with one pass over a digit table, 16 bytes at a time
+ * with SSSE3 or NEON where the compiler targets them, and handed to the output as one block.
+ * This replaces printing each byte or each line with a separate printf.
+ */
+#ifndef __HEX_DUMP_H__
+#define __HEX_DUMP_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HEX_DUMP_LINE_BYTES     16      // bytes per line of a dump
+#define HEX_DUMP_SCRATCH_SIZE   1024    // text passed to the output at a time, 21 full lines
+
+/* Text size needed for len bytes in any layout, including the terminating NUL */
+#define HEX_DUMP_TEXT_SIZE(len) (3 * (len) + 1)
+
+/*
+ * Formats len bytes as lowercase hex. With bytes_per_line set the bytes are separated by spaces
+ * and every line, the last one included, ends with a newline. With bytes_per_line 0 the digits
+ * are written as one run with no separators. Output stops at the last byte that fits, the text
+ * is always NUL terminated. Returns the length of the text.
+ */
+uint32_t hex_dump_format(char *p_text, uint32_t text_size, const uint8_t *p_data, uint32_t len, uint32_t bytes_per_line);
+
+/* Receives one block of dump text, len does not count the terminating NUL */
+typedef void (HEX_DUMP_OUTPUT)(const char *p_text, uint32_t len);
+
+/*
+ * Dumps at most max_lines lines of HEX_DUMP_LINE_BYTES bytes, all of them if max_lines is 0.
+ * The text is built in a scratch area on the stack, p_output is called once per
+ * HEX_DUMP_SCRATCH_SIZE of text, that is once for any mesh packet.
+ */
+void hex_dump(const uint8_t *p_data, uint32_t len, uint32_t max_lines, HEX_DUMP_OUTPUT *p_output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HEX_DUMP_H__ */
@@ -74,27 +74,45 @@
 #include "wiced_bt_trace.h"
 #include "wiced_bt_ble.h"
 #include "wiced_bt_gatt.h"
+#include "timer_wheel.h"
+#include "timer_stats.h"
+#include "log_ring.h"
+#include "hex_dump.h"
+#include "mesh_trace.h"
 
 
 typedef void (TIMER_CBACK)(void *p_tle);
 #define TIMER_PARAM_TYPE    void *
-extern void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg);
+extern void execute_timer_callback(TIMER_CBACK *p_callback, TIMER_PARAM_TYPE arg, uint64_t deadline_us);
 
 #define TIMER_ACTIVE          0x0001
 
+#define TIMER_SECONDS_SLACK     64      // default slack in ms of seconds timers, they only need 1 second resolution
+#define TIMER_DISPATCH_MAX      16      // max due timers collected per pass of the timer thread
+
+#ifndef TIMER_STATS_DUMP_INTERVAL
+#define TIMER_STATS_DUMP_INTERVAL   60000   // ms between dumps of the timer statistics, 0 disables the dump
+#endif
+
 typedef struct _tle
 {
-    struct _tle  *p_next;
+    TIMER_WHEEL_ENT wheel;              /* Link in the timer wheel, target_time is in timer_get_tick_count ms */
     TIMER_CBACK  *p_cback;
-    UINT16        flags;                /* Flags for timer*/
-    UINT16        type;
-    UINT32        interval;             /* Periodical time out inteval, in 1 us unit */
     TIMER_PARAM_TYPE arg;               /* parameter for expiration function */
-    UINT64        target_time;          /* Target time for timer expire, in us */
+    UINT32        interval;             /* Timeout passed to wiced_start_timer, in seconds or ms depending on type */
+    UINT8         flags;                /* Flags for timer*/
+    UINT8         type;
+    UINT16        slack;                /* ms the timer may expire late to share a wakeup with other timers */
 } TIMER_LIST_ENT;
 
-static TIMER_LIST_ENT *pOsTimerHead = NULL;
-static UINT64       absTimeHi = 0;
+// TIMER_LIST_ENT lives inside the wiced_timer_t allocated by the caller
+typedef char timer_list_ent_size_check[(sizeof(TIMER_LIST_ENT) <= sizeof(wiced_timer_t)) ? 1 : -1];
+
+static TIMER_WHEEL  timer_wheel;
+static UINT64       timer_wakeup_time = 0;      // tick the timer thread sleeps until, 0 while it is running
+static mesh_timer_stats_t timer_thread_stats;
+static UINT64       timer_thread_stats_time;    // tick of the last reset of timer_thread_stats
+static LARGE_INTEGER qpc_frequency;
 static void timerThread(void *arg);
 static HANDLE   sleepHandle;
 
@@ -106,25 +124,66 @@ extern wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id);
 
 extern CRITICAL_SECTION cs;
 
-void ods(char * fmt_str, ...)
+// Writes one line to the debugger with the local time at which it was logged
+static void ods_write(uint64_t time_us, uint32_t thread, const char *p_text)
 {
-    char buf[1000] = { 0 };
-    va_list marker = NULL;
+    char            buf[1024];
+    SYSTEMTIME      st;
+    FILETIME        ft;
+    ULARGE_INTEGER  t;
 
-    va_start(marker, fmt_str);
-
-    SYSTEMTIME st;
+    // Lines from the log ring are written a little later, back date the time by the delay
     GetLocalTime(&st);
+    SystemTimeToFileTime(&st, &ft);
+    t.LowPart  = ft.dwLowDateTime;
+    t.HighPart = ft.dwHighDateTime;
+    t.QuadPart -= (clock_SystemTimeMicroseconds64() - time_us) * 10;
+    ft.dwLowDateTime  = t.LowPart;
+    ft.dwHighDateTime = t.HighPart;
+    FileTimeToSystemTime(&ft, &st);
 
     int len = sprintf_s(buf, sizeof(buf), "%02d:%02d:%02d.%03d ", st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
-    vsnprintf_s(&buf[len], sizeof(buf) - len, _TRUNCATE, fmt_str, marker);
-    va_end(marker);
+    strncpy_s(&buf[len], sizeof(buf) - len, p_text, _TRUNCATE);
 
     if(buf[strlen(buf) - 1] != '\n')
         strcat_s(buf, sizeof(buf), "\n");
     OutputDebugStringA(buf);
 }
 
+void mesh_trace_init(void)
+{
+    char  spec[128];
+    DWORD len;
+
+    // Trace levels can be set without a rebuild, for example MESH_TRACE=all=info,timer=verbose
+    len = GetEnvironmentVariableA("MESH_TRACE", spec, sizeof(spec));
+    if ((len != 0) && (len < sizeof(spec)))
+        mesh_trace_configure(spec);
+
+    log_ring_init(ods_write);
+}
+
+void mesh_trace_deinit(void)
+{
+    log_ring_deinit();
+}
+
+void ods(char * fmt_str, ...)
+{
+    char buf[1000] = { 0 };
+    va_list marker = NULL;
+
+    va_start(marker, fmt_str);
+
+    // Only copied to the log ring when the writer runs, formatted and written here otherwise
+    if (!log_ring_vtext(fmt_str, marker))
+    {
+        vsnprintf_s(buf, sizeof(buf), _TRUNCATE, fmt_str, marker);
+        ods_write(clock_SystemTimeMicroseconds64(), 0, buf);
+    }
+    va_end(marker);
+}
+
 int wiced_printf(char * buffer, int len, char * fmt_str, ...)
 {
     char buf[2048];
@@ -142,43 +201,49 @@ int wiced_printf(char * buffer, int len, char * fmt_str, ...)
 */
 void ble_trace0(const char *p_str)
 {
-    ods((char *)p_str);
+    if (!log_ring_text(p_str))
+        ods((char *)p_str);
 }
 
+// The formats are string constants of the mesh core, the log ring keeps just the pointer and the args.
+// Formats with a %s are formatted right away, the string may be gone before the writer runs.
 void ble_trace1(const char *fmt_str, UINT32 p1)
 {
-    ods((char *)fmt_str, p1);
+    UINT32 args[] = { p1 };
+    if (!log_ring_args(fmt_str, args, 1))
+        ods((char *)fmt_str, p1);
 }
 
 void ble_trace2(const char *fmt_str, UINT32 p1, UINT32 p2)
 {
-    ods((char *)fmt_str, p1, p2);
+    UINT32 args[] = { p1, p2 };
+    if (!log_ring_args(fmt_str, args, 2))
+        ods((char *)fmt_str, p1, p2);
 }
 
 void ble_trace3(const char *fmt_str, UINT32 p1, UINT32 p2, UINT32 p3)
 {
-    ods((char *)fmt_str, p1, p2, p3);
+    UINT32 args[] = { p1, p2, p3 };
+    if (!log_ring_args(fmt_str, args, 3))
+        ods((char *)fmt_str, p1, p2, p3);
 }
 
 void ble_trace4(const char *fmt_str, UINT32 p1, UINT32 p2, UINT32 p3, UINT32 p4)
 {
-    ods((char *)fmt_str, p1, p2, p3, p4);
+    UINT32 args[] = { p1, p2, p3, p4 };
+    if (!log_ring_args(fmt_str, args, 4))
+        ods((char *)fmt_str, p1, p2, p3, p4);
+}
+
+static void ods_hex(const char *p_text, uint32_t len)
+{
+    ods_write(clock_SystemTimeMicroseconds64(), 0, p_text);
 }
 
 void ble_tracen(const char *p_str, UINT32 len)
 {
-    char buf[100];
-    memset(buf, 0, sizeof(buf));
-    unsigned int i;
-    while (len)
-    {
-        for (i = 0; i < len && i < 16; i++)
-            sprintf_s(&buf[3 * i], 100 - (3 * i), "%02x ", (UINT8)p_str[i]);
-        buf[3 * i] = 0;
-        ods(buf);
-        len -= i;
-        p_str += i;
-    }
+    if (!log_ring_bytes((const uint8_t *)p_str, len))
+        hex_dump((const uint8_t *)p_str, len, 0, ods_hex);
 }
 
 void* wiced_memory_permanent_allocate(UINT32 length)
@@ -215,7 +280,23 @@ uint64_t wiced_bt_mesh_core_get_tick_count()
 
 uint64_t clock_SystemTimeMicroseconds64(void)
 {
-    return GetTickCount64() * 1000;
+    LARGE_INTEGER counter;
+
+    // The frequency is fixed at boot, a racing first call just stores the same value twice
+    if (qpc_frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&qpc_frequency);
+
+    QueryPerformanceCounter(&counter);
+
+    // Split the conversion so that counter * 1000000 cannot overflow
+    return (uint64_t)(counter.QuadPart / qpc_frequency.QuadPart) * 1000000 +
+           (uint64_t)(counter.QuadPart % qpc_frequency.QuadPart) * 1000000 / qpc_frequency.QuadPart;
+}
+
+// Timer ticks are in ms and come from the same clock as clock_SystemTimeMicroseconds64
+static UINT64 timer_get_tick_count(void)
+{
+    return clock_SystemTimeMicroseconds64() / 1000;
 }
 
 static wiced_timer_t *wiced_timer_first = NULL;
@@ -226,28 +307,75 @@ wiced_result_t wiced_init_timer(wiced_timer_t* p_timer, wiced_timer_callback_fp
 {
     TIMER_LIST_ENT *p = (TIMER_LIST_ENT *)p_timer;
 
-    ods("wiced_init_timer p_timer:%x\n", p_timer);
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_init_timer p_timer:%x\n", p_timer);
 
     memset(p_timer, 0, sizeof(TIMER_LIST_ENT));
     p->p_cback  = TimerCb;
     p->arg      = cBackparam;
     p->type     = type;
     p->interval = 0;
+    if (type == WICED_SECONDS_TIMER || type == WICED_SECONDS_PERIODIC_TIMER)
+        p->slack = TIMER_SECONDS_SLACK;
 
     return WICED_BT_SUCCESS;
 }
 
+void wiced_set_timer_slack(wiced_timer_t *p_timer, uint32_t slack_ms)
+{
+    TIMER_LIST_ENT *p = (TIMER_LIST_ENT *)p_timer;
+
+    p->slack = (slack_ms > 0xFFFF) ? 0xFFFF : (UINT16)slack_ms;
+}
+
+// Rounds the deadline up to a multiple of the largest power of two that is not above the slack,
+// timers due around the same time then land on the same tick and share one wakeup.
+static UINT64 timer_apply_slack(UINT64 target_time, UINT16 slack)
+{
+    UINT64 granularity = 1;
+
+    if (slack == 0)
+        return target_time;
+
+    while ((granularity << 1) <= slack)
+        granularity <<= 1;
+
+    return (target_time + granularity - 1) & ~(granularity - 1);
+}
+
 wiced_result_t wiced_deinit_timer(wiced_timer_t* p)
 {
-    ods("wiced_deinit_timer:%x\n", p);
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_deinit_timer:%x\n", p);
     return WICED_BT_SUCCESS;
 }
 
+// Puts the timer in the wheel, cs is held. Returns TRUE if the timer thread sleeps past the new deadline.
+static BOOL timer_arm(TIMER_LIST_ENT *p_timer, UINT32 timeout)
+{
+    // Make sure that we are not starting the same timer twice.
+    if (p_timer->flags & TIMER_ACTIVE)
+        timer_wheel_remove(&timer_wheel, &p_timer->wheel);
+
+    p_timer->interval = timeout;
+
+    if (p_timer->type == WICED_SECONDS_TIMER || p_timer->type == WICED_SECONDS_PERIODIC_TIMER)
+        timeout *= 1000;
+
+    p_timer->wheel.target_time = timer_apply_slack(timer_get_tick_count() + timeout, p_timer->slack);
+    timer_wheel_add(&timer_wheel, &p_timer->wheel);
+
+    p_timer->flags |= TIMER_ACTIVE;
+
+    if (p_timer->wheel.target_time >= timer_wakeup_time)
+        return FALSE;
+
+    timer_wakeup_time = 0;
+    return TRUE;
+}
+
 wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    TIMER_LIST_ENT  *p_cur, *p_prev;
-    UINT32          cur_tc, expire_tc;
+    BOOL            wake_thread;
 
     // This could be done more elegantly in a final product...
     static BOOL threadStarted = FALSE;
@@ -256,69 +384,26 @@ wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
         DWORD   thread_address;
         threadStarted = TRUE;
 
+        timer_wheel_init(&timer_wheel, timer_get_tick_count());
+        timer_thread_stats_time = timer_get_tick_count();
+
         sleepHandle = CreateEvent (NULL, FALSE, FALSE, NULL);
 
         CreateThread(0, 0, (LPTHREAD_START_ROUTINE)timerThread, (LPVOID)1, 0, &thread_address);
     }
     EnterCriticalSection(&cs);
 
-    // ods("wiced_start_timer:%x timeout:%d\n", p_timer, timeout);
-
-    // Make sure that we are not starting the same timer twice.
-    wiced_stop_timer(wt);
-
-    p_timer->interval = timeout;
-
-    if (p_timer->type == WICED_SECONDS_TIMER || p_timer->type == WICED_SECONDS_PERIODIC_TIMER)
-        timeout *= 1000;
-
-    cur_tc = GetTickCount();
-    expire_tc = cur_tc + timeout;   // interval is in milliseconds, convert to ms
-
-    p_timer->target_time = absTimeHi + expire_tc;
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_start_timer:%x timeout:%d\n", p_timer, timeout);
 
-    // Check for rollover of the 32-bit tick count
-    if (expire_tc < cur_tc)
-        p_timer->target_time += 0x100000000;
+    timer_stats_start(p_timer->p_cback, (p_timer->flags & TIMER_ACTIVE) != 0);
 
-    // Put the timer in the appropriate place
-    if ((pOsTimerHead == NULL) || (pOsTimerHead->target_time > p_timer->target_time))
-    {
-        // New timer goes at start of list
-        p_timer->p_next = pOsTimerHead;
-        pOsTimerHead = p_timer;
-    }
-    else
-    {
-        p_prev = pOsTimerHead;
-        p_cur = p_prev->p_next;
-
-        for (; ; )
-        {
-            if (p_cur == NULL)
-            {
-                // New timer goes at end of list
-                p_prev->p_next = p_timer;
-                p_timer->p_next = NULL;
-                break;
-            }
-            if (p_cur->target_time > p_timer->target_time)
-            {
-                // New timer goes in the middle of the list
-                p_prev->p_next  = p_timer;
-                p_timer->p_next = p_cur;
-                break;
-            }
-            p_prev = p_cur;
-            p_cur = p_prev->p_next;
-        }
-    }
-
-    p_timer->flags |= TIMER_ACTIVE;
+    // Only wake the timer thread if it sleeps past the new deadline
+    wake_thread = timer_arm(p_timer, timeout);
 
     LeaveCriticalSection(&cs);
 
-    SetEvent (sleepHandle);
+    if (wake_thread)
+        SetEvent (sleepHandle);
 
     return WICED_BT_SUCCESS;
 }
@@ -326,34 +411,21 @@ wiced_result_t wiced_start_timer(wiced_timer_t* wt, uint32_t timeout)
 wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    TIMER_LIST_ENT *pt;
 
-    // ods("wiced_stop_timer:%x\n", p_timer);
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "wiced_stop_timer:%x\n", p_timer);
 
     EnterCriticalSection(&cs);
 
-    p_timer->flags &= ~TIMER_ACTIVE;
-
-    if (p_timer == pOsTimerHead)
+    // The timer thread does not need to be woken up, at worst it wakes up early and goes back to sleep
+    if (p_timer->flags & TIMER_ACTIVE)
     {
-        pOsTimerHead = pOsTimerHead->p_next;
-        LeaveCriticalSection(&cs);
-        SetEvent (sleepHandle);
-        return (0);
+        p_timer->flags &= ~TIMER_ACTIVE;
+        timer_wheel_remove(&timer_wheel, &p_timer->wheel);
+        timer_stats_stop(p_timer->p_cback);
     }
 
-    /* Find timer in the queue */
-    for (pt = pOsTimerHead; pt != NULL; pt = pt->p_next)
-        if (pt->p_next == p_timer)
-            break;
-
-    if (pt != NULL)
-        pt->p_next = p_timer->p_next;
-
     LeaveCriticalSection(&cs);
 
-    SetEvent (sleepHandle);
-
     return WICED_BT_SUCCESS;
 }
 
@@ -369,65 +441,155 @@ wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p)
 void wiced_release_timer(wiced_bt_mesh_event_t *p_event)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)&p_event->timer;
-    ods("!!!wiced_release_timer:%x\n", p_timer);
+    MESH_TRACE_DEBUG(MESH_TRACE_TIMER, "!!!wiced_release_timer:%x\n", p_timer);
     wiced_stop_timer((wiced_timer_t *)p_timer);
 }
 
+void mesh_timer_get_stats(mesh_timer_stats_t *p_stats, wiced_bool_t reset)
+{
+    UINT64 now;
+
+    EnterCriticalSection(&cs);
+
+    now = timer_get_tick_count();
+    *p_stats = timer_thread_stats;
+    p_stats->elapsed_ms = now - timer_thread_stats_time;
+
+    if (reset)
+    {
+        memset(&timer_thread_stats, 0, sizeof(timer_thread_stats));
+        timer_thread_stats_time = now;
+        timer_stats_reset();
+    }
+
+    LeaveCriticalSection(&cs);
+}
+
+int mesh_timer_get_site_stats(TIMER_STATS_REPORT *p_report, int max_reports)
+{
+    int count;
+
+    EnterCriticalSection(&cs);
+    count = timer_stats_query(p_report, max_reports);
+    LeaveCriticalSection(&cs);
+
+    return count;
+}
+
+void mesh_timer_callback_started(void *p_cback, uint64_t deadline_us)
+{
+    uint64_t now_us = clock_SystemTimeMicroseconds64();
+
+    EnterCriticalSection(&cs);
+    timer_stats_fired(p_cback, deadline_us, now_us);
+    LeaveCriticalSection(&cs);
+}
+
 static void timerThread(void *arg)
 {
-    UINT32          last_tc, cur_tc, sleep_time;
-    UINT64          cur_absTime;
+    UINT64          cur_tc, next_tc;
+    DWORD           sleep_time = 0;
     TIMER_LIST_ENT  *pTimer;
+    TIMER_CBACK     *p_cback[TIMER_DISPATCH_MAX];
+    TIMER_PARAM_TYPE cback_arg[TIMER_DISPATCH_MAX];
+    UINT64          deadline_us[TIMER_DISPATCH_MAX];
+    UINT32          count, i, fired = 0;
+    BOOL            timed_out = FALSE;  // this pass follows a sleep which ran to its end
+#if TIMER_STATS_DUMP_INTERVAL
+    static TIMER_STATS_REPORT report[TIMER_STATS_MAX_SITES + 1];
+    mesh_timer_stats_t thread_stats;
+    UINT64          dump_tc = timer_get_tick_count() + TIMER_STATS_DUMP_INTERVAL;
+    int             report_count;
+#endif
 
     SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
 
     for ( ; ; )
     {
-        last_tc = GetTickCount();
-        cur_absTime = absTimeHi + last_tc;
+        EnterCriticalSection(&cs);
 
-        if (pOsTimerHead != NULL)
-        {
-            if (pOsTimerHead->target_time < cur_absTime)
-                sleep_time = 0;
-            else
-                sleep_time = (UINT32)(pOsTimerHead->target_time - cur_absTime);
-        }
-        else
-            sleep_time = 60000;        // 1 minute is small enough to detect rollovers
+        timer_wakeup_time = 0;
+        cur_tc = timer_get_tick_count();
 
-        if (sleep_time != 0)
-            WaitForSingleObject (sleepHandle, sleep_time);
+        // Collect every timer that is due in one pass, the callbacks run back to back once cs is released
+        for (count = 0; count < TIMER_DISPATCH_MAX; count++)
+        {
+            pTimer = (TIMER_LIST_ENT *)timer_wheel_pop_expired(&timer_wheel, cur_tc);
+            if (pTimer == NULL)
+                break;
 
-        EnterCriticalSection(&cs);
+            pTimer->flags &= ~TIMER_ACTIVE;
+            deadline_us[count] = pTimer->wheel.target_time * 1000;
 
-        cur_tc = GetTickCount();
+            // Check for periodic timer, the rearm is not counted as a start
+            if ((pTimer->type == WICED_SECONDS_PERIODIC_TIMER) || (pTimer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER))
+                timer_arm(pTimer, pTimer->interval);
 
-        // Check for rollover - this assumes no timer is more than 49 days
-        if (cur_tc < last_tc)
-            absTimeHi += 0x100000000;
+            p_cback[count]   = pTimer->p_cback;
+            cback_arg[count] = pTimer->arg;
+        }
 
-        cur_absTime = absTimeHi + cur_tc;
+        if (timed_out && count == 0)
+            timer_thread_stats.idle_wakeups++;
+        timer_thread_stats.timers_fired += count;
+        fired += count;
 
-        // Check if the first timer on the list has expired
-        if ((pOsTimerHead != NULL) && (pOsTimerHead->target_time <= cur_absTime))
+        // A full batch means there may be more due timers, come back without sleeping
+        if (count == TIMER_DISPATCH_MAX)
         {
-            pTimer = pOsTimerHead;
-
-            // Check for periodic timer
-            if ((pTimer->type == WICED_SECONDS_PERIODIC_TIMER) || (pTimer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER))
-                wiced_start_timer ((wiced_timer_t *)pTimer, pTimer->interval);
+            sleep_time = 0;
+        }
+        else
+        {
+            next_tc = timer_wheel_next_event(&timer_wheel);
+            if (next_tc == TIMER_WHEEL_NEVER)
+                sleep_time = INFINITE;
+            else if (next_tc <= cur_tc)
+                sleep_time = 0;
+            else if (next_tc - cur_tc >= INFINITE)
+                sleep_time = INFINITE - 1;
             else
-                wiced_stop_timer ((wiced_timer_t *)pTimer);
+                sleep_time = (DWORD)(next_tc - cur_tc);
 
-            LeaveCriticalSection(&cs);
+            timer_wakeup_time = (next_tc == TIMER_WHEEL_NEVER) ? next_tc : cur_tc + sleep_time;
+        }
 
-            execute_timer_callback(pTimer->p_cback, pTimer->arg);
+        if (sleep_time != 0)
+        {
+            timer_thread_stats.wakeups++;
+            if (fired > timer_thread_stats.max_timers_per_wakeup)
+                timer_thread_stats.max_timers_per_wakeup = fired;
+            fired = 0;
         }
-        else
+
+#if TIMER_STATS_DUMP_INTERVAL
+        // Snapshot under cs, print after it is released
+        report_count = -1;
+        if (cur_tc >= dump_tc)
         {
-            LeaveCriticalSection(&cs);
+            dump_tc = cur_tc + TIMER_STATS_DUMP_INTERVAL;
+            thread_stats = timer_thread_stats;
+            thread_stats.elapsed_ms = cur_tc - timer_thread_stats_time;
+            report_count = timer_stats_query(report, TIMER_STATS_MAX_SITES + 1);
         }
+#endif
+
+        LeaveCriticalSection(&cs);
+
+        for (i = 0; i < count; i++)
+            execute_timer_callback(p_cback[i], cback_arg[i], deadline_us[i]);
+
+#if TIMER_STATS_DUMP_INTERVAL
+        if ((report_count >= 0) && MESH_TRACE_ENABLED(MESH_TRACE_TIMER, MESH_TRACE_LEVEL_INFO))
+        {
+            ods("timer thread: %u ms wakeups:%u idle:%u fired:%u max per wakeup:%u\n", (UINT32)thread_stats.elapsed_ms,
+                thread_stats.wakeups, thread_stats.idle_wakeups, thread_stats.timers_fired, thread_stats.max_timers_per_wakeup);
+            timer_stats_print(report, report_count, ods);
+        }
+#endif
+
+        // A wakeup for a new or stopped timer is expected to find nothing due, only a timeout is idle
+        timed_out = (sleep_time != 0) && (WaitForSingleObject(sleepHandle, sleep_time) == WAIT_TIMEOUT);
     }
 }
 
@@ -508,7 +670,7 @@ wiced_bool_t wiced_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr,
     wiced_bt_ble_conn_mode_t conn_mode,
     wiced_bool_t is_direct)
 {
-    ods("wiced_bt_gatt_le_connect\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "wiced_bt_gatt_le_connect\n");
     return mesh_bt_gatt_le_connect(bd_addr, bd_addr_type, conn_mode, is_direct);
 }
 
@@ -38,6 +38,9 @@
 #ifndef __MESH_MAIN_H__
 #define __MESH_MAIN_H__
 
+#include "wiced_timer.h"
+#include "timer_stats.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -49,6 +52,42 @@ void mesh_adv_scan_stop(void);
 wiced_bool_t mesh_adv_publish_start(void);
 void mesh_adv_publish_stop(void);
 
+/* Starts and stops the writer thread of the deferred log. Until it is started, ods and the
+ * ble_trace functions format and write each line on the calling thread. mesh_trace_init also
+ * applies the trace levels in the MESH_TRACE environment variable, see mesh_trace_configure.
+ * The levels can be changed later with mesh_trace_configure or mesh_trace_set_level. */
+void mesh_trace_init(void);
+void mesh_trace_deinit(void);
+
+/* Lets the timer expire up to slack_ms late so that it can share a wakeup of the timer thread with
+ * other timers due around the same time. 0 makes the timer exact, seconds timers default to 64 ms.
+ * The slack is kept until the timer is initialized again. */
+void wiced_set_timer_slack(wiced_timer_t *p_timer, uint32_t slack_ms);
+
+typedef struct
+{
+    uint64_t    elapsed_ms;             /* time covered by the counters */
+    uint32_t    wakeups;                /* times the timer thread went to sleep and woke up */
+    uint32_t    idle_wakeups;           /* sleeps which timed out and found no timer due */
+    uint32_t    timers_fired;           /* timers expired */
+    uint32_t    max_timers_per_wakeup;  /* most timers expired in one wakeup */
+} mesh_timer_stats_t;
+
+/* Copies the timer thread counters since start or the last reset. Wakeups per second is
+ * wakeups * 1000 / elapsed_ms and timers per wakeup is timers_fired / wakeups. The reset also
+ * clears the per callback statistics. */
+void mesh_timer_get_stats(mesh_timer_stats_t *p_stats, wiced_bool_t reset);
+
+/* Copies the start/stop counts and expiry lateness of up to max_reports timer callbacks, busiest
+ * first, and returns how many were copied. The same report is dumped with ods every
+ * TIMER_STATS_DUMP_INTERVAL ms. */
+int mesh_timer_get_site_stats(TIMER_STATS_REPORT *p_report, int max_reports);
+
+/* Called by the application right before it runs a callback passed to execute_timer_callback,
+ * on the thread that runs it. Records the expiry lateness, so it includes the hand-off from the
+ * timer thread. */
+void mesh_timer_callback_started(void *p_cback, uint64_t deadline_us);
+
 
 #ifdef __cplusplus
 }
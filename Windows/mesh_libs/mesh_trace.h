@@ -0,0 +1,123 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+/** @file
+ *
+ * Trace categories and levels of the platform glue.
+ *
+ * Each trace site names a category and a level. MESH_TRACE tests the level of the category in
+ * one shared word before any argument is evaluated, so a disabled site costs a load, a shift and
+ * a compare. Sites above MESH_TRACE_LEVEL_FLOOR are removed by the compiler, release builds keep
+ * errors and info only. The levels can be changed at any time with mesh_trace_configure, for
+ * example "all=info,timer=verbose".
+ */
+#ifndef __MESH_TRACE_H__
+#define __MESH_TRACE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Categories
+#define MESH_TRACE_TIMER            0
+#define MESH_TRACE_GATT             1
+#define MESH_TRACE_ADV              2
+#define MESH_TRACE_PROV             3
+#define MESH_TRACE_DFU              4
+#define MESH_TRACE_JNI              5
+#define MESH_TRACE_CRYPTO           6
+#define MESH_TRACE_CATEGORIES       7
+#define MESH_TRACE_ALL              (-1)
+
+// Levels, a site is written when its level is not above the level of its category
+#define MESH_TRACE_LEVEL_OFF        0
+#define MESH_TRACE_LEVEL_ERROR      1
+#define MESH_TRACE_LEVEL_INFO       2
+#define MESH_TRACE_LEVEL_DEBUG      3
+#define MESH_TRACE_LEVEL_VERBOSE    4
+
+// Highest level compiled in
+#ifndef MESH_TRACE_LEVEL_FLOOR
+#ifdef NDEBUG
+#define MESH_TRACE_LEVEL_FLOOR      MESH_TRACE_LEVEL_INFO
+#else
+#define MESH_TRACE_LEVEL_FLOOR      MESH_TRACE_LEVEL_VERBOSE
+#endif
+#endif
+
+// Level of every category at start
+#ifndef MESH_TRACE_DEFAULT_LEVEL
+#define MESH_TRACE_DEFAULT_LEVEL    MESH_TRACE_LEVEL_INFO
+#endif
+
+/* 4 bits per category. It is read without a lock, a stale value only shows or hides a line. */
+extern volatile uint32_t mesh_trace_levels;
+
+void ods(char *fmt_str, ...);
+
+#define MESH_TRACE_ENABLED(cat, level) \
+    (((level) <= MESH_TRACE_LEVEL_FLOOR) && ((int)((mesh_trace_levels >> ((cat) * 4)) & 0xF) >= (level)))
+
+#define MESH_TRACE(cat, level, ...) \
+    do { if (MESH_TRACE_ENABLED(cat, level)) ods(__VA_ARGS__); } while (0)
+
+#define MESH_TRACE_ERROR(cat, ...)      MESH_TRACE(cat, MESH_TRACE_LEVEL_ERROR, __VA_ARGS__)
+#define MESH_TRACE_INFO(cat, ...)       MESH_TRACE(cat, MESH_TRACE_LEVEL_INFO, __VA_ARGS__)
+#define MESH_TRACE_DEBUG(cat, ...)      MESH_TRACE(cat, MESH_TRACE_LEVEL_DEBUG, __VA_ARGS__)
+#define MESH_TRACE_VERBOSE(cat, ...)    MESH_TRACE(cat, MESH_TRACE_LEVEL_VERBOSE, __VA_ARGS__)
+
+/* category may be MESH_TRACE_ALL. Returns 0, or -1 for an unknown category or level. */
+int  mesh_trace_set_level(int category, int level);
+int  mesh_trace_get_level(int category);
+
+/* Applies a list of category=level items separated by commas or spaces, "all" names every
+ * category and a level alone applies to all of them. Levels are off, error, info, debug, verbose
+ * or 0 to 4. Nothing is changed and -1 is returned if an item is not valid. */
+int  mesh_trace_configure(const char *p_spec);
+
+/* Writes the current levels in the form accepted by mesh_trace_configure, returns the length */
+int  mesh_trace_describe(char *p_buf, int len);
+
+const char *mesh_trace_category_name(int category);
+const char *mesh_trace_level_name(int level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__MESH_TRACE_H__
@@ -45,6 +45,20 @@
 #include "p_256_multprecision.h"
 #include "p_256_ecc_pp.h"
 
+// p_256_multprecision.h comes from the SDK include path on Windows, so the
+// declarations added in the Android and iOS copies are given here
+void MP_Squa(DWORD *c, DWORD *a, uint32_t keyLength);
+void MP_InvMod_Euclid(DWORD *aminus, DWORD *u, uint32_t keyLength);
+void MP_InvMod_P256(DWORD *aminus, DWORD *a);
+void MP_InvModBatch(DWORD *aminus[], DWORD *a[], uint32_t count, uint32_t keyLength);
+
+// On 64-bit targets with a 128-bit product type the P-256 multiplication
+// and reduction work on 4 x 64-bit limbs; 32-bit targets (armeabi-v7a)
+// use the DWORD code. Define P256_NO_LIMB64 to force the DWORD code.
+#if defined(__SIZEOF_INT128__) && (defined(__x86_64__) || defined(__aarch64__)) && !defined(P256_NO_LIMB64)
+#define P256_LIMB64
+#endif
+
 void MP_Init(DWORD *c, uint32_t keyLength)
 {
     uint32_t i;
@@ -197,11 +211,146 @@ void MP_RShift(DWORD * c, DWORD * a, uint32_t keyLength)
     }
 }
 
+#ifdef P256_LIMB64
+
+typedef unsigned __int128 UINT128;
+
+static void P256_Load64(UINT64 *r, DWORD *a)
+{
+    int i;
+
+    for(i=0; i<4; i++)
+        r[i] = (UINT64)a[2*i] | ((UINT64)a[2*i+1] << 32);
+}
+
+// t=a*b, 4 x 64-bit limbs in, 8 out; each product is formed once
+static void P256_Mult64(UINT64 *t, UINT64 *a, UINT64 *b)
+{
+    UINT128 acc;
+    UINT64 carrier;
+    int i, j;
+
+    for(i=0; i<4; i++)
+        t[i] = 0;
+
+    for(i=0; i<4; i++)
+    {
+        carrier = 0;
+        for(j=0; j<4; j++)
+        {
+            acc = (UINT128)a[i] * b[j] + t[i+j] + carrier;
+            t[i+j] = (UINT64)acc;
+            carrier = (UINT64)(acc >> 64);
+        }
+        t[i+4] = carrier;
+    }
+}
+
+// t=a^2; the cross products are formed once and doubled
+static void P256_Squa64(UINT64 *t, UINT64 *a)
+{
+    UINT128 acc;
+    UINT64 carrier;
+    int i, j;
+
+    for(i=0; i<8; i++)
+        t[i] = 0;
+
+    for(i=0; i<3; i++)
+    {
+        carrier = 0;
+        for(j=i+1; j<4; j++)
+        {
+            acc = (UINT128)a[i] * a[j] + t[i+j] + carrier;
+            t[i+j] = (UINT64)acc;
+            carrier = (UINT64)(acc >> 64);
+        }
+        t[i+4] = carrier;
+    }
+
+    t[7] = t[6] >> 63;
+    for(i=6; i>0; i--)
+        t[i] = (t[i] << 1) | (t[i-1] >> 63);
+    t[0] <<= 1;
+
+    carrier = 0;
+    for(i=0; i<4; i++)
+    {
+        acc = (UINT128)a[i] * a[i] + t[2*i] + carrier;
+        t[2*i] = (UINT64)acc;
+        acc = (UINT128)t[2*i+1] + (UINT64)(acc >> 64);
+        t[2*i+1] = (UINT64)acc;
+        carrier = (UINT64)(acc >> 64);
+    }
+}
+
+// c=t mod p256 by Solinas reduction (FIPS 186-4 D.2.3). The terms are
+// 32-bit words of t, so each column of c is summed with its signs in a
+// 64-bit accumulator and the carries are propagated once at the end.
+static void P256_FastMod64(DWORD *c, UINT64 *t)
+{
+    int64_t w[16], acc[8], carrier;
+    int i;
+
+    for(i=0; i<8; i++)
+    {
+        w[2*i] = (uint32_t)t[i];
+        w[2*i+1] = t[i] >> 32;
+    }
+
+    // c = s1 + 2*s2 + 2*s3 + s4 + s5 - s6 - s7 - s8 - s9, column by column
+    acc[0] = w[0]                                  + w[8]  + w[9]  - w[11] - w[12] - w[13] - w[14];
+    acc[1] = w[1]                                  + w[9]  + w[10] - w[12] - w[13] - w[14] - w[15];
+    acc[2] = w[2]                                  + w[10] + w[11] - w[13] - w[14] - w[15];
+    acc[3] = w[3] + 2*w[11]          + 2*w[12]             + w[13] - w[15] - w[8]  - w[9];
+    acc[4] = w[4] + 2*w[12]          + 2*w[13]             + w[14]         - w[9]  - w[10];
+    acc[5] = w[5] + 2*w[13]          + 2*w[14]             + w[15]         - w[10] - w[11];
+    acc[6] = w[6] + 2*w[14]          + 2*w[15]   + w[14]   + w[13] - w[8]  - w[9];
+    acc[7] = w[7] + 2*w[15]                      + w[15]   + w[8]  - w[10] - w[11] - w[12] - w[13];
+
+    // fold the carry out of bit 256 back in, 2^256 = 2^224 - 2^192 - 2^96 + 1 mod p
+    do
+    {
+        carrier = 0;
+        for(i=0; i<8; i++)
+        {
+            acc[i] += carrier;
+            carrier = acc[i] >> 32;
+            acc[i] &= 0xFFFFFFFF;
+        }
+        acc[0] += carrier;
+        acc[3] -= carrier;
+        acc[6] -= carrier;
+        acc[7] += carrier;
+    } while(carrier);
+
+    for(i=0; i<8; i++)
+        c[i] = (DWORD)acc[i];
+
+    if(MP_CMP(c, curve_p256.p, KEY_LENGTH_DWORDS_P256)>=0)
+        MP_Sub(c, c, curve_p256.p, KEY_LENGTH_DWORDS_P256);
+}
+
+#endif
+
 // Curve specific optimization when p is a pseudo-Mersenns prime, p=2^(KEY_LENGTH_BITS)-omega
 void MP_MersennsMultMod(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength)
 {
     DWORD cc[2*KEY_LENGTH_DWORDS_P256];
 
+#ifdef P256_LIMB64
+    if(keyLength == KEY_LENGTH_DWORDS_P256)
+    {
+        UINT64 a64[4], b64[4], t[8];
+
+        P256_Load64(a64, a);
+        P256_Load64(b64, b);
+        P256_Mult64(t, a64, b64);
+        P256_FastMod64(c, t);
+        return;
+    }
+#endif
+
     MP_Mult(cc, a, b, keyLength);
 
     if(keyLength == 6)
@@ -215,7 +364,26 @@ void MP_MersennsMultMod(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength)
 // Curve specific optimization when p is a pseudo-Mersenns prime
 void MP_MersennsSquaMod(DWORD *c, DWORD *a, uint32_t keyLength)
 {
-    MP_MersennsMultMod(c, a, a, keyLength);
+    DWORD cc[2*KEY_LENGTH_DWORDS_P256];
+
+#ifdef P256_LIMB64
+    if(keyLength == KEY_LENGTH_DWORDS_P256)
+    {
+        UINT64 a64[4], t[8];
+
+        P256_Load64(a64, a);
+        P256_Squa64(t, a64);
+        P256_FastMod64(c, t);
+        return;
+    }
+#endif
+
+    MP_Squa(cc, a, keyLength);
+
+    if(keyLength == 6)
+        MP_FastMod(c, cc);
+    else if(keyLength == 8)
+        MP_FastMod_P256(c, cc);
 }
 
 // c=(a+b) mod p, b<p, a<p
@@ -318,6 +486,43 @@ void MP_Mult(DWORD *c, DWORD *a, DWORD *b, uint32_t keyLength)
     }
 }
 
+// c=a^2; c must have a buffer of 2*Key_LENGTH_DWORDS, c != a. The cross
+// products are formed once and doubled
+void MP_Squa(DWORD *c, DWORD *a, uint32_t keyLength)
+{
+    uint32_t i, j;
+    UINT64 acc;
+    DWORD U;
+
+    MP_Init(c, 2*keyLength);
+
+    for(i=0; i<keyLength-1; i++)
+    {
+        U = 0;
+        for(j=i+1; j<keyLength; j++)
+        {
+            acc = ((UINT64)a[i]) * ((UINT64)a[j]) + c[i+j] + U;
+            c[i+j] = (DWORD)acc;
+            U = (DWORD)(acc >> 32);
+        }
+        c[i+keyLength] = U;
+    }
+
+    c[2*keyLength-1] = c[2*keyLength-2] >> 31;
+    for(i=2*keyLength-2; i>0; i--)
+        c[i] = (c[i] << 1) | (c[i-1] >> 31);
+    c[0] <<= 1;
+
+    U = 0;
+    for(i=0; i<keyLength; i++)
+    {
+        acc = ((UINT64)a[i]) * ((UINT64)a[i]) + c[2*i] + U;
+        c[2*i] = (DWORD)acc;
+        acc = (UINT64)c[2*i+1] + (DWORD)(acc >> 32);
+        c[2*i+1] = (DWORD)acc;
+        U = (DWORD)(acc >> 32);
+    }
+}
 
 void MP_FastMod(DWORD *c, DWORD *a)
 {
@@ -452,7 +657,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[1] < UU);
+        U = 0 - (DWORD)(a[1] < UU);
         c[1] = a[1] - UU;
     }
     else
@@ -472,7 +677,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[2] < UU);
+        U = 0 - (DWORD)(a[2] < UU);
         c[2] = a[2] - UU;
     }
     else
@@ -492,7 +697,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[3] < UU);
+        U = 0 - (DWORD)(a[3] < UU);
         c[3] = a[3] - UU;
     }
     else
@@ -520,7 +725,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[4] < UU);
+        U = 0 - (DWORD)(a[4] < UU);
         c[4] = a[4] - UU;
     }
     else
@@ -546,7 +751,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[5] < UU);
+        U = 0 - (DWORD)(a[5] < UU);
         c[5] = a[5] - UU;
     }
     else
@@ -570,7 +775,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[6] < UU);
+        U = 0 - (DWORD)(a[6] < UU);
         c[6] = a[6] - UU;
     }
     else
@@ -596,7 +801,7 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
     {
         DWORD UU;
         UU = 0 - U;
-        U = (a[7] < UU);
+        U = 0 - (DWORD)(a[7] < UU);
         c[7] = a[7] - UU;
     }
     else
@@ -639,7 +844,23 @@ void MP_FastMod_P256(DWORD *c, DWORD *a)
 
 }
 
+// aminus=1/u mod p. With 64-bit limbs the P-256 Fermat chain is faster than
+// the binary extended Euclid; with DWORD limbs the Euclid is about twice as
+// fast. u may be destroyed.
 void MP_InvMod(DWORD *aminus, DWORD *u, uint32_t keyLength)
+{
+#ifdef P256_LIMB64
+    if(keyLength == KEY_LENGTH_DWORDS_P256)
+    {
+        MP_InvMod_P256(aminus, u);
+        return;
+    }
+#endif
+    MP_InvMod_Euclid(aminus, u, keyLength);
+}
+
+// binary extended Euclid, u is destroyed
+void MP_InvMod_Euclid(DWORD *aminus, DWORD *u, uint32_t keyLength)
 {
     DWORD v[KEY_LENGTH_DWORDS_P256];
     DWORD A[KEY_LENGTH_DWORDS_P256+1], C[KEY_LENGTH_DWORDS_P256+1];
@@ -705,4 +926,209 @@ void MP_InvMod(DWORD *aminus, DWORD *u, uint32_t keyLength)
         MP_Copy(aminus, C, keyLength);
 }
 
+// Field elements for the inversion chain. With 64-bit limbs they are kept in
+// Montgomery form, aR mod p with R=2^256: -1/p mod 2^64 is 1 for P-256, so
+// each reduction step is a multiply by the sparse p and a shift, cheaper
+// than converting to and from the Solinas reduction for every squaring.
+#ifdef P256_LIMB64
+
+typedef UINT64 P256_FE[4];
+
+static const UINT64 p256_p64[4] =
+    { 0xFFFFFFFFFFFFFFFFULL, 0x00000000FFFFFFFFULL, 0, 0xFFFFFFFF00000001ULL };
+static const UINT64 p256_rr64[4] =                  // R^2 mod p
+    { 0x0000000000000003ULL, 0xFFFFFFFBFFFFFFFFULL, 0xFFFFFFFFFFFFFFFEULL, 0x00000004FFFFFFFDULL };
+
+// c=a*b/R mod p, operand scanning with the reduction interleaved
+static void P256_FeMul(UINT64 *c, const UINT64 *a, const UINT64 *b)
+{
+    UINT64 t[6], carrier, m, borrow;
+    UINT128 acc;
+    int i, j;
+
+    for(i=0; i<6; i++)
+        t[i] = 0;
+
+    for(i=0; i<4; i++)
+    {
+        carrier = 0;
+        for(j=0; j<4; j++)
+        {
+            acc = (UINT128)a[j] * b[i] + t[j] + carrier;
+            t[j] = (UINT64)acc;
+            carrier = (UINT64)(acc >> 64);
+        }
+        acc = (UINT128)t[4] + carrier;
+        t[4] = (UINT64)acc;
+        t[5] = (UINT64)(acc >> 64);
+
+        // t=(t+m*p)/2^64 with m=t[0]; (p+1)/2^64 = p[3]*2^128 + 2^32
+        m = t[0];
+        acc = (UINT128)t[1] + (m << 32);
+        t[0] = (UINT64)acc;
+        acc = (UINT128)t[2] + (m >> 32) + (UINT64)(acc >> 64);
+        t[1] = (UINT64)acc;
+        acc = (UINT128)m * p256_p64[3] + t[3] + (UINT64)(acc >> 64);
+        t[2] = (UINT64)acc;
+        acc = (UINT128)t[4] + (UINT64)(acc >> 64);
+        t[3] = (UINT64)acc;
+        t[4] = t[5] + (UINT64)(acc >> 64);
+    }
+
+    // t < 2p, subtract p once if needed
+    borrow = 0;
+    for(i=0; i<4; i++)
+    {
+        acc = (UINT128)t[i] - p256_p64[i] - borrow;
+        c[i] = (UINT64)acc;
+        borrow = (UINT64)(acc >> 64) & 1;
+    }
+    if(t[4] < borrow)
+        for(i=0; i<4; i++)
+            c[i] = t[i];
+}
+
+static void P256_FeSqr(UINT64 *c, const UINT64 *a, int n)
+{
+    P256_FeMul(c, a, a);
+    while(--n)
+        P256_FeMul(c, c, c);
+}
+
+static void P256_FeIn(UINT64 *c, DWORD *a)
+{
+    UINT64 a64[4];
+
+    P256_Load64(a64, a);
+    P256_FeMul(c, a64, p256_rr64);
+}
+
+static void P256_FeOut(DWORD *c, const UINT64 *a)
+{
+    static const UINT64 one[4] = { 1, 0, 0, 0 };
+    UINT64 r[4];
+    int i;
+
+    P256_FeMul(r, a, one);
+    for(i=0; i<4; i++)
+    {
+        c[2*i] = (DWORD)r[i];
+        c[2*i+1] = (DWORD)(r[i] >> 32);
+    }
+}
+
+#else
+
+typedef DWORD P256_FE[KEY_LENGTH_DWORDS_P256];
+
+static void P256_FeMul(DWORD *c, DWORD *a, DWORD *b)
+{
+    MP_MersennsMultMod(c, a, b, KEY_LENGTH_DWORDS_P256);
+}
+
+static void P256_FeSqr(DWORD *c, DWORD *a, int n)
+{
+    MP_MersennsSquaMod(c, a, KEY_LENGTH_DWORDS_P256);
+    while(--n)
+        MP_MersennsSquaMod(c, c, KEY_LENGTH_DWORDS_P256);
+}
+
+static void P256_FeIn(DWORD *c, DWORD *a)
+{
+    MP_Copy(c, a, KEY_LENGTH_DWORDS_P256);
+}
+
+static void P256_FeOut(DWORD *c, DWORD *a)
+{
+    MP_Copy(c, a, KEY_LENGTH_DWORDS_P256);
+}
+
+#endif
+
+// aminus=a^(p-2) mod p256 (Fermat), 255 squarings and 12 multiplications.
+// p-2 = ffffffff 00000001 00000000 00000000 00000000 ffffffff ffffffff fffffffd,
+// built from xk=a^(2^k-1). a is left unchanged, aminus may be a; 0 gives 0.
+void MP_InvMod_P256(DWORD *aminus, DWORD *a)
+{
+    P256_FE x1, x2, x3, x6, x12, x15, x30, x32, t;
+
+    P256_FeIn(x1, a);
+
+    P256_FeSqr(t, x1, 1);
+    P256_FeMul(x2, t, x1);
+    P256_FeSqr(t, x2, 1);
+    P256_FeMul(x3, t, x1);
+    P256_FeSqr(t, x3, 3);
+    P256_FeMul(x6, t, x3);
+    P256_FeSqr(t, x6, 6);
+    P256_FeMul(x12, t, x6);
+    P256_FeSqr(t, x12, 3);
+    P256_FeMul(x15, t, x3);
+    P256_FeSqr(t, x15, 15);
+    P256_FeMul(x30, t, x15);
+    P256_FeSqr(t, x30, 2);
+    P256_FeMul(x32, t, x2);
+
+    P256_FeSqr(t, x32, 32);             // ffffffff 00000000
+    P256_FeMul(t, t, x1);               // ffffffff 00000001
+    P256_FeSqr(t, t, 128);
+    P256_FeMul(t, t, x32);              // ... 00000000 ffffffff
+    P256_FeSqr(t, t, 32);
+    P256_FeMul(t, t, x32);              // ... ffffffff ffffffff
+    P256_FeSqr(t, t, 30);
+    P256_FeMul(t, t, x30);              // ... 3fffffff
+    P256_FeSqr(t, t, 2);
+    P256_FeMul(t, t, x1);               // ... fffffffd
+
+    P256_FeOut(aminus, t);
+}
+
+// aminus[i]=1/a[i] for count values with one inversion (Montgomery's trick):
+// the running products a[0]..a[i] are kept in aminus, the product of all of
+// them is inverted and the inverse is peeled back one value at a time.
+// aminus[i] and a[j] must not overlap; zero values give zero.
+void MP_InvModBatch(DWORD *aminus[], DWORD *a[], uint32_t count, uint32_t keyLength)
+{
+    DWORD inv[KEY_LENGTH_DWORDS_P256], t[KEY_LENGTH_DWORDS_P256];
+    DWORD *prev = NULL;
+    int i, j;
+
+    for(i=0; i<(int)count; i++)
+    {
+        if(MP_isZero(a[i], keyLength))
+        {
+            MP_Init(aminus[i], keyLength);
+            continue;
+        }
+        if(prev)
+            MP_MersennsMultMod(aminus[i], prev, a[i], keyLength);
+        else
+            MP_Copy(aminus[i], a[i], keyLength);
+        prev = aminus[i];
+    }
+    if(!prev)
+        return;
+
+    MP_Copy(t, prev, keyLength);
+    MP_InvMod(inv, t, keyLength);
+
+    for(i=count-1; i>=0; i--)
+    {
+        if(MP_isZero(a[i], keyLength))
+            continue;
+
+        for(j=i-1; j>=0 && MP_isZero(a[j], keyLength); j--)
+            ;
+        if(j < 0)
+        {
+            MP_Copy(aminus[i], inv, keyLength);
+            break;
+        }
+        MP_MersennsMultMod(t, inv, aminus[j], keyLength);      // 1/a[i]
+        MP_MersennsMultMod(inv, inv, a[i], keyLength);         // 1/(a[0]..a[j])
+        MP_Copy(aminus[i], t, keyLength);
+        i = j + 1;
+    }
+}
+
 #endif
@@ -78,12 +78,6 @@ NS_ASSUME_NONNULL_BEGIN
 /* @param delegate  pointer to the instance that implemented the IMeshNativeCallback protocol */
 -(void) registerNativeCallback:(id) delegate;
 
-#ifdef DEBUG    // for test purpose only, aimed to test system timer implementation.
--(uint32_t) meshStartTimer:(uint32_t)timeout type:(uint16_t)type;
--(void) meshStopTimer:(uint32_t)timerId;
--(uint32_t) meshRestartTimer:(uint32_t)timeout timerId:(uint32_t)timerId;
-#endif
-
 +(NSString *) getProvisionerUuidFileName;
 +(int) setFileStorageAtPath:(NSString *)path;
 +(int) setFileStorageAtPath:(NSString *)path provisionerUuid: (NSUUID * __nullable)provisionerUuid;
@@ -284,6 +278,9 @@ NS_ASSUME_NONNULL_BEGIN
 +(Boolean) isMeshClientProvisionKeyRefreshing;
 +(void) meshClientLog:(NSString *)message;
 +(void) meshClientLogInit:(Boolean) is_console_enabled;
++(void) meshClientSetLogFileMaxSize:(uint32_t)maxSize generations:(uint32_t)generations compress:(Boolean)compress;
++(int) meshClientSetTraceLevels:(NSString *)spec;
++(NSString *) meshClientGetTraceLevels;
 +(NSString * __nullable) meshClientGetNetworkName;
 @end
 
@@ -13,6 +13,7 @@
 #import "MeshNativeHelper.h"
 #import "IMeshNativeCallback.h"
 #import "mesh_main.h"
+#import "mesh_trace.h"
 #import "wiced_timer.h"
 #import "wiced_bt_ble.h"
 #import "wiced_bt_mesh_model_defs.h"
@@ -267,154 +268,6 @@ mesh_client_init_t mesh_client_init_callback = {
     .vendor_specific_data_callback = meshClientVendorSpecificDataCb,
 };
 
-// timer based iOS platform.
-static uint32_t gMeshTimerId = 1;       // always > 0; 1 is the first and the app whole life second pediodic timer; other values can be reused.
-static NSMutableDictionary *gMeshTimersDict = nil;
-
--(void) meshTimerInit
-{
-    if (gMeshTimersDict == nil) {
-        EnterCriticalSection();
-        if (gMeshTimersDict == nil) {
-            gMeshTimersDict = [[NSMutableDictionary alloc] initWithCapacity:5];
-        }
-        LeaveCriticalSection();
-    }
-}
-
--(uint32_t) allocateMeshTimerId
-{
-    uint32_t timerId = 0;   // default set to invalid timerId
-    EnterCriticalSection();
-    do {
-        timerId = gMeshTimerId++;
-        if (timerId == 0) { // the gMeshTimerid must be round back.
-            continue;
-        }
-        // avoid the same timerId was used, because some timer running for long time or  presistent.
-        if ([gMeshTimersDict valueForKey:[NSString stringWithFormat:@"%u", timerId]] == nil) {
-            break;  // return new not used timerId.
-        }
-    } while (true);
-    LeaveCriticalSection();
-    return timerId;
-}
-
--(void) timerFiredMethod:(NSTimer *)timer
-{
-    NSString * timerKey = timer.userInfo;
-    uint32_t timerId = 0;
-    if (timerKey != nil) {
-        timerId = (uint32_t)timerKey.longLongValue;
-    }
-
-    //WICED_BT_TRACE("[MeshNativeHelper timerFiredMethod] timerId:%u\n", timerId);
-    MeshTimerFunc((long)timerId);
-}
-
-/*
- * @param timeout   Timer trigger interval, uint: milliseconds.
- * @param type      The timer type.
- *                  When the timer type is WICED_SECONDS_TIMER or WICED_MILLI_SECONDS_TIMER,
- *                      the timer will be invalidated after it fires.
- *                  When the timer type is WICED_SECONDS_PERIODIC_TIMER or WICED_MILLI_SECONDS_PERIODIC_TIMER,
- *                      the timer will repeatedly reschedule itself until stopped.
- * @return          A non-zero timerId will be returned when started on success. Otherwize, 0 will be return on failure.
- */
--(uint32_t) meshStartTimer:(uint32_t)timeout type:(uint16_t)type
-{
-    [MeshNativeHelper.getSharedInstance meshTimerInit];
-    uint32_t timerId = [MeshNativeHelper.getSharedInstance allocateMeshTimerId];
-    Boolean repeats = (type == WICED_SECONDS_PERIODIC_TIMER || type == WICED_MILLI_SECONDS_PERIODIC_TIMER) ? true : false;
-    NSTimeInterval interval = (NSTimeInterval)timeout;
-    interval /= (NSTimeInterval)1000;
-    NSString * timerKey = [NSString stringWithFormat:@"%u", timerId];
-    NSTimer *timer = [NSTimer scheduledTimerWithTimeInterval:interval
-                                                      target:MeshNativeHelper.getSharedInstance
-                                                    selector:@selector(timerFiredMethod:)
-                                                    userInfo:timerKey
-                                                     repeats:repeats];
-    if (timer == nil) {
-        WICED_BT_TRACE("[MeshNativeHelper meshStartTimer] error: failed to create and init the timer\n");
-        return 0;
-    }
-
-    NSArray *timerInfo = [[NSArray alloc] initWithObjects:[NSNumber numberWithUnsignedInt:timerId], [NSNumber numberWithUnsignedShort:type], timer, nil];
-    [gMeshTimersDict setObject:timerInfo forKey:timerKey];
-    //WICED_BT_TRACE("[MeshNativeHelper meshStartTimer] timerId:%u started, type=%u, interval=%f\n", timerId, type, interval);
-    return timerId;
-}
-uint32_t start_timer(uint32_t timeout, uint16_t type) {
-    return [MeshNativeHelper.getSharedInstance meshStartTimer:timeout type:type];
-}
-
--(void) meshStopTimer:(uint32_t)timerId
-{
-    [MeshNativeHelper.getSharedInstance meshTimerInit];
-    NSString *timerKey = [NSString stringWithFormat:@"%u", timerId];
-    NSArray *timerInfo = [gMeshTimersDict valueForKey:timerKey];
-    if (timerInfo != nil && [timerInfo count] == 3) {
-        NSTimer *timer = timerInfo[2];
-        if (timer != nil) {
-            [timer invalidate];
-        }
-    }
-    [gMeshTimersDict removeObjectForKey:timerKey];
-    //WICED_BT_TRACE("[MeshNativeHelper meshStopTimer] timerId:%u stopped\n", timerId);
-}
-void stop_timer(uint32_t timerId)
-{
-    [MeshNativeHelper.getSharedInstance meshStopTimer:timerId];
-}
-
-/*
- * @param timeout   Timer trigger interval, uint: milliseconds.
- * @param type      The timer type.
- *                  When the timer type is WICED_SECONDS_TIMER or WICED_MILLI_SECONDS_TIMER,
- *                      the timer will be invalidated after it fires.
- *                  When the timer type is WICED_SECONDS_PERIODIC_TIMER or WICED_MILLI_SECONDS_PERIODIC_TIMER,
- *                      the timer will repeatedly reschedule itself until stopped.
- * @return          The same non-zero timerId will be returned when restarted on success. Otherwize, 0 will be return on failure.
- */
--(uint32_t) meshRestartTimer:(uint32_t)timeout timerId:(uint32_t)timerId
-{
-    [MeshNativeHelper.getSharedInstance meshTimerInit];
-    NSString *timerKey = [NSString stringWithFormat:@"%u", timerId];
-    NSArray *timerInfo = [gMeshTimersDict valueForKey:timerKey];
-    NSNumber *numType = timerInfo[1];
-    NSTimer *timer = timerInfo[2];
-    uint16_t type;
-
-    if (timerInfo == nil || [timerInfo count] != 3 || timer == nil || numType == nil) {
-        WICED_BT_TRACE("[MeshNativeHelper meshRestartTimer] error: failed to fetch the timer with timerId=%u\n", timerId);
-        return 0;
-    }
-
-    type = [numType unsignedShortValue];
-    [timer invalidate];
-
-    Boolean repeats = (type == WICED_SECONDS_PERIODIC_TIMER || type == WICED_MILLI_SECONDS_PERIODIC_TIMER) ? true : false;
-    NSTimeInterval interval = (NSTimeInterval)timeout;
-    interval /= (NSTimeInterval)1000;
-    timer = [NSTimer scheduledTimerWithTimeInterval:interval
-                                             target:MeshNativeHelper.getSharedInstance
-                                           selector:@selector(timerFiredMethod:)
-                                           userInfo:timerKey
-                                            repeats:repeats];
-    if (timer == nil) {
-        WICED_BT_TRACE("[MeshNativeHelper meshRestartTimer] error: failed to create and init the timer\n");
-        return 0;
-    }
-
-    timerInfo = [[NSArray alloc] initWithObjects:[NSNumber numberWithUnsignedInt:timerId], [NSNumber numberWithUnsignedShort:type], timer, nil];
-    [gMeshTimersDict setObject:timerInfo forKey:timerKey];
-    //WICED_BT_TRACE("[MeshNativeHelper meshRestartTimer] timerId:%u, type=%u, interval=%f\n", timerId, type, interval);
-    return timerId;
-}
-uint32_t restart_timer(uint32_t timeout, uint32_t timerId ) {
-    return [MeshNativeHelper.getSharedInstance meshRestartTimer:timeout timerId:timerId];
-}
-
 void mesh_provision_gatt_send(uint16_t connId, uint8_t *packet, uint32_t packet_len)
 {
     WICED_BT_TRACE("[MeshNativeHelper mesh_provision_gatt_send] connId=%d, packet_len=%d\n", connId, packet_len);
@@ -503,7 +356,6 @@ void mesh_adv_scan_stop(void)
 /* Do all necessory initializations for the shared class instance. */
 -(void) instanceInit
 {
-    [self meshTimerInit];
     [self meshBdAddrDictInit];
 #ifdef MESH_DFU_ENABLED
     mesh_dfu_metadata_init();
@@ -1480,17 +1332,6 @@ static NSMutableDictionary *gMeshBdAddrDict = nil;
     zoneOnceToken = 0;
     [gMeshBdAddrDict removeAllObjects];
     gMeshBdAddrDict = nil;
-    for (NSString *key in [gMeshTimersDict allKeys]) {
-        NSArray *timerInfo = [gMeshTimersDict valueForKey:key];
-        if (timerInfo != nil && [timerInfo count] == 3) {
-            NSTimer *timer = timerInfo[2];
-            if (timer != nil) {
-                [timer invalidate];
-            }
-        }
-    }
-    [gMeshTimersDict removeAllObjects];
-    gMeshTimersDict = nil;
     strcpy(provisioner_uuid, "");
     _instance = nil;
 }
@@ -2373,6 +2214,27 @@ void mesh_native_helper_read_file_chunk(const char *p_path, uint8_t *p_data, uin
     mesh_trace_log_init(is_console_enabled ? TRUE : FALSE);
 }
 
++(void) meshClientSetLogFileMaxSize:(uint32_t)maxSize generations:(uint32_t)generations compress:(Boolean)compress
+{
+    set_log_file_max_size(maxSize);
+    set_log_file_generations(generations);
+    set_log_file_compress(compress ? TRUE : FALSE);
+}
+
+/* spec is a list of category=level items, for example @"all=info,timer=verbose", see mesh_trace.h */
++(int) meshClientSetTraceLevels:(NSString *)spec
+{
+    return mesh_trace_configure(spec.UTF8String);
+}
+
++(NSString *) meshClientGetTraceLevels
+{
+    char buf[128];
+
+    mesh_trace_describe(buf, sizeof(buf));
+    return [[NSString alloc] initWithUTF8String:buf];
+}
+
 +(void) meshClientLog:(NSString *)message
 {
     if (message == nil || message.length == 0) {
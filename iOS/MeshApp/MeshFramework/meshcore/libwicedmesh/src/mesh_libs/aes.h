@@ -97,6 +97,21 @@ extern "C"
         unsigned char out[N_BLOCK],
         const aes_context ctx[1]);
 
+    /*  Encrypt n independent blocks in place, blk[i] with the key schedule
+        ctx[i]; the blocks are interleaved through the cipher when that is
+        faster than encrypting them one at a time
+        */
+
+    return_type aes_encrypt_n(unsigned char *blk[],
+        const aes_context *ctx[],
+        int n);
+
+    /*  Encrypt two independent blocks in place with one key schedule */
+
+    return_type aes_encrypt_pair(unsigned char b0[N_BLOCK],
+        unsigned char b1[N_BLOCK],
+        const aes_context ctx[1]);
+
     return_type aes_cbc_encrypt(const unsigned char *in,
         unsigned char *out,
         int n_block,
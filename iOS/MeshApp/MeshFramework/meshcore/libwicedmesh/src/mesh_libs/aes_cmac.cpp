@@ -66,6 +66,8 @@ static  unsigned char const_Zero[16] = {
   };
 #endif
 
+#include <string.h>
+
 #ifndef UINT8
 typedef unsigned  char UINT8;
 
@@ -73,50 +75,7 @@ typedef unsigned  char UINT8;
 
   /* Basic Functions */
 
-#if 0
-void AES_128(unsigned char *key, unsigned char *text, unsigned char *outText  )
-{
-    aes_encrypt_128( text, outText, key,key);
-}
-#else
-static void AES_128(unsigned char *key, unsigned char *text, unsigned char *outText  )
-{
-    UINT8 k[16];
-    UINT8 t[16];
-    int i;
-
-    for(i=0; i< 16;i++)
-    {
-#if 0
-        // fill the key and text backward. The aes encrypt uses big endian.
-        t[15-i] = text[i];
-        k[15-i] = key[i];
-#else
-        t[i] = text[i];
-        k[i] = key[i];
-#endif
-    }
-
-
-    // software AES. This function is big endian.
-    aes_encrypt_128( t, outText, k,k);
-
-#if 0
-    // swap the output also.
-    for(i=0; i< 16/2;i++)
-    {
-        int tmp = outText[i];
-        // fill the key and text backward. The aes encrypt uses big endian.
-        outText[i] = outText[15-i];
-        outText[15-i] = tmp;
-    }
-#endif
-}
-#endif
-
-
-
-static  void xor_128(unsigned char *a, unsigned char *b, unsigned char *out)
+static  void xor_128(const unsigned char *a, const unsigned char *b, unsigned char *out)
 {
     int i;
     for (i=0;i<16; i++)
@@ -173,7 +132,7 @@ static  void leftshift_onebit(unsigned char *input,unsigned char *output)
     return;
 }
 
-static void generate_subkey(unsigned char *key, unsigned char *K1,
+static void generate_subkey(const aes_context *aes, unsigned char *K1,
         unsigned char *K2)
 {
     unsigned char L[16];
@@ -183,7 +142,7 @@ static void generate_subkey(unsigned char *key, unsigned char *K1,
 
     for ( i=0; i<16; i++ ) Z[i] = 0;
 
-    AES_128(key,Z,L);
+    aes_encrypt(Z,L,aes);
 
     if ( (L[0] & 0x80) == 0 ) { /* If MSB(L) = 0, then K1 = L << 1 */
         leftshift_onebit(L,K1);
@@ -203,7 +162,7 @@ static void generate_subkey(unsigned char *key, unsigned char *K1,
     return;
 }
 
-static void padding ( unsigned char *lastb, unsigned char *pad, int length )
+static void padding ( const unsigned char *lastb, unsigned char *pad, int length )
 {
     int j;
 
@@ -219,13 +178,17 @@ static void padding ( unsigned char *lastb, unsigned char *pad, int length )
     }
 }
 
-void AES_CMAC ( unsigned char *key, unsigned char *input, int length,
+void aes_cmac_ctx_init ( aes_cmac_ctx *ctx, const unsigned char *key )
+{
+    aes_set_key(key,16,ctx->aes);
+    generate_subkey(ctx->aes,ctx->K1,ctx->K2);
+}
+
+void aes_cmac_ctx_mac ( const aes_cmac_ctx *ctx, unsigned char *input, int length,
                                                           unsigned char *mac )
 {
     unsigned char       X[16],Y[16], M_last[16], padded[16];
-    unsigned char       K1[16], K2[16];
     int         n, i, flag;
-    generate_subkey(key,K1,K2);
 
     n = (length+15) / 16;       /* n is number of rounds */
 
@@ -241,30 +204,106 @@ void AES_CMAC ( unsigned char *key, unsigned char *input, int length,
     }
 
     if ( flag ) { /* last block is complete block */
-        xor_128(&input[16*(n-1)],K1,M_last);
+        xor_128(&input[16*(n-1)],ctx->K1,M_last);
     } else {
         padding(&input[16*(n-1)],padded,length%16);
-        xor_128(padded,K2,M_last);
+        xor_128(padded,ctx->K2,M_last);
     }
 
     for ( i=0; i<16; i++ ) X[i] = 0;
     for ( i=0; i<n-1; i++ ) {
         xor_128(X,&input[16*i],Y); /* Y := Mi (+) X  */
-        AES_128(key,Y,X);      /* X := AES-128(KEY, Y); */
+        aes_encrypt(Y,X,ctx->aes);      /* X := AES-128(KEY, Y); */
     }
 
     xor_128(X,M_last,Y);
-    AES_128(key,Y,X);
+    aes_encrypt(Y,X,ctx->aes);
 
     for ( i=0; i<16; i++ ) {
         mac[i] = X[i];
     }
 }
 
+void AES_CMAC ( unsigned char *key, unsigned char *input, int length,
+                                                          unsigned char *mac )
+{
+    aes_cmac_ctx        ctx;
+
+    aes_cmac_ctx_init(&ctx,key);
+    aes_cmac_ctx_mac(&ctx,input,length,mac);
+}
+
+  /* Incremental AES-CMAC */
+
+void aes_cmac_init ( aes_cmac_state *st, const aes_cmac_ctx *ctx )
+{
+    int i;
+
+    st->ctx = ctx;
+    for ( i=0; i<16; i++ ) st->X[i] = 0;
+    st->M_len = 0;
+}
+
+void aes_cmac_update ( aes_cmac_state *st, const unsigned char *input, int length )
+{
+    unsigned char       Y[16];
+    int         n;
+
+    if ( length <= 0 )
+        return;
+
+    /* top up the pending block */
+    n = 16 - st->M_len;
+    if ( n > length )
+        n = length;
+    memcpy(&st->M[st->M_len],input,n);
+    st->M_len += n;
+    input += n;
+    length -= n;
+
+    /* the pending block is only known not to be the last one once more */
+    /* data arrives, so it stays buffered until then                    */
+    if ( length == 0 )
+        return;
+
+    xor_128(st->X,st->M,Y);
+    aes_encrypt(Y,st->X,st->ctx->aes);
+
+    /* whole blocks straight from the input, keeping the last one back */
+    while ( length > 16 ) {
+        xor_128(st->X,input,Y);
+        aes_encrypt(Y,st->X,st->ctx->aes);
+        input += 16;
+        length -= 16;
+    }
+
+    memcpy(st->M,input,length);
+    st->M_len = length;
+}
+
+void aes_cmac_final ( aes_cmac_state *st, unsigned char *mac )
+{
+    unsigned char       Y[16], M_last[16], padded[16];
+
+    if ( st->M_len == 16 ) { /* last block is complete block */
+        xor_128(st->M,st->ctx->K1,M_last);
+    } else {
+        padding(st->M,padded,st->M_len);
+        xor_128(padded,st->ctx->K2,M_last);
+    }
+
+    xor_128(st->X,M_last,Y);
+    aes_encrypt(Y,mac,st->ctx->aes);
+}
+
 #ifdef AES_CMAC_UNIT_TEST
 int main()
 {
-    unsigned char L[16], K1[16], K2[16], T[16], TT[12];
+    unsigned char L[16], T[16], TT[12];
+    aes_cmac_ctx ctx;
+    aes_cmac_state st;
+    int len[4] = { 0, 16, 40, 64 };
+    int i;
     unsigned char M[64] = {
         0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
         0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
@@ -284,12 +323,12 @@ int main()
     printf("K              "); print128(key); printf("\n");
 
     printf("\nSubkey Generation\n");
-    AES_128(key,const_Zero,L);
+    aes_cmac_ctx_init(&ctx,key);
+    aes_encrypt(const_Zero,L,ctx.aes);
     printf("AES_128(key,0) "); print128(L); printf("\n");
-    generate_subkey(key,K1,K2);
 
-    printf("K1             "); print128(K1); printf("\n");
-    printf("K2             "); print128(K2); printf("\n");
+    printf("K1             "); print128(ctx.K1); printf("\n");
+    printf("K2             "); print128(ctx.K2); printf("\n");
 
     printf("\nExample 1: len = 0\n");
     printf("M              "); printf("<empty string>\n");
@@ -311,6 +350,36 @@ int main()
     AES_CMAC(key,M,64,T);
     printf("AES_CMAC       "); print128(T); printf("\n");
 
+    printf("\nKeyed context, one init for all examples\n");
+    for ( i=0; i<4; i++ ) {
+        AES_CMAC(key,M,len[i],T);
+        aes_cmac_ctx_mac(&ctx,M,len[i],L);
+        printf("len = %-2d       %s\n", len[i], memcmp(T,L,16) ? "FAIL" : "pass");
+    }
+
+    printf("\nIncremental, every split point\n");
+    for ( i=0; i<4; i++ ) {
+        int s1, s2, fail = 0;
+
+        AES_CMAC(key,M,len[i],T);
+        for ( s1=0; s1<=len[i]; s1++ ) {
+            for ( s2=s1; s2<=len[i]; s2++ ) {
+                aes_cmac_init(&st,&ctx);
+                aes_cmac_update(&st,M,s1);
+                aes_cmac_update(&st,M+s1,s2-s1);
+                aes_cmac_update(&st,M+s2,len[i]-s2);
+                aes_cmac_final(&st,L);
+                fail |= memcmp(T,L,16);
+            }
+        }
+        aes_cmac_init(&st,&ctx);
+        for ( s1=0; s1<len[i]; s1++ )
+            aes_cmac_update(&st,M+s1,1);
+        aes_cmac_final(&st,L);
+        fail |= memcmp(T,L,16);
+        printf("len = %-2d       %s\n", len[i], fail ? "FAIL" : "pass");
+    }
+
     printf("--------------------------------------------------\n");
 
     return 0;
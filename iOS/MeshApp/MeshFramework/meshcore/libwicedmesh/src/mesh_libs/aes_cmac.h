@@ -39,6 +39,8 @@
 #ifndef _AES_CMAC_H_
 #define _AES_CMAC_H_
 
+#include "aes.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,6 +50,41 @@ extern "C" {
 void AES_CMAC( unsigned char *key, unsigned char *input, int length,
                   unsigned char *mac );
 
+// Keyed CMAC context. aes_cmac_ctx_init() expands the AES-128 key and
+// computes the subkeys K1 and K2 once; aes_cmac_ctx_mac() can then be
+// called any number of times and gives the same result as AES_CMAC()
+// with that key.
+typedef struct
+{
+    aes_context     aes[1];     // expanded key schedule
+    unsigned char   K1[16];     // CMAC subkeys
+    unsigned char   K2[16];
+} aes_cmac_ctx;
+
+void aes_cmac_ctx_init( aes_cmac_ctx *ctx, const unsigned char *key );
+
+void aes_cmac_ctx_mac( const aes_cmac_ctx *ctx, unsigned char *input, int length,
+                  unsigned char *mac );
+
+// Incremental CMAC for messages that are not contiguous in memory. The
+// message is fed in pieces of any size with aes_cmac_update(), and
+// aes_cmac_final() gives the same MAC as aes_cmac_ctx_mac() over the
+// whole message. The state is a fixed size whatever the message length.
+// ctx must stay valid until aes_cmac_final() returns.
+typedef struct
+{
+    const aes_cmac_ctx  *ctx;
+    unsigned char       X[16];      // running CBC value
+    unsigned char       M[16];      // pending, possibly last, block
+    int                 M_len;
+} aes_cmac_state;
+
+void aes_cmac_init( aes_cmac_state *st, const aes_cmac_ctx *ctx );
+
+void aes_cmac_update( aes_cmac_state *st, const unsigned char *input, int length );
+
+void aes_cmac_final( aes_cmac_state *st, unsigned char *mac );
+
 
 #ifdef __cplusplus
 }
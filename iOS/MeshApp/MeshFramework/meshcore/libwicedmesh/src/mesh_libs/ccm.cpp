@@ -20,6 +20,8 @@ Issue Date: 21/07/2009
 My thanks to Colin Sinclair for finding an error and suggesting a number
 of improvements to this code
 */
+// #define CCM_UNIT_TEST
+
 #include <string.h>
 #include <stdio.h>
 
@@ -495,6 +497,605 @@ ret_type ccm_decrypt_message(               /* decrypt an entire message    */
     return (rr != RETURN_GOOD || memcmp(tag, local_tag, tag_len)) ? RETURN_ERROR : RETURN_GOOD;
 }
 
+/*  Batched CCM for independent messages. Each message is a lane with its
+    own CBC-MAC and counter streams. Every step takes one CBC-MAC block and
+    at most two counter blocks from each lane and encrypts them with one
+    aes_encrypt_n call, so the cipher is never waiting on one CBC chain.
+
+    In lane order the CBC-MAC input is B0, the formatted header blocks and
+    then the message blocks. On encryption message block j is absorbed and
+    encrypted in the same step. On decryption the key stream for block j
+    is one step ahead so the plaintext is ready when the CBC-MAC reaches it.
+*/
+
+typedef struct
+{   ccm_batch_msg *m;
+    uint8_t     cbc[BLOCK_SIZE];            /* running CBC-MAC value        */
+    uint8_t     ctr[BLOCK_SIZE];            /* counter block, counter 0     */
+    uint8_t     ks[BLOCK_SIZE];             /* counter / key stream block   */
+    uint8_t     s0[BLOCK_SIZE];             /* encrypted counter 0          */
+    uint32_t    hdr_blks;                   /* formatted header blocks      */
+    uint32_t    msg_blks;                   /* message blocks               */
+    uint32_t    ctr_lag;                    /* counter step offset          */
+} ccm_lane;
+
+static int ccm_lane_ok(const ccm_batch_msg *m)
+{   unsigned long l = BLOCK_SIZE - 1 - m->iv_len;
+
+    return m->ctx->aes->rnd
+        && m->tag_len >= 4 && m->tag_len <= 16 && !(m->tag_len & 1)
+        && m->iv_len >= 7 && m->iv_len <= 13
+        && m->hdr_len < 0xff00
+        && (l >= 4 || (m->msg_len >> (8 * l)) == 0);
+}
+
+static void ccm_lane_init(ccm_lane *ln, ccm_batch_msg *m, int decrypt)
+{   uint32_t l = BLOCK_SIZE - 1 - (uint32_t)m->iv_len, i;
+    unsigned long len = m->msg_len;
+
+    ln->m = m;
+    ln->hdr_blks = m->hdr_len ? (uint32_t)(m->hdr_len + 2 + BLOCK_SIZE - 1) / BLOCK_SIZE : 0;
+    ln->msg_blks = (uint32_t)(m->msg_len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    ln->ctr_lag = 1 + ln->hdr_blks - (decrypt ? 1 : 0);
+
+    /* counter 0, encrypted in the first step for the tag */
+    ln->ctr[0] = (uint8_t)(l - 1);
+    memcpy(ln->ctr + 1, m->iv, m->iv_len);
+    memset(ln->ctr + 1 + m->iv_len, 0, l);
+    memcpy(ln->s0, ln->ctr, BLOCK_SIZE);
+
+    /* B0 */
+    memcpy(ln->cbc, ln->ctr, BLOCK_SIZE);
+    ln->cbc[0] |= (m->hdr_len ? 0x40 : 0) + ((m->tag_len - 2) << 2);
+    for(i = BLOCK_SIZE - 1; len; --i, len >>= 8)
+        ln->cbc[i] = (uint8_t)len;
+}
+
+/* absorb CBC-MAC block t (t > 0) of the lane */
+static void ccm_lane_auth(ccm_lane *ln, uint32_t t)
+{   const ccm_batch_msg *m = ln->m;
+    uint32_t i, p;
+
+    if(t <= ln->hdr_blks)
+    {
+        /* the header is preceded by its length in two bytes */
+        for(i = 0, p = (t - 1) * BLOCK_SIZE; i < BLOCK_SIZE; ++i, ++p)
+        {
+            if(p < 2)
+                ln->cbc[i] ^= (uint8_t)(m->hdr_len >> (8 - 8 * p));
+            else if(p - 2 < m->hdr_len)
+                ln->cbc[i] ^= m->hdr[p - 2];
+        }
+    }
+    else if((p = (t - 1 - ln->hdr_blks) * BLOCK_SIZE) + BLOCK_SIZE <= m->msg_len)
+        xor_block(ln->cbc, ln->cbc, m->msg + p);
+    else
+        for(i = 0; p + i < m->msg_len; ++i)
+            ln->cbc[i] ^= m->msg[p + i];
+}
+
+/* the counter block for the next message block, in the ks buffer */
+static void ccm_lane_ctr(ccm_lane *ln)
+{
+    inc_ctr(ln->ctr);
+    memcpy(ln->ks, ln->ctr, BLOCK_SIZE);
+}
+
+static void ccm_lane_crypt(ccm_lane *ln, uint32_t j)
+{   const ccm_batch_msg *m = ln->m;
+    uint32_t i, p = j * BLOCK_SIZE;
+
+    if(p + BLOCK_SIZE <= m->msg_len)
+        xor_block(m->msg + p, m->msg + p, ln->ks);
+    else
+        for(i = 0; p + i < m->msg_len; ++i)
+            m->msg[p + i] ^= ln->ks[i];
+}
+
+static ret_type ccm_batch(ccm_batch_msg msg[], unsigned long n_msg, int decrypt)
+{   ccm_lane lane[CCM_BATCH_LANES];
+    unsigned char *blk[3 * CCM_BATCH_LANES];
+    const aes_context *key[3 * CCM_BATCH_LANES];
+    ret_type rv = RETURN_GOOD;
+
+    while(n_msg)
+    {   uint32_t n_lane = 0, steps = 0, t, i, j, n;
+        int ctr_at[CCM_BATCH_LANES];
+
+        /* messages the batch cannot format go through the generic code */
+        for( ; n_msg && n_lane < CCM_BATCH_LANES; ++msg, --n_msg)
+        {
+            if(!ccm_lane_ok(msg))
+            {
+                if(decrypt)
+                    msg->ret = ccm_decrypt_message(msg->iv, msg->iv_len, msg->hdr, msg->hdr_len,
+                                    msg->msg, msg->msg_len, msg->tag, msg->tag_len, msg->ctx);
+                else
+                    msg->ret = ccm_encrypt_message(msg->iv, msg->iv_len, msg->hdr, msg->hdr_len,
+                                    msg->msg, msg->msg_len, msg->tag, msg->tag_len, msg->ctx);
+                if(msg->ret != RETURN_GOOD)
+                    rv = RETURN_ERROR;
+                continue;
+            }
+            ccm_lane_init(&lane[n_lane], msg, decrypt);
+            if(1 + lane[n_lane].hdr_blks + lane[n_lane].msg_blks > steps)
+                steps = 1 + lane[n_lane].hdr_blks + lane[n_lane].msg_blks;
+            ++n_lane;
+        }
+
+        for(t = 0; t < steps; ++t)
+        {
+            for(i = n = 0; i < n_lane; ++i)
+            {   ccm_lane *ln = &lane[i];
+
+                ctr_at[i] = -1;
+                if(t >= 1 + ln->hdr_blks + ln->msg_blks)
+                    continue;
+                if(t)
+                    ccm_lane_auth(ln, t);
+                blk[n] = ln->cbc, key[n++] = ln->m->ctx->aes;
+                if(!t)
+                    blk[n] = ln->s0, key[n++] = ln->m->ctx->aes;
+                if(t >= ln->ctr_lag && (j = t - ln->ctr_lag) < ln->msg_blks)
+                {
+                    ccm_lane_ctr(ln);
+                    blk[n] = ln->ks, key[n++] = ln->m->ctx->aes;
+                    ctr_at[i] = (int)j;
+                }
+            }
+
+            aes_encrypt_n(blk, key, (int)n);
+
+            for(i = 0; i < n_lane; ++i)
+                if(ctr_at[i] >= 0)
+                    ccm_lane_crypt(&lane[i], (uint32_t)ctr_at[i]);
+        }
+
+        for(i = 0; i < n_lane; ++i)
+        {   ccm_batch_msg *m = lane[i].m;
+            uint8_t tag[BLOCK_SIZE];
+
+            for(j = 0; j < m->tag_len; ++j)
+                tag[j] = lane[i].cbc[j] ^ lane[i].s0[j];
+            if(decrypt)
+                m->ret = memcmp(tag, m->tag, m->tag_len) ? RETURN_ERROR : RETURN_GOOD;
+            else
+                memcpy(m->tag, tag, m->tag_len), m->ret = RETURN_GOOD;
+            if(m->ret != RETURN_GOOD)
+                rv = RETURN_ERROR;
+        }
+    }
+    return rv;
+}
+
+ret_type ccm_encrypt_batch(                 /* encrypt independent messages */
+            ccm_batch_msg msg[],            /* the messages                 */
+            unsigned long n_msg)            /* and their number             */
+{
+    return ccm_batch(msg, n_msg, 0);
+}
+
+ret_type ccm_decrypt_batch(                 /* decrypt independent messages */
+            ccm_batch_msg msg[],            /* the messages                 */
+            unsigned long n_msg)            /* and their number             */
+{
+    return ccm_batch(msg, n_msg, 1);
+}
+
+/*  Single pass CCM for Bluetooth Mesh parameters. With a 13 byte nonce the
+    counter and the B0 length field are two bytes and the header, if any,
+    fits in two formatted blocks, so nothing but the message length varies
+    at run time.
+
+    The CBC-MAC input is B0, the header blocks and the message blocks and
+    each step encrypts the next of them together with the next counter
+    block: A1 .. An for the message followed by A0 for the tag. The key
+    stream for message block j is therefore ready at step j, before the
+    CBC-MAC reaches that block at step 1 + hdr_blks + j, so decryption can
+    apply it at once while encryption keeps it until the plaintext has been
+    absorbed, at most three steps later.
+*/
+
+#define MESH_L          (BLOCK_SIZE - 1 - CCM_MESH_IV_LEN)
+#define MESH_KS_BUFS    4                   /* > header blocks, power of 2  */
+
+static int ccm_mesh_ok(unsigned long hdr_len, unsigned long msg_len, unsigned long tag_len, const ccm_ctx ctx[1])
+{
+    return ctx->aes->rnd && (tag_len == 4 || tag_len == 8)
+        && hdr_len <= CCM_MESH_MAX_HDR && msg_len <= CCM_MESH_MAX_MSG;
+}
+
+static void ccm_mesh(const unsigned char iv[], const unsigned char hdr[], uint32_t hdr_len,
+                     unsigned char msg[], uint32_t msg_len, uint32_t tag_len,
+                     uint8_t cbc[BLOCK_SIZE], uint8_t s0[BLOCK_SIZE], const aes_context aes[1], int decrypt)
+{   uint8_t ctr[BLOCK_SIZE], ks[MESH_KS_BUFS][BLOCK_SIZE];
+    uint32_t hdr_blks = hdr_len ? (hdr_len + 2 + BLOCK_SIZE - 1) / BLOCK_SIZE : 0;
+    uint32_t msg_blks = (msg_len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint32_t t, i, j, p;
+
+    ctr[0] = MESH_L - 1;
+    memcpy(ctr + 1, iv, CCM_MESH_IV_LEN);
+    ctr[BLOCK_SIZE - 2] = ctr[BLOCK_SIZE - 1] = 0;
+    memcpy(s0, ctr, BLOCK_SIZE);
+
+    memcpy(cbc, ctr, BLOCK_SIZE);
+    cbc[0] |= (hdr_len ? 0x40 : 0) + ((tag_len - 2) << 2);
+    cbc[BLOCK_SIZE - 2] = (uint8_t)(msg_len >> 8);
+    cbc[BLOCK_SIZE - 1] = (uint8_t)msg_len;
+
+    for(t = 0; t <= hdr_blks + msg_blks; ++t)
+    {
+        if(t && t <= hdr_blks)
+        {
+            /* the header is preceded by its length in two bytes */
+            for(i = 0, p = (t - 1) * BLOCK_SIZE; i < BLOCK_SIZE; ++i, ++p)
+            {
+                if(p < 2)
+                    cbc[i] ^= (uint8_t)(hdr_len >> (8 - 8 * p));
+                else if(p - 2 < hdr_len)
+                    cbc[i] ^= hdr[p - 2];
+            }
+        }
+        else if(t)
+        {
+            j = t - 1 - hdr_blks, p = j * BLOCK_SIZE;
+            if(p + BLOCK_SIZE <= msg_len)
+            {
+                xor_block(cbc, cbc, msg + p);
+                if(!decrypt)
+                    xor_block(msg + p, msg + p, ks[j & (MESH_KS_BUFS - 1)]);
+            }
+            else
+                for(i = 0; p + i < msg_len; ++i)
+                {
+                    cbc[i] ^= msg[p + i];
+                    if(!decrypt)
+                        msg[p + i] ^= ks[j & (MESH_KS_BUFS - 1)][i];
+                }
+        }
+
+        if(t < msg_blks)
+        {   uint8_t *k = ks[t & (MESH_KS_BUFS - 1)];
+
+            ctr[BLOCK_SIZE - 2] = (uint8_t)((t + 1) >> 8);
+            ctr[BLOCK_SIZE - 1] = (uint8_t)(t + 1);
+            memcpy(k, ctr, BLOCK_SIZE);
+            aes_encrypt_pair(cbc, k, aes);
+            if(decrypt)
+            {
+                p = t * BLOCK_SIZE;
+                if(p + BLOCK_SIZE <= msg_len)
+                    xor_block(msg + p, msg + p, k);
+                else
+                    for(i = 0; p + i < msg_len; ++i)
+                        msg[p + i] ^= k[i];
+            }
+        }
+        else if(t == msg_blks)
+            aes_encrypt_pair(cbc, s0, aes);
+        else
+            aes_encrypt(cbc, cbc, aes);
+    }
+}
+
+ret_type ccm_mesh_encrypt_message(          /* encrypt a mesh message       */
+            const unsigned char iv[],       /* the 13 byte nonce            */
+            const unsigned char hdr[],      /* the header buffer            */
+            unsigned long hdr_len,          /* and its length in bytes      */
+            unsigned char msg[],            /* the message buffer           */
+            unsigned long msg_len,          /* and its length in bytes      */
+            unsigned char tag[],            /* the buffer for the tag       */
+            unsigned long tag_len,          /* and its length in bytes      */
+            ccm_ctx ctx[1])                 /* the mode context             */
+{   uint8_t cbc[BLOCK_SIZE], s0[BLOCK_SIZE];
+    uint32_t i;
+
+    if(!ccm_mesh_ok(hdr_len, msg_len, tag_len, ctx))
+        return ccm_encrypt_message(iv, CCM_MESH_IV_LEN, hdr, hdr_len, msg, msg_len, tag, tag_len, ctx);
+
+    ccm_mesh(iv, hdr, (uint32_t)hdr_len, msg, (uint32_t)msg_len, (uint32_t)tag_len, cbc, s0, ctx->aes, 0);
+    for(i = 0; i < tag_len; ++i)
+        tag[i] = cbc[i] ^ s0[i];
+    return RETURN_GOOD;
+}
+
+ret_type ccm_mesh_decrypt_message(          /* decrypt a mesh message       */
+            const unsigned char iv[],       /* the 13 byte nonce            */
+            const unsigned char hdr[],      /* the header buffer            */
+            unsigned long hdr_len,          /* and its length in bytes      */
+            unsigned char msg[],            /* the message buffer           */
+            unsigned long msg_len,          /* and its length in bytes      */
+            const unsigned char tag[],      /* the tag to verify            */
+            unsigned long tag_len,          /* and its length in bytes      */
+            ccm_ctx ctx[1])                 /* the mode context             */
+{   uint8_t cbc[BLOCK_SIZE], s0[BLOCK_SIZE], diff = 0;
+    uint32_t i;
+
+    if(!ccm_mesh_ok(hdr_len, msg_len, tag_len, ctx))
+        return ccm_decrypt_message(iv, CCM_MESH_IV_LEN, hdr, hdr_len, msg, msg_len, tag, tag_len, ctx);
+
+    ccm_mesh(iv, hdr, (uint32_t)hdr_len, msg, (uint32_t)msg_len, (uint32_t)tag_len, cbc, s0, ctx->aes, 1);
+    for(i = 0; i < tag_len; ++i)
+        diff |= tag[i] ^ cbc[i] ^ s0[i];
+    return diff ? RETURN_ERROR : RETURN_GOOD;
+}
+
 #if defined(__cplusplus)
 }
 #endif
+
+#ifdef CCM_UNIT_TEST
+/*  NIST SP 800-38C and RFC 3610 known answer tests, comparisons of the batch
+    and mesh paths with the generic one and messages per second for each */
+#include <stdlib.h>
+#include <time.h>
+
+static uint32_t test_seed = 1;
+
+static uint8_t test_rand(void)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return (uint8_t)(test_seed >> 16);
+}
+
+static int test_kat(void)
+{
+    static const uint8_t key[16] = {
+        0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+        0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f };
+    static const uint8_t iv[8] = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17 };
+    static const uint8_t hdr[16] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    static const uint8_t pt[16] = {
+        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+        0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f };
+    static const struct
+    {   uint8_t iv_len, hdr_len, msg_len, tag_len;
+        uint8_t ct[32];
+    } kat[] =
+    {
+        { 7, 8, 4, 4, { 0x71, 0x62, 0x01, 0x5b, 0x4d, 0xac, 0x25, 0x5d } },
+        { 8, 16, 16, 6, { 0xd2, 0xa1, 0xf0, 0xe0, 0x51, 0xea, 0x5f, 0x62, 0x08, 0x1a, 0x77, 0x92,
+                          0x07, 0x3d, 0x59, 0x3d, 0x1f, 0xc6, 0x4f, 0xbf, 0xac, 0xcd } },
+    };
+    ccm_ctx ctx[1];
+    ccm_batch_msg bm[1];
+    uint8_t msg[16], tag[16];
+    unsigned int i;
+    int ok = 1, r;
+
+    ccm_init_and_key(key, 16, ctx);
+    for(i = 0; i < sizeof(kat) / sizeof(kat[0]); ++i)
+    {
+        memcpy(msg, pt, kat[i].msg_len);
+        ccm_encrypt_message(iv, kat[i].iv_len, hdr, kat[i].hdr_len, msg, kat[i].msg_len, tag, kat[i].tag_len, ctx);
+        r = !memcmp(msg, kat[i].ct, kat[i].msg_len) && !memcmp(tag, kat[i].ct + kat[i].msg_len, kat[i].tag_len);
+
+        memcpy(msg, pt, kat[i].msg_len);
+        bm->iv = iv, bm->iv_len = kat[i].iv_len, bm->hdr = hdr, bm->hdr_len = kat[i].hdr_len;
+        bm->msg = msg, bm->msg_len = kat[i].msg_len, bm->tag = tag, bm->tag_len = kat[i].tag_len, bm->ctx = ctx;
+        ccm_encrypt_batch(bm, 1);
+        r &= !memcmp(msg, kat[i].ct, kat[i].msg_len) && !memcmp(tag, kat[i].ct + kat[i].msg_len, kat[i].tag_len);
+        r &= ccm_decrypt_batch(bm, 1) == RETURN_GOOD && !memcmp(msg, pt, kat[i].msg_len);
+
+        printf("SP 800-38C example %u   %s\n", i + 1, r ? "pass" : "FAIL");
+        ok &= r;
+    }
+    return ok;
+}
+
+#define TEST_MAX_MSG    400
+
+static int test_random(int rounds)
+{
+    ccm_ctx ctx[CCM_BATCH_LANES + 1];
+    ccm_batch_msg bm[CCM_BATCH_LANES + 1];
+    uint8_t iv[CCM_BATCH_LANES + 1][13], hdr[CCM_BATCH_LANES + 1][40];
+    uint8_t pt[CCM_BATCH_LANES + 1][TEST_MAX_MSG], msg[CCM_BATCH_LANES + 1][TEST_MAX_MSG], ref[TEST_MAX_MSG];
+    uint8_t tag[CCM_BATCH_LANES + 1][16], ref_tag[16], key[16];
+    int ok = 1, n, i, j;
+
+    while(rounds--)
+    {
+        n = 1 + test_rand() % (CCM_BATCH_LANES + 1);
+        for(i = 0; i < n; ++i)
+        {
+            for(j = 0; j < 16; ++j)
+                key[j] = test_rand();
+            ccm_init_and_key(key, 16, ctx + i);
+            bm[i].iv = iv[i], bm[i].iv_len = 7 + test_rand() % 7;
+            bm[i].hdr = hdr[i], bm[i].hdr_len = test_rand() % 41;
+            bm[i].msg = msg[i], bm[i].msg_len = (test_rand() | (test_rand() << 8)) % (TEST_MAX_MSG + 1);
+            bm[i].tag = tag[i], bm[i].tag_len = 4 + 2 * (test_rand() % 7);
+            bm[i].ctx = ctx + i;
+            for(j = 0; j < 13; ++j)
+                iv[i][j] = test_rand();
+            for(j = 0; j < 40; ++j)
+                hdr[i][j] = test_rand();
+            for(j = 0; j < TEST_MAX_MSG; ++j)
+                msg[i][j] = pt[i][j] = test_rand();
+        }
+
+        ok &= ccm_encrypt_batch(bm, n) == RETURN_GOOD;
+        for(i = 0; i < n; ++i)
+        {
+            memcpy(ref, pt[i], bm[i].msg_len);
+            ccm_encrypt_message(bm[i].iv, bm[i].iv_len, bm[i].hdr, bm[i].hdr_len, ref, bm[i].msg_len,
+                                ref_tag, bm[i].tag_len, bm[i].ctx);
+            ok &= !memcmp(ref, msg[i], bm[i].msg_len) && !memcmp(ref_tag, tag[i], bm[i].tag_len);
+        }
+
+        ok &= ccm_decrypt_batch(bm, n) == RETURN_GOOD;
+        for(i = 0; i < n; ++i)
+            ok &= !memcmp(pt[i], msg[i], bm[i].msg_len);
+
+        /* a corrupted tag fails only its own message */
+        ccm_encrypt_batch(bm, n);
+        tag[0][0] ^= 1;
+        ok &= ccm_decrypt_batch(bm, n) == RETURN_ERROR && bm[0].ret == RETURN_ERROR;
+        for(i = 1; i < n; ++i)
+            ok &= bm[i].ret == RETURN_GOOD;
+    }
+    printf("batch matches single path    %s\n", ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static void test_speed(unsigned long msg_len)
+{
+    ccm_ctx ctx[CCM_BATCH_LANES];
+    ccm_batch_msg bm[CCM_BATCH_LANES];
+    uint8_t iv[13] = { 0 }, hdr[1] = { 0 }, msg[CCM_BATCH_LANES][TEST_MAX_MSG], tag[CCM_BATCH_LANES][8], key[16];
+    long count = 200000 / (long)(1 + msg_len / 16), k;
+    int i, j;
+    clock_t t;
+    double single, batch;
+
+    for(i = 0; i < CCM_BATCH_LANES; ++i)
+    {
+        for(j = 0; j < 16; ++j)
+            key[j] = test_rand();
+        ccm_init_and_key(key, 16, ctx + i);
+        bm[i].iv = iv, bm[i].iv_len = 13, bm[i].hdr = hdr, bm[i].hdr_len = 0;
+        bm[i].msg = msg[i], bm[i].msg_len = msg_len, bm[i].tag = tag[i], bm[i].tag_len = 8, bm[i].ctx = ctx + i;
+    }
+
+    t = clock();
+    for(k = 0; k < count; ++k)
+        for(i = 0; i < CCM_BATCH_LANES; ++i)
+            ccm_encrypt_message(iv, 13, hdr, 0, msg[i], msg_len, tag[i], 8, ctx + i);
+    single = (double)count * CCM_BATCH_LANES * CLOCKS_PER_SEC / (double)(clock() - t + 1);
+
+    t = clock();
+    for(k = 0; k < count; ++k)
+        ccm_encrypt_batch(bm, CCM_BATCH_LANES);
+    batch = (double)count * CCM_BATCH_LANES * CLOCKS_PER_SEC / (double)(clock() - t + 1);
+
+    printf("%3lu byte messages: single %9.0f msg/s, batch of %d %9.0f msg/s\n",
+           msg_len, single, CCM_BATCH_LANES, batch);
+}
+
+/* RFC 3610 packet vectors 1 and 2: 13 byte nonce, 8 byte tag */
+static int test_mesh_kat(void)
+{
+    static const uint8_t key[16] = {
+        0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+        0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf };
+    static const struct
+    {   uint8_t iv[13];
+        uint8_t pkt_len;
+        uint8_t ct[32 - 8 + 8];
+    } kat[] =
+    {
+        { { 0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5 }, 31,
+          { 0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80,
+            0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84, 0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0 } },
+        { { 0x00, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5 }, 32,
+          { 0x72, 0xc9, 0x1a, 0x36, 0xe1, 0x35, 0xf8, 0xcf, 0x29, 0x1c, 0xa8, 0x94, 0x08, 0x5c, 0x87, 0xe3,
+            0xcc, 0x15, 0xc4, 0x39, 0xc9, 0xe4, 0x3a, 0x3b, 0xa0, 0x91, 0xd5, 0x6e, 0x10, 0x40, 0x09, 0x16 } },
+    };
+    ccm_ctx ctx[1];
+    uint8_t pkt[32], tag[8];
+    unsigned int i, j, msg_len;
+    int ok = 1, r;
+
+    ccm_init_and_key(key, 16, ctx);
+    for(i = 0; i < sizeof(kat) / sizeof(kat[0]); ++i)
+    {
+        msg_len = kat[i].pkt_len - 8;
+        for(j = 0; j < kat[i].pkt_len; ++j)
+            pkt[j] = (uint8_t)j;
+
+        ccm_mesh_encrypt_message(kat[i].iv, pkt, 8, pkt + 8, msg_len, tag, 8, ctx);
+        r = !memcmp(pkt + 8, kat[i].ct, msg_len) && !memcmp(tag, kat[i].ct + msg_len, 8);
+        r &= ccm_mesh_decrypt_message(kat[i].iv, pkt, 8, pkt + 8, msg_len, tag, 8, ctx) == RETURN_GOOD;
+        for(j = 0; j < kat[i].pkt_len; ++j)
+            r &= pkt[j] == j;
+
+        printf("RFC 3610 packet %u      %s\n", i + 1, r ? "pass" : "FAIL");
+        ok &= r;
+    }
+    return ok;
+}
+
+/* the mesh path against the generic one for every header and tag length */
+static int test_mesh_generic(void)
+{
+    static const unsigned long hdr_lens[] = { 0, 1, 13, 14, 15, 16, 17 };
+    static const unsigned long tag_lens[] = { 4, 8, 6, 16 };
+    ccm_ctx ctx[1];
+    uint8_t iv[13], hdr[17], key[16], pt[TEST_MAX_MSG], msg[TEST_MAX_MSG], ref[TEST_MAX_MSG];
+    uint8_t tag[16], ref_tag[16];
+    unsigned long h, g, msg_len;
+    int ok = 1, j;
+
+    for(j = 0; j < 16; ++j)
+        key[j] = test_rand();
+    ccm_init_and_key(key, 16, ctx);
+    for(j = 0; j < 17; ++j)
+        hdr[j] = test_rand();
+    for(msg_len = 0; msg_len <= TEST_MAX_MSG; ++msg_len)
+        for(h = 0; h < sizeof(hdr_lens) / sizeof(hdr_lens[0]); ++h)
+            for(g = 0; g < sizeof(tag_lens) / sizeof(tag_lens[0]); ++g)
+            {
+                for(j = 0; j < 13; ++j)
+                    iv[j] = test_rand();
+                for(j = 0; j < (int)msg_len; ++j)
+                    pt[j] = msg[j] = ref[j] = test_rand();
+
+                ccm_mesh_encrypt_message(iv, hdr, hdr_lens[h], msg, msg_len, tag, tag_lens[g], ctx);
+                ccm_encrypt_message(iv, 13, hdr, hdr_lens[h], ref, msg_len, ref_tag, tag_lens[g], ctx);
+                ok &= !memcmp(msg, ref, msg_len) && !memcmp(tag, ref_tag, tag_lens[g]);
+
+                ok &= ccm_mesh_decrypt_message(iv, hdr, hdr_lens[h], msg, msg_len, tag, tag_lens[g], ctx) == RETURN_GOOD;
+                ok &= !memcmp(msg, pt, msg_len);
+
+                ccm_encrypt_message(iv, 13, hdr, hdr_lens[h], msg, msg_len, tag, tag_lens[g], ctx);
+                tag[tag_lens[g] - 1] ^= 0x80;
+                ok &= ccm_mesh_decrypt_message(iv, hdr, hdr_lens[h], msg, msg_len, tag, tag_lens[g], ctx) == RETURN_ERROR;
+            }
+    printf("mesh path matches generic    %s\n", ok ? "pass" : "FAIL");
+    return ok;
+}
+
+static void test_mesh_speed(unsigned long msg_len)
+{
+    ccm_ctx ctx[1];
+    uint8_t iv[13] = { 0 }, hdr[1] = { 0 }, msg[TEST_MAX_MSG], tag[8], key[16] = { 0 };
+    long count = 2000000 / (long)(1 + msg_len / 16), k;
+    clock_t t;
+    double generic, mesh;
+
+    ccm_init_and_key(key, 16, ctx);
+    memset(msg, 0, sizeof(msg));
+
+    t = clock();
+    for(k = 0; k < count; ++k)
+        ccm_encrypt_message(iv, 13, hdr, 0, msg, msg_len, tag, 4, ctx);
+    generic = (double)count * CLOCKS_PER_SEC / (double)(clock() - t + 1);
+
+    t = clock();
+    for(k = 0; k < count; ++k)
+        ccm_mesh_encrypt_message(iv, hdr, 0, msg, msg_len, tag, 4, ctx);
+    mesh = (double)count * CLOCKS_PER_SEC / (double)(clock() - t + 1);
+
+    printf("%3lu byte messages: generic %9.0f msg/s, mesh %9.0f msg/s\n", msg_len, generic, mesh);
+}
+
+int main()
+{
+    int ok = test_kat();
+
+    ok &= test_random(2000);
+    ok &= test_mesh_kat();
+    ok &= test_mesh_generic();
+    test_speed(16);
+    test_speed(64);
+    test_speed(384);
+    test_mesh_speed(16);
+    test_mesh_speed(64);
+    test_mesh_speed(384);
+    return ok ? 0 : 1;
+}
+
+#endif
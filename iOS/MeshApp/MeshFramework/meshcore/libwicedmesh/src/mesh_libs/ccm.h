@@ -178,6 +178,69 @@ ret_type ccm_decrypt_message(               /* decrypt an entire message    */
             unsigned long tag_len,          /* and its length in bytes      */
             ccm_ctx ctx[1]);                /* the mode context             */
 
+/*  The following calls handle a batch of independent complete messages,
+    each with its own nonce and key (ccm_ctx keyed by ccm_init_and_key).
+    Up to CCM_BATCH_LANES messages are processed together so that their
+    AES operations can be interleaved. On return 'ret' holds the result
+    for each message as ccm_encrypt_message or ccm_decrypt_message would
+    give it, and RETURN_GOOD is returned only if every message is good.
+*/
+
+#define CCM_BATCH_LANES 8
+
+typedef struct
+{   const unsigned char *iv;                /* the initialisation vector    */
+    unsigned long   iv_len;                 /* and its length in bytes      */
+    const unsigned char *hdr;               /* the header buffer            */
+    unsigned long   hdr_len;                /* and its length in bytes      */
+    unsigned char   *msg;                   /* the message buffer           */
+    unsigned long   msg_len;                /* and its length in bytes      */
+    unsigned char   *tag;                   /* the tag (out for encryption) */
+    unsigned long   tag_len;                /* and its length in bytes      */
+    ccm_ctx         *ctx;                   /* the keyed mode context       */
+    ret_type        ret;                    /* result for this message      */
+} ccm_batch_msg;
+
+ret_type ccm_encrypt_batch(                 /* encrypt independent messages */
+            ccm_batch_msg msg[],            /* the messages                 */
+            unsigned long n_msg);           /* and their number             */
+
+ret_type ccm_decrypt_batch(                 /* decrypt independent messages */
+            ccm_batch_msg msg[],            /* the messages                 */
+            unsigned long n_msg);           /* and their number             */
+
+/*  The following calls are specialised for Bluetooth Mesh: a 13 byte nonce
+    (so a two byte length field), a 4 or 8 byte tag, at most CCM_MESH_MAX_HDR
+    bytes of associated data (the label UUID of a virtual address) and at
+    most CCM_MESH_MAX_MSG bytes of message. CBC-MAC and counter blocks are
+    computed in a single pass, two AES blocks at a time. Any other parameters
+    are passed on to ccm_encrypt_message or ccm_decrypt_message.
+*/
+
+#define CCM_MESH_IV_LEN     13
+#define CCM_MESH_MAX_HDR    16
+#define CCM_MESH_MAX_MSG    384
+
+ret_type ccm_mesh_encrypt_message(          /* encrypt a mesh message       */
+            const unsigned char iv[],       /* the 13 byte nonce            */
+            const unsigned char hdr[],      /* the header buffer            */
+            unsigned long hdr_len,          /* and its length in bytes      */
+            unsigned char msg[],            /* the message buffer           */
+            unsigned long msg_len,          /* and its length in bytes      */
+            unsigned char tag[],            /* the buffer for the tag       */
+            unsigned long tag_len,          /* and its length in bytes      */
+            ccm_ctx ctx[1]);                /* the mode context             */
+
+ret_type ccm_mesh_decrypt_message(          /* decrypt a mesh message       */
+            const unsigned char iv[],       /* the 13 byte nonce            */
+            const unsigned char hdr[],      /* the header buffer            */
+            unsigned long hdr_len,          /* and its length in bytes      */
+            unsigned char msg[],            /* the message buffer           */
+            unsigned long msg_len,          /* and its length in bytes      */
+            const unsigned char tag[],      /* the tag to verify            */
+            unsigned long tag_len,          /* and its length in bytes      */
+            ccm_ctx ctx[1]);                /* the mode context             */
+
 /* The following calls handle messages in a sequence of operations followed */
 /* by tag computation after the sequence has been completed. In these calls */
 /* the user is responsible for verfiying the computed tag on decryption     */
@@ -0,0 +1,606 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Buffered log file writer, see log_file.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#ifdef LOG_FILE_ZLIB
+#include <zlib.h>
+#endif
+#include "log_file.h"
+
+#define LOG_FILE_NAME_MAX           1024
+#define LOG_FILE_GEN_NAME_MAX       (LOG_FILE_NAME_MAX + 16)   // room for .N.gz
+#define LOG_FILE_MIN_FLUSH_MS       10
+#define LOG_FILE_COMPRESS_CHUNK     (64 * 1024)     // compressed per writer pass, buffers are written in between
+
+typedef struct
+{
+    char       *p_data;
+    uint32_t    len;
+} LOG_FILE_BUFFER;
+
+static pthread_mutex_t  log_file_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   log_file_wake  = PTHREAD_COND_INITIALIZER;      // the writer waits for lines
+static pthread_cond_t   log_file_space = PTHREAD_COND_INITIALIZER;      // logging threads wait for an empty buffer
+static pthread_cond_t   log_file_done  = PTHREAD_COND_INITIALIZER;      // log_file_flush waits for the writer
+static pthread_t        log_file_thread;
+static int              log_file_running;
+static LOG_FILE_BUFFER  log_file_buffers[2];
+static int              log_file_fill;              // the buffer logging threads copy into, the other one is empty
+static uint32_t         log_file_flush_requests;
+static uint32_t         log_file_flushed;
+static LOG_FILE_CONFIG  log_file_config =
+{
+    LOG_FILE_DEFAULT_MAX_SIZE, LOG_FILE_DEFAULT_GENERATIONS, LOG_FILE_DEFAULT_FLUSH_MS, 0
+};
+static LOG_FILE_STATS   log_file_stats;
+
+// Owned by the writer thread while it runs
+static char             log_file_path[LOG_FILE_NAME_MAX];
+static int              log_file_fd = -1;
+static uint64_t         log_file_size;              // bytes in the current file, counted instead of asking ftell
+static LOG_FILE_STATS   log_file_writer_stats;      // added to log_file_stats after every pass
+#ifdef LOG_FILE_ZLIB
+static int              log_file_gz_in = -1;
+static gzFile           log_file_gz_out;
+static char             log_file_gz_name[LOG_FILE_GEN_NAME_MAX];       // the generation being compressed
+static char             log_file_gz_chunk[LOG_FILE_COMPRESS_CHUNK];
+#endif
+
+static void log_file_generation_name(char *p_name, uint32_t generation, int gz)
+{
+    snprintf(p_name, LOG_FILE_GEN_NAME_MAX, gz ? "%s.%u.gz" : "%s.%u", log_file_path, generation);
+}
+
+static void log_file_rename(const char *p_from, const char *p_to)
+{
+    if ((rename(p_from, p_to) != 0) && (errno != ENOENT))
+        log_file_writer_stats.errors++;
+}
+
+#ifdef LOG_FILE_ZLIB
+// Starts compressing path.1 to path.1.gz, the work is done by log_file_compress_step
+static void log_file_compress_start(void)
+{
+    char name[LOG_FILE_GEN_NAME_MAX];
+
+    log_file_generation_name(log_file_gz_name, 1, 0);
+    log_file_generation_name(name, 1, 1);
+    if ((log_file_gz_in = open(log_file_gz_name, O_RDONLY)) < 0)
+        return;
+    if ((log_file_gz_out = gzopen(name, "wb")) == NULL)
+    {
+        close(log_file_gz_in);
+        log_file_gz_in = -1;
+        log_file_writer_stats.errors++;
+    }
+}
+
+// Compresses the next chunk, returns 1 while there is more to do
+static int log_file_compress_step(void)
+{
+    char    name[LOG_FILE_GEN_NAME_MAX];
+    ssize_t len;
+
+    if (log_file_gz_in < 0)
+        return 0;
+
+    len = read(log_file_gz_in, log_file_gz_chunk, sizeof(log_file_gz_chunk));
+    if ((len > 0) && (gzwrite(log_file_gz_out, log_file_gz_chunk, (unsigned)len) == len))
+        return 1;
+
+    close(log_file_gz_in);
+    log_file_gz_in = -1;
+    if ((gzclose(log_file_gz_out) == Z_OK) && (len == 0))
+    {
+        remove(log_file_gz_name);
+        log_file_writer_stats.compressed++;
+    }
+    else
+    {
+        // Keep the generation as it is
+        log_file_generation_name(name, 1, 1);
+        remove(name);
+        log_file_writer_stats.errors++;
+    }
+    log_file_gz_out = NULL;
+    return 0;
+}
+#endif
+
+// Shifts path.1 .. path.N-1 up by one, the oldest one is dropped, and starts a new file
+static void log_file_rotate(const LOG_FILE_CONFIG *p_config)
+{
+    char     from[LOG_FILE_GEN_NAME_MAX], to[LOG_FILE_GEN_NAME_MAX];
+    uint32_t i;
+    int      gz;
+
+#ifdef LOG_FILE_ZLIB
+    // path.1 is about to move, finish it first
+    while (log_file_compress_step())
+        ;
+#endif
+    close(log_file_fd);
+
+    // A generation can be there plain or compressed
+    for (gz = 0; (gz < 2) && (p_config->generations != 0); gz++)
+    {
+        log_file_generation_name(to, p_config->generations, gz);
+        remove(to);
+        for (i = p_config->generations; i > 1; i--)
+        {
+            log_file_generation_name(from, i - 1, gz);
+            log_file_generation_name(to, i, gz);
+            log_file_rename(from, to);
+        }
+    }
+    if (p_config->generations != 0)
+    {
+        log_file_generation_name(to, 1, 0);
+        log_file_rename(log_file_path, to);
+    }
+    else
+    {
+        remove(log_file_path);
+    }
+
+    log_file_fd   = open(log_file_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    log_file_size = 0;
+    log_file_writer_stats.rotations++;
+    if (log_file_fd < 0)
+        log_file_writer_stats.errors++;
+
+#ifdef LOG_FILE_ZLIB
+    if (p_config->compress && (p_config->generations != 0))
+        log_file_compress_start();
+#endif
+}
+
+static void log_file_write_out(const LOG_FILE_CONFIG *p_config, const char *p_text, uint32_t len)
+{
+    uint64_t    max_size = p_config->max_size;
+    uint32_t    count;
+    ssize_t     written;
+
+    while (len != 0)
+    {
+        count = len;
+        if ((max_size != 0) && (log_file_size + count > max_size))
+        {
+            // Fill the file up to the limit with whole lines, then go on in a new one
+            count = (log_file_size < max_size) ? (uint32_t)(max_size - log_file_size) : 0;
+            while ((count != 0) && (p_text[count - 1] != '\n'))
+                count--;
+            if (count == 0)
+            {
+                if (log_file_size != 0)
+                {
+                    log_file_rotate(p_config);
+                    continue;
+                }
+                // A line longer than a whole file goes out as it is
+                while ((count < len) && (p_text[count++] != '\n'))
+                    ;
+            }
+        }
+
+        if ((log_file_fd < 0) && ((log_file_fd = open(log_file_path, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0))
+        {
+            log_file_writer_stats.errors++;
+            return;
+        }
+        written = write(log_file_fd, p_text, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            log_file_writer_stats.errors++;
+            return;
+        }
+        log_file_size += (uint64_t)written;
+        log_file_writer_stats.bytes += (uint64_t)written;
+        p_text += written;
+        len    -= (uint32_t)written;
+    }
+}
+
+static void log_file_deadline(struct timespec *p_deadline, uint32_t ms)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    p_deadline->tv_sec  = now.tv_sec + ms / 1000;
+    p_deadline->tv_nsec = now.tv_usec * 1000L + (ms % 1000) * 1000000L;
+    if (p_deadline->tv_nsec >= 1000000000L)
+    {
+        p_deadline->tv_sec++;
+        p_deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+// Called with log_file_mutex held
+static void log_file_merge_stats(void)
+{
+    log_file_stats.bytes      += log_file_writer_stats.bytes;
+    log_file_stats.writes     += log_file_writer_stats.writes;
+    log_file_stats.rotations  += log_file_writer_stats.rotations;
+    log_file_stats.compressed += log_file_writer_stats.compressed;
+    log_file_stats.errors     += log_file_writer_stats.errors;
+    memset(&log_file_writer_stats, 0, sizeof(log_file_writer_stats));
+}
+
+static void *log_file_writer(void *p_arg)
+{
+    LOG_FILE_CONFIG  config;
+    LOG_FILE_BUFFER *p_buffer;
+    struct timespec  deadline;
+    uint32_t         requests;
+    int              compressing = 0;
+
+    (void)p_arg;
+    pthread_mutex_lock(&log_file_mutex);
+    for (;;)
+    {
+        p_buffer = &log_file_buffers[log_file_fill];
+        if (log_file_running && !compressing && (p_buffer->len < LOG_FILE_BUFFER_SIZE / 2) &&
+            (log_file_flushed == log_file_flush_requests))
+        {
+            log_file_deadline(&deadline, log_file_config.flush_interval_ms);
+            pthread_cond_timedwait(&log_file_wake, &log_file_mutex, &deadline);
+        }
+        if (!log_file_running && (p_buffer->len == 0))
+            break;
+
+        // Logging goes on into the other buffer while this one is written
+        requests = log_file_flush_requests;
+        config   = log_file_config;
+        if (p_buffer->len != 0)
+        {
+            log_file_fill ^= 1;
+            pthread_cond_broadcast(&log_file_space);
+            pthread_mutex_unlock(&log_file_mutex);
+
+            log_file_write_out(&config, p_buffer->p_data, p_buffer->len);
+            log_file_writer_stats.writes++;
+
+            pthread_mutex_lock(&log_file_mutex);
+            p_buffer->len = 0;
+        }
+        log_file_flushed = requests;
+        pthread_cond_broadcast(&log_file_done);
+
+        log_file_merge_stats();
+
+#ifdef LOG_FILE_ZLIB
+        pthread_mutex_unlock(&log_file_mutex);
+        compressing = log_file_compress_step();
+        pthread_mutex_lock(&log_file_mutex);
+#endif
+    }
+    pthread_mutex_unlock(&log_file_mutex);
+
+#ifdef LOG_FILE_ZLIB
+    while (log_file_compress_step())
+        ;
+#endif
+    close(log_file_fd);
+    log_file_fd = -1;
+
+    pthread_mutex_lock(&log_file_mutex);
+    log_file_merge_stats();
+    pthread_mutex_unlock(&log_file_mutex);
+    return NULL;
+}
+
+int log_file_open(const char *p_path)
+{
+    struct stat st;
+    int         i;
+
+    log_file_close();
+    if (strlen(p_path) >= LOG_FILE_NAME_MAX)
+        return 0;
+
+    for (i = 0; i < 2; i++)
+    {
+        log_file_buffers[i].len = 0;
+        if ((log_file_buffers[i].p_data = (char *)malloc(LOG_FILE_BUFFER_SIZE)) == NULL)
+            break;
+    }
+    strcpy(log_file_path, p_path);
+    if ((i < 2) || ((log_file_fd = open(log_file_path, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0))
+    {
+        free(log_file_buffers[0].p_data);
+        free(log_file_buffers[1].p_data);
+        log_file_buffers[0].p_data = log_file_buffers[1].p_data = NULL;
+        return 0;
+    }
+    log_file_size = (fstat(log_file_fd, &st) == 0) ? (uint64_t)st.st_size : 0;
+
+    log_file_running = 1;
+    if (pthread_create(&log_file_thread, NULL, log_file_writer, NULL) != 0)
+    {
+        log_file_running = 0;
+        log_file_close();
+        return 0;
+    }
+    return 1;
+}
+
+void log_file_close(void)
+{
+    int was_running;
+
+    pthread_mutex_lock(&log_file_mutex);
+    was_running = log_file_running;
+    log_file_running = 0;
+    pthread_cond_signal(&log_file_wake);
+    pthread_cond_broadcast(&log_file_space);
+    pthread_cond_broadcast(&log_file_done);
+    pthread_mutex_unlock(&log_file_mutex);
+
+    if (was_running)
+        pthread_join(log_file_thread, NULL);
+    if (log_file_fd >= 0)
+    {
+        close(log_file_fd);
+        log_file_fd = -1;
+    }
+    free(log_file_buffers[0].p_data);
+    free(log_file_buffers[1].p_data);
+    log_file_buffers[0].p_data = log_file_buffers[1].p_data = NULL;
+}
+
+void log_file_write(const char *p_text, uint32_t len)
+{
+    LOG_FILE_BUFFER *p_buffer;
+    uint32_t         count;
+
+    pthread_mutex_lock(&log_file_mutex);
+    while (log_file_running && (len != 0))
+    {
+        // A line is not split over two buffers, a rotation in between would split it over two files
+        p_buffer = &log_file_buffers[log_file_fill];
+        if ((p_buffer->len == LOG_FILE_BUFFER_SIZE) ||
+            ((p_buffer->len != 0) && (len <= LOG_FILE_BUFFER_SIZE) && (p_buffer->len + len > LOG_FILE_BUFFER_SIZE)))
+        {
+            // Both buffers are in use, the writer hands back the other one once it is written
+            log_file_stats.waits++;
+            pthread_cond_signal(&log_file_wake);
+            pthread_cond_wait(&log_file_space, &log_file_mutex);
+            continue;
+        }
+        count = LOG_FILE_BUFFER_SIZE - p_buffer->len;
+        if (count > len)
+            count = len;
+        memcpy(&p_buffer->p_data[p_buffer->len], p_text, count);
+        p_buffer->len += count;
+        p_text        += count;
+        len           -= count;
+
+        if ((p_buffer->len >= LOG_FILE_BUFFER_SIZE / 2) && (p_buffer->len - count < LOG_FILE_BUFFER_SIZE / 2))
+            pthread_cond_signal(&log_file_wake);
+    }
+    pthread_mutex_unlock(&log_file_mutex);
+}
+
+void log_file_flush(void)
+{
+    uint32_t request;
+
+    pthread_mutex_lock(&log_file_mutex);
+    request = ++log_file_flush_requests;
+    pthread_cond_signal(&log_file_wake);
+    while (log_file_running && ((int32_t)(log_file_flushed - request) < 0))
+        pthread_cond_wait(&log_file_done, &log_file_mutex);
+    pthread_mutex_unlock(&log_file_mutex);
+}
+
+void log_file_set_config(const LOG_FILE_CONFIG *p_config)
+{
+    pthread_mutex_lock(&log_file_mutex);
+    log_file_config = *p_config;
+    if (log_file_config.flush_interval_ms < LOG_FILE_MIN_FLUSH_MS)
+        log_file_config.flush_interval_ms = LOG_FILE_MIN_FLUSH_MS;
+    pthread_mutex_unlock(&log_file_mutex);
+}
+
+void log_file_get_config(LOG_FILE_CONFIG *p_config)
+{
+    pthread_mutex_lock(&log_file_mutex);
+    *p_config = log_file_config;
+    pthread_mutex_unlock(&log_file_mutex);
+}
+
+void log_file_get_stats(LOG_FILE_STATS *p_stats)
+{
+    pthread_mutex_lock(&log_file_mutex);
+    *p_stats = log_file_stats;
+    pthread_mutex_unlock(&log_file_mutex);
+}
+
+#ifdef LOG_FILE_UNIT_TEST
+// Several threads log numbered lines into small rotating files, then one more line each. The
+// generations that are kept, read oldest first, must hold each thread's lines in order up to that one:
+//   gcc -O2 -DLOG_FILE_UNIT_TEST log_file.c -lpthread && ./a.out
+//   gcc -O2 -DLOG_FILE_UNIT_TEST -DLOG_FILE_ZLIB log_file.c -lpthread -lz && ./a.out
+#define TEST_THREADS        4
+#define TEST_LINES          20000
+#define TEST_MAX_SIZE       (64 * 1024)
+#define TEST_GENERATIONS    3
+
+static char test_dir[] = "/tmp/log_file_test_XXXXXX";
+
+static void *test_producer(void *p_arg)
+{
+    uint32_t thread = (uint32_t)(uintptr_t)p_arg;
+    char     line[80];
+    int      i, len;
+
+    for (i = 1; i <= TEST_LINES; i++)
+    {
+        len = snprintf(line, sizeof(line), "%u %06d the quick brown fox jumps over the lazy dog\n", thread, i);
+        log_file_write(line, (uint32_t)len);
+    }
+    return NULL;
+}
+
+// Reads one generation, plain or compressed, and checks its lines. Returns -1 on an error.
+static int test_read(const char *p_name, int *p_last, int *p_files)
+{
+    char     line[128];
+    uint32_t thread;
+    int      number, lines = 0;
+    FILE    *fp;
+#ifdef LOG_FILE_ZLIB
+    gzFile   gz = gzopen(p_name, "rb");
+
+    if (gz == NULL)
+        return 0;
+    while (gzgets(gz, line, sizeof(line)) != NULL)
+#else
+    if ((fp = fopen(p_name, "r")) == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+#endif
+    {
+        if ((sscanf(line, "%u %d", &thread, &number) != 2) || (thread >= TEST_THREADS) ||
+            (line[strlen(line) - 1] != '\n') || ((p_last[thread] != 0) && (number != p_last[thread] + 1)))
+        {
+            printf("%s: bad line %s", p_name, line);
+            lines = -1;
+            break;
+        }
+        p_last[thread] = number;
+        lines++;
+    }
+#ifdef LOG_FILE_ZLIB
+    gzclose(gz);
+    (void)fp;
+#else
+    fclose(fp);
+#endif
+    (*p_files)++;
+    return lines;
+}
+
+int main(void)
+{
+#ifdef LOG_FILE_ZLIB
+    LOG_FILE_CONFIG config = { TEST_MAX_SIZE, TEST_GENERATIONS, 20, 1 };
+#else
+    LOG_FILE_CONFIG config = { TEST_MAX_SIZE, TEST_GENERATIONS, 20, 0 };
+#endif
+    LOG_FILE_STATS  stats;
+    pthread_t       threads[TEST_THREADS];
+    char            path[LOG_FILE_NAME_MAX], name[LOG_FILE_GEN_NAME_MAX];
+    struct stat     st;
+    int             last[TEST_THREADS] = { 0 };
+    int             i, gz, files = 0, failed = 0;
+
+    if (mkdtemp(test_dir) == NULL)
+        return 1;
+    snprintf(path, sizeof(path), "%s/meshcore.log", test_dir);
+    log_file_set_config(&config);
+
+    // A flushed line is in the file, the size counts what was there before
+    if (!log_file_open(path))
+        return 1;
+    log_file_write("0 000000 first\n", 15);
+    log_file_flush();
+    if ((stat(path, &st) != 0) || (st.st_size != 15))
+        failed = 1;
+    log_file_close();
+    if (!log_file_open(path) || (log_file_size != 15))
+        failed = 1;
+
+    for (i = 0; i < TEST_THREADS; i++)
+        pthread_create(&threads[i], NULL, test_producer, (void *)(uintptr_t)i);
+    for (i = 0; i < TEST_THREADS; i++)
+        pthread_join(threads[i], NULL);
+    for (i = 0; i < TEST_THREADS; i++)
+    {
+        snprintf(name, sizeof(name), "%d %06d last\n", i, TEST_LINES + 1);
+        log_file_write(name, (uint32_t)strlen(name));
+    }
+    log_file_close();
+    log_file_get_stats(&stats);
+
+    // Oldest generation first, no file over the limit, nothing beyond the last generation
+    for (i = TEST_GENERATIONS; i >= 0; i--)
+    {
+        for (gz = 0; gz < 2; gz++)
+        {
+            if (i == 0)
+                strcpy(name, path);
+            else
+                log_file_generation_name(name, (uint32_t)i, gz);
+            if ((stat(name, &st) == 0) && !gz && (st.st_size > TEST_MAX_SIZE))
+                failed = 1;
+            if (test_read(name, last, &files) < 0)
+                failed = 1;
+            remove(name);
+            if (i == 0)
+                break;
+        }
+    }
+    log_file_generation_name(name, TEST_GENERATIONS + 1, 0);
+    if (stat(name, &st) == 0)
+        failed = 1;
+    for (i = 0; i < TEST_THREADS; i++)
+        if (last[i] != TEST_LINES + 1)
+            failed = 1;
+
+    printf("bytes:%llu writes:%u rotations:%u compressed:%u waits:%u errors:%u files:%d\n",
+           (unsigned long long)stats.bytes, stats.writes, stats.rotations, stats.compressed, stats.waits, stats.errors, files);
+    if ((files != TEST_GENERATIONS + 1) || (stats.errors != 0) || (stats.rotations == 0) ||
+        (config.compress && (stats.compressed != stats.rotations)))
+        failed = 1;
+    rmdir(test_dir);
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Buffered log file writer.
+ *
+ * Logging threads copy their lines into a large buffer and return, a writer thread writes the
+ * buffer out when it is half full or the flush interval has passed. The writer keeps the size
+ * of the file itself and rotates it to numbered generations, path.1 being the newest, and with
+ * LOG_FILE_ZLIB defined it can gzip the closed generations between buffer writes.
+ */
+#ifndef __LOG_FILE_H__
+#define __LOG_FILE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define LOG_FILE_BUFFER_SIZE            (256 * 1024)        // each of the two buffers
+#define LOG_FILE_DEFAULT_MAX_SIZE       (20 * 1024 * 1024)  // a generation, enough for any single mesh operation
+#define LOG_FILE_DEFAULT_GENERATIONS    1
+#define LOG_FILE_DEFAULT_FLUSH_MS       1000
+
+typedef struct
+{
+    uint32_t    max_size;               /* bytes of the log file before it is rotated, 0 for no limit */
+    uint32_t    generations;            /* closed files kept as path.1 .. path.N, 0 to drop them */
+    uint32_t    flush_interval_ms;      /* longest time a line stays in the buffer */
+    int         compress;               /* gzip closed files to path.N.gz, ignored without LOG_FILE_ZLIB */
+} LOG_FILE_CONFIG;
+
+typedef struct
+{
+    uint64_t    bytes;                  /* bytes written to the files */
+    uint32_t    writes;                 /* buffers written */
+    uint32_t    rotations;
+    uint32_t    compressed;             /* generations compressed */
+    uint32_t    waits;                  /* times a logging thread waited for the writer */
+    uint32_t    errors;                 /* failed writes, opens and renames */
+} LOG_FILE_STATS;
+
+/* Opens path for appending and starts the writer, a file already open is closed first.
+ * Returns 0 if the file cannot be opened. */
+int  log_file_open(const char *p_path);
+
+/* Writes out everything buffered, stops the writer and closes the file */
+void log_file_close(void);
+
+/* Copies the text into the buffer, does nothing while no file is open. Waits only when both
+ * buffers are full, so no line is lost. */
+void log_file_write(const char *p_text, uint32_t len);
+
+/* Returns once everything written so far is in the file */
+void log_file_flush(void);
+
+/* Takes effect at the next buffer write, can be called with the file open or closed */
+void log_file_set_config(const LOG_FILE_CONFIG *p_config);
+void log_file_get_config(LOG_FILE_CONFIG *p_config);
+
+void log_file_get_stats(LOG_FILE_STATS *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_FILE_H__ */
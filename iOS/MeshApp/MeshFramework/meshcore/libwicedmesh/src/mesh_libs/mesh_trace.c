@@ -0,0 +1,306 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+/** @file
+ *
+ * Trace category registry, see mesh_trace.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "mesh_trace.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#define MESH_TRACE_CAS(p, old, new)     (InterlockedCompareExchange((volatile LONG *)(p), (LONG)(new), (LONG)(old)) == (LONG)(old))
+#else
+#define MESH_TRACE_CAS(p, old, new)     __sync_bool_compare_and_swap((p), (old), (new))
+#endif
+
+#define MESH_TRACE_ALL_MASK     ((1u << (MESH_TRACE_CATEGORIES * 4)) - 1)
+
+volatile uint32_t mesh_trace_levels = MESH_TRACE_DEFAULT_LEVEL * (MESH_TRACE_ALL_MASK / 0xF);
+
+static const char *mesh_trace_category_names[MESH_TRACE_CATEGORIES] =
+{
+    "timer", "gatt", "adv", "prov", "dfu", "jni", "crypto"
+};
+
+static const char *mesh_trace_level_names[] =
+{
+    "off", "error", "info", "debug", "verbose"
+};
+
+#define MESH_TRACE_LEVELS   (sizeof(mesh_trace_level_names) / sizeof(mesh_trace_level_names[0]))
+
+// Returns the levels with the category or all of them changed
+static uint32_t mesh_trace_apply(uint32_t levels, int category, int level)
+{
+    if (category == MESH_TRACE_ALL)
+        return (uint32_t)level * (MESH_TRACE_ALL_MASK / 0xF);
+
+    return (levels & ~(0xFu << (category * 4))) | ((uint32_t)level << (category * 4));
+}
+
+int mesh_trace_set_level(int category, int level)
+{
+    uint32_t levels;
+
+    if ((category < MESH_TRACE_ALL) || (category >= MESH_TRACE_CATEGORIES) || (level < 0) || (level >= (int)MESH_TRACE_LEVELS))
+        return -1;
+
+    do
+    {
+        levels = mesh_trace_levels;
+    } while (!MESH_TRACE_CAS(&mesh_trace_levels, levels, mesh_trace_apply(levels, category, level)));
+
+    return 0;
+}
+
+int mesh_trace_get_level(int category)
+{
+    if ((category < 0) || (category >= MESH_TRACE_CATEGORIES))
+        return -1;
+
+    return (int)((mesh_trace_levels >> (category * 4)) & 0xF);
+}
+
+const char *mesh_trace_category_name(int category)
+{
+    if (category == MESH_TRACE_ALL)
+        return "all";
+    if ((category < 0) || (category >= MESH_TRACE_CATEGORIES))
+        return "?";
+    return mesh_trace_category_names[category];
+}
+
+const char *mesh_trace_level_name(int level)
+{
+    if ((level < 0) || (level >= (int)MESH_TRACE_LEVELS))
+        return "?";
+    return mesh_trace_level_names[level];
+}
+
+// Case insensitive compare of len characters of p_str to a complete name
+static int mesh_trace_match(const char *p_str, size_t len, const char *p_name)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((p_name[i] == 0) || (tolower((unsigned char)p_str[i]) != p_name[i]))
+            return 0;
+    }
+    return p_name[len] == 0;
+}
+
+static int mesh_trace_parse_level(const char *p_str, size_t len)
+{
+    size_t i;
+
+    if ((len == 1) && (p_str[0] >= '0') && (p_str[0] < '0' + (int)MESH_TRACE_LEVELS))
+        return p_str[0] - '0';
+
+    for (i = 0; i < MESH_TRACE_LEVELS; i++)
+    {
+        if (mesh_trace_match(p_str, len, mesh_trace_level_names[i]))
+            return (int)i;
+    }
+    return -1;
+}
+
+int mesh_trace_configure(const char *p_spec)
+{
+    uint32_t    levels, new_levels;
+    const char *p_item, *p_end, *p_value;
+    int         category, level, i;
+
+    if (p_spec == NULL)
+        return -1;
+
+    // Parse into a copy and store it at once, an invalid item leaves the levels unchanged
+    do
+    {
+        levels     = mesh_trace_levels;
+        new_levels = levels;
+
+        for (p_item = p_spec; *p_item != 0; p_item = p_end)
+        {
+            while ((*p_item == ',') || isspace((unsigned char)*p_item))
+                p_item++;
+            if (*p_item == 0)
+                break;
+
+            for (p_end = p_item; (*p_end != 0) && (*p_end != ',') && !isspace((unsigned char)*p_end); p_end++)
+                ;
+            for (p_value = p_item; (p_value < p_end) && (*p_value != '='); p_value++)
+                ;
+
+            if (p_value == p_end)
+            {
+                // A level alone applies to all categories
+                category = MESH_TRACE_ALL;
+                p_value  = p_item;
+            }
+            else
+            {
+                category = -2;
+                if (mesh_trace_match(p_item, p_value - p_item, "all"))
+                    category = MESH_TRACE_ALL;
+                for (i = 0; i < MESH_TRACE_CATEGORIES; i++)
+                {
+                    if (mesh_trace_match(p_item, p_value - p_item, mesh_trace_category_names[i]))
+                        category = i;
+                }
+                if (category == -2)
+                    return -1;
+                p_value++;
+            }
+
+            if ((level = mesh_trace_parse_level(p_value, p_end - p_value)) < 0)
+                return -1;
+
+            new_levels = mesh_trace_apply(new_levels, category, level);
+        }
+    } while (!MESH_TRACE_CAS(&mesh_trace_levels, levels, new_levels));
+
+    return 0;
+}
+
+int mesh_trace_describe(char *p_buf, int len)
+{
+    int i, used = 0, n;
+
+    if (len <= 0)
+        return 0;
+
+    p_buf[0] = 0;
+    for (i = 0; i < MESH_TRACE_CATEGORIES; i++)
+    {
+        n = snprintf(&p_buf[used], len - used, "%s%s=%s", (i == 0) ? "" : ",",
+                     mesh_trace_category_names[i], mesh_trace_level_name(mesh_trace_get_level(i)));
+        if ((n < 0) || (n >= len - used))
+            return len - 1;
+        used += n;
+    }
+    return used;
+}
+
+#ifdef MESH_TRACE_UNIT_TEST
+// Checks the parser and measures a disabled trace site. The floor is lowered to debug so that the
+// verbose site below must be compiled out:
+//   gcc -O2 -DMESH_TRACE_UNIT_TEST -DMESH_TRACE_LEVEL_FLOOR=3 mesh_trace.c
+#include <stdarg.h>
+#include <time.h>
+
+static uint32_t test_lines;
+static uint32_t test_evaluated;
+
+void ods(char *fmt_str, ...)
+{
+    (void)fmt_str;
+    test_lines++;
+}
+
+static uint32_t test_arg(uint32_t i)
+{
+    test_evaluated++;
+    return i;
+}
+
+static double test_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    char     buf[128];
+    uint32_t i, loops = 100000000;
+    double   start, off_ns, on_ns;
+    int      failed = 0;
+
+    if ((mesh_trace_get_level(MESH_TRACE_TIMER) != MESH_TRACE_DEFAULT_LEVEL) || (mesh_trace_get_level(MESH_TRACE_CRYPTO) != MESH_TRACE_DEFAULT_LEVEL))
+        failed = 1;
+
+    if ((mesh_trace_configure("all=off, timer=verbose,GATT=2 4") != 0) || (mesh_trace_get_level(MESH_TRACE_GATT) != MESH_TRACE_LEVEL_VERBOSE))
+        failed = 1;
+    if ((mesh_trace_configure("off,timer=debug jni=error") != 0) || (mesh_trace_get_level(MESH_TRACE_TIMER) != MESH_TRACE_LEVEL_DEBUG) ||
+        (mesh_trace_get_level(MESH_TRACE_JNI) != MESH_TRACE_LEVEL_ERROR) || (mesh_trace_get_level(MESH_TRACE_ADV) != MESH_TRACE_LEVEL_OFF))
+        failed = 1;
+
+    // Invalid items change nothing
+    if ((mesh_trace_configure("adv=info,bogus=info") == 0) || (mesh_trace_configure("adv=loud") == 0) ||
+        (mesh_trace_configure("timerx=info") == 0) || (mesh_trace_get_level(MESH_TRACE_ADV) != MESH_TRACE_LEVEL_OFF))
+        failed = 1;
+    if ((mesh_trace_set_level(MESH_TRACE_CATEGORIES, 1) == 0) || (mesh_trace_set_level(MESH_TRACE_ALL, 5) == 0))
+        failed = 1;
+
+    mesh_trace_describe(buf, sizeof(buf));
+    printf("%s\n", buf);
+    if (strcmp(buf, "timer=debug,gatt=off,adv=off,prov=off,dfu=off,jni=error,crypto=off") != 0)
+        failed = 1;
+
+    // Verbose is above the floor of this build, debug is written, arguments of skipped sites are not evaluated
+    mesh_trace_set_level(MESH_TRACE_ALL, MESH_TRACE_LEVEL_VERBOSE);
+    MESH_TRACE_VERBOSE(MESH_TRACE_TIMER, "%u", test_arg(1));
+    MESH_TRACE_DEBUG(MESH_TRACE_TIMER, "%u", test_arg(2));
+    mesh_trace_set_level(MESH_TRACE_TIMER, MESH_TRACE_LEVEL_INFO);
+    MESH_TRACE_DEBUG(MESH_TRACE_TIMER, "%u", test_arg(3));
+    if ((test_lines != 1) || (test_evaluated != 1))
+        failed = 1;
+
+    // Cost of a disabled site and of the same loop without any trace
+    start = test_seconds();
+    for (i = 0; i < loops; i++)
+        MESH_TRACE_DEBUG(MESH_TRACE_TIMER, "timer %u\n", test_arg(i));
+    off_ns = (test_seconds() - start) * 1e9 / loops;
+
+    start = test_seconds();
+    for (i = 0; i < loops; i++)
+        __asm__ volatile("" : : "r"(i) : "memory");
+    on_ns = (test_seconds() - start) * 1e9 / loops;
+    printf("disabled site: %.2f ns, empty loop: %.2f ns\n", off_ns, on_ns);
+    if (test_lines != 1 || test_evaluated != 1)
+        failed = 1;
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
+#endif
@@ -97,4 +97,522 @@ void p_256_init_curve(uint32_t keyLength)
     }
 }
 
+// Generator comb table for ECC_PM_Comb_G: entry i-1 is the affine point
+// sum(bit j of i * 2^(j*COMB_SPACING)) * G, x and y least significant DWORD
+// first. Generated by the P256_UNIT_TEST build of p_256_ecc_pp.c with
+// -DP256_COMB_GEN, which also checks it.
+const DWORD p256_comb_G[COMB_POINTS][2][KEY_LENGTH_DWORDS_P256] =
+{
+    {{0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81, 0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2},
+     {0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357, 0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2}},
+    {{0x185a5943, 0x3a5a9e22, 0x5c65dfb6, 0x1ab91936, 0x262c71da, 0x21656b32, 0xaf22af89, 0x7fe36b40},
+     {0x699ca101, 0xd50d152c, 0x7b8af212, 0x74b3d586, 0x07dca6f1, 0x9f09f404, 0x25b63624, 0xe697d458}},
+    {{0x8101e6e4, 0x16fc51ff, 0xfccc3ac2, 0x830895e4, 0x4aa7358f, 0x608548c2, 0x0cedc02a, 0xe3579822},
+     {0x52c392c3, 0xaad2b998, 0xc523e6ef, 0xf0570bed, 0x768a3299, 0xf3e4b396, 0x1f433a2d, 0x700f948e}},
+    {{0x8e14db63, 0x90e75cb4, 0xad651f7e, 0x29493baa, 0x326e25de, 0x8492592e, 0x2811aaa5, 0x0fa822bc},
+     {0x5f462ee7, 0xe4112454, 0x50fe82f5, 0x34b1a650, 0xb3df188b, 0x6f4ad4bc, 0xf5dba80d, 0xbff44ae8}},
+    {{0x097992af, 0x93391ce2, 0x0d35f1fa, 0xe96c98fd, 0x95e02789, 0xb257c0de, 0x89d6726f, 0x300a4bbc},
+     {0xc08127a0, 0xaa54a291, 0xa9d806a5, 0x5bb1eead, 0xff1e3c6f, 0x7f1ddb25, 0xd09b4644, 0x72aac7e0}},
+    {{0xee4039a0, 0xd6e260f8, 0x6c224571, 0xe0d3eb33, 0x680a7daa, 0xa9cad33b, 0x606a4a62, 0x14cb5692},
+     {0x9d83bc01, 0xfe93d315, 0x8039927c, 0x5205ef8d, 0x997a9a3b, 0x878487ed, 0x3e1e4663, 0x53098cfa}},
+    {{0xd945111e, 0x30368cb6, 0xf5c4ad42, 0x585a137e, 0xffea17c1, 0xc22c48c5, 0x958f1608, 0xa5ab9e10},
+     {0x785b4ed9, 0xc34a47b8, 0x49a10f77, 0x46ed771c, 0xad0648f4, 0x629e17eb, 0x8b1aa09a, 0xd3ebc611}},
+    {{0x7512218e, 0xa84aa939, 0x74ca0141, 0xe9a521b0, 0x18a2e902, 0x57880b3a, 0x12a677a6, 0x4a5b5066},
+     {0x4c4f3840, 0x0beada7a, 0x19e26d9d, 0x626db154, 0xe1627d40, 0xc42604fb, 0xeac089f1, 0xeb13461c}},
+    {{0xcc049786, 0xc761c1fe, 0x5e98c12d, 0x48f9c187, 0xfd208dfb, 0x00d1a0a5, 0xa0642197, 0x418d68de},
+     {0x51b50759, 0x481eef55, 0xc16caad0, 0x17429c50, 0x2ef8d320, 0x43563962, 0xa5ba6dd4, 0x5d7b26f6}},
+    {{0x27a43281, 0xf9faed09, 0x4103ecbc, 0x5e52c414, 0xa815c857, 0xc342967a, 0x1c6a220a, 0x0781b829},
+     {0xeac55f80, 0x5a8343ce, 0xe54a05e3, 0x88f80eee, 0x12916434, 0x97b2a14f, 0xf0151593, 0x690cde8d}},
+    {{0xe38e3820, 0xc52c00ca, 0xdd561bec, 0x82d789a6, 0x74647ebe, 0x54a0fe52, 0xa7b5d4fb, 0x57f62eec},
+     {0x48f81460, 0xaa60759d, 0xec356dce, 0x0d300594, 0xefea8f48, 0x60e9c067, 0x89bfe2ad, 0x5e5ff8bf}},
+    {{0xfa3289d5, 0x5920d7b0, 0x28994439, 0x54d5dad9, 0x27caa747, 0x27035d26, 0x88e9843c, 0x91c821d4},
+     {0x9aa8a566, 0xe130dead, 0x0408ebad, 0x7b7df6ea, 0x34938dac, 0x919adc37, 0x8f879f44, 0xdb7aecc7}},
+    {{0xc6fae6d7, 0xbc499ee7, 0x7e1c792e, 0xeddf9c6c, 0x5bf70c35, 0xc9c6f541, 0x90422d81, 0x06f0afdb},
+     {0x4dbc747a, 0x214f0ad0, 0xaf7ae617, 0x41a7cf1a, 0xdde64646, 0x7bab8955, 0x3f9804c4, 0x77f9e8f7}},
+    {{0xc96900d8, 0x5d01a765, 0x5e4ec965, 0xf0698ff7, 0xbcdf6567, 0x92052d44, 0xd6536c02, 0xbc07bb82},
+     {0x83762c71, 0x5fe58ccf, 0xc2e7ba73, 0x635f210e, 0xc7b19a1e, 0xa17bf29f, 0x1d90902a, 0xeb165f9c}},
+    {{0xf2159928, 0xaf972b45, 0x4760c41e, 0xd86848c8, 0x6b47957b, 0x269843f1, 0x2086a46c, 0xe018aaa2},
+     {0x99698420, 0x21a03322, 0x4fed7bb9, 0xd36d88b3, 0xba0dbc83, 0xf2fe8863, 0x7f10ee50, 0x383f4db0}},
+    {{0xd789bd85, 0x57c84fc9, 0xc297eac3, 0xfc35ff7d, 0x88c6766e, 0xfb982fd5, 0xeedb5e67, 0x447d739b},
+     {0x72e25b32, 0x0c7e33c9, 0xa7fae500, 0x3d349b95, 0x3a4aaff7, 0xe12e9d95, 0x834131ee, 0x2d4825ab}},
+    {{0x2a1d367f, 0x13949c93, 0x1a0a11b7, 0xef7fbd2b, 0xb91dfc60, 0xddc6068b, 0x8a9c72ff, 0xef951932},
+     {0x7376d8a8, 0x196035a7, 0x95ca1740, 0x23183b08, 0x022c219c, 0xc1ee9807, 0x7dbb2c9b, 0x611e9fc3}},
+    {{0x0af44892, 0x9dda03e1, 0xffa77f1e, 0xdd78a219, 0x8aee6cba, 0x67aa472a, 0xa822a856, 0xe42c3142},
+     {0xf20db957, 0xbee346fe, 0xd00f7365, 0xbd464186, 0x032c4f8e, 0x21774e51, 0xc011817a, 0x8ad034d0}},
+    {{0xd94b1a05, 0x1f969276, 0xadf9e430, 0xca9b1154, 0x4b3cf7fb, 0x8930de36, 0xb9a7112b, 0x4ee298bb},
+     {0xcaba1c4a, 0xc7551f59, 0xfb972962, 0x79a86b84, 0xb38a628c, 0xe47c8ac6, 0x463a6a4c, 0x2cbbf338}},
+    {{0x0b57f4bc, 0xcae2b192, 0xc6c9bc36, 0x2936df5e, 0xe11238bf, 0x7dea6482, 0x7b51f5d8, 0x55066379},
+     {0x348a964c, 0x44ffe216, 0xdbdefbe1, 0x9fb3d576, 0x8d9d50e5, 0x0afa4001, 0x8aecb851, 0x15716484}},
+    {{0xfc5cde01, 0xe48ecaff, 0x0d715f26, 0x7ccd84e7, 0xf43e4391, 0xa2e8f483, 0xb21141ea, 0xeb5d7745},
+     {0x731a3479, 0xcac917e2, 0x2844b645, 0x85f22cfe, 0x58006cee, 0x0990e6a1, 0xdbecc17b, 0xeafd72eb}},
+    {{0xa7dde09f, 0x9f95a5ab, 0x221aa522, 0xc1e70873, 0x724a8b0a, 0x3774353a, 0xf0fe9dfe, 0xb942b33f},
+     {0x34fc7653, 0xe9601ac3, 0xc2beaa26, 0xae3e0880, 0x4fab6ae5, 0xd6c52e03, 0xa61e51ef, 0x0b909273}},
+    {{0x1a780592, 0x91ba25b5, 0x1500d337, 0xee59a574, 0x9288e474, 0xe36f1c44, 0xd85f6d65, 0xd3e89acc},
+     {0xd8871d87, 0x0f5590ec, 0x92e2f47a, 0x565c81ca, 0x841fb007, 0x55942307, 0xa5dc1163, 0xa4f12b40}},
+    {{0x471bd072, 0x298ad9c1, 0xf6d4b375, 0xb286a3b3, 0xda5f8abd, 0xb6cbd28c, 0x700ba968, 0x529dc0b0},
+     {0xaa8c414a, 0x44672963, 0xbc3089da, 0x99685e9c, 0x1e39fce6, 0x9ab4c983, 0xc49bc6a7, 0x9b5426c7}},
+    {{0xab0c3e88, 0x1fe36ffc, 0xba8303d2, 0xc2b3b386, 0xadc757ca, 0x72aabf6e, 0x5eec7013, 0x1240b6fd},
+     {0x1a9310a3, 0x106308a8, 0x2c136832, 0xb9f4ab88, 0xf43cc68f, 0x48a48000, 0x214b70d9, 0xe54f16a7}},
+    {{0x0fee06c8, 0xd9d5e5c8, 0x41d13f39, 0x8bf29817, 0xfdaa2b5f, 0x7f25bf81, 0x5ec68bbf, 0x0a70f85c},
+     {0xd5e4d954, 0xf2cfc922, 0x83421b3d, 0x5d404051, 0x20a2e32f, 0x383e025c, 0x848ef239, 0x63228d59}},
+    {{0x52ffcef3, 0xbaf7d307, 0x9eec8a3e, 0x46b57e18, 0xf7ea3bdb, 0x77a91d71, 0x2bc76af7, 0x771f4575},
+     {0xfce5c8b5, 0xd918b424, 0x53df5f8f, 0xef6a2851, 0x2615a6d0, 0xc375b434, 0x42161a6e, 0x32e41149}},
+    {{0x5543f33f, 0xfa268bc1, 0x79a1e862, 0x057848f6, 0xe778c5d5, 0x2acc9e80, 0x1f24fb5c, 0x81cf6721},
+     {0x0f94bce2, 0x87656e35, 0x9851bb7e, 0x9650c9c8, 0x92e85c53, 0x0d41954d, 0x45b0a71a, 0xef55045a}},
+    {{0x9ef0f09e, 0xea5d651d, 0xcad74dc7, 0x2fe6a994, 0x8003a37e, 0xa6c44b75, 0x8579357a, 0xdb525471},
+     {0x2ed0f0b1, 0x8732a3e3, 0xb0bb5647, 0xbe207a55, 0x32d4eceb, 0x4335fde2, 0x72c4ad3e, 0x91b67e63}},
+    {{0xab018c7e, 0xcdedcb0d, 0xad8cee06, 0xf29e7e82, 0xc417b614, 0x7ce355b7, 0xf8bff7eb, 0xcd20145a},
+     {0xe5457eb3, 0xaec6a202, 0x75459f98, 0xef934b95, 0xc00f55de, 0x10475df1, 0xcb510c09, 0xd4619f15}},
+    {{0x152b9a0e, 0x7ff55fc4, 0x8473875d, 0x3f68c71c, 0x57862556, 0xe52b3f50, 0x97b14c6e, 0xe3ddb10a},
+     {0x68dba9f2, 0x36758574, 0xd269de87, 0xd1d4f5dd, 0x41c3def2, 0x57392917, 0x72836177, 0xd3b0f1bf}},
+    {{0xf7f82f2a, 0xaee9c75d, 0x4afdf43a, 0x9e4c3587, 0x37371326, 0xf5622df4, 0x6ec73617, 0x8a535f56},
+     {0x223094b7, 0xc5f9a0ac, 0x4c8c7669, 0xcde53386, 0x085a92bf, 0x37e02819, 0x68b08bd7, 0x0455c084}},
+    {{0x374e4457, 0x9bf49908, 0x5eecb703, 0x40bf984b, 0x68f1f6f1, 0x9b6f997e, 0x9d565a0c, 0x47b54b04},
+     {0x69900111, 0x241301c3, 0x776f48bb, 0x4e2a6ea3, 0x0feb1cc1, 0x77368e75, 0x15a4a7df, 0xe7afea29}},
+    {{0x9477b5d9, 0x0c0a6e2c, 0x876dc444, 0xf9a4bf62, 0xb6cdc279, 0x5050a949, 0xb77f8276, 0x06bada7a},
+     {0xea48dac9, 0xc8b4aed1, 0x7ea1070f, 0xdebd8a4b, 0x1366eb70, 0x427d4910, 0x0e6cb18a, 0x5b476dfd}},
+    {{0xd961d446, 0x03220fb8, 0x0626c5d7, 0x176324e4, 0x722425cc, 0xd43b2ebc, 0x86dbc8f8, 0x29d6274e},
+     {0xc08d73db, 0x58185a44, 0xe1239ea5, 0x9c8c1cbf, 0xbac64731, 0x2b1cfe87, 0xa5816948, 0x6c16b472}},
+    {{0x23a81ffb, 0xe2753cb1, 0xb82a9f20, 0x22278fa5, 0xf09c4be2, 0x4b032745, 0x059ffd23, 0x5f68c836},
+     {0x1dbf8f8d, 0xbf3ae369, 0xf9fb8d66, 0xb2b1552c, 0x34925367, 0x0c84bfb3, 0x9e109af7, 0x0639e57e}},
+    {{0xc60c4684, 0xd8218845, 0x0859a19e, 0x66a66447, 0x3ed6dfca, 0x9e18931e, 0x6fea0609, 0x3b5b03e6},
+     {0xa9d7edbb, 0xd8bc19b5, 0x64477877, 0x95ffd112, 0xf35c8263, 0x2cd1ca07, 0x38e14ddc, 0x76f1e0c8}},
+    {{0x611d1a41, 0xa3d21037, 0x4b11663f, 0x62b730a1, 0xedf0f22e, 0x9ebd9fa2, 0xcb79ea5a, 0x2c1a2336},
+     {0xac53b363, 0x294b5675, 0x729cb7fe, 0x2c2988be, 0xb587c2e9, 0x146454ff, 0x1dfc32e7, 0x2e1c4770}},
+    {{0x67429e4d, 0x8722658c, 0x0561f51e, 0xbe9522aa, 0xd9d59f46, 0x3d622057, 0x89ef69a2, 0x76e96b46},
+     {0xb797faed, 0x16aa0650, 0x15ff8993, 0x75b78e22, 0x27f9fb88, 0x1575c0cb, 0xf705e319, 0xcf218959}},
+    {{0x278c340a, 0x7c5c3e44, 0x12d66f3b, 0x4d546068, 0xae23c5d8, 0x29a751b1, 0x8a2ec908, 0x3e29864e},
+     {0x26dbb850, 0x142d2a66, 0x765bd780, 0xad1744c4, 0xe322d1ed, 0x1f150e68, 0x3dc31e7e, 0x239b90ea}},
+    {{0x87617f0e, 0xcf15dc9c, 0x6858d44b, 0x85b40dee, 0x121421de, 0xa96c9e4b, 0x05d45c5a, 0x191eb33a},
+     {0x199cf43b, 0xc9c16e10, 0x28ee6e02, 0xf245c57b, 0x45e9654f, 0xf3eb80dd, 0x592282a1, 0x8a9365ff}},
+    {{0x7a53322a, 0x78c41652, 0x09776f8e, 0x305dde67, 0xf8862ed4, 0xdbcab759, 0x49f72ff7, 0x820f4dd9},
+     {0x2b5debd4, 0x6cc544a6, 0x7b4e8cc4, 0x75be5d93, 0x215c14d3, 0x1b481b1b, 0x783a05ec, 0x140406ec}},
+    {{0x7e0e3190, 0x44f65f50, 0xea3f501a, 0x1370d12f, 0x8c6615b0, 0xb8635f9a, 0xb3cd1c0f, 0xff29dc0f},
+     {0x738114f6, 0x07f8a15d, 0xeecc62e3, 0x14def0ab, 0x09b8e6b6, 0x24dd6595, 0x3439a422, 0xc43831f3}},
+    {{0x93501899, 0x42293cdf, 0x1cc1e2e5, 0xe7f0390c, 0xcbf28253, 0xe1ef732a, 0x1f2b6b79, 0xe21f15f3},
+     {0xd622619a, 0xcfc0f97c, 0x726b5a08, 0xc056b494, 0x4d24ee97, 0x38c94cb1, 0xbc052d44, 0x4a3fc23c}},
+    {{0x60d54267, 0xa30935f7, 0x652f6cd5, 0x5c5093ba, 0x0b854da9, 0x8720d196, 0x2c10d86c, 0xf361d706},
+     {0x723b99e4, 0xd11a3d27, 0x2f7d40c8, 0x8a18ce4b, 0xc3d3516d, 0x44bdb2fa, 0x6b183cfb, 0x2c990dbb}},
+    {{0x96480ca6, 0xed303f4c, 0xce200b86, 0xe2dbe559, 0x4ceb95a3, 0x87704e32, 0x21cd1c8d, 0x5991daa2},
+     {0x75c04ee0, 0x20a4bdad, 0xd3ab3659, 0x9fe5ed7d, 0x1dd427e8, 0x0efb4bea, 0x8ce1431a, 0xde5d5896}},
+    {{0xa52342b3, 0xaf31d989, 0xc03eb194, 0x918e1fb4, 0x6b6cb7b9, 0x303e35f0, 0xe062a8c2, 0x33fef524},
+     {0x512e5bc0, 0x692a4fbe, 0xf5162c74, 0x067cfb0d, 0x20859bd2, 0x519ad6ff, 0xd84dbd4e, 0x0a5b4caa}},
+    {{0xfbb7f12d, 0x4193640b, 0xdfd6c3f3, 0xef8bf285, 0x010729ac, 0x23fe7442, 0x2c214cd9, 0xff25f55a},
+     {0xf30f0fc8, 0xd77bf411, 0x2ab82b74, 0x1a08ebc7, 0x74a58d77, 0x00c15ba7, 0x8a405100, 0x94f114d3}},
+    {{0xd0a62b2c, 0x1fd07ab7, 0x9f776819, 0x31c6f056, 0x8edc0d13, 0xe0443b93, 0x63ae46a6, 0x1b9d594e},
+     {0xc14453e5, 0x5ab358fc, 0x9a58ab51, 0xfb52863b, 0x01683cef, 0x473ab211, 0xed96c8e1, 0xed16ba54}},
+    {{0x29ba369a, 0x2641769d, 0xcd922263, 0xe498612f, 0x1898ead9, 0x861b8e4c, 0x95baf610, 0xc3948bd4},
+     {0x3ff24345, 0xb529a79b, 0xbe0a3da8, 0xa2b8624a, 0x94743717, 0x2f5b7f80, 0x218a7b61, 0xbe92ada7}},
+    {{0xfd943a71, 0xef977470, 0xef2d93e1, 0x2dbfbc52, 0x62b812a7, 0xfbe20b47, 0x3ef44b43, 0xa1547557},
+     {0x89bc18d0, 0xf18068cb, 0xb7e40a72, 0xd0702163, 0x92efaf4f, 0xb5115ad4, 0x8c4b8a43, 0x384d5627}},
+    {{0xc0b0755e, 0x80d58211, 0xb4cacf23, 0xca274a6d, 0xecf21b69, 0xae21f1b4, 0x03b2b318, 0x8d84f419},
+     {0x9f10418f, 0xc518f894, 0xd91762a0, 0xc73b5fdf, 0xec26c110, 0xc98ecbf6, 0x6953fd62, 0x15bcd7d0}},
+    {{0x061457fe, 0xc877db08, 0xc6471595, 0x60eb5c88, 0x808ec0ed, 0x03ce1e41, 0xe27f462a, 0x4a014325},
+     {0xa4fba4fc, 0x7961a1cd, 0x662743c7, 0x206d4beb, 0x41cda791, 0x47f12714, 0x2f381bb9, 0xb069f7e0}},
+    {{0xcb87dea8, 0x6e6f4859, 0x39546374, 0x4787ec66, 0x6121b977, 0x1cbf27b3, 0x44e182ab, 0xca7ee915},
+     {0x7f985b5b, 0x40bd566d, 0x6d5fdb9a, 0x4225339a, 0x2fc8c2a3, 0x4cd02584, 0x70f14a3d, 0x0d4c0016}},
+    {{0x9b6d8676, 0x9a89a4cc, 0xad3055b9, 0xcbe46247, 0x6b4f6a92, 0x8a8c8b10, 0x570e8f0f, 0xd96633a7},
+     {0xe8b04cc1, 0xd1fda6e8, 0x40ba4a72, 0x215d4ce6, 0xf64c3358, 0xd7533270, 0x9825b9fd, 0x4d144dea}},
+    {{0x66fdc380, 0xa3baaf1d, 0x4cd0c836, 0x1b08f73d, 0x9d67ff49, 0x563f9fba, 0x5af864ec, 0x1577aca8},
+     {0x0c0b7b43, 0xe61a8c7e, 0xa8e5ec0a, 0xcdbe96b5, 0x8e1d9252, 0xe3061205, 0x138e5ef8, 0x78286cc9}},
+    {{0x253bcbf0, 0x0f8364c4, 0x03bb9180, 0xf26390c7, 0xad1e3bb3, 0x4ebccda4, 0x85a5d1eb, 0xb08c91a3},
+     {0xb643475c, 0x60dc9158, 0x2ba0101b, 0x39bd97d6, 0xc502fbe0, 0x6fd29d96, 0x3158a73c, 0xb8fe20c1}},
+    {{0xe0106368, 0xfc0ddf3b, 0x93f52b68, 0xd3c72ba5, 0xa8787924, 0x7c6bdf85, 0x532189d3, 0x9645c64a},
+     {0x824e2771, 0x58d3cc9b, 0x6e82dc91, 0x9b7e75e1, 0xe0ed1cc0, 0xbf4ec9f6, 0x3260f488, 0xffb683e6}},
+    {{0xa4f0c81b, 0x8821c701, 0x881d4342, 0xeaa11d49, 0x79a87eef, 0x346fab79, 0x39848086, 0xa9c3643e},
+     {0xf6c6e053, 0xe040a053, 0xe1f9d4ba, 0x0d287400, 0xbd4aa53c, 0xa48cf15d, 0x11e94cef, 0x76cdf40c}},
+    {{0x7ef30e41, 0x3f023041, 0x4ce753c8, 0x9184493f, 0x2a7516ca, 0x5a228849, 0x660402f4, 0x97c0af3a},
+     {0x8a23e934, 0xd0db8ce7, 0xe707a0b2, 0x4f22360c, 0x2032d181, 0xb487dbb9, 0xcb5623fd, 0xc6d1b0f9}},
+    {{0x2bc5c755, 0x8746f483, 0x775a0fe2, 0x3dc6f57f, 0x0f21c2c9, 0x87bccbe9, 0xeae51818, 0xdb93a6b1},
+     {0xa87aa88a, 0xf5754a37, 0x73972e83, 0x2791bf54, 0xdeac962d, 0x65fe92b6, 0x5db3c2a5, 0x7675343a}},
+    {{0x1c77336e, 0x5c2ce444, 0xd14b1a55, 0x6fd6234a, 0x10c24e9e, 0x1e25c808, 0xd88c3194, 0x7e941cef},
+     {0xe4b9453f, 0xbfa7a9ba, 0xdb055169, 0x6256b1bf, 0xd4956f06, 0x835e6cd4, 0x2948048d, 0x7d3bcf9d}},
+    {{0x18064104, 0x82480753, 0x0891878c, 0xf3c2f9c4, 0x29af296d, 0x1d6cbef1, 0x55b9ed41, 0xa57ddaa3},
+     {0x903a1cdf, 0x4f47c7f1, 0x197db90d, 0x45057fcf, 0xca13fa12, 0xc125bb25, 0xd7f746df, 0x5bcfd6f3}},
+    {{0x313728be, 0x6cf20ffb, 0xa3c6b94a, 0x96439591, 0x44315fc5, 0x2736ff83, 0xa7849276, 0xa6d39677},
+     {0xc357f5f4, 0xf2bab833, 0x2284059b, 0x824a920c, 0x2d27ecdf, 0x66b8babd, 0x9b0b8816, 0x674f8474}},
+    {{0x677c8a3e, 0x2df48c04, 0x0203a56b, 0x74e02f08, 0xb8c7fedb, 0x31855f7d, 0x72c9ddad, 0x4e769e76},
+     {0xb824bbb0, 0xa4c36165, 0x3b9122a5, 0xfb9ae16f, 0x06947281, 0x1ec00572, 0xde830663, 0x42b99082}},
+    {{0xbb162b85, 0x40b11c79, 0x5a890653, 0x426e2f71, 0x7586e3c3, 0xe9e180a6, 0x65dbb34a, 0x507b542a},
+     {0xe489b8ad, 0x225f912a, 0x301369c1, 0x33520333, 0xd338ecde, 0xca383ce7, 0xd11a51d6, 0x5eb5701e}},
+    {{0xfbcbc0c3, 0x490e66bc, 0x15065b98, 0xe8d7b164, 0x3e1a841c, 0xf2f80e3e, 0x7696fcf5, 0x62d4a49f},
+     {0xf521f731, 0x86eddee7, 0x77305b14, 0x90337684, 0xf36fa83e, 0x56193ecb, 0xd347d332, 0xd18b33eb}},
+    {{0xdda868b9, 0x6ef95150, 0x9c0ce131, 0xd1f89e79, 0x08a1c478, 0x7fdc1ca0, 0x1c6ce04d, 0x78878ef6},
+     {0x1fe0d976, 0x9c62b912, 0xbde08d4f, 0x6ace570e, 0x12309def, 0xde53142c, 0x7b72c321, 0xb6cb3f5d}},
+    {{0xc31a3573, 0x7f991ed2, 0xd54fb496, 0x5b82dd5b, 0x812ffcae, 0x595c5220, 0x716b1287, 0x0c88bc4d},
+     {0x5f48aca8, 0x3a57bf63, 0xdf2564f3, 0x7c8181f4, 0x9c04e6aa, 0x18d1b5b3, 0xf3901dc6, 0xdd5ddea3}},
+    {{0xfb696d7b, 0x8b030fea, 0x400cfa69, 0x9d11bdca, 0x8fa8a597, 0x3bcfb88d, 0xff476ef0, 0xaa59e783},
+     {0x88f5a016, 0xfbad3413, 0x5c0aba02, 0x2a4147fa, 0xd831450e, 0xda2c96d0, 0x30e77dd1, 0x30a12aad}},
+    {{0x30076ed0, 0xdfa412e5, 0xece43efe, 0x90e7efc3, 0xe9c9c2a2, 0x7d021b57, 0xb498993d, 0xe3ddf1b7},
+     {0x846b4d7e, 0x5b955c48, 0xae7c855e, 0x959131ad, 0x77227a7b, 0x8490e467, 0xa60ce85f, 0x283833a8}},
+    {{0x2fb3062c, 0xfb5a3d22, 0xb65437ec, 0x5682157e, 0x76fd0872, 0x7657711b, 0x4ad70bcc, 0xce6d933a},
+     {0xfc3e65c1, 0xa9cebba1, 0xd4111c9d, 0x0fda9930, 0x9a834dd3, 0xd1edb57b, 0x5d2c8bb7, 0xa8839960}},
+    {{0x8c4150cc, 0x88bc6c8d, 0xad6c3923, 0x73758b21, 0x29928820, 0xd43a7503, 0x95ea9feb, 0x790ecf86},
+     {0x1bfb5292, 0x59a580f7, 0x9f51de15, 0x0f7a900f, 0x9d6239f6, 0xf444c49a, 0xd87decf6, 0xe340d641}},
+    {{0x1026b033, 0x1ebb28ac, 0x3a50d3ac, 0xff199a09, 0xe869a58e, 0xa2c053e4, 0x414dd6be, 0xb05e35aa},
+     {0x6754449f, 0xfbcb4c4a, 0xf8427d60, 0xc25c0899, 0xc5ae69de, 0xd7e45688, 0x6646039a, 0x47270f9c}},
+    {{0xe872889a, 0x0dfab50a, 0x703913a8, 0xfab939d7, 0x16b20242, 0x4ebc7144, 0xd2f8bae8, 0x22bc5020},
+     {0x9d713946, 0xabeaaae6, 0x3ef21012, 0x3c2cd39e, 0xaef98a9b, 0xac67692c, 0x78e64c2e, 0x616222e4}},
+    {{0xb6a8a95d, 0xffcdcc28, 0xf068c865, 0x61948cc6, 0x48a3fbb6, 0x02790b8c, 0x93239bc6, 0xfaa43bed},
+     {0x77a8fe3d, 0x97747046, 0x3e4708bd, 0x5f83ca7a, 0x43482e7d, 0x1388e9e2, 0x026921ca, 0xd21a75f1}},
+    {{0xa15bbae6, 0x7549f1b1, 0x8ba6bbcf, 0xa9c4ebbc, 0x3ab26d77, 0xf3deb351, 0x7f94bbb6, 0xfd3bcf2d},
+     {0x46fe3ddc, 0xfa8344d7, 0xd2f4fdab, 0xbad3e545, 0xf8de5d37, 0xba4ccb8e, 0xd97112db, 0xada514fe}},
+    {{0x8bcf4dbf, 0x017fa5e2, 0x80217643, 0xabcaeada, 0x4bbf5a9f, 0xefb61274, 0x5144598e, 0xf28dc88b},
+     {0xb384a585, 0x2fd4905e, 0x73df56d7, 0x30987256, 0x671dd081, 0xe1913ca6, 0x8249b59b, 0x1a242940}},
+    {{0x1f70723f, 0xda398393, 0xb21ac825, 0x6cfe750a, 0xf4eb6e64, 0x92c6a768, 0x47c9e925, 0x4290db0b},
+     {0x413464c5, 0xf9d2fb88, 0xc8971f1a, 0x64aa8ad3, 0xf2ebcd3c, 0x263bead1, 0x3374c163, 0xb5d01e33}},
+    {{0x3e72ad0c, 0xe96a79fb, 0x42ba792f, 0x43a0a28c, 0x083e49f3, 0xefe0a423, 0x6b317466, 0x68f344af},
+     {0x3fb24d4a, 0xcdfe17db, 0x71f5c626, 0x668bfc22, 0x24d67ff3, 0x604ed93c, 0xf8540a20, 0x31b9c405}},
+    {{0xa2582e7f, 0xd36b4789, 0x4ec39c28, 0x0d1a1014, 0xedbad7a0, 0x663c62c3, 0x6f461db9, 0x4052bf4b},
+     {0x188d25eb, 0x235a27c3, 0x99bfcc5b, 0xe724f339, 0x71d70cc8, 0x862be6bd, 0x90b0fc61, 0xfecf4d51}},
+    {{0x15a27295, 0x63fec45f, 0x74d2b111, 0xa41a773e, 0x12dde90d, 0x9341bc09, 0xaa83c35c, 0x5583dafa},
+     {0x05f406f4, 0xbc93ae0b, 0xc427f2ec, 0xcf73a836, 0x2c6e92a6, 0x0af26be5, 0x49b67cd6, 0xe096722b}},
+    {{0x00aef6e0, 0xf4b1ad53, 0x92448ec8, 0x51d353e9, 0x4f5f7050, 0xbda23624, 0x5172ddf2, 0x38641e4c},
+     {0x0dafe306, 0xd076b5ae, 0x042f9b7f, 0xbaf02e13, 0x7bb9888d, 0xefb76553, 0xeee3a756, 0x28ac3017}},
+    {{0xa1d4cfac, 0x74346c10, 0x8526a7a4, 0xafdf5cc0, 0xf62bff7a, 0x123202a8, 0xc802e41a, 0x1eddbae2},
+     {0xd603f844, 0x8fa0af2d, 0x4c701917, 0x36e06b7e, 0x73db33a0, 0x0c45f452, 0x560ebcfc, 0x43104d86}},
+    {{0x0d1d78e5, 0x9615b511, 0x25c4744b, 0x66b0de32, 0x6aaf363a, 0x0a4a46fb, 0x84f7a21c, 0xb48e26b4},
+     {0x21a01b2d, 0x06ebb0f6, 0x8b7b0f98, 0xc004e404, 0xfed6f668, 0x64131bcd, 0x4d4d3dab, 0xfac01540}},
+    {{0x72600e54, 0xff8d09c0, 0x10203d11, 0x1960edaf, 0x377756fc, 0x429dd48f, 0x884d880e, 0x4fa4a1ea},
+     {0x8d24ad69, 0x7fa9eaf1, 0xae16e60f, 0x4b9a578c, 0x35364b6a, 0x7e8849f3, 0x426f03fe, 0x3a6681db}},
+    {{0x8fa9f0a4, 0x62427d34, 0xa7621aa3, 0xef92aac0, 0x6bc20d7f, 0x9a3bfb57, 0x57add1cf, 0xe00f53af},
+     {0x9a8e182b, 0xaa091420, 0x65870acd, 0x6dbadf70, 0x9e7fa3d9, 0x1873e2cb, 0xae5822e9, 0x15b8c5b7}},
+    {{0x593d097f, 0x6b53bf21, 0x84d5959a, 0xbf667bea, 0xeeb4beac, 0xd1609f4f, 0xcac8251d, 0x69a5b074},
+     {0x5318ecb3, 0x612d6531, 0xd420d3e0, 0x66a6aebc, 0x685d7231, 0x6840955e, 0x1daa4128, 0x454f241c}},
+    {{0xa5d67e8a, 0x8d3e6d40, 0xa18b743b, 0xe139639f, 0x948e7dc2, 0x63749ea0, 0x526bde8f, 0xabd4c85f},
+     {0x2d812dfe, 0x731da794, 0x67ed8673, 0x9a9c0ddd, 0xa83f2506, 0x63feba54, 0xf64a622e, 0x475baed2}},
+    {{0xb40aab96, 0x1aa70ad1, 0xf911ec64, 0xf7accaed, 0x70fa959c, 0x637899ce, 0x109a2589, 0xe9bc4fe4},
+     {0x1bf979e4, 0x7bcce0d0, 0xbb65d9be, 0x2941c273, 0xbae3365e, 0x4997cc24, 0x8b08213e, 0x20efcfbb}},
+    {{0xbdd6fa57, 0xdde6c1b0, 0x6877584c, 0x64da38dc, 0x88a2ea3b, 0x5efd04d6, 0x8de94787, 0x5e12f389},
+     {0x4c229e61, 0x822dc6f3, 0x32c58ce1, 0x0220a965, 0x12104d90, 0xbff58f54, 0x6f430c30, 0xcc9c71a8}},
+    {{0x146a91dd, 0x69a3f7af, 0x77603291, 0x66fb0376, 0x34331450, 0xf8ba5650, 0x5d12fc47, 0x4d88f26e},
+     {0xde1d8482, 0x52e87a6f, 0xd84f6dc4, 0x71fc3d27, 0x1c1bfc10, 0x80660eb4, 0x39ad0a51, 0x2f4241dd}},
+    {{0x5da65e89, 0xcea18fed, 0xb6030005, 0x89d02e3a, 0x16b45eab, 0x593303db, 0x40b36824, 0xf5d40404},
+     {0xb6e6ca16, 0x8e62c398, 0xa0f8db73, 0xb6680f4a, 0x3735f704, 0xe2cb53ab, 0x005e4955, 0x90eaf4b0}},
+    {{0xd030702a, 0x4ea9bf09, 0xce4824bb, 0xe8e44ea4, 0x821e5b58, 0x0aaa6a0a, 0x117da962, 0x2090fa8e},
+     {0x80902901, 0x1b68c306, 0x0b4e7472, 0xaf0a7e97, 0x0393f96b, 0xebb4408c, 0xec32f258, 0x984bd632}},
+    {{0x1159f10e, 0x807d9af8, 0xb42511bc, 0xe05eff00, 0x61b05022, 0x2ee9f026, 0x29fb81a6, 0x3d45853a},
+     {0xf75bc3a9, 0xa6b9c16e, 0x515a90e0, 0x82111a06, 0xedfc125e, 0x87211449, 0xa80a8311, 0x4e4de334}},
+    {{0x637d797d, 0x270a098d, 0xff736545, 0x60ff39ed, 0x9d6b4a9b, 0xeb3df8bf, 0x0e6155fa, 0x0ac9835f},
+     {0x640bc0e9, 0x50c04b69, 0x3fe89b08, 0xfa24f733, 0x5c6872b2, 0xd8ac7b19, 0x3d00d534, 0xd6882b26}},
+    {{0x0236a83d, 0xe0052323, 0xcd9a2912, 0x1fb825a3, 0x3f92d724, 0x69479cbc, 0x38ec3ddd, 0x389eff26},
+     {0x1eb367c1, 0xe9ffea6c, 0x91f3a0de, 0x113a50c5, 0xb7b0af9e, 0xcfd0310c, 0x31ea1ac9, 0x5e1b21c9}},
+    {{0x48aceff5, 0xda6e2f06, 0xea0dfe34, 0x78ddc159, 0x14db328c, 0xb5f5fb47, 0xe6f3ba6a, 0x9419acf5},
+     {0xc66c1b27, 0xb19cd157, 0xf91bdb7b, 0x473be3d3, 0xee3174a1, 0x08a1f515, 0x1b427e86, 0x565a9071}},
+    {{0x863def2f, 0x71db5c74, 0x86db595a, 0x46fc6cc6, 0xb0578f7c, 0x41a41f2a, 0x00c9bc26, 0x3af24209},
+     {0xb3c9ab1a, 0x134233fd, 0xb6070f59, 0x7870f3a9, 0xdf2af343, 0x39b1f3b2, 0x4ab472ab, 0x6013da0e}},
+    {{0xf319ca96, 0xa4ab1856, 0xf8f15fac, 0xfad93fe2, 0xa833145e, 0x9a143ff7, 0xf19e3798, 0xb7f41bbe},
+     {0x88fba40d, 0xe71b2d47, 0xfd3b7782, 0xfbe87b9f, 0xdef04692, 0x51bed9be, 0x0a92fe70, 0x9d86b0cc}},
+    {{0x901d3434, 0xe4269dbe, 0xfe90a0f6, 0x93b1c84f, 0xc4383c70, 0x9e0ab0cf, 0x9ef8f7f3, 0x94a875b9},
+     {0x7bd07e21, 0x7c54e527, 0x24c1f8a1, 0x4426e751, 0xa59e4156, 0x88d04ff3, 0x2e3f9185, 0xca552076}},
+    {{0x3f32bef2, 0xc6c3baae, 0xccbf8eb6, 0x130ee8f7, 0x8e7e89c3, 0x09ec2b46, 0xbc2625f9, 0x3fbfbd74},
+     {0xb27173d1, 0x88502a08, 0x3cf0d529, 0xbb3271ff, 0xeb6fc065, 0x1409df32, 0x75196790, 0x21531773}},
+    {{0x0da1427c, 0x93eb1d71, 0x410e3f28, 0xb5f1a270, 0xa9325717, 0x7e9d484b, 0x576b2b28, 0xf883c4ab},
+     {0x15b0cc94, 0x8471e075, 0x560fab54, 0xaee70132, 0xdd9dec7a, 0xb461efe8, 0x488ab1d0, 0x6086f208}},
+    {{0xd41345eb, 0x8a9b3774, 0x4320bec3, 0xe42d2ea2, 0xd72435ff, 0xebb176e7, 0xca2c0e18, 0x3841166e},
+     {0xd372be35, 0x9c27a301, 0xe329d0df, 0x7518195c, 0xca99fe01, 0x203c98cb, 0x89f4ced9, 0x84d9c1a6}},
+    {{0xb789034e, 0xa7f47395, 0xe3acd77c, 0x5378515c, 0xa20bcd3f, 0x29d692e0, 0x59e44b71, 0xbfd07180},
+     {0x6733f199, 0x92cd3e15, 0x99f9141a, 0x43428c81, 0x07e9c6e8, 0x47e891ec, 0x75deaf04, 0x47103963}},
+    {{0x07888c81, 0xe2403426, 0x87490006, 0x03547365, 0x1fca7f34, 0x48369a11, 0x6e2f531d, 0x383707d0},
+     {0x9f7d10dc, 0xdc6a8214, 0xc9d5ef32, 0xca0b8578, 0xcdb6f94d, 0x8a4a5b65, 0x9b236f7a, 0x287ff192}},
+    {{0x48c1555e, 0x886878ca, 0xaf70db2d, 0x5fb1fbc9, 0xb15fda95, 0xdffff48f, 0x8fb2fa61, 0xfd98525d},
+     {0x57f0c9a8, 0x9a481e75, 0x27069783, 0x9bab3b2a, 0xa223c95e, 0x9569dffb, 0x0f6b2d61, 0x93840d78}},
+    {{0x23baeb04, 0xeaaaa5d8, 0x3a4708fa, 0xb7adca0c, 0x17b23442, 0x1394cbdc, 0x1d926d0f, 0xb241aa94},
+     {0x1de2521d, 0xda7549f5, 0xe4b48a02, 0xee7534c9, 0x46ba6568, 0x1dde0dee, 0x21b920e4, 0x85aa7eed}},
+    {{0xbaf91228, 0x348857ea, 0x4ecb2af2, 0x892d0a81, 0x91e8b82b, 0x06136e7f, 0x495431ad, 0x0869ec0d},
+     {0x2e051cdf, 0x54fa49c4, 0x823c9b51, 0xcb47adca, 0x265eb81a, 0x70a00076, 0x9b7675a0, 0x5572895c}},
+    {{0x96c14e8f, 0x9d1adf60, 0x2c06a25a, 0x06597793, 0x58d5a91a, 0xb2dcbd1f, 0xde733f89, 0x1283033b},
+     {0x9bbd6a2d, 0xb4020e0e, 0x7d383846, 0xe8b07157, 0xa635c7be, 0x84af4665, 0x34dd7d5f, 0x549c0eaa}},
+    {{0xe86e02ab, 0xf29fb08f, 0x0d5c06ca, 0xa8266dc1, 0x2f48f49f, 0x25d5e27d, 0xe6f31bb3, 0xa2ebf469},
+     {0x0382a8eb, 0x86ae97d9, 0x363f04f7, 0xcb92f44b, 0x002d76f6, 0x391b9654, 0x4432235d, 0x27bebd8c}},
+    {{0x3765581e, 0x7b3068d0, 0x1dc2d82e, 0x561d30f5, 0xb1f23d69, 0x8a404541, 0x1b4084ce, 0x6a25fb20},
+     {0x60206329, 0x50180e1b, 0x5cf443d5, 0x1e15941a, 0xd06a4007, 0xf5763393, 0x19cfb424, 0x5a0aebfc}},
+    {{0xe529a049, 0xa2d545da, 0xc73a541a, 0xa581a768, 0xe0950a67, 0xafe88b1e, 0x52b8fcca, 0x62778f74},
+     {0x0b8483fc, 0x44bb1bfa, 0x6e882c24, 0x5d727f5a, 0x553a776c, 0x4e4cbe60, 0x1ae91088, 0xe155b2f8}},
+    {{0x1b207a93, 0x5d84a3a3, 0xb71b2f04, 0xfbae3d63, 0x6013b8ba, 0xaa9cebc1, 0xd1c608d1, 0xfc9aa3cf},
+     {0xcf8cd72d, 0x1e3f596c, 0xda16b20c, 0x26152558, 0x85ac096c, 0x6db0b1cd, 0x2bb637da, 0x34ab0e43}},
+    {{0x12c953e4, 0xa9f4f5c1, 0x2a6a470a, 0xfe518080, 0x0b17775b, 0x5455fbcb, 0xc1752bb7, 0x4f117894},
+     {0x544a3be7, 0x5b5e49de, 0x22c3ec1c, 0x0dde356f, 0x01da56c9, 0xe26ae66a, 0x35ffd9dc, 0xab3b6155}},
+    {{0xc94f4326, 0x21ad037b, 0x01f60a81, 0xdd3c9aad, 0xa3106421, 0x4f11ee65, 0xadbacc80, 0x4751fe00},
+     {0xd3c2917e, 0xe4683589, 0x71d43f65, 0xfa8bd144, 0x11a422f6, 0x200697f3, 0x1fa0772b, 0xe83d7d4f}},
+    {{0x59b21469, 0xca907bff, 0xc44627de, 0xecfda9fd, 0x5af99278, 0x8b32c8bb, 0x51c0a6fc, 0x2298506c},
+     {0x9d7bfc5f, 0x2227244e, 0xbc8dcdbc, 0xd903a0c9, 0xa5809f67, 0x8916acec, 0x4c45bbd7, 0xfef3434a}},
+    {{0xc5332d4d, 0x12749619, 0x076108b7, 0x78346549, 0x52f84fde, 0x44f0646e, 0x9b855f0e, 0xaca1b2fa},
+     {0xbb5acc3e, 0x9f40edd1, 0x5cb0077a, 0x341dd551, 0x7731c386, 0x4162bf6f, 0x7d37f6e4, 0x30fc315c}},
+    {{0xbe224934, 0x07c6577e, 0x133b52f5, 0x0bd79c64, 0x26ea9a30, 0x6d440b9b, 0x8af95af2, 0xdc9823e4},
+     {0x951a08eb, 0xf3dcb38a, 0xcd6f6b4f, 0xcaedc3a2, 0x55572efd, 0xb648efdb, 0x043c56dd, 0xb2656a22}},
+    {{0x7cab3106, 0x24c2e7a2, 0x45ddcbcc, 0xe70143a5, 0xe23c4d47, 0x121738aa, 0xc9729043, 0xd3559359},
+     {0x5f6e4215, 0xd0abcedd, 0xd8c94522, 0xf09ef638, 0xfbf9ab22, 0x7bdde51f, 0x95edb586, 0x7aa22698}},
+    {{0x530e8727, 0xc7e05f58, 0x88a132f3, 0xd41592d9, 0x4835f583, 0x7cb9b486, 0x8f603959, 0x0d5caba2},
+     {0x7d850a76, 0xb97c361d, 0x0751fedf, 0x75d0638a, 0xeb862fbe, 0xad213d44, 0x597d997b, 0xcb814263}},
+    {{0x85fba82b, 0x5e2a21f5, 0xee80d718, 0xe2b23452, 0x8f8d3ad4, 0x61cd936d, 0xaea80a6b, 0x537e0faa},
+     {0x65c03360, 0xe8a1913b, 0xe9a48461, 0xad915586, 0xc9e7c92d, 0x197c7be0, 0x0476e6db, 0x98ff32e1}},
+    {{0xf8d734ca, 0x56131598, 0x32ab6115, 0xa90c803b, 0x294f6172, 0xf20b6904, 0x29bb4956, 0x9c4c8c6b},
+     {0xa3443e3c, 0x72523cbc, 0x1aaf4a8f, 0x403fc2d5, 0xf99a6339, 0x264bcaa0, 0x6437cec7, 0xf837ca9f}},
+    {{0x15685448, 0x3bb78084, 0x1186bde2, 0x0fc3a28f, 0xcf4eebdf, 0xd41f0cfa, 0xae3a0ddc, 0x8384f799},
+     {0x10b4f451, 0xf4ee653f, 0x833d3476, 0xc2f5d30f, 0x38e0e1ce, 0x6c3bceb3, 0xaa489e30, 0x76570d52}},
+    {{0xa38218cf, 0xb7aeab38, 0xa9e0d3c4, 0x2b07aeb1, 0x47a4c94d, 0xf0d16be2, 0x91fd763c, 0x5af88695},
+     {0x2a9da273, 0x053ab914, 0x61ebe016, 0x10d130ab, 0xd34e284a, 0x5099b9c8, 0x6ed4de65, 0xb21a4103}},
+    {{0xf8e85a02, 0x940f3648, 0x555e9ca4, 0x014ff0a9, 0x2ebff5ce, 0x656e0598, 0x7cd3977c, 0x7104ded9},
+     {0x6385dfe7, 0x9a4c0512, 0x0830e76d, 0x0627be3c, 0xb14a50bf, 0xf8c14705, 0x8c3faa7e, 0x3b4a1d7f}},
+    {{0xe6a868a0, 0x84b1e14b, 0x47bc1e4f, 0x7b98a2bb, 0xcc803733, 0x0e6df4e4, 0x7958e14d, 0xb751a536},
+     {0x5b9871b7, 0xf925771b, 0xe16ed05e, 0xeffa615a, 0xc695ddd6, 0x3141411a, 0x61468d10, 0x91eb562a}},
+    {{0xe895df07, 0x6a703f10, 0x01876bd8, 0xfd75f3fa, 0x0ce08ffe, 0xeb5b06e7, 0x2783dfee, 0x68f6b854},
+     {0x78712655, 0x90c76f8a, 0xf310bf7f, 0xcf5293d2, 0xfda45028, 0xfbc8044d, 0x92e40ce6, 0xcbe1feba}},
+    {{0xc0c1ce9f, 0xfd4c1473, 0x7eda11d3, 0x27f187b9, 0xd9845057, 0x024cd871, 0xa174d4d3, 0xcf6b116f},
+     {0xd279352f, 0xd300b23f, 0x23f12526, 0x364bc658, 0x2ab7b709, 0xc7908819, 0xb6bfc532, 0xc2de1fa1}},
+    {{0x4396e4c1, 0xe998ceea, 0x6acea274, 0xfc82ef0b, 0x2250e927, 0x230f729f, 0x2f420109, 0xd0b2f94d},
+     {0xb38d4966, 0x4305addd, 0x624c3b45, 0x10b838f8, 0x58954e7a, 0x7db26366, 0x8b0719e5, 0x97145982}},
+    {{0xd93f535c, 0x64549b3d, 0xa76e5bf3, 0x93978b4d, 0x5a01c10e, 0xe2b1f3ee, 0xa9d19ea8, 0x76f210af},
+     {0xc4264d57, 0xf04aca7a, 0x483487ba, 0x9f989031, 0xe6280f91, 0x84132d01, 0xb3a040cf, 0xf34b31ce}},
+    {{0xeee8cb7e, 0x75cec1ff, 0xf8735fb1, 0x566bf7fa, 0x5975d2fd, 0xc360c19a, 0xf075ec6c, 0x93b3ce8d},
+     {0x815d65ce, 0x718b6e47, 0xd1c39345, 0x17ec17c1, 0x6dac86b0, 0x4a1d862f, 0xe6dfab8e, 0x268c55b1}},
+    {{0xcffcaf2d, 0xb535fd34, 0xa23b8b1b, 0x9c8838df, 0xe178f644, 0xb2fb47fd, 0xf5d8be2c, 0x201173f5},
+     {0x9968eeee, 0x485e1c8d, 0xf856b514, 0x165d69ea, 0x756b5779, 0x17b6206c, 0xafe2ae9a, 0x8dac7611}},
+    {{0xdbdf389d, 0x0c55f223, 0x61eda89e, 0x76030246, 0xa1150650, 0x18975ae2, 0xc911375c, 0x77aaebab},
+     {0x2fe056e6, 0xedae9ad1, 0x2dde44e4, 0x8aa8f740, 0xe2873522, 0x9d288103, 0xfb60cd48, 0xf34aaca7}},
+    {{0x08bdf594, 0xbc7bcc73, 0xa9178a0b, 0x8fec77f2, 0x949edfb7, 0x7bb27826, 0xf137d62f, 0x77b0d0c5},
+     {0x88f8a9ea, 0x5add7b4b, 0x966cda49, 0x133edfbd, 0xeab66f18, 0x0189ca26, 0x55f452b1, 0x40c07b47}},
+    {{0x23369fc9, 0x4bd6b726, 0x53d0b876, 0x57f2929e, 0xf2340687, 0xc2d5cba4, 0x4a866aba, 0x96161000},
+     {0x2e407a5e, 0x49997bcd, 0x92ddcb24, 0x69ab197d, 0x8fe5131c, 0x2cf1f243, 0xcee75e44, 0x7acb9fad}},
+    {{0xb34983b1, 0xfb5f7e26, 0xd3fbb145, 0x7e38e207, 0xaf71ed7f, 0xf608ee91, 0x686e5aea, 0x6d78f612},
+     {0x607e751e, 0x2f9d2e63, 0x2748ba3b, 0x8607cb37, 0xf4fe56a9, 0x006f6d32, 0x6d242b89, 0x2980bd5a}},
+    {{0x23d2d4c0, 0x254e8394, 0x7aea685b, 0xf57f0c91, 0x6f75aaea, 0xa60d880f, 0xa333bf5b, 0x24eb9acc},
+     {0x1cda5dea, 0xe3de4ccb, 0xc51a6b4f, 0xfeef9341, 0x8bac4c4d, 0x743125f8, 0xacd079cc, 0x69f891c5}},
+    {{0x3dba87e7, 0x6384ab74, 0xb78a63ac, 0xe8f20516, 0x03fa5c24, 0xc6d198de, 0xb50c2893, 0x7afb3d4f},
+     {0x3a4cf320, 0xe4d418b9, 0x4faa9acc, 0xaac22a0e, 0x552c1f31, 0x08a7cc67, 0xd6668beb, 0x36009a3a}},
+    {{0xb34d794f, 0x09a16e3b, 0x4e743813, 0x8c3f4a31, 0x651c9834, 0xe8a7b747, 0xd2c76536, 0x4667ebb9},
+     {0xb8a887ab, 0x1f6884fa, 0xa08df843, 0xd021bc8d, 0x55f59432, 0xfc2d4609, 0x38d06677, 0x2d5c1ac7}},
+    {{0xfaecb3e4, 0x1d348841, 0x0406e1ce, 0xe2e6d3b5, 0x87679b85, 0x504b9726, 0x78812b43, 0x25279d03},
+     {0x56676779, 0x7e329009, 0xb002bcf5, 0xf0184a5b, 0xd630da82, 0x49e88336, 0xf08564a7, 0x92d01b0b}},
+    {{0x36cfa9e8, 0x9460f46a, 0x84a462f7, 0x6800b8a8, 0xc06a6673, 0x9f5d99a2, 0xb101b4f6, 0x1ab172c7},
+     {0x5321c59c, 0xf699c703, 0xed13bc1f, 0x0b9aca14, 0xdfaa5eaa, 0x91c6eebb, 0x4f346816, 0x885ae502}},
+    {{0xc9757170, 0xdbdeb29d, 0xcbf1b409, 0x55b5a898, 0xa4c0cbd2, 0x01b3dfd4, 0xd97e4324, 0x38611618},
+     {0x57bee79e, 0xf3ea3774, 0xbc20e2c6, 0x60941f4e, 0x53c47b89, 0x21d8f508, 0xb8f41362, 0x7e7d03d3}},
+    {{0xf202481a, 0xcc38452e, 0xabc96fed, 0x50d19d86, 0xc62cd055, 0x83fb2d63, 0x7b81568e, 0xbd6058b0},
+     {0x70737bb6, 0x628271f1, 0x83f257d4, 0xc51419ed, 0x09ef7dd9, 0x9ee514e4, 0xf8467e37, 0xf78e1fbe}},
+    {{0x339fe5ce, 0x045ef431, 0xd24c26d1, 0xef414a60, 0x661f3bbe, 0xc4151215, 0xa31d0a51, 0xca270c0b},
+     {0x89d02271, 0x0bddc41d, 0x55b9ae92, 0x5da2412a, 0x1b6552cc, 0xe2a468e2, 0x29cbeee5, 0x0920500e}},
+    {{0x92873d50, 0x8272ef36, 0x79cc84d1, 0xe6325d26, 0x38675522, 0xd634f48d, 0xe4d5882c, 0x1d96882c},
+     {0x5c7604c9, 0x7f0b5356, 0xd43110a3, 0x3c33b393, 0x96de3985, 0x4bcb6430, 0x9f50539e, 0x35c125a1}},
+    {{0x8c720a67, 0xbad5f61f, 0x16bfc3dd, 0x2c3c19bc, 0x65d64e56, 0x997d4265, 0x49504379, 0xab25034f},
+     {0x1410392e, 0x1f6297f6, 0x12e86d68, 0xbef8d14a, 0x1dfbd10b, 0xd6405555, 0x0d44fbaa, 0x53cad2bd}},
+    {{0x0d25ca56, 0x60d14d0e, 0xbcf946ff, 0x31cce9a5, 0xbef23766, 0x7f2e2c69, 0x0d8e4b51, 0x4e3c677a},
+     {0x6bb0d0ce, 0xa7c52eca, 0xd0391ca8, 0x1a2389c8, 0x7e8b1d46, 0x41165173, 0xa70684b1, 0x71094b90}},
+    {{0x66554187, 0x76f6c646, 0xd3bac858, 0xde2a1e0e, 0xca976e8b, 0xa81f6685, 0xf60c851c, 0x48a9d631},
+     {0x336936e6, 0x95a81b38, 0xf7934cbd, 0x588c234f, 0x68db8031, 0x5603885c, 0x5c1a48c7, 0x9c777837}},
+    {{0x8709b816, 0xfc9c7afb, 0xd4ab7632, 0xf0190802, 0x4c80bd1e, 0x609275b0, 0x3680a202, 0x791851e2},
+     {0x5899ef09, 0x0b4fd3fb, 0xacb207b3, 0x53b13f9c, 0x7c507f60, 0x3c993d16, 0x8d9e3b7c, 0xf1ef5083}},
+    {{0x0ad2fe5c, 0xf426fe06, 0x9022c4cb, 0xb8746069, 0x403efce0, 0xa1f27672, 0x53e2cc9a, 0xc34b4a30},
+     {0xd0e57d9f, 0x7e49b3ab, 0x13463806, 0x9906218b, 0x8bff74a6, 0x91a140b9, 0xe37c6ea3, 0x52de5611}},
+    {{0xe28b1b92, 0xad1e58c9, 0x77a11d29, 0xbfc3ead0, 0xba1de923, 0x9f5d367a, 0xafb30e89, 0xc1ee712f},
+     {0x75876ac6, 0x04886f34, 0x54b5c1c3, 0xb1d36d27, 0x18cba903, 0xb36b5fd0, 0x696a7139, 0x9b4a54bc}},
+    {{0x519e0427, 0xdb84065d, 0xb863af57, 0xd69dda22, 0x6ad4bc18, 0x71bb07b4, 0xc29564f8, 0x41cdad11},
+     {0x503cc09b, 0x7272b74c, 0x46ba501d, 0x72e4d2b6, 0x5033cca7, 0xf477717d, 0xf3df9d57, 0xfeeec42c}},
+    {{0x57186ac4, 0x435b40ee, 0x97b24f3d, 0xa16130ea, 0x453c442e, 0xf2b8c361, 0x647e46e4, 0x532de1cf},
+     {0x64ccd9ef, 0xfaf3c94f, 0x182eb339, 0x4e7192ec, 0xf2dfea04, 0x45cbeda8, 0x539889dc, 0xcb652c2d}},
+    {{0xd34c847e, 0x8e6576bb, 0xd5de9a09, 0xccaeb5ee, 0xbf91842d, 0x604ca87d, 0x7de9e9ed, 0x363b9c74},
+     {0x84919f51, 0x20e28af4, 0x7279a592, 0x8ea65e9c, 0xadec5331, 0x1df4b333, 0x0b1573df, 0x1b42a7c7}},
+    {{0x55ef6c3c, 0xe9ee350d, 0x058a3ba9, 0xf84a8cad, 0xe079d281, 0x5316a4fb, 0x11a280e5, 0xc9bf6f15},
+     {0x860e512e, 0x77414a7a, 0xd9430464, 0xb5722bcf, 0xfcd817ba, 0x631d68d7, 0x20f282f6, 0xcb8de2d9}},
+    {{0x86af53ca, 0xe3cc6151, 0x609c485f, 0x3cbbe8d7, 0x2024de09, 0xed635088, 0x3ed70f65, 0x3b9b4f1c},
+     {0x4e292129, 0x9c0b92e3, 0x137df53d, 0x4add5adc, 0xecdb4d15, 0x74bad233, 0x1a3d8634, 0x90610274}},
+    {{0x2374f412, 0x12022915, 0x162247d9, 0xc1c05129, 0x04b21320, 0x4a49989b, 0xcb478149, 0xda65930f},
+     {0x69fb4789, 0xed96215f, 0xad7fccb6, 0x3cfce1cf, 0x00687bbd, 0xe454254f, 0xb30413b9, 0x5d96fddd}},
+    {{0x5dee2192, 0x20f89c80, 0x5cfb0642, 0x6919a925, 0xe8e3e133, 0x94a30525, 0x68585ed2, 0x66209c61},
+     {0x6de12c85, 0x0c904364, 0xf0248824, 0xdac80d74, 0xf320f71f, 0x7b7fa943, 0xd5882c26, 0x0a244a2a}},
+    {{0x702476b5, 0xeee44b35, 0xe45c2258, 0x7ed031a0, 0xbd6f8514, 0xb422d1e7, 0x5972a107, 0xe51f547c},
+     {0xc9cf343d, 0xa25bcd6f, 0x097c184e, 0x8ca922ee, 0xa9fe9a06, 0xa62f98b3, 0x25bb1387, 0x1c309a2b}},
+    {{0xc6ee75b0, 0xa352a845, 0x4afafbab, 0x0d667013, 0x824a9c3f, 0xf2c9f8cc, 0x6671ea61, 0x1123ced9},
+     {0xc4c0426b, 0xe2064c2b, 0x5dda8f0c, 0xae8a4ac7, 0x8b03f8d0, 0x4789d01e, 0x2fd8bec7, 0x6d8a6838}},
+    {{0x1967c459, 0x9295dbeb, 0x3472c98e, 0xb0014883, 0x08011828, 0xc5049777, 0xa2c4e503, 0x20b87b8a},
+     {0xe057c277, 0x3063175d, 0x8fe582dd, 0x1bd53933, 0x5f69a044, 0x0d11adef, 0x919776be, 0xf5c6fa49}},
+    {{0xe418daad, 0x27326510, 0x625c8dda, 0x31c73944, 0x43030723, 0x32b46d0d, 0xcfd15d0c, 0x39a10292},
+     {0x99961dea, 0x1ef74176, 0x175f71ee, 0xa0ba92f0, 0x08f50113, 0x33f788b2, 0x71a8271d, 0xfb83754a}},
+    {{0x16898779, 0x60ffee0c, 0xf624c894, 0x07f24f18, 0x0adc727d, 0xa3b4c6e6, 0x68229401, 0xbe61fbae},
+     {0x634fe770, 0xe7c012bf, 0xbc5336ed, 0x1b4108e0, 0x34e57c7e, 0x68a1116b, 0xcd615837, 0x39012ba1}},
+    {{0xbd26c6ae, 0x2c8ca159, 0xcccfc5a6, 0x843d7f20, 0x81fbacad, 0x03349ce1, 0x656b250f, 0xeb34ef6f},
+     {0x0c299bce, 0x66e79036, 0x4ff14d30, 0xf50639f6, 0x1e49dd7a, 0x9b887542, 0xf0b88704, 0xa64bff59}},
+    {{0xb7f335bb, 0x00a5a2c3, 0x48af3a1a, 0x0dfaf15d, 0xaae1ae3a, 0x3c0a7831, 0x8cdca788, 0x4832590d},
+     {0xecf2985c, 0x9937352d, 0x18129bfb, 0x069199d7, 0xd9875fcc, 0xd747e700, 0xbfec3698, 0x0707e099}},
+    {{0x03541f94, 0xb1a8e69a, 0x3dfed107, 0xce50f2c0, 0xedd8d48c, 0xe235cb04, 0xd14ff204, 0x06de6b81},
+     {0xc4600a5e, 0x5ca05ca3, 0xdd87634b, 0x00aa7aa4, 0x4817fb86, 0xc00f85a4, 0xc3977369, 0xdad5c91c}},
+    {{0x0fd59e11, 0x8c944e76, 0x102fad5f, 0x3876cba1, 0xd83faa56, 0xa454c3fa, 0x332010b9, 0x1ed7d1b9},
+     {0x0024b889, 0xa1011a27, 0xac0cd344, 0x05e4d0dc, 0xeb6a2a24, 0x52b520f0, 0x3217257a, 0x3a2b03f0}},
+    {{0xb315365b, 0x0b25c598, 0xa33802f1, 0x4f9fbbf4, 0xdf1000b7, 0xf17bbaf7, 0x92ed176a, 0xd7f06111},
+     {0xe9aed821, 0xe6d03f9e, 0xc3c2c608, 0x6479a7fb, 0x833fe7d0, 0x4d4ad114, 0x5dc730b9, 0x0633f165}},
+    {{0xdf1d043d, 0xf20fc2af, 0xb58d5a62, 0xf330240d, 0xa0058c3b, 0xfc7d229c, 0xc78dd9f6, 0x15fee545},
+     {0x5bc98cda, 0x501e8288, 0xd046ac04, 0x41ef80e5, 0x461210fb, 0x557d9f49, 0xb8753f81, 0x4ab5b6b2}},
+    {{0x8618edf1, 0x9cda05e2, 0xdbf91167, 0xd9bbbdf1, 0x5b3f7f24, 0x210e5999, 0x3290e994, 0x5556c6a3},
+     {0xfd9d9264, 0xdfa4617f, 0xa4034316, 0x35f67e2c, 0xa6f5d2c1, 0xe732b3c2, 0xb6d666f1, 0x6384a08e}},
+    {{0x2dc58892, 0xb2d37da4, 0x03bdeb8d, 0xed936a9c, 0x1f8ed30f, 0x13ca866a, 0xe07de033, 0xceedb9c0},
+     {0x3e5135b4, 0x88f742d4, 0x0ec7d64c, 0xf329daa7, 0x9a484a31, 0x0d463e11, 0x70cdddcf, 0x978e9348}},
+    {{0x8939ca0b, 0xc5d60ab4, 0x9378f406, 0x95adebe4, 0x9718f642, 0x097b65a7, 0x8ea4a221, 0x93cb902b},
+     {0x7b6d5fdb, 0xf072428c, 0xe51424d6, 0x7c4e4dbb, 0x2db584df, 0xeeea7c18, 0xe8141b67, 0xd3b0dc0a}},
+    {{0x8e33832b, 0xc42bb0bd, 0x82b2725c, 0x3b6d0ef3, 0x8cfc624b, 0x85918af4, 0x8ee47c9b, 0xdf895bd3},
+     {0xc15185f0, 0x8bb5d0bb, 0x585c96b0, 0x819d351a, 0x154be8dd, 0x6a83828d, 0xc36963d6, 0x299c4da5}},
+    {{0x289149a5, 0xea4c1463, 0xac879905, 0xf3fcccf2, 0xe13a9610, 0x2185dc73, 0xf3cf0208, 0xcd651aa7},
+     {0x46927d66, 0xa481d874, 0x28198bba, 0x6a9a3c39, 0x3f54042d, 0xfc590faa, 0xb0ee6067, 0x10dd490f}},
+    {{0xaac4170a, 0x9baf4d7a, 0x0d75821e, 0x6da147f0, 0x3879d7d8, 0x58e0a73c, 0xa60bcd77, 0x86699898},
+     {0x598a46eb, 0xae7cd4da, 0x0187f877, 0x428dede8, 0x2af12355, 0x32ca235d, 0xa4b075f4, 0xc0d84aec}},
+    {{0xd35d8953, 0x48ced071, 0x7e1eedbe, 0x867c3459, 0x1a074661, 0x36dc5ad7, 0x9e6861cb, 0x939ee1b7},
+     {0x5b609c5b, 0x0e5e70eb, 0x28282282, 0xa8796969, 0x7ba8bb79, 0xc617bac6, 0x152dae15, 0x194a24f2}},
+    {{0xded33571, 0x39f582c5, 0x91f4fb95, 0x2b9a8ed7, 0x82a3ef27, 0x0442464e, 0x87b3fac1, 0xa7e35647},
+     {0xa367dea6, 0x005bad87, 0x019da0dd, 0x0f3cdd60, 0xa59305ff, 0x306f746a, 0xb2909721, 0x971f1ed8}},
+    {{0xb852cdd7, 0x4511c44c, 0x975b995d, 0xeb6bf1dd, 0x572add8d, 0x2601f683, 0xd054b296, 0x21121447},
+     {0x42cf0265, 0xf4f62401, 0xe3a79a2a, 0x6467317b, 0xaf927b35, 0xf04ed2d1, 0x6534b5a1, 0x8e96e1cf}},
+    {{0xaf4247b2, 0x58adb933, 0x0537352e, 0x48cebf9b, 0x966ff1fa, 0x8df30a42, 0xe788e9c4, 0x239e0726},
+     {0xd79b48b0, 0x5c6958a2, 0x4e914e8e, 0x22272e55, 0x7e106a1f, 0x191cbb75, 0x5f71c539, 0x4f8a6029}},
+    {{0xf7158bea, 0x25b336a3, 0x27774720, 0x2c80a110, 0x0a0b4413, 0x14d2f6a4, 0x43d8d04a, 0x13a5bee3},
+     {0xe4a44502, 0x93b68c5f, 0x364957b2, 0x5da5d14c, 0x26d8258c, 0x75168f8a, 0xeb43c098, 0xb455e8a4}},
+    {{0xb1ebe50c, 0x640614a3, 0x76acaa65, 0x3f805476, 0x8b4d91ff, 0x69530604, 0x519859d3, 0x903bb9ea},
+     {0x9f5fac7f, 0x93a59e69, 0x390d8900, 0x1df54929, 0x8ce5fa33, 0x823dba18, 0x2350281b, 0x5574f271}},
+    {{0x0309488a, 0xf111b200, 0xed2e78be, 0x6dba1852, 0xc5f6a056, 0xa848d319, 0x8c4b59c2, 0xf1ae1709},
+     {0x881bd57f, 0x757d507b, 0xed484551, 0xd7db6879, 0x8529cc2b, 0x0ce00c9c, 0xebd18ac3, 0xfb339802}},
+    {{0x1fc78e0c, 0x250c5af3, 0x04f7fda9, 0x84eeb8e9, 0x9ffe80e6, 0xa5a17e06, 0x703285cf, 0xde96f184},
+     {0x3fe41e6f, 0xcceabb01, 0x8724d28e, 0x2f674547, 0xb8bd6d72, 0x7babf7e2, 0xfcbef7cb, 0x0d6b8ab0}},
+    {{0x19abcaf5, 0x9be634cc, 0x02919487, 0xc0eebac0, 0x3bd130b6, 0x9f1bfedd, 0x22d625c1, 0x24dab3a1},
+     {0xb4206e3a, 0x46ab327c, 0x555042a3, 0x232d3373, 0x0eb9ea81, 0x8ddae1b5, 0xcb9f9e6d, 0xbe1cf505}},
+    {{0xcbcdafe6, 0xe854e0a5, 0x43534d5a, 0xf1e98103, 0x340f393c, 0xa7273058, 0x8cfd2794, 0x7329508c},
+     {0x538e99cd, 0xe715886a, 0x651e2938, 0x494d5a8f, 0x694b2061, 0xe8e08261, 0xc40be3ca, 0x0971a6ff}},
+    {{0x455d0d81, 0x56643934, 0x73f8fcef, 0x10c24d59, 0xbb38a630, 0xa612c437, 0x92f1445e, 0x4ef9a80e},
+     {0x1ee44719, 0xa9a648e2, 0x0d1dc166, 0x2f62feca, 0x97178ba3, 0x69c3d990, 0x9ff67325, 0xec8a3ad8}},
+    {{0x90828f9a, 0x7ce0d6ac, 0x5c9531ce, 0xb2bd1a02, 0xbb10ab9d, 0x5c1b4412, 0xaeee4c0e, 0x387518cd},
+     {0x98f368aa, 0x87de57ce, 0xbb92be7a, 0x21f57922, 0xf1744809, 0x65d54499, 0xd9e3102d, 0x777b407c}},
+    {{0xe746eaa6, 0x09d92a8e, 0x5c0b2593, 0xfe861385, 0x658b8eaf, 0x2696f3ff, 0x1a3c51e1, 0x896fcf1c},
+     {0xfc538f16, 0x8d8e617e, 0x610922e6, 0x1cd3c38f, 0xd6eac1c9, 0x84c50345, 0xa4205d21, 0x61ff42c1}},
+    {{0x8230a9a6, 0x7b741b5d, 0x8bf29bb9, 0xf579deb9, 0x98ffd997, 0x39671277, 0xf4fcb1e1, 0x6de16859},
+     {0xea723b7f, 0xc6b7a38d, 0xf4fb138f, 0x77d3e0f2, 0xa150fa04, 0x9b478f3a, 0x69b0beed, 0x5b961787}},
+    {{0x1d842031, 0x66d0eecb, 0xa5aedbc6, 0xafa9c66e, 0xfaad16d1, 0x67515b87, 0x15840989, 0xd827c8b4},
+     {0xc8a420ed, 0x5e1b7bb1, 0xdc28e5bd, 0x8ea03cab, 0xd45188d7, 0xfc4d874f, 0xc22ecf90, 0x2f661c17}},
+    {{0x328fb9ef, 0xdceafeb7, 0x311cb1f3, 0x3478e062, 0x03e042ea, 0xb7fbe79e, 0x28a8a8fb, 0xfb0249aa},
+     {0xb8ee1b8b, 0x50b4bb44, 0x3d152813, 0x0e540e9f, 0x09aa13a2, 0x48e514e1, 0x9c5fbc3e, 0x172f4633}},
+    {{0xa37cfbfe, 0xdd8d54f8, 0xf8ffb4a9, 0x7b03cdfe, 0x24070df5, 0xca347052, 0x99bf4616, 0x0b659251},
+     {0xee44254b, 0xce2e30d8, 0x415ba4f1, 0xa45c28fd, 0x5e8366aa, 0xcc31d2bf, 0x59b2f313, 0x8e249aeb}},
+    {{0x56f93781, 0x8874151d, 0x22891225, 0x3b208cda, 0x53f5b5af, 0x9f9f4b01, 0x457c10bc, 0x60aaa403},
+     {0x0300cd5e, 0x52a2bda0, 0xa7436841, 0xe4503bb0, 0x7c7158c1, 0xe34045fe, 0x15ac62a9, 0xdca8e0d7}},
+    {{0x9361cf42, 0xa423dc88, 0xca111dd0, 0x25953391, 0x4509733e, 0xcd1bf722, 0x5e552eae, 0x62a8f8a7},
+     {0x4dfb5704, 0xa6a1a79c, 0xa2abc546, 0x215f2de4, 0x4dcca7d6, 0xee3ede74, 0x493ed75f, 0xbbd935cd}},
+    {{0xad8fbf6a, 0x228b7867, 0x49f109d0, 0x2b4dccba, 0x6cea145c, 0x2ededda5, 0x052d7980, 0x33ae4c04},
+     {0xdf1203af, 0x487e1051, 0x30c418f9, 0x343ed3d8, 0x0495ea86, 0x715ad94e, 0xe945824b, 0xc78a5ac5}},
+    {{0x8c935e5f, 0x3680071a, 0xf58543c1, 0x7d764e91, 0xee52df5e, 0x4db687f0, 0xfecf1d1d, 0x7ead1e20},
+     {0x5fe9a684, 0x453cb994, 0xb65bb00a, 0x1ca6c43f, 0xd51630d5, 0x99039a8a, 0x97c7d645, 0x0ca741ed}},
+    {{0xf45be76b, 0x614e1441, 0x177d8e3d, 0xa5ef3ec0, 0x45e70812, 0xe3662065, 0xa25ebc68, 0x05d525ac},
+     {0x916e827a, 0x11c3041b, 0x868bc04c, 0x7d5ab00a, 0x1e80ea45, 0x129f80b1, 0x82ab5457, 0x663c8854}},
+    {{0xc4268106, 0x0ea0ef30, 0x9827ed70, 0x9037b2f3, 0x583f6310, 0xc3db4e2f, 0x2ab10678, 0x10a3f54b},
+     {0x706e16c5, 0x7097dd2b, 0xaf165242, 0xd4770a89, 0x370e1411, 0x9514515e, 0x0da518ef, 0xad237305}},
+    {{0x1c86789a, 0x1f5ba028, 0xa557050d, 0x53c33fab, 0x401788b3, 0x41d49663, 0xa1636f3b, 0x37fbf41e},
+     {0x0f7b0609, 0x07763b95, 0xacaa8d51, 0xbf50bc02, 0x6e61b1c6, 0xc2a5c173, 0xf46a6605, 0xa9116c70}},
+    {{0x336f30c4, 0x5999001a, 0x504b641a, 0x4d8b3c3b, 0x31696b82, 0x3a1a5507, 0xe650fe2b, 0x605a5fd0},
+     {0x4624ad94, 0xe45bcf34, 0x42ff1bcf, 0x360522e1, 0x0583b20b, 0x0ec6913b, 0xa3e4a361, 0x87004ddc}},
+    {{0xb029d3d7, 0x94b476bc, 0x8883a492, 0x355100cb, 0x82e9a1db, 0x1c540464, 0xdb0836b1, 0xe35df7eb},
+     {0x6ba5ddb7, 0x2db5a7f5, 0x72ef8a86, 0x921bc05b, 0x8ddcd14f, 0xd697f63e, 0x19352ce1, 0x0646fe17}},
+    {{0x18ac6f86, 0x63dfc0b7, 0xd0531de8, 0xe2fb9537, 0xd0136ae3, 0x481eaf13, 0x8e4bd2f7, 0xe01af14a},
+     {0x88f974ec, 0x49ee4f9f, 0x92aef323, 0xd764a4c6, 0x1e03afa9, 0x443cb43f, 0x736e1021, 0xc0c7bf9e}},
+    {{0x9bb57932, 0x72f792d1, 0x0514514c, 0x1bed9845, 0x44c50cb7, 0xa4eb06a6, 0x4efdcedd, 0x8254b868},
+     {0xc9dadade, 0x47bb74d9, 0xb3d95615, 0x2d48e4ec, 0xc15aa29f, 0xadfc9cf1, 0x78462b89, 0x0cba2046}},
+    {{0x479f4bfe, 0x9b0d9abb, 0x5e3c4768, 0x3e790d21, 0x375c643c, 0xa3ad44cd, 0x6ac0dc43, 0x9dfbbb65},
+     {0x55c762ec, 0xda6ffb79, 0xde78a5e1, 0x12294f31, 0x4d704863, 0x0ae22c68, 0x6c18c02e, 0x61114035}},
+    {{0xd96dd1ed, 0x2360d888, 0x0a936c6b, 0x1b99cc55, 0x8609f93f, 0x4372a3f5, 0x4dc993c4, 0x0afc214a},
+     {0xa6bf396f, 0xba08d6c7, 0xaf2235e2, 0xa6d44568, 0xbdec43ed, 0xe3e1c378, 0xd9ca7e1d, 0x00b80a92}},
+    {{0xc7ab8183, 0x06750a2a, 0x97f4eb7b, 0x042dd3d6, 0x3d0efa7a, 0x4cc4d792, 0xd9793753, 0xff36e487},
+     {0x4e06e132, 0x104dff63, 0x6d1706fe, 0x9773ae26, 0x3ffebb01, 0x97299181, 0xdfc694ff, 0x59006dc6}},
+    {{0xdc0b1061, 0x2ffbcf19, 0x139ad48c, 0x846730ad, 0x12ca3c26, 0xcbbd5f20, 0x8855a59a, 0xebc3d35e},
+     {0x5b93e742, 0x18644a97, 0xf8f4be3a, 0x0da658f5, 0x3fe32589, 0x4b3c3785, 0x61ce3030, 0x5290bec1}},
+    {{0x3df40f6f, 0xe6fad49d, 0xcca526f5, 0x885dd6df, 0x4a1807a1, 0xc0b00e7c, 0x3404d5a1, 0x3fecd70b},
+     {0x6782d8d7, 0xe77bfe48, 0x7155ec7d, 0x54ab18c9, 0xb3202407, 0x77cdb71f, 0x67ba5604, 0x8441556c}},
+    {{0xe9d78dd4, 0x38694e01, 0xb58c2f9b, 0xf84fbbfb, 0xa234c73f, 0x3bd303d3, 0xff16883f, 0x82396be5},
+     {0xe886df4e, 0x56ecf3fd, 0x817255a6, 0xcad118bd, 0x1aa338db, 0xba6926ba, 0xaa1981ff, 0x2a677961}},
+    {{0x05f4cc58, 0x75a1590c, 0xa69f58c8, 0x43f076bc, 0x79786c3a, 0x8ada939b, 0x95a50c0a, 0x3a758d61},
+     {0xba2155ef, 0x22348461, 0xebfe41ad, 0x5985f593, 0x91fb5cf7, 0xadffad55, 0xe54e241c, 0xb8891adc}},
+    {{0x24fc05cd, 0x18115178, 0x092d97be, 0x2c73fd44, 0x2bebb106, 0x5b5a8cba, 0xee17d82a, 0x017cc283},
+     {0x42ee8fdb, 0x19974730, 0x89433e44, 0xf16121e8, 0xa2ff19e7, 0x760eaad5, 0xa1ec8caa, 0xd71a2864}},
+    {{0x7f42a1bf, 0x26f1caf3, 0x82f27586, 0xcabd266e, 0x6af484f4, 0x0971375b, 0x0a43e6fa, 0xabf356cc},
+     {0x91c5e0f8, 0xc7b50396, 0x3a8efac5, 0xbaf618fe, 0x15a2316f, 0xcb21fe99, 0x0f2635d3, 0x1565ca3b}},
+    {{0x79fb664d, 0x01babf6d, 0xb9659aa1, 0xa14b4ab5, 0xb64daa60, 0x6fe4c1bd, 0x938edb85, 0xea4b209d},
+     {0x3290b2f4, 0xe322af73, 0x292af72e, 0x4bacded7, 0xb1e09d85, 0xf01824e4, 0xcaa001b1, 0x485c0038}},
+    {{0x7c092020, 0x954e5fa8, 0x99a7318d, 0x06591ec9, 0x6fc3ea5b, 0xc3506151, 0xda3e40c7, 0xcfb13598},
+     {0x826f6eb1, 0xb447cc06, 0xcc4b15bb, 0xb9176be6, 0xc61599ec, 0x0204e321, 0x4e9fce6b, 0x66512cbd}},
+    {{0x6891ea5a, 0xf59ca041, 0x5a12f3c8, 0xac0d2cc0, 0xefadecb4, 0x2f827232, 0xc3a86505, 0x743a048f},
+     {0xf9aa9765, 0xd0154838, 0x11fedb76, 0xa548e7ec, 0x61e77c87, 0x10a67ed6, 0x5e165be4, 0xa4394d9e}},
+    {{0x012ddf9f, 0x2798852b, 0xbf4fcb96, 0xd5539be9, 0xb08c6b69, 0x198a79b9, 0xa37060d9, 0xe23bd3cb},
+     {0x68a6a401, 0xcc7f52c9, 0x57091704, 0xdf697f4b, 0x7514abbe, 0xc429b0b8, 0x3212ca5b, 0x9dfd8b3f}},
+    {{0x84a74d26, 0x4c82a438, 0xdc49feee, 0x94fc7759, 0x73af33a7, 0xa604d0ca, 0x99993f69, 0xa2028cc5},
+     {0x733d26c8, 0x06d21477, 0x3704942e, 0x97ea2867, 0xf123fe2d, 0x26fd5fb5, 0x62c4c70e, 0x19d166cc}},
+    {{0xabbfe286, 0x4af25ce1, 0xfcdeed1a, 0xa53341c7, 0xcd20e76d, 0xcb1d3464, 0x4ab23d35, 0x56decf3e},
+     {0xe524aafb, 0xdd832027, 0x05a43863, 0xee102be5, 0xd463f935, 0xf9a6bffa, 0x44f43b95, 0xc49eae38}},
+    {{0x8b894f9b, 0x59e60bd8, 0xb510a245, 0x77c0a893, 0xac45e9f3, 0xf6133ded, 0x7e0a7bba, 0x7f88fc4e},
+     {0x751bb0fd, 0x8c615daa, 0x5623e6e8, 0x64ba7615, 0x4bd8deac, 0xf6bf0161, 0x3997b513, 0x68c635f0}},
+    {{0xe7753698, 0x8d15f49d, 0x166245dd, 0xb1d6f20c, 0x92eea7b3, 0x998ac40b, 0x0c3c0922, 0xe5c81e0b},
+     {0x85a9e76a, 0xf65ca633, 0x88a56acd, 0x2779b4b3, 0xeefb0c07, 0x405ba189, 0xa7d62d55, 0x6591e281}},
+    {{0x6bd408b4, 0x48c896d1, 0x9c6baf95, 0x47ce08a1, 0xa887eebc, 0x4f4ddce9, 0xae7398d9, 0x0447f868},
+     {0x9cbaa537, 0xb70895fe, 0xe15eff33, 0xdc935601, 0xa2a7c433, 0x035c1d08, 0xf0fb4cac, 0x5f37ccef}},
+    {{0xa47c229b, 0xf5a4aa87, 0x1136ee1b, 0x19dc19b9, 0x51e08c26, 0x1d5ded4c, 0x4f85d804, 0x41ab4614},
+     {0x738106ca, 0xf02dd1d4, 0x2ab68aff, 0x20cc8ff4, 0x3c3ce367, 0xc1c053e7, 0x33f9e08d, 0x48517644}},
+    {{0xb7f6be1f, 0x1e3081ab, 0x0d8a6fb0, 0xd7768c94, 0x31905283, 0x70e00c75, 0xae64d738, 0xa176c395},
+     {0x1fa3578c, 0x9e5850bc, 0x611fe506, 0x087565ce, 0x9feeea5c, 0x51ab984b, 0x947b45f1, 0x9ebdec88}},
+    {{0xb792fbec, 0x587c5da0, 0xee9e8acb, 0x5986356b, 0x24e55c73, 0xfaa63b4d, 0x4c985649, 0xcefb8440},
+     {0x540926df, 0x1c20fe34, 0x79c38de9, 0x6204487e, 0x5881270e, 0x7b5348a9, 0x0767a863, 0xa40c8baf}},
+    {{0xdc53717d, 0x4f0ec8f0, 0xebb3b85e, 0x42fc6006, 0x067977ff, 0x95f962d2, 0xd50ae583, 0x6194bdd5},
+     {0x2c4fa8aa, 0x76c2178c, 0x3abf1768, 0x35277d4f, 0xe5e8d851, 0x4a22db58, 0xbf903362, 0xaf64998d}},
+    {{0x7fbef628, 0xc3c2b412, 0x0008abb4, 0xa69c7756, 0xdd3a1376, 0x3f52438e, 0x7688a086, 0x3a6f4c49},
+     {0x126f5476, 0x8dca1641, 0x5e790b59, 0x7de645ce, 0x45125197, 0x5b51a327, 0xf79973fb, 0x796aba23}},
+    {{0xb78a0575, 0x06129252, 0x031e9f63, 0x6cb9019d, 0x01f22992, 0x03928544, 0x6eca6194, 0xda7fa95f},
+     {0x6346268c, 0x5abf16bb, 0x8ec5dca6, 0xac24e560, 0xbc92bc35, 0x72889d45, 0xbbd19859, 0x2c2efedb}},
+    {{0xd347feca, 0x89eb1b96, 0xcda31e4a, 0xc8c78f4f, 0x9b5ebee5, 0x9948cc8c, 0x6f69b457, 0x56952543},
+     {0xdaa7367a, 0x6a3b3ef7, 0x3eae86cd, 0x2becf2d4, 0x8a9bcb17, 0x663509a6, 0xbbbbc36e, 0xc670543e}},
+    {{0x28bc89e8, 0x7b292496, 0x376de4ad, 0xb1ac125e, 0xf591522e, 0x4736603b, 0x7c775b6b, 0x9c2c6267},
+     {0x8e2a143b, 0xca91de65, 0xdc7ab49b, 0x2a626e93, 0xe7fbc78f, 0x86320365, 0x6df16f90, 0x9ddcadc5}},
+    {{0x9099b9c9, 0x4131bfd0, 0xeb850dda, 0x3bf11e70, 0xb34f5321, 0x422705c3, 0x082e4d79, 0x21ba3c52},
+     {0xe427ebe9, 0x76a27c83, 0x5eeb87b8, 0x2e1d8cd4, 0x72955119, 0xecfaa6e5, 0x077cbc91, 0xa2d7916c}},
+    {{0x3581c6cd, 0x8cbe4d6e, 0xfd43f5ec, 0x5f07093e, 0xb1571512, 0x2fff27f8, 0x976d2d4b, 0x3d5929b3},
+     {0x00b64b81, 0x171dc0c2, 0xf03fcd1e, 0x36f4b114, 0x97a014f4, 0x11451b78, 0xb73f2090, 0x277fa77b}},
+    {{0xaf5cab24, 0x6fcde854, 0x467a04b7, 0xd4e8aa74, 0x7bcf3d2c, 0x14d14d59, 0xa0abcaae, 0xc56d84f7},
+     {0xe9ec1dd7, 0x937608b1, 0x867114f6, 0xdf5054eb, 0x6ddf93a6, 0x6b013bc5, 0xdd3e48fc, 0x5bff4f05}},
+    {{0xe8eb9fa6, 0xa6874da5, 0x5d53d5d9, 0x8717f1d9, 0xe775420a, 0x7255dc15, 0xd119777e, 0x71cd2638},
+     {0xaca9fc16, 0xed636262, 0x6937763b, 0x5171c1f7, 0x037ec77b, 0x1bf18c1d, 0xbf3b8213, 0x63b482de}},
+    {{0x7d6de321, 0x0bc91e66, 0x7469772e, 0xfae8dd8f, 0x4ef060b6, 0x61eaa825, 0xddb31399, 0xf46bad95},
+     {0xc21213c9, 0x92708587, 0x7d09eb1c, 0x11d287d0, 0x6ea52f68, 0xa79815d8, 0xeddb10a7, 0xb54bb792}},
+    {{0x636d0ae6, 0x2d7c4576, 0x7fcbeeec, 0x4b387e0b, 0x103707cb, 0xa3f9a9d0, 0x1398a20c, 0xd20da011},
+     {0x77bb0455, 0xfd1fac78, 0x8afbe9ce, 0x5cc544d7, 0x78baca74, 0x15846d91, 0x4901dd7d, 0x30271d42}},
+    {{0x4b037401, 0xee0af6df, 0xf4b85d2d, 0x55cd3618, 0x493fb0dc, 0x4ea35646, 0x81bd0405, 0xadfceaf6},
+     {0x5b1ddf0d, 0x342df99f, 0x605d3bb9, 0x2fe483a7, 0x639e33d9, 0xdaadd46a, 0x91623d28, 0x9b4daab1}},
+    {{0x03c5178a, 0xe7980bd9, 0x72f35b9c, 0x4a5ed035, 0x32ed344c, 0x5c0945c0, 0x92a40b28, 0xdcd9f5eb},
+     {0x51e6c89a, 0x58d2fb9b, 0x75ddbbba, 0x3f2bbaf8, 0xffb0a284, 0x4ab9791c, 0x7bad9a46, 0xe12ec09a}},
+    {{0x0b89d4bd, 0x048df69b, 0xb70fba85, 0x222888ef, 0xcce017f6, 0x44a0c5f6, 0xc264855c, 0xebc469d8},
+     {0xd7cb56bb, 0xb6420b9d, 0xea5f6aec, 0x24f72349, 0x86efe6a9, 0xe35956d8, 0x4b12634f, 0xbae5fb78}},
+    {{0x7bca0bc1, 0x1bcb36a5, 0xc6ad55f1, 0xdadf6dce, 0x6080e0f8, 0x9de1e8e7, 0xb2567ac5, 0x681d6be2},
+     {0x763f4fcb, 0xdeb1edd4, 0xe58790f1, 0x2a6a766e, 0xcf14e1b0, 0x263f2166, 0xc48087f3, 0x1dfcab92}},
+    {{0x778189c5, 0xc0c38d52, 0xa201226f, 0x68f81bc5, 0x35e974ba, 0x890e8ba3, 0x9b23a1d3, 0xb6634418},
+     {0xda3b7af3, 0x7cde9e81, 0x6ca457e4, 0xd7e854a2, 0x8e7a3d5e, 0x6d2992bc, 0xd1da4558, 0xc85b3262}},
+    {{0xee5df4eb, 0x32fb658a, 0x75a1aea2, 0x9c82e929, 0x90638f38, 0x5079da88, 0x5a2cc1f6, 0xac9d5b23},
+     {0xa4b6436b, 0x4c315413, 0xe22c0b32, 0x183b4444, 0x81769921, 0xffd20056, 0x8dbb9503, 0x6cbb0b44}},
+    {{0xde1300a9, 0x61f97d99, 0x83953873, 0x41841225, 0xdb0c465c, 0x9f249e32, 0xdc2447be, 0xefa5ceed},
+     {0x6c191d51, 0x9ab30d9a, 0x9005b6a4, 0xdbf4dded, 0x00e670fe, 0x90bd6b03, 0xc8efd72e, 0x2b961781}},
+    {{0x96409eb3, 0x02ac3618, 0x4ac5731b, 0xa9040e46, 0x80e8987a, 0x00744fb8, 0xc571fb67, 0x37b726d8},
+     {0x7d57d0f1, 0x2ad96a5a, 0x0a8ef52a, 0xdc59d323, 0x751b6beb, 0xa9e01754, 0x49e1c809, 0xbf0df92f}},
+    {{0x39f81c9e, 0xe86e9a3d, 0x7783946a, 0xb47a9004, 0x541cb355, 0x72ba430f, 0xac3fdf37, 0x5b8ee3fa},
+     {0x635ae687, 0xdf371fda, 0xd30bc7d3, 0x75429f37, 0x0a90fb23, 0xc0d58d9b, 0xac1d5e95, 0x59575436}},
+    {{0x0c6ce683, 0xb5d21d64, 0x08076b0a, 0xeaa6f725, 0x8646fbec, 0x081d887c, 0x5af13ff5, 0x9cba423e},
+     {0xf54fc3c0, 0x9bb2fc49, 0x26c5c719, 0x79f37273, 0x15cdf0ae, 0x05af002f, 0x2aa017e0, 0x7562190a}},
+    {{0x05a0af19, 0x64777efc, 0x6292ac20, 0xc3cda2ed, 0x640d9419, 0xf25592e5, 0xb4bb2e1f, 0x5308b91d},
+     {0xbf1444ce, 0xbc5d3721, 0xed42874a, 0xe4b6bd8c, 0xabae0290, 0x2d50b9af, 0x47c018ab, 0x6b64bf26}},
+    {{0xb376ce56, 0x580e9c32, 0x9fd6e193, 0x7d700ee2, 0x1eec566b, 0x12bd427a, 0x61ea45a6, 0xe9f73a45},
+     {0x08490971, 0x55617aa8, 0xdbca1ad2, 0x4a5aa3ab, 0x8384b6ac, 0x58beb1a6, 0x07e4444c, 0x76323ee2}},
+    {{0x0c4a3b64, 0xe88f54d3, 0xce1c832d, 0xf7615b0d, 0x973d58fe, 0x2f67adb0, 0xc3cef173, 0xb2871e1c},
+     {0x7a97569e, 0xed83d2a2, 0xab59d53a, 0xd11912b4, 0xa435918d, 0x10764c79, 0xef2764c3, 0xca537a69}},
+    {{0x90125dee, 0x94d56bc8, 0xe778a787, 0xb531f3b8, 0xaf58f361, 0x3bd55133, 0xe15c70e5, 0xfe17e49f},
+     {0xc6f1d920, 0xdd93b546, 0x36ccb9f9, 0x0c5ff33b, 0x28f1575f, 0x43aca5e6, 0x5c274ad0, 0xa55b4f60}},
+    {{0x06589232, 0x5a6fda9d, 0x560e6363, 0x967f03d6, 0x6176fe56, 0x8913e989, 0x543db0ef, 0xacb44d40},
+     {0x8e895b40, 0xab0e252a, 0xd42959e6, 0xab32c974, 0x44a05ad1, 0xbc3f7e15, 0x6511572e, 0x65271ba1}},
+    {{0xbcd91c45, 0xfcf99e08, 0xaca75397, 0xef84f18b, 0x6e525d1f, 0x15464f30, 0x425d091f, 0x0d216a15},
+     {0x0ac21d69, 0x1f87dcaf, 0x67416519, 0xaab24306, 0x7f5d18f8, 0x1768a8b8, 0xc40a8c75, 0xce3e7c99}},
+    {{0x37b6d3ee, 0x4f31f586, 0x74ac2be8, 0x4f6a0343, 0xc47589cc, 0x6cb479f4, 0xc8dea1b6, 0x34f06e15},
+     {0x053e171b, 0xe091b4dd, 0x240fdd1f, 0x6989fd6d, 0x9ff2123f, 0xde25a063, 0x513a6da1, 0x0e04bcc9}},
+    {{0xe9343616, 0x64981b01, 0xcb86e631, 0x90502cbc, 0x86a5defc, 0x44e595ec, 0xc5f1c69e, 0x5684a676},
+     {0xc2d85a87, 0xe4b9d8cf, 0x5ccd436b, 0xa9cd9009, 0x3d913783, 0x33195343, 0x0ac25661, 0x949349c5}},
+    {{0x564efa22, 0x2be3f5f5, 0x1ee27deb, 0xc5f4cef5, 0x0e25bd0d, 0x3b239e56, 0x9bf10706, 0xdaf3f4f1},
+     {0x5b919a7d, 0x788294b5, 0xbf83cb15, 0x1bc79c9e, 0x1e312dcb, 0xe0642403, 0x051194cd, 0x7ffa38df}},
+};
+
 #endif
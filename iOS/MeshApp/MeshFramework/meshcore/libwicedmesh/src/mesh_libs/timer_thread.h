@@ -0,0 +1,92 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Native timer service for the platforms that used to run every wiced_timer_t through the
+ * managed runtime (a Java Handler on Android, an NSTimer on iOS).
+ *
+ * One pthread sleeps on a condition variable until the earliest deadline in a timer wheel
+ * and calls the expired callback for each due timer with the caller's lock held, the same
+ * lock that protects the rest of the mesh core. Starting and stopping a timer is a wheel
+ * insert or unlink and wakes the thread only if the new deadline is the earliest one.
+ * When the callbacks must run on a given thread (the main queue on iOS) the timer thread
+ * only tells the owner that timers are due and the owner runs them.
+ */
+#ifndef __TIMER_THREAD_H__
+#define __TIMER_THREAD_H__
+
+#include <stdint.h>
+#include <pthread.h>
+#include "timer_wheel.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Called on the timer thread with the lock held, p_ent has already been unlinked from the wheel */
+typedef void (TIMER_THREAD_EXPIRED_CBACK)(TIMER_WHEEL_ENT *p_ent);
+
+/* Called on the timer thread with the lock held when timers are due, must not block */
+typedef void (TIMER_THREAD_DISPATCH_CBACK)(void);
+
+/* Starts the timer thread. p_lock must be a recursive mutex, it is held while a callback runs.
+ * Returns 0 on success, safe to call again once started. */
+int      timer_thread_init(pthread_mutex_t *p_lock, TIMER_THREAD_EXPIRED_CBACK *p_expired_cback);
+
+/* Stops and joins the timer thread, timers still in the wheel are dropped */
+void     timer_thread_deinit(void);
+
+/* Set before timer_thread_init to run the expired callbacks on the owner's thread instead of the
+ * timer thread. The timer thread calls p_dispatch_cback once when timers are due and waits until
+ * the owner calls timer_thread_run_expired with the lock held. */
+void     timer_thread_set_dispatch(TIMER_THREAD_DISPATCH_CBACK *p_dispatch_cback);
+void     timer_thread_run_expired(void);
+
+/* Microseconds of the monotonic clock the deadlines are based on */
+uint64_t timer_thread_get_time_us(void);
+
+/* The same clock in milliseconds, the unit of TIMER_WHEEL_ENT target_time */
+uint64_t timer_thread_get_tick_count(void);
+
+/* Both must be called with the lock held. p_ent->target_time is set by the caller before adding. */
+void     timer_thread_add(TIMER_WHEEL_ENT *p_ent);
+void     timer_thread_remove(TIMER_WHEEL_ENT *p_ent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIMER_THREAD_H__
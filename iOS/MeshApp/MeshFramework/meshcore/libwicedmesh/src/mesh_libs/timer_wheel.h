@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016-2020, Cypress Semiconductor Corporation or a subsidiary of
+ * Cypress Semiconductor Corporation. All Rights Reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software"), is owned by Cypress Semiconductor Corporation
+ * or one of its subsidiaries ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products. Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Hierarchical timing wheel used by the wiced_timer_t implementation.
+ *
+ * Five levels of 64 slots each cover 2^30 ticks ahead of the wheel base. Every slot is an
+ * intrusive doubly linked list, so adding and removing a timer is O(1). Each level keeps a
+ * bitmap of the slots in use, so the next tick that needs work is found without walking
+ * the slots. Timers further out than the wheel covers are parked in the last slot that is
+ * in range and placed again when that slot is cascaded.
+ */
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TIMER_WHEEL_BITS        6
+#define TIMER_WHEEL_SLOTS       (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK        (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS      5
+#define TIMER_WHEEL_RANGE       ((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+#define TIMER_WHEEL_NEVER       ((uint64_t)-1)
+
+typedef struct _twe
+{
+    struct _twe  *p_next;
+    struct _twe  *p_prev;
+    uint64_t      target_time;          /* Tick at which the timer expires, set before timer_wheel_add */
+    uint8_t       level;                /* Slot the entry is linked in, valid while in the wheel */
+    uint8_t       slot;
+} TIMER_WHEEL_ENT;
+
+typedef struct
+{
+    TIMER_WHEEL_ENT *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t         in_use[TIMER_WHEEL_LEVELS];    /* bit n set when slots[level][n] is not empty */
+    uint64_t         base;                          /* every tick before base has been processed */
+    uint32_t         count;
+} TIMER_WHEEL;
+
+void             timer_wheel_init(TIMER_WHEEL *p_wheel, uint64_t now);
+void             timer_wheel_add(TIMER_WHEEL *p_wheel, TIMER_WHEEL_ENT *p_ent);
+void             timer_wheel_remove(TIMER_WHEEL *p_wheel, TIMER_WHEEL_ENT *p_ent);
+
+/* Returns one timer that is due at now and unlinks it, or NULL when none is left */
+TIMER_WHEEL_ENT *timer_wheel_pop_expired(TIMER_WHEEL *p_wheel, uint64_t now);
+
+/* Same as timer_wheel_pop_expired but leaves the timer in the wheel. Cascades up to now like the pop does. */
+TIMER_WHEEL_ENT *timer_wheel_peek_expired(TIMER_WHEEL *p_wheel, uint64_t now);
+
+/* Returns the earliest tick at which a timer expires or a slot has to be cascaded, TIMER_WHEEL_NEVER if empty.
+ * Never later than the earliest target_time in the wheel, so it can be used as the sleep deadline. */
+uint64_t         timer_wheel_next_event(TIMER_WHEEL *p_wheel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIMER_WHEEL_H__
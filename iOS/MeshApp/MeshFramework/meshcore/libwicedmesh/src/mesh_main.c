@@ -49,6 +49,7 @@
 #  include <unistd.h>
 #  include <time.h>
 #  include <sys/time.h>
+#  include <dispatch/dispatch.h>
 #  ifndef HAVE_CLOCK_GETTIME    // aimed to suppot platforms: iOS *.* < iOS 10.0
 #    include <mach/clock.h>
 #    include <mach/mach.h>
@@ -60,26 +61,31 @@
 #include "wiced_bt_mesh_core.h"
 #include "wiced_bt_gatt.h"
 #include "wiced_bt_mesh_provision.h"
+#include "timer_thread.h"
+#include "timer_stats.h"
+#include "mesh_trace.h"
 
 typedef void (TIMER_CBACK)(void *p_tle);
 #undef TIMER_PARAM_TYPE
 #define TIMER_PARAM_TYPE    void *
 
-extern uint32_t start_timer(int32_t timeout,  uint16_t type);
-extern void stop_timer(uint32_t timer_id);
 extern void mesh_provision_process_event(uint16_t event, wiced_bt_mesh_event_t *p_event, void *p_data);
 
 #define IS_TIMER_ENABLED(p, f)    ((((p)->flags) & (f)) == (f))
 #define TIMER_FLAG_ACTIVE       0x0001
+
+#ifndef TIMER_STATS_DUMP_INTERVAL
+#define TIMER_STATS_DUMP_INTERVAL   60000   // ms between dumps of the timer statistics, 0 disables the dump
+#endif
+
 typedef struct _tle
 {
-    struct _tle         *p_next;
+    TIMER_WHEEL_ENT     wheel;      /* Link in the timer thread wheel, must be the first member. */
     TIMER_CBACK         *p_cback;   /* Timer expiration callback function. */
     TIMER_PARAM_TYPE    param;      /* Parameter for the expiration callback function. */
-    uint32_t            idTimer;    /* Uniquely identifies a timer in the system. */
     uint32_t            timeout;    /* Periodical timeout interval in 1ms unit. */
-    uint16_t            type;       /* Timer type, see wiced_timer_type_t definitions. */
-    uint16_t            flags;      /* Flags for timer. */
+    uint8_t             type;       /* Timer type, see wiced_timer_type_t definitions. */
+    uint8_t             flags;      /* Flags for timer. */
 } TIMER_LIST_ENT;   // Must make sure the size of TIMER_LIST_ENT is equal or less than the size of wiced_timer_t.
 
 #define BILLION  1000000000L;
@@ -94,7 +100,6 @@ extern wiced_bool_t mesh_adv_scan_start(void);
 extern wiced_bool_t mesh_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
     wiced_bt_ble_conn_mode_t conn_mode, wiced_bool_t is_direct);
 extern wiced_bool_t mesh_bt_gatt_le_disconnect(uint32_t conn_id);
-extern uint32_t restart_timer(uint32_t timeout, uint32_t timer_id);
 
 void* wiced_memory_allocate(UINT32 length)
 {
@@ -151,40 +156,7 @@ uint64_t GetTickCount64()
 
 uint64_t clock_SystemTimeMicroseconds64(void)
 {
-    uint64_t res =  1000 * GetTickCount64();
-    return res;
-}
-
-static wiced_timer_t *wiced_timer_first = NULL;
-
-TIMER_LIST_ENT *wiced_find_timer(uint32_t idTimer)
-{
-    TIMER_LIST_ENT  *p_timer;
-    // got through each initialized timer
-    for (p_timer = (TIMER_LIST_ENT *)wiced_timer_first; p_timer != NULL; p_timer = (TIMER_LIST_ENT*)p_timer->p_next)
-    {
-        if (p_timer->idTimer == idTimer)
-        {
-            //ods("wiced_find_timer, found timer p_timer:0x%lx, idTimer=%u\n", p_timer, p_timer->idTimer);
-            return p_timer;
-        }
-    }
-
-    //ods("!!! wiced_find_timer, not found queued timer with idTimer=%u\n", idTimer);
-    return NULL;
-}
-
-wiced_bool_t is_queued_timer(wiced_timer_t *wt)
-{
-    TIMER_LIST_ENT *p_timer;
-    for (p_timer = (TIMER_LIST_ENT *)wiced_timer_first; p_timer != NULL; p_timer = p_timer->p_next)
-    {
-        if (p_timer == (TIMER_LIST_ENT *)wt)
-        {
-            return WICED_TRUE;
-        }
-    }
-    return WICED_FALSE;
+    return timer_thread_get_time_us();
 }
 
 wiced_result_t wiced_init_timer(wiced_timer_t *wt, wiced_timer_callback_t TimerCb,
@@ -197,12 +169,8 @@ wiced_result_t wiced_init_timer(wiced_timer_t *wt, wiced_timer_callback_t TimerC
         return WICED_NOT_AVAILABLE;
     }
 
+    // The content of wt is undefined here, it may be allocated and not cleared, so it can't be checked for a running timer.
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    if (is_queued_timer(wt)) {
-        // should not go to here.
-        ods("!!! wiced_init_timer, init queued timer, p_timer:0x%lx, type=%d, idTimer=%u, timeout=%u, p_cback=0x%lx, flags=0x%04x, p_next=0x%lx\n", p_timer, p_timer->type, p_timer->idTimer, p_timer->timeout, p_timer->p_cback, p_timer->flags, p_timer->p_next);
-        wiced_deinit_timer(wt);
-    }
 
     //ods("wiced_init_timer, p_timer:0x%lx, type=%d, TimerCb=0x%lx, cBackparam=0x%lx\n", p_timer, type, TimerCb, cBackparam);
     memset(p_timer, 0, sizeof(TIMER_LIST_ENT));
@@ -218,10 +186,10 @@ wiced_result_t wiced_init_timer(wiced_timer_t *wt, wiced_timer_callback_t TimerC
 wiced_result_t wiced_deinit_timer(wiced_timer_t* wt)
 {
     EnterCriticalSection();
-    // Make sure that we are not running the timer and removed from the timer list.
+    // Make sure that we are not running the timer and removed from the timer wheel.
     if (wiced_is_timer_in_use(wt))
     {
-        ods("!!! wiced_deinit_timer, p_timer:0x%lx is in using, trying to stop it firstly\n", wt);
+        MESH_TRACE_DEBUG(MESH_TRACE_TIMER, "!!! wiced_deinit_timer, p_timer:0x%lx is in using, trying to stop it firstly\n", wt);
         wiced_stop_timer(wt);
     }
     //ods("wiced_deinit_timer, p_timer:0x%lx\n", wt);
@@ -240,43 +208,19 @@ wiced_result_t wiced_start_timer(wiced_timer_t *wt, uint32_t timeout)
         timeout *= 1000;
     }
 
-    // Make sure that we are not starting the same timer twice.
-    // So, try to restart it with new timeout value if it was possible.
-    if (p_timer->idTimer != 0)
-    {
-        if (is_queued_timer(wt))
-        {
-            ods("!!! wiced_start_timer, restart timer p_timer:0x%lx, type=%d, idTimer=%u, timeout=%u, p_cback=0x%lx, flags=0x%04x, p_next=0x%lx\n", p_timer, p_timer->type, p_timer->idTimer, timeout, p_timer->p_cback, p_timer->flags, p_timer->p_next);
-            p_timer->idTimer = restart_timer(timeout, p_timer->idTimer);
-            if (p_timer->idTimer != 0)
-            {
-                p_timer->timeout = timeout;
-                p_timer->flags &= TIMER_FLAG_ACTIVE;
-
-                LeaveCriticalSection();
-                return WICED_SUCCESS;
-            }
-            else
-            {
-                ods("!!! wiced_start_timer, restart timer p_timer:0x%lx failed\n", p_timer);
-            }
-        }
-
-        // try to stop the timer firstly when the timer has been running.
-        wiced_stop_timer(wt);
-    }
+    timer_stats_start(p_timer->p_cback, IS_TIMER_ENABLED(p_timer, TIMER_FLAG_ACTIVE));
 
-    p_timer->idTimer = start_timer(timeout, p_timer->type);
-    if (p_timer->idTimer == 0)
+    // Make sure that we are not starting the same timer twice, restart it with the new timeout value.
+    if (IS_TIMER_ENABLED(p_timer, TIMER_FLAG_ACTIVE))
     {
-        ods("!!! wiced_start_timer, failed to do start_timer, p_timer=0x%lx\n", p_timer);
-        return WICED_START_ERROR;
+        timer_thread_remove(&p_timer->wheel);
     }
+
     p_timer->timeout = timeout;
-    p_timer->flags &= TIMER_FLAG_ACTIVE;
-    p_timer->p_next = (TIMER_LIST_ENT *)wiced_timer_first;
-    wiced_timer_first = wt;
-    //ods("wiced_start_timer, p_timer:0x%lx, type=%d, idTimer=%u, timeout=%u, p_cback=0x%lx, flags=0x%04x, p_next=0x%lx\n", p_timer, p_timer->type, p_timer->idTimer, timeout, p_timer->p_cback, p_timer->flags, p_timer->p_next);
+    p_timer->wheel.target_time = timer_thread_get_tick_count() + timeout;
+    timer_thread_add(&p_timer->wheel);
+    p_timer->flags |= TIMER_FLAG_ACTIVE;
+    //ods("wiced_start_timer, p_timer:0x%lx, type=%d, timeout=%u, p_cback=0x%lx, flags=0x%04x\n", p_timer, p_timer->type, timeout, p_timer->p_cback, p_timer->flags);
 
     LeaveCriticalSection();
     return WICED_SUCCESS;
@@ -285,55 +229,23 @@ wiced_result_t wiced_start_timer(wiced_timer_t *wt, uint32_t timeout)
 wiced_result_t wiced_stop_timer(wiced_timer_t* wt)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    TIMER_LIST_ENT *p_cur;
 
     EnterCriticalSection();
-    //ods("wiced_stop_timer, p_timer:0x%lx, type=%d, idTimer=%u, flags=0x%04x, p_next=0x%lx\n", p_timer, p_timer->type, p_timer->idTimer, p_timer->flags, p_timer->p_next);
-    if (!is_queued_timer(wt))
+    //ods("wiced_stop_timer, p_timer:0x%lx, type=%d, flags=0x%04x\n", p_timer, p_timer->type, p_timer->flags);
+    if (IS_TIMER_ENABLED(p_timer, TIMER_FLAG_ACTIVE))
     {
-        if (p_timer->idTimer != 0)
-        {
-            stop_timer(p_timer->idTimer);
-        }
         p_timer->flags &= ~TIMER_FLAG_ACTIVE;
-        LeaveCriticalSection();
-        return WICED_BT_SUCCESS;
-    }
-
-    stop_timer(p_timer->idTimer);
-    p_timer->flags &= ~TIMER_FLAG_ACTIVE;
-    //ods("wiced_stop_timer, p_timer:0x%lx, type=%d, idTimer=%u, flags=0x%04x, p_next=0x%lx\n", p_timer, p_timer->type, p_timer->idTimer, p_timer->flags, p_timer->p_next);
-
-    // unlink the timer from the list
-    if (wiced_timer_first == wt)
-    {
-        wiced_timer_first = (wiced_timer_t *)(p_timer->p_next);
-        p_timer->p_next = NULL;
-        LeaveCriticalSection();
-        return WICED_BT_SUCCESS;
-    }
-
-    // got through each initialized timer
-    for (p_cur = (TIMER_LIST_ENT *)wiced_timer_first; p_cur != NULL; p_cur = (TIMER_LIST_ENT *)p_cur->p_next)
-    {
-        if (p_cur->p_next == p_timer)
-        {
-            p_cur->p_next = p_timer->p_next;
-            p_timer->p_next = NULL;
-            LeaveCriticalSection();
-            return WICED_BT_SUCCESS;
-        }
+        timer_thread_remove(&p_timer->wheel);
+        timer_stats_stop(p_timer->p_cback);
     }
-
-    ods("!!! wiced_stop_timer, not found in queued timer list, p_timer:0x%lx, type=%d, idTimer=%u, flags=0x%04x, p_next=0x%lx\n", p_timer, p_timer->type, p_timer->idTimer, p_timer->flags, p_timer->p_next);
     LeaveCriticalSection();
-    return WICED_NO_INSTANCE;
+    return WICED_BT_SUCCESS;
 }
 
 wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *wt)
 {
     TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)wt;
-    if (is_queued_timer(wt) || ((p_timer->idTimer != 0) && IS_TIMER_ENABLED(p_timer, TIMER_FLAG_ACTIVE)))
+    if (IS_TIMER_ENABLED(p_timer, TIMER_FLAG_ACTIVE))
     {
         return WICED_TRUE;
     }
@@ -343,35 +255,79 @@ wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *wt)
     }
 }
 
-void MeshTimerFunc(long timer_id)
+int mesh_timer_get_site_stats(TIMER_STATS_REPORT *p_report, int max_reports)
 {
+    int count;
+
     EnterCriticalSection();
+    count = timer_stats_query(p_report, max_reports);
+    LeaveCriticalSection();
 
-    //ods("MeshTimerFunc, timer triggerred for timer_id=%ld", timer_id);
-    TIMER_LIST_ENT *p_timer = wiced_find_timer((uint32_t)timer_id);
-    if (p_timer != NULL)
-    {
-        if ((p_timer->type != WICED_SECONDS_PERIODIC_TIMER) && (p_timer->type != WICED_MILLI_SECONDS_PERIODIC_TIMER))
-        {
-            wiced_stop_timer((wiced_timer_t *)p_timer);
-        } else {
-            restart_timer(p_timer->timeout, p_timer->idTimer);
-        }
+    return count;
+}
 
-        if (p_timer->p_cback)
-        {
-            //ods("MeshTimerFunc, invoking the timer callback p_timer=0x%lx, timer_id=%ld, p_cback=0x%lx param=0x%lx\n", p_timer, p_timer->idTimer, p_timer->p_cback, p_timer->param);
-            p_timer->p_cback(p_timer->param);
-        }
+#if TIMER_STATS_DUMP_INTERVAL
+/* Checked each time a timer expires, so an idle client does not wake up just to dump. */
+static void mesh_timer_stats_dump(uint64_t now)
+{
+    static uint64_t           dump_time = 0;
+    static TIMER_STATS_REPORT report[TIMER_STATS_MAX_SITES + 1];
+
+    if (dump_time == 0)
+        dump_time = now + TIMER_STATS_DUMP_INTERVAL;
+    if (now < dump_time)
+        return;
+
+    dump_time = now + TIMER_STATS_DUMP_INTERVAL;
+    if (MESH_TRACE_ENABLED(MESH_TRACE_TIMER, MESH_TRACE_LEVEL_INFO))
+        timer_stats_print(report, timer_stats_query(report, TIMER_STATS_MAX_SITES + 1), ods);
+}
+#endif
+
+/* Called on the main queue with the cs lock held. */
+static void MeshTimerFunc(TIMER_WHEEL_ENT *p_ent)
+{
+    TIMER_LIST_ENT *p_timer = (TIMER_LIST_ENT *)p_ent;
+    uint64_t        now_us = timer_thread_get_time_us();
+
+    timer_stats_fired(p_timer->p_cback, p_ent->target_time * 1000, now_us);
+
+    if ((p_timer->type != WICED_SECONDS_PERIODIC_TIMER) && (p_timer->type != WICED_MILLI_SECONDS_PERIODIC_TIMER))
+    {
+        p_timer->flags &= ~TIMER_FLAG_ACTIVE;
+    } else {
+        p_timer->wheel.target_time = timer_thread_get_tick_count() + p_timer->timeout;
+        timer_thread_add(&p_timer->wheel);
     }
-    else
+
+    if (p_timer->p_cback)
     {
-        ods("!!! timer expired not found for timer_id=%ld\n", timer_id);
+        //ods("MeshTimerFunc, invoking the timer callback p_timer=0x%lx, p_cback=0x%lx param=0x%lx\n", p_timer, p_timer->p_cback, p_timer->param);
+        p_timer->p_cback(p_timer->param);
     }
+#if TIMER_STATS_DUMP_INTERVAL
+    mesh_timer_stats_dump(now_us / 1000);
+#endif
+}
 
+/*
+ * The timer callbacks end up in MeshNativeHelper delegates that use CoreBluetooth, NSTimer and
+ * notifications observed by the UI, so they run on the main queue like the NSTimers used to.
+ */
+static void MeshTimerRunExpired(void *context)
+{
+    (void)context;
+    EnterCriticalSection();
+    timer_thread_run_expired();
     LeaveCriticalSection();
 }
 
+/* Called by the timer thread with the cs lock held when timers are due. */
+static void MeshTimerDispatch(void)
+{
+    dispatch_async_f(dispatch_get_main_queue(), NULL, MeshTimerRunExpired);
+}
+
 // empty functions not needed in MeshController
 
 void mesh_discovery_start(void)
@@ -427,7 +383,7 @@ wiced_bool_t wiced_bt_gatt_le_connect(wiced_bt_device_address_t bd_addr,
     wiced_bt_ble_conn_mode_t conn_mode,
     wiced_bool_t is_direct)
 {
-    ods("wiced_bt_gatt_le_connect\n");
+    MESH_TRACE_DEBUG(MESH_TRACE_GATT, "wiced_bt_gatt_le_connect\n");
     return mesh_bt_gatt_le_connect(bd_addr, bd_addr_type, conn_mode, is_direct);
 }
 
@@ -472,8 +428,8 @@ wiced_bool_t initTimer()
     if(!timer_initialized ) {
         if (sizeof(wiced_timer_t) < sizeof(TIMER_LIST_ENT)) {
             // used to check the data size is correctly, because the wiced_timer_t data size may be udpated and cause inconsistent issue.
-            ods("\nerror: initTimer, invalid wiced_time_t size:%lu < TIMER_LIST_ENT size:%lu\n", sizeof(wiced_timer_t), sizeof(TIMER_LIST_ENT));
-            ods("please check the WICED_TIMER_INSTANCE_SIZE_IN_WORDS value in wiced_timer.h or update the TIMER_LIST_ENT to fix the new size.\n");
+            MESH_TRACE_ERROR(MESH_TRACE_TIMER, "\nerror: initTimer, invalid wiced_time_t size:%lu < TIMER_LIST_ENT size:%lu\n", sizeof(wiced_timer_t), sizeof(TIMER_LIST_ENT));
+            MESH_TRACE_ERROR(MESH_TRACE_TIMER, "please check the WICED_TIMER_INSTANCE_SIZE_IN_WORDS value in wiced_timer.h or update the TIMER_LIST_ENT to fix the new size.\n");
             return WICED_FALSE;
         }
 
@@ -482,7 +438,13 @@ wiced_bool_t initTimer()
         pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
         if (pthread_mutex_init(&cs, &Attr) != 0)
         {
-            ods("\nerror: initTimer, failed to initialize recursive mutex lock\n");
+            MESH_TRACE_ERROR(MESH_TRACE_TIMER, "\nerror: initTimer, failed to initialize recursive mutex lock\n");
+            return WICED_FALSE;
+        }
+        timer_thread_set_dispatch(MeshTimerDispatch);
+        if (timer_thread_init(&cs, MeshTimerFunc) != 0)
+        {
+            MESH_TRACE_ERROR(MESH_TRACE_TIMER, "\nerror: initTimer, failed to start the timer thread\n");
             return WICED_FALSE;
         }
         timer_initialized = WICED_TRUE;
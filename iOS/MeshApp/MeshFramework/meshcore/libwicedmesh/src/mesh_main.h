@@ -45,6 +45,7 @@
 #include "wiced.h"
 #include "bt_types.h"
 #include "trace.h"
+#include "timer_stats.h"
 
 #define LOG_TAG "MeshLibrary"
 
@@ -54,7 +55,6 @@ extern "C"
 #endif
 #define BT_MEMSET memset
 #define BT_MEMCPY memcpy
-void MeshTimerFunc(long timer_id);
 
 void mesh_set_adv_params(uint8_t delay, uint8_t repeat_times, uint16_t repeat_interval, uint8_t onetime_instance, uint16_t seg_dst, uint32_t seg_mask);
 void wiced_hal_wdog_reset_system(void);
@@ -72,6 +72,10 @@ wiced_bool_t initTimer(void);   // This API must be called firstly before using
 void EnterCriticalSection(void);
 void LeaveCriticalSection(void);
 
+/* Copies the start/stop counts and expiry lateness of up to max_reports timer callbacks, busiest
+ * first, and returns how many were copied. The same report is logged every TIMER_STATS_DUMP_INTERVAL ms. */
+int mesh_timer_get_site_stats(TIMER_STATS_REPORT *p_report, int max_reports);
+
 void setDfuFilePath(char* dfuFilepath);
 char *getDfuFilePath(void);
 
@@ -54,14 +54,15 @@
 #  endif
 #endif
 #include "trace.h"
+#include "hex_dump.h"
+#include "log_file.h"
 
 #define LOG_TAG "MeshJni"
 
-// Max 20M for each single log file. It's big enought to record any signle meash operation.
-#define LOG_FILE_MAX_SIZE (20 * 1024 * 1024)
+#define TRACE_LINE_MAX 1024
+
 static char* log_file_path = NULL;
 static char log_file_name[] = MESH_CORE_LOG_FILE_NAME;
-static FILE *log_fp = NULL;
 static int is_debug_enabled = TRUE;
 
 void mesh_trace_log_init(int is_console_enabled)
@@ -97,142 +98,101 @@ void open_log_file()
         Log("error: log_file_path not initialized yet, ignore\n");
         return;
     }
-    if (log_fp) {
-        fclose(log_fp);
-    }
-    log_fp = fopen(log_file_path, "a");
-    if (log_fp == NULL) {
+    // The writer thread owns the file from here on, lines are buffered and written in the background
+    if (!log_file_open(log_file_path)) {
         Log("error: failed to open log_file_path: %s\n", log_file_path);
+        return;
     }
     Log("opened log_file_path: %s", log_file_path);
 }
 
 void close_log_file()
 {
-    if (log_fp != NULL) {
-        Log("closed log_file_path: %s", log_file_path);
-        fclose(log_fp);
-        log_fp = NULL;
-    } else {
-        Log("closed log_file_path: NULL");
-    }
+    Log("closed log_file_path: %s", log_file_path ? log_file_path : "NULL");
+    log_file_close();
+}
+
+void set_log_file_max_size(uint32_t max_size)
+{
+    LOG_FILE_CONFIG config;
+
+    log_file_get_config(&config);
+    config.max_size = max_size;
+    log_file_set_config(&config);
+}
+
+void set_log_file_generations(uint32_t generations)
+{
+    LOG_FILE_CONFIG config;
+
+    log_file_get_config(&config);
+    config.generations = generations;
+    log_file_set_config(&config);
+}
+
+void set_log_file_flush_interval(uint32_t interval_ms)
+{
+    LOG_FILE_CONFIG config;
+
+    log_file_get_config(&config);
+    config.flush_interval_ms = interval_ms;
+    log_file_set_config(&config);
+}
+
+void set_log_file_compress(int compress)
+{
+    LOG_FILE_CONFIG config;
+
+    log_file_get_config(&config);
+    config.compress = compress;
+    log_file_set_config(&config);
 }
 
-void print_current_time()
+#ifndef __ANDROID__
+static void trace_output(const char *p_text, uint32_t len, int to_console)
 {
+    if (to_console && is_debug_enabled) fwrite(p_text, 1, len, stdout);
+    log_file_write(p_text, len);
+}
+
+// Formats the line once, with its time stamp, for both the console and the log file
+static void trace_vprint(const char *fmt, va_list ap, int add_newline, int to_console)
+{
+    char           line[TRACE_LINE_MAX];
     struct timeval tv;
-    char log_file_bak_name[PATH_MAX];
-
-    if (log_fp && (ftell(log_fp) > LOG_FILE_MAX_SIZE)) {
-        // remove previous backup log file and rename current log file as backup log file.
-        fflush(log_fp);
-        fclose(log_fp);
-        snprintf(log_file_bak_name, PATH_MAX, "%s.bak", log_file_path);
-        remove(log_file_bak_name);
-        rename(log_file_path, log_file_bak_name);
-
-        // re-create the log file.
-        open_log_file();
-        if (log_fp == NULL) {
-            // try again if failed to re-create the log file.
-            fflush(NULL);
-            open_log_file();
-        }
-    }
+    int            len, n;
 
-    if (gettimeofday(&tv, NULL) == 0)
-    {
-        if (is_debug_enabled) printf("%ld.%06d ", tv.tv_sec, tv.tv_usec);
-        if (log_fp) fprintf(log_fp, "%ld.%06d ", tv.tv_sec, tv.tv_usec);
-    }
-    else
-    {
-        if (is_debug_enabled) printf("%ld.%06d ", 0L, 0);
-        if (log_fp) fprintf(log_fp, "%ld.%06d ", 0L, 0);
+    if (gettimeofday(&tv, NULL) != 0) {
+        tv.tv_sec = 0;
+        tv.tv_usec = 0;
     }
+    len = snprintf(line, sizeof(line), "%ld.%06d ", (long)tv.tv_sec, (int)tv.tv_usec);
+
+    // One byte is kept for the newline
+    n = vsnprintf(&line[len], sizeof(line) - len - 1, fmt, ap);
+    if (n > 0)
+        len = (len + n < (int)sizeof(line) - 2) ? len + n : (int)sizeof(line) - 2;
+    if (add_newline && (line[len - 1] != '\n'))
+        line[len++] = '\n';
+    line[len] = 0;
+    trace_output(line, (uint32_t)len, to_console);
 }
+#endif
 
+// A dump is written as one block, the text already ends with a newline
+static void Logn_write(const char *p_text, uint32_t len)
+{
 #ifdef __ANDROID__
-#define  LOGY(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG,__VA_ARGS__)
+    __android_log_write(ANDROID_LOG_ERROR, LOG_TAG, p_text);
 #else
-#define  LOGY(...)  if (is_debug_enabled) { printf(__VA_ARGS__); printf("\n"); } if (log_fp) { fprintf(log_fp, __VA_ARGS__); fprintf(log_fp, "\n"); }
+    trace_output(p_text, len, 1);
 #endif
+}
+
 void Logn(uint8_t* data, int len)
 {
-    int count = 0;
-    int i;
-    for (i = 0; i < len; i += count){
-        count = len - i;
-        if (count >= 16) {
-            count = 16;
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12], data[13], data[14], data[15]);
-        }
-        else if (count == 15) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12], data[13], data[14]);
-        }
-        else if (count == 14) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12], data[13]);
-        }
-        else if (count == 13) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11],data[12]);
-        }
-        else if (count == 12) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10], data[11]);
-        }
-        else if (count == 11) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3], data[4],  data[5],  data[6],  data[7],
-                data[8],  data[9],  data[10]);
-        }
-        else if (count == 10) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3],
-                data[4],  data[5],  data[6],  data[7], data[8],  data[9]);
-        }
-        else if (count == 9) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0],  data[1],  data[2],  data[3],
-                data[4],  data[5],  data[6],  data[7], data[8]);
-        }
-        else if (count == 8) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x %02x",
-                data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
-        }
-        else if (count == 7) {
-            LOGY("%02x %02x %02x %02x %02x %02x %02x",
-                data[0], data[1], data[2], data[3], data[4], data[5], data[6]);
-        }
-        else if (count == 6) {
-            LOGY("%02x %02x %02x %02x %02x %02x",
-                data[0], data[1], data[2], data[3], data[4], data[5]);
-        }
-        else if (count == 5) {
-            LOGY("%02x %02x %02x %02x %02x", data[0], data[1], data[2], data[3], data[4]);
-        }
-        else if (count == 4) {
-            LOGY("%02x %02x %02x %02x", data[0], data[1], data[2], data[3]);
-        }
-        else if (count == 3) {
-            LOGY("%02x %02x %02x", data[0], data[1], data[2]);
-        }
-        else if (count == 2) {
-            LOGY("%02x %02x", data[0], data[1]);
-        }
-        else {
-            LOGY("%02x", data[0]);
-        }
-        data += count;
-    }
+    if (len > 0)
+        hex_dump(data, (uint32_t)len, 0, Logn_write);
 }
 
 void Log(char *fmt, ...)
@@ -242,17 +202,7 @@ void Log(char *fmt, ...)
 #ifdef __ANDROID__
     __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt, ap);
 #else
-    va_list aplist;
-    va_start(aplist, fmt);
-    print_current_time();
-    if (is_debug_enabled) vprintf(fmt, ap);
-    if (log_fp) vfprintf(log_fp, fmt, aplist);
-    if (fmt && fmt[strlen(fmt) - 1] != '\n')
-    {
-        if (is_debug_enabled) printf("\n");
-        if (log_fp) fprintf(log_fp, "\n");
-    }
-    va_end(aplist);
+    trace_vprint(fmt, ap, 1, 1);
 #endif
     va_end(ap);
 }
@@ -264,17 +214,7 @@ void ods(char * fmt_str, ...)
 #ifdef __ANDROID__
     __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt_str, ap);
 #else
-    va_list aplist;
-    va_start(aplist, fmt_str);
-    print_current_time();
-    if (is_debug_enabled) vprintf(fmt_str, ap);
-    if (log_fp) vfprintf(log_fp, fmt_str, aplist);
-    if (fmt_str && fmt_str[strlen(fmt_str) - 1] != '\n')
-    {
-        if (is_debug_enabled) printf("\n");
-        if (log_fp) fprintf(log_fp, "\n");
-    }
-    va_end(aplist);
+    trace_vprint(fmt_str, ap, 1, 1);
 #endif
     va_end(ap);
 }
@@ -288,18 +228,15 @@ int wiced_printf(char * buffer, int len, char *fmt_str, ...)
         fmt_str++;
     }
 #else
-    print_current_time();
     va_list ap;
     va_start(ap, fmt_str);
-    va_list aplist;
-    va_start(aplist, fmt_str);
-    if (buffer && len)
-        vsnprintf(buffer, len, fmt_str, ap);
-    else
-        if (is_debug_enabled) vprintf(fmt_str, ap);
-    if (log_fp)
-        vfprintf(log_fp, fmt_str, aplist);
-    va_end(aplist);
+    if (buffer && len) {
+        va_list aplist;
+        va_copy(aplist, ap);
+        vsnprintf(buffer, len, fmt_str, aplist);
+        va_end(aplist);
+    }
+    trace_vprint(fmt_str, ap, 0, !(buffer && len));
     va_end(ap);
 #endif
     return 0;
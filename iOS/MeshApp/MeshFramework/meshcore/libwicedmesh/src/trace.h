@@ -53,6 +53,11 @@ void mesh_trace_log_init(int is_console_enabled);
 void set_log_file_path(char* path);
 void open_log_file(void);
 void close_log_file(void);
+/* Log file limits, they take effect at the next write of the log file buffer */
+void set_log_file_max_size(uint32_t max_size);          // bytes, 0 for no limit
+void set_log_file_generations(uint32_t generations);    // rotated files kept as meshcore.log.1 .. N
+void set_log_file_flush_interval(uint32_t interval_ms);
+void set_log_file_compress(int compress);               // gzip rotated files, LOG_FILE_ZLIB builds only
 
 void ods(char *fmt, ...);
 void Log(char *fmt, ...);